@@ -524,7 +524,7 @@ nw_error_t *dcgan_fit(int64_t epochs, int64_t number_of_samples, batch_t *batch,
             }
 
             // Train discriminator with real images.
-            error = zero_gradient_model(discriminator);
+            error = zero_gradient_model(discriminator, false);
             if (error)
             {
                 error = ERROR(ERROR_ZERO_GRADIENT, string_create("failed zero gradient."), error);
@@ -697,7 +697,7 @@ nw_error_t *dcgan_fit(int64_t epochs, int64_t number_of_samples, batch_t *batch,
             fake_labels = NULL;
             generator_loss = NULL;
 
-            error = zero_gradient_model(generator);
+            error = zero_gradient_model(generator, false);
             if (error)
             {
                 error = ERROR(ERROR_ZERO_GRADIENT, string_create("failed zero gradient."), error);
@@ -111,9 +111,9 @@ nw_error_t *save_tensor_grayscale_to_png_file(tensor_t *tensor, string_t path)
 {
     bitmap_t png_img;
 
-    int64_t batch_size = tensor->buffer->view->shape[0];
-    int64_t image_height = tensor->buffer->view->shape[2];
-    int64_t image_width = tensor->buffer->view->shape[3];
+    int64_t batch_size = tensor->buffer->view.shape[0];
+    int64_t image_height = tensor->buffer->view.shape[2];
+    int64_t image_width = tensor->buffer->view.shape[3];
     int64_t grid_length = sqrt(batch_size);
     png_img.width = grid_length * image_width;
     png_img.height = grid_length * image_height;
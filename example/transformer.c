@@ -298,7 +298,7 @@ nw_error_t *generate(model_t *model, void *arguments, runtime_t runtime, datatyp
     fprintf(stdout, "Prompt: %s\nOutput: ", simpsons_dataset->prompt);
     for (int64_t i = 0; i < simpsons_dataset->max_tokens; ++i)
     {
-        int64_t sequence_length = x->buffer->view->shape[1];
+        int64_t sequence_length = x->buffer->view.shape[1];
 
         error = model_forward(model, x, &y);
         if (error)
@@ -15,23 +15,21 @@ nw_error_t *categorical_cross_entropy(const tensor_t *y_true, const tensor_t *y_
 
     CHECK_NULL_ARGUMENT(y_true, "y_true");
     CHECK_NULL_ARGUMENT(y_true->buffer, "y_true->buffer");
-    CHECK_NULL_ARGUMENT(y_true->buffer->view, "y_true->buffer->view");
     CHECK_NULL_ARGUMENT(y_prediction, "y_prediction");
     CHECK_NULL_ARGUMENT(y_prediction->buffer, "y_prediction->buffer");
-    CHECK_NULL_ARGUMENT(y_prediction->buffer->view, "y_prediction->buffer->view");
     CHECK_NULL_ARGUMENT(cost, "cost");
 
-    if (y_true->buffer->view->rank != y_prediction->buffer->view->rank)
+    if (y_true->buffer->view.rank != y_prediction->buffer->view.rank)
     {
         return ERROR(ERROR_RANK, string_create("rank conflict."), NULL);
     }
 
     nw_error_t *error = NULL;
-    int64_t rank = y_true->buffer->view->rank;
+    int64_t rank = y_true->buffer->view.rank;
     runtime_t runtime = y_true->buffer->storage->runtime;
     datatype_t datatype = y_true->buffer->storage->datatype;
-    int64_t batch_size = y_true->buffer->view->shape[0];
-    int64_t label_size = y_prediction->buffer->view->shape[rank - 1];
+    int64_t batch_size = y_true->buffer->view.shape[0];
+    int64_t label_size = y_prediction->buffer->view.shape[rank - 1];
     void *start = NULL;
     void *stop = NULL;
     void *step = NULL;
@@ -183,10 +181,8 @@ nw_error_t *binary_cross_entropy(const tensor_t *y_true, const tensor_t *y_predi
 
     CHECK_NULL_ARGUMENT(y_true, "y_true");
     CHECK_NULL_ARGUMENT(y_true->buffer, "y_true->buffer");
-    CHECK_NULL_ARGUMENT(y_true->buffer->view, "y_true->buffer->view");
     CHECK_NULL_ARGUMENT(y_prediction, "y_prediction");
     CHECK_NULL_ARGUMENT(y_prediction->buffer, "y_prediction->buffer");
-    CHECK_NULL_ARGUMENT(y_prediction->buffer->view, "y_prediction->buffer->view");
     CHECK_NULL_ARGUMENT(cost, "cost");
 
     nw_error_t *error = NULL;
@@ -303,10 +299,8 @@ nw_error_t *binary_cross_entropy_logits(const tensor_t *y_true, const tensor_t *
 
     CHECK_NULL_ARGUMENT(y_true, "y_true");
     CHECK_NULL_ARGUMENT(y_true->buffer, "y_true->buffer");
-    CHECK_NULL_ARGUMENT(y_true->buffer->view, "y_true->buffer->view");
     CHECK_NULL_ARGUMENT(y_prediction, "y_prediction");
     CHECK_NULL_ARGUMENT(y_prediction->buffer, "y_prediction->buffer");
-    CHECK_NULL_ARGUMENT(y_prediction->buffer->view, "y_prediction->buffer->view");
     CHECK_NULL_ARGUMENT(cost, "cost");
 
     nw_error_t *error = NULL;
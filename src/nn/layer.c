@@ -298,6 +298,7 @@ nw_error_t *linear_create(linear_t **linear, tensor_t *weights, tensor_t *bias)
 
     (*linear)->weights = weights;
     (*linear)->bias = bias;
+    (*linear)->quantization = NULL;
 
     return NULL;
 }
@@ -308,6 +309,7 @@ void linear_destroy(linear_t *linear)
     {
         tensor_destroy(linear->weights);
         tensor_destroy(linear->bias);
+        quantization_destroy(linear->quantization);
         free(linear);
     }
 }
@@ -327,6 +329,7 @@ nw_error_t *convolution_2d_create(convolution_2d_t **convolution_2d, int64_t pad
     (*convolution_2d)->stride = stride;
     (*convolution_2d)->kernel = kernel;
     (*convolution_2d)->bias = bias;
+    (*convolution_2d)->quantization = NULL;
 
     return NULL;
 }
@@ -337,6 +340,7 @@ void convolution_2d_destroy(convolution_2d_t *convolution_2d)
     {
         tensor_destroy(convolution_2d->kernel);
         tensor_destroy(convolution_2d->bias);
+        quantization_destroy(convolution_2d->quantization);
         free(convolution_2d);
     }
 }
@@ -634,6 +638,7 @@ nw_error_t *embedding_create(embedding_t **embedding, int64_t vocabulary_size, i
     (*embedding)->embedding_size = embedding_size;
     (*embedding)->vocabulary_counter = vocabulary_counter;
     (*embedding)->weights = weights;
+    (*embedding)->sparse = false;
 
     return NULL;
 }
@@ -1152,67 +1157,20 @@ nw_error_t *reshape_layer_create(layer_t **layer, int64_t *shape, int64_t length
     return error;
 }
 
-static nw_error_t *vocabulary_count_create(tensor_t **vocabulary_count, int64_t vocabulary_size, datatype_t datatype, runtime_t runtime)
+static nw_error_t *vocabulary_count_create(tensor_t **vocabulary_count, int64_t vocabulary_size, runtime_t runtime)
 {
     nw_error_t *error = NULL;
-    void *start = NULL;
-    void *stop = NULL;
-    void *step = NULL;
-    size_t size = datatype_size(datatype);
-
-    start = (void *) malloc(size);
-    if (!start)
-    {
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-    }
-
-    stop = (void *) malloc(size);
-    if (!stop)
-    {
-        free(start);
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-    }
-
-    step = (void *) malloc(size);
-    if (!step)
-    {
-        free(start);
-        free(stop);
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-    }
+    float64_t start = 0.0;
+    float64_t stop = (float64_t) vocabulary_size;
+    float64_t step = 1.0;
 
-    switch (datatype)
-    {
-    case FLOAT32:
-        *(float32_t *) start = (float32_t) 0.0;
-        *(float32_t *) stop = (float32_t) vocabulary_size;
-        *(float32_t *) step = (float32_t) 1.0;
-        break;
-    case FLOAT64:
-        *(float64_t *) start = (float64_t) 0.0;
-        *(float64_t *) stop = (float64_t) vocabulary_size;
-        *(float64_t *) step = (float64_t) 1.0;
-        break;
-    default:
-        free(start);
-        free(stop);
-        free(step);
-        return ERROR(ERROR_DATATYPE, string_create("unknown datatype."), NULL);
-    }
-
-    error = tensor_arange(vocabulary_count, start, stop, step, runtime, datatype, false, true);
+    // Token ids are indices, the counter is int64 whatever the datatype of the embedding weights.
+    error = tensor_arange(vocabulary_count, &start, &stop, &step, runtime, INT64, false, true);
     if (error)
     {
-        free(start);
-        free(stop);
-        free(step);
         return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
     }
 
-    free(start);
-    free(stop);
-    free(step);
-
     return error;
 }
 
@@ -1227,7 +1185,7 @@ static nw_error_t *embedding_initialize(embedding_t **embedding, int64_t vocabul
     int64_t embedding_rank = 2;
     tensor_t *vocabulary_count = NULL;
 
-    error = vocabulary_count_create(&vocabulary_count, vocabulary_size, datatype, runtime);
+    error = vocabulary_count_create(&vocabulary_count, vocabulary_size, runtime);
     if (error)
     {
         return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
@@ -1290,12 +1248,11 @@ static nw_error_t *embedding_create_from_parameters(embedding_t **embedding, ten
 
     nw_error_t *error = NULL;
     tensor_t *vocabulary_count = NULL;
-    int64_t vocabulary_size = weights->buffer->view->shape[0];
-    int64_t embedding_size = weights->buffer->view->shape[1];
-    datatype_t datatype = weights->buffer->storage->datatype;
+    int64_t vocabulary_size = weights->buffer->view.shape[0];
+    int64_t embedding_size = weights->buffer->view.shape[1];
     runtime_t runtime = weights->buffer->storage->runtime;
 
-    error = vocabulary_count_create(&vocabulary_count, vocabulary_size, datatype, runtime);
+    error = vocabulary_count_create(&vocabulary_count, vocabulary_size, runtime);
     if (error)
     {
         return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
@@ -1984,7 +1941,15 @@ nw_error_t *linear_forward(linear_t *linear, tensor_t *x, tensor_t **y)
 
     nw_error_t *error = NULL;
 
-    error = tensor_linear(x, linear->weights, linear->bias, y);
+    if (linear->quantization)
+    {
+        error = tensor_quantized_linear(x, linear->quantization, linear->bias, y);
+    }
+    else
+    {
+        error = tensor_linear(x, linear->weights, linear->bias, y);
+    }
+
     if (error)
     {
         return ERROR(ERROR_LINEAR, string_create("failed to matrix multiply tensors."), error);
@@ -2009,7 +1974,16 @@ nw_error_t *convolution_2d_forward(convolution_2d_t *convolution_2d, tensor_t *x
 
     nw_error_t *error = NULL;
 
-    error = tensor_convolution_2d(x, convolution_2d->kernel, convolution_2d->bias, y, convolution_2d->stride, convolution_2d->padding);
+    if (convolution_2d->quantization)
+    {
+        error = tensor_quantized_convolution_2d(x, convolution_2d->quantization, convolution_2d->bias, y, 
+                                                convolution_2d->kernel->buffer->view.shape[2], convolution_2d->stride, convolution_2d->padding);
+    }
+    else
+    {
+        error = tensor_convolution_2d(x, convolution_2d->kernel, convolution_2d->bias, y, convolution_2d->stride, convolution_2d->padding);
+    }
+
     if (error)
     {
         return ERROR(ERROR_CONVOLUTION, string_create("failed to apply convolution_2d."), error);
@@ -2208,7 +2182,7 @@ nw_error_t *embedding_forward(embedding_t *embedding, tensor_t *x, tensor_t **y)
 
     nw_error_t *error = NULL;
 
-    error = tensor_embedding(x, embedding->weights, embedding->vocabulary_counter, y);
+    error = tensor_embedding(x, embedding->weights, embedding->vocabulary_counter, embedding->sparse, y);
     if (error)
     {
         return ERROR(ERROR_EMBEDDING, string_create("failed to embed tensor."), error);
@@ -2235,53 +2209,14 @@ nw_error_t *transformer_embedding_forward(transformer_embedding_t *transformer_e
     tensor_t *position_embedding = NULL;
     tensor_t *positions = NULL;
     tensor_t *positions_expand = NULL;
-    datatype_t datatype = x->buffer->storage->datatype;
     runtime_t runtime = x->buffer->storage->runtime;
-    int64_t block_size = x->buffer->view->shape[1];
-    void *start = NULL;
-    void *stop = NULL;
-    void *step = NULL;
-    size_t size = datatype_size(datatype);
+    int64_t block_size = x->buffer->view.shape[1];
+    float64_t start = 0.0;
+    float64_t stop = (float64_t) block_size;
+    float64_t step = 1.0;
 
-    start = (void *) malloc(size);
-    if (!start)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes", size), NULL);
-        goto cleanup;
-    }
-
-    stop = (void *) malloc(size);
-    if (!stop)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes", size), NULL);
-        goto cleanup;
-    }
-
-    step = (void *) malloc(size);
-    if (!step)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes", size), NULL);
-        goto cleanup;
-    }
-
-    switch (datatype)
-    {
-    case FLOAT32:
-        *(float32_t *) start = (float32_t) 0.0;
-        *(float32_t *) stop = (float32_t) block_size;
-        *(float32_t *) step = 1.0;
-        break;
-    case FLOAT64:
-        *(float64_t *) start = (float64_t) 0.0;
-        *(float64_t *) stop = (float64_t) block_size;
-        *(float64_t *) step = 1.0;
-        break;
-    default:
-        error = ERROR(ERROR_DATATYPE, string_create("unknown datatype."), NULL);
-        goto cleanup;
-    }
-
-    error = tensor_arange(&positions, start, stop, step, runtime, datatype, false, false);
+    // Positions are int64 indices like the token ids.
+    error = tensor_arange(&positions, &start, &stop, &step, runtime, INT64, false, false);
     if (error)
     {
         error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
@@ -2322,11 +2257,13 @@ nw_error_t *transformer_embedding_forward(transformer_embedding_t *transformer_e
 
 cleanup:
 
-    free(start);
-    free(stop);
-    free(step);
     tensor_destroy(positions);
-    tensor_destroy(positions_expand);
+
+    // The expanded positions are an operand of the position embedding and belong to the graph when it is differentiated.
+    if (!transformer_embedding->position_embedding->weights->requires_gradient || no_gradient)
+    {
+        tensor_destroy(positions_expand);
+    }
 
     if (!(x->requires_gradient || transformer_embedding->token_embedding->weights->requires_gradient || transformer_embedding->position_embedding->weights->requires_gradient) || no_gradient)
     {
@@ -2435,6 +2372,7 @@ nw_error_t *block_inference(block_t *block, bool_t inference)
             block->layers[i]->transform->causal_multihead_self_attention->inference = inference;
             break;
         case BLOCK:
+        case RESIDUAL_BLOCK:
             error = block_inference(block->layers[i]->transform->block, inference);
             if (error)
             {
@@ -2449,6 +2387,147 @@ nw_error_t *block_inference(block_t *block, bool_t inference)
     return error;
 }
 
+/**
+ * @brief Choose whether embedding weights receive row sparse gradients holding only the looked up rows.
+ *        The optimizers then only update those rows, which keeps large vocabularies cheap to train.
+ */
+nw_error_t *model_sparse_gradient(model_t *model, bool_t sparse)
+{
+    CHECK_NULL_ARGUMENT(model, "model");
+
+    nw_error_t *error = block_sparse_gradient(model->block, sparse);
+    if (error)
+    {
+        return ERROR(ERROR_SET, string_create("failed to set sparse gradient flag."), error);
+    }
+
+    return error;
+}
+
+nw_error_t *block_sparse_gradient(block_t *block, bool_t sparse)
+{
+    CHECK_NULL_ARGUMENT(block, "block");
+
+    nw_error_t *error = NULL;
+
+    for (int64_t i = 0; i < block->depth; ++i)
+    {
+        switch (block->layers[i]->transform_type)
+        {
+        case EMBEDDING:
+            block->layers[i]->transform->embedding->sparse = sparse;
+            break;
+        case TRANSFORMER_EMBEDDING:
+            block->layers[i]->transform->transformer_embedding->token_embedding->sparse = sparse;
+            block->layers[i]->transform->transformer_embedding->position_embedding->sparse = sparse;
+            break;
+        case BLOCK:
+        case RESIDUAL_BLOCK:
+            error = block_sparse_gradient(block->layers[i]->transform->block, sparse);
+            if (error)
+            {
+                return ERROR(ERROR_SET, string_create("failed to set sparse gradient flag."), error);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return error;
+}
+
+/**
+ * @brief Post-training quantization of every linear and convolution layer to int8 weights with per channel scales.
+ *        Afterwards `model_forward` runs those layers through the integer GEMM with dynamically quantized activations.
+ *        The float weights are kept so the model can still be saved, the quantized forward pass does not propagate gradients.
+ */
+nw_error_t *model_quantize(model_t *model)
+{
+    CHECK_NULL_ARGUMENT(model, "model");
+
+    nw_error_t *error = block_quantize(model->block);
+    if (error)
+    {
+        return ERROR(ERROR_QUANTIZATION, string_create("failed to quantize model."), error);
+    }
+
+    return error;
+}
+
+nw_error_t *block_quantize(block_t *block)
+{
+    CHECK_NULL_ARGUMENT(block, "block");
+
+    nw_error_t *error = NULL;
+
+    for (int64_t i = 0; i < block->depth; ++i)
+    {
+        switch (block->layers[i]->transform_type)
+        {
+        case LINEAR:
+            error = linear_quantize(block->layers[i]->transform->linear);
+            break;
+        case CONVOLUTION_2D:
+            error = convolution_2d_quantize(block->layers[i]->transform->convolution_2d);
+            break;
+        case BLOCK:
+        case RESIDUAL_BLOCK:
+            error = block_quantize(block->layers[i]->transform->block);
+            break;
+        default:
+            break;
+        }
+
+        if (error)
+        {
+            return ERROR(ERROR_QUANTIZATION, string_create("failed to quantize layer."), error);
+        }
+    }
+
+    return error;
+}
+
+nw_error_t *linear_quantize(linear_t *linear)
+{
+    CHECK_NULL_ARGUMENT(linear, "linear");
+    CHECK_NULL_ARGUMENT(linear->weights, "linear->weights");
+
+    nw_error_t *error = NULL;
+    quantization_t *quantization = NULL;
+
+    error = buffer_quantize(linear->weights->buffer, true, &quantization);
+    if (error)
+    {
+        return ERROR(ERROR_QUANTIZATION, string_create("failed to quantize weights."), error);
+    }
+
+    quantization_destroy(linear->quantization);
+    linear->quantization = quantization;
+
+    return error;
+}
+
+nw_error_t *convolution_2d_quantize(convolution_2d_t *convolution_2d)
+{
+    CHECK_NULL_ARGUMENT(convolution_2d, "convolution_2d");
+    CHECK_NULL_ARGUMENT(convolution_2d->kernel, "convolution_2d->kernel");
+
+    nw_error_t *error = NULL;
+    quantization_t *quantization = NULL;
+
+    error = buffer_quantize(convolution_2d->kernel->buffer, false, &quantization);
+    if (error)
+    {
+        return ERROR(ERROR_QUANTIZATION, string_create("failed to quantize kernel."), error);
+    }
+
+    quantization_destroy(convolution_2d->quantization);
+    convolution_2d->quantization = quantization;
+
+    return error;
+}
+
 nw_error_t *model_save(model_t *model, string_t path)
 {
     CHECK_NULL_ARGUMENT(model, "model");
@@ -3086,6 +3165,7 @@ nw_error_t *linear_load(linear_t **linear, FILE *file)
 
     (*linear)->weights = NULL;
     (*linear)->bias = NULL;
+    (*linear)->quantization = NULL;
     
     error = tensor_load(&(*linear)->weights, file);
     if (error)
@@ -3126,6 +3206,7 @@ nw_error_t *convolution_2d_load(convolution_2d_t **convolution_2d, FILE *file)
 
     (*convolution_2d)->kernel = NULL;
     (*convolution_2d)->bias = NULL;
+    (*convolution_2d)->quantization = NULL;
 
     error = tensor_load(&(*convolution_2d)->kernel, file);
     if (error)
@@ -3499,6 +3580,7 @@ nw_error_t *embedding_load(embedding_t **embedding, FILE *file)
 
     (*embedding)->vocabulary_counter = NULL;
     (*embedding)->weights = NULL;
+    (*embedding)->sparse = false;
 
     if (!fread(&(*embedding)->vocabulary_size, sizeof(int64_t), 1, file))
     {
@@ -3765,7 +3847,7 @@ nw_error_t *linear_parameter_count(linear_t *linear, int64_t *count)
 
     if (linear->weights) 
     {
-        error = view_physical_size(linear->weights->buffer->view, &size);
+        error = view_physical_size(&linear->weights->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3776,7 +3858,7 @@ nw_error_t *linear_parameter_count(linear_t *linear, int64_t *count)
 
     if (linear->bias) 
     {
-        error = view_physical_size(linear->bias->buffer->view, &size);
+        error = view_physical_size(&linear->bias->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3798,7 +3880,7 @@ nw_error_t *convolution_2d_parameter_count(convolution_2d_t *convolution_2d, int
 
     if (convolution_2d->kernel) 
     {
-        error = view_physical_size(convolution_2d->kernel->buffer->view, &size);
+        error = view_physical_size(&convolution_2d->kernel->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3809,7 +3891,7 @@ nw_error_t *convolution_2d_parameter_count(convolution_2d_t *convolution_2d, int
 
     if (convolution_2d->bias) 
     {
-        error = view_physical_size(convolution_2d->bias->buffer->view, &size);
+        error = view_physical_size(&convolution_2d->bias->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3831,7 +3913,7 @@ nw_error_t *batch_normalization_2d_parameter_count(batch_normalization_2d_t *bat
 
     if (batch_normalization_2d->weights) 
     {
-        error = view_physical_size(batch_normalization_2d->weights->buffer->view, &size);
+        error = view_physical_size(&batch_normalization_2d->weights->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3842,7 +3924,7 @@ nw_error_t *batch_normalization_2d_parameter_count(batch_normalization_2d_t *bat
 
     if (batch_normalization_2d->bias) 
     {
-        error = view_physical_size(batch_normalization_2d->bias->buffer->view, &size);
+        error = view_physical_size(&batch_normalization_2d->bias->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3864,7 +3946,7 @@ nw_error_t *layer_normalization_parameter_count(layer_normalization_t *layer_nor
 
     if (layer_normalization->weights) 
     {
-        error = view_physical_size(layer_normalization->weights->buffer->view, &size);
+        error = view_physical_size(&layer_normalization->weights->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3875,7 +3957,7 @@ nw_error_t *layer_normalization_parameter_count(layer_normalization_t *layer_nor
 
     if (layer_normalization->bias) 
     {
-        error = view_physical_size(layer_normalization->bias->buffer->view, &size);
+        error = view_physical_size(&layer_normalization->bias->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3897,7 +3979,7 @@ nw_error_t *embedding_parameter_count(embedding_t *embedding, int64_t *count)
 
     if (embedding->weights) 
     {
-        error = view_physical_size(embedding->weights->buffer->view, &size);
+        error = view_physical_size(&embedding->weights->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3952,7 +4034,7 @@ nw_error_t *causal_multihead_self_attention_parameter_count(causal_multihead_sel
 
     if (causal_multihead_self_attention->input_weights) 
     {
-        error = view_physical_size(causal_multihead_self_attention->input_weights->buffer->view, &size);
+        error = view_physical_size(&causal_multihead_self_attention->input_weights->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3963,7 +4045,7 @@ nw_error_t *causal_multihead_self_attention_parameter_count(causal_multihead_sel
 
     if (causal_multihead_self_attention->input_bias) 
     {
-        error = view_physical_size(causal_multihead_self_attention->input_bias->buffer->view, &size);
+        error = view_physical_size(&causal_multihead_self_attention->input_bias->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3974,7 +4056,7 @@ nw_error_t *causal_multihead_self_attention_parameter_count(causal_multihead_sel
 
     if (causal_multihead_self_attention->output_weights) 
     {
-        error = view_physical_size(causal_multihead_self_attention->output_weights->buffer->view, &size);
+        error = view_physical_size(&causal_multihead_self_attention->output_weights->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
@@ -3985,7 +4067,7 @@ nw_error_t *causal_multihead_self_attention_parameter_count(causal_multihead_sel
 
     if (causal_multihead_self_attention->output_bias) 
     {
-        error = view_physical_size(causal_multihead_self_attention->output_bias->buffer->view, &size);
+        error = view_physical_size(&causal_multihead_self_attention->output_bias->buffer->view, &size);
         if (error)
         {
             return ERROR(ERROR_N, string_create("failed to count parameters."), error);
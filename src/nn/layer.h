@@ -15,6 +15,7 @@ typedef struct linear_t
 {
     tensor_t *weights;
     tensor_t *bias;
+    quantization_t *quantization;
 } linear_t;
 
 typedef struct convolution_2d_t
@@ -23,6 +24,7 @@ typedef struct convolution_2d_t
     int64_t stride;
     tensor_t *kernel;
     tensor_t *bias;
+    quantization_t *quantization;
 } convolution_2d_t;
 
 typedef struct pooling_2d_t
@@ -74,6 +76,7 @@ typedef struct embedding_t
     int64_t embedding_size;
     tensor_t *vocabulary_counter;
     tensor_t *weights;
+    bool_t sparse;
 } embedding_t;
 
 typedef struct transformer_embedding_t
@@ -266,6 +269,16 @@ nw_error_t *causal_multihead_self_attention_parameter_count(causal_multihead_sel
 nw_error_t *model_inference(model_t *model, bool_t inference);
 nw_error_t *block_inference(block_t *block, bool_t inference);
 
+// Sparse gradient set
+nw_error_t *model_sparse_gradient(model_t *model, bool_t sparse);
+nw_error_t *block_sparse_gradient(block_t *block, bool_t sparse);
+
+// Quantization
+nw_error_t *model_quantize(model_t *model);
+nw_error_t *block_quantize(block_t *block);
+nw_error_t *linear_quantize(linear_t *linear);
+nw_error_t *convolution_2d_quantize(convolution_2d_t *convolution_2d);
+
 // Save Model
 nw_error_t *model_save(model_t *model, string_t path);
 nw_error_t *block_save(block_t *block, FILE *file);
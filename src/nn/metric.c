@@ -60,7 +60,10 @@ nw_error_t *multiclass_accuracy(const tensor_t *y_pred, const tensor_t *y_true,
     nw_error_t *error = NULL;
     tensor_t *y_i = NULL;
     tensor_t *y_j = NULL;
-    int64_t rank = y_pred->buffer->view->rank;
+    tensor_t *y_k = NULL;
+    tensor_t *y_l = NULL;
+    int64_t rank = y_pred->buffer->view.rank;
+    datatype_t datatype = y_true->buffer->storage->datatype;
 
     error = tensor_argument_maximum(y_pred, &y_i, rank - 1, true);
     if (error)
@@ -69,14 +72,36 @@ nw_error_t *multiclass_accuracy(const tensor_t *y_pred, const tensor_t *y_true,
         goto cleanup;
     }
 
-    error = tensor_compare_equal(y_i, y_true, &y_j);
+    // Predicted classes are int64, labels stored in another datatype are compared against cast predictions.
+    if (y_i->buffer->storage->datatype != datatype)
+    {
+        error = tensor_cast(y_i, datatype, &y_k);
+        if (error)
+        {
+            error = ERROR(ERROR_DATATYPE, string_create("failed to cast tensor."), error);
+            goto cleanup;
+        }
+    }
+
+    error = tensor_compare_equal((y_k) ? y_k : y_i, y_true, &y_j);
     if (error)
     {
         error = ERROR(ERROR_COMPARE_EQUAL, string_create("failed to compare equal tensors."), error);
         goto cleanup;
     }
 
-    error = tensor_mean(y_j, accuracy, NULL, 0, false);
+    // Integer matches are averaged in the datatype of the predictions so the accuracy is not rounded.
+    if (datatype_is_integer(datatype))
+    {
+        error = tensor_cast(y_j, y_pred->buffer->storage->datatype, &y_l);
+        if (error)
+        {
+            error = ERROR(ERROR_DATATYPE, string_create("failed to cast tensor."), error);
+            goto cleanup;
+        }
+    }
+
+    error = tensor_mean((y_l) ? y_l : y_j, accuracy, NULL, 0, false);
     if (error)
     {
         error = ERROR(ERROR_MEAN, string_create("failed to get mean of tensor."), error);
@@ -85,6 +110,9 @@ nw_error_t *multiclass_accuracy(const tensor_t *y_pred, const tensor_t *y_true,
 
 cleanup:
 
+    tensor_destroy(y_k);
+    tensor_destroy(y_l);
+
     if (!y_pred->requires_gradient || no_gradient)
     {
         if (y_j != *accuracy)
@@ -472,6 +472,7 @@ nw_error_t *adam_create(adam_t **adam, datatype_t datatype, void *learning_rate,
     (*adam)->iteration = NULL;
     (*adam)->first_moment = NULL;
     (*adam)->second_moment = NULL;
+    (*adam)->row_iteration = NULL;
 
     size_t size = datatype_size(datatype);
 
@@ -552,6 +553,13 @@ nw_error_t *adam_create(adam_t **adam, datatype_t datatype, void *learning_rate,
         goto cleanup;
     }
 
+    error = map_create(&(*adam)->row_iteration);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create map."), NULL);
+        goto cleanup;
+    }
+
     return error;
 
 cleanup:
@@ -563,8 +571,8 @@ void adam_destroy(adam_t *adam)
 {
     if (adam)
     {
-        map_t *maps[] = {adam->iteration, adam->first_moment, adam->second_moment};
-        for (int i = 0; i < 3; ++i)
+        map_t *maps[] = {adam->iteration, adam->first_moment, adam->second_moment, adam->row_iteration};
+        for (int i = 0; i < 4; ++i)
         {
             for (uint64_t j = 0; j < maps[i]->capacity; ++j)
             {
@@ -852,16 +860,37 @@ nw_error_t *update_parameters(optimizer_t *optimizer, tensor_t *parameters)
 
     if (parameters)
     {
+        // Row sparse gradients only update the rows they cover, RMSProp has no sparse variant and densifies them.
+        bool_t sparse = parameters->gradient && parameters->gradient_rows;
+
         switch (optimizer->algorithm_type)
         {
         case STOCASTIC_GRADIENT_DESCENT:
-            error = stochastic_gradient_descent(optimizer->algorithm->stochastic_gradient_descent, parameters);
+            if (sparse)
+            {
+                error = sparse_stochastic_gradient_descent(optimizer->algorithm->stochastic_gradient_descent, parameters);
+            }
+            else
+            {
+                error = stochastic_gradient_descent(optimizer->algorithm->stochastic_gradient_descent, parameters);
+            }
             break;
         case RMS_PROP:
-            error = rms_prop(optimizer->algorithm->rms_prop, parameters);
+            error = tensor_dense_gradient(parameters);
+            if (!error)
+            {
+                error = rms_prop(optimizer->algorithm->rms_prop, parameters);
+            }
             break;
         case ADAM:
-            error = adam(optimizer->algorithm->adam, parameters);
+            if (sparse)
+            {
+                error = sparse_adam(optimizer->algorithm->adam, parameters);
+            }
+            else
+            {
+                error = adam(optimizer->algorithm->adam, parameters);
+            }
             break;
         default:
             return ERROR(ERROR_ALGORITHM, string_create("unknown algorithm %d.", (int) optimizer->algorithm_type), error);
@@ -876,6 +905,39 @@ nw_error_t *update_parameters(optimizer_t *optimizer, tensor_t *parameters)
     return error;
 }
 
+/**
+ * @brief Store optimizer state of the parameters under `key`.
+ *        The state is kept across training steps, so its storage is moved out of the step arena first.
+ */
+static nw_error_t *optimizer_state_set(map_t *map, string_t key, tensor_t *state)
+{
+    nw_error_t *error = buffer_persist(state->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to move optimizer state out of the arena."), error);
+    }
+
+    return map_set(map, key, state);
+}
+
+static float64_t optimizer_scalar(void *value, datatype_t datatype)
+{
+    float64_t scalar;
+
+    runtime_convert(datatype, value, FLOAT64, &scalar, 1);
+
+    return scalar;
+}
+
+/**
+ * @brief Convert `value` to the compute datatype of tensors of `datatype`, the form scale factors of in place updates take.
+ * @param alpha Storage for the converted scalar, wide enough for every compute datatype.
+ */
+static void optimizer_alpha(float64_t value, datatype_t datatype, float64_t *alpha)
+{
+    runtime_convert(FLOAT64, &value, datatype_compute(datatype), alpha, 1);
+}
+
 nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer, tensor_t *parameters)
 {
     CHECK_NULL_ARGUMENT(optimizer, "optimizer");
@@ -885,23 +947,18 @@ nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer
     PRINTLN_DEBUG_TENSOR("parameters", parameters);
 
     nw_error_t *error = NULL;
-    tensor_t *learning_rate = NULL;
     tensor_t *weight_decay = NULL;
     tensor_t *weight_decay_product = NULL;
-    tensor_t *parameter_update = NULL;
     tensor_t *momentum_constant = NULL;
-    tensor_t *momentum_product = NULL;
-    tensor_t *dampening_constant = NULL;
-    tensor_t *dampening_gradient = NULL;
     tensor_t *updated_momentum = NULL;
     tensor_t *modified_momentum = NULL;
-    tensor_t *initial_momentum = NULL;
     tensor_t *nesterov_momentum = NULL;
     tensor_t *weight_decay_sum = NULL;
     tensor_t *gradient = NULL;
     string_t key = string_create("%lu", parameters->id);
     datatype_t datatype = parameters->buffer->storage->datatype;
     runtime_t runtime = parameters->buffer->storage->runtime;
+    float64_t alpha;
 
     with_no_gradient(true);
 
@@ -949,14 +1006,21 @@ nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer
     {
         if (!map_contains(optimizer->momentum_buffer, key))
         {
-            error = tensor_as_tensor(gradient, &updated_momentum);
+            error = tensor_zeroes_like(gradient, &updated_momentum, false, true);
             if (error)
             {
                 error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
                 goto cleanup;
             }
 
-            error = map_set(optimizer->momentum_buffer, key, updated_momentum);
+            error = tensor_addition_inplace(updated_momentum, gradient);
+            if (error)
+            {
+                error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
+                goto cleanup;
+            }
+
+            error = optimizer_state_set(optimizer->momentum_buffer, key, updated_momentum);
             if (error)
             {
                 error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
@@ -972,63 +1036,27 @@ nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer
                 goto cleanup;
             }
 
-            error = map_get(optimizer->momentum_buffer, key, (void **) &initial_momentum);
+            error = map_get(optimizer->momentum_buffer, key, (void **) &updated_momentum);
             if (error)
             {
                 error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
                 goto cleanup;
             }
 
-            error = tensor_multiplication(momentum_constant, initial_momentum, &momentum_product);
+            error = tensor_multiplication_inplace(updated_momentum, momentum_constant);
             if (error)
             {
                 error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
                 goto cleanup;
             }
 
-            switch(datatype)
-            {
-                case FLOAT32:
-                    float32_t dampening_alpha_32 = (float32_t) 1 - *(float32_t *) (optimizer->dampening);
-                    error = tensor_constant(&dampening_alpha_32, datatype, runtime, false, false, &dampening_constant);
-                    break;
-                case FLOAT64:
-                    float64_t dampening_alpha_64 = (float64_t) 1 - *(float64_t *) (optimizer->dampening);
-                    error = tensor_constant(&dampening_alpha_64, datatype, runtime, false, false, &dampening_constant);
-                    break;
-                default:
-                    error = ERROR(ERROR_DATATYPE, string_create("unknown datatype %d.", (int)datatype), NULL);
-                    break;
-            }
-            if (error)
-            {
-                error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-                goto cleanup;
-            }
-
-            error = tensor_multiplication(dampening_constant, gradient, &dampening_gradient);
-            if (error)
-            {
-                error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-                goto cleanup;
-            }
-
-            error = tensor_addition(dampening_gradient, momentum_product, &updated_momentum);
+            optimizer_alpha(1.0 - optimizer_scalar(optimizer->dampening, optimizer->datatype), datatype, &alpha);
+            error = tensor_scaled_add_inplace(updated_momentum, gradient, &alpha);
             if (error)
             {
                 error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
                 goto cleanup;
             }
-
-            tensor_destroy(initial_momentum);
-            initial_momentum = NULL;
-
-            error = map_set(optimizer->momentum_buffer, key, updated_momentum);
-            if (error)
-            {
-                error = ERROR(ERROR_SET, string_create("failed to set entry."), error);
-                goto cleanup;
-            }
         }
         if (optimizer->nesterov)
         {
@@ -1077,21 +1105,8 @@ nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer
         }
     }
 
-    error = tensor_constant(optimizer->learning_rate, datatype, runtime, false, false, &learning_rate);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-    
-    error = tensor_multiplication(learning_rate, gradient, &parameter_update);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_subtraction(parameters, parameter_update, &parameters);
+    optimizer_alpha(-optimizer_scalar(optimizer->learning_rate, optimizer->datatype), datatype, &alpha);
+    error = tensor_scaled_add_inplace(parameters, gradient, &alpha);
     if (error)
     {
         error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
@@ -1102,16 +1117,10 @@ nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer
 
 cleanup:
     string_destroy(key);
-    tensor_destroy(learning_rate);
     tensor_destroy(weight_decay);
     tensor_destroy(weight_decay_product);
-    tensor_destroy(parameter_update);
     tensor_destroy(momentum_constant);
-    tensor_destroy(momentum_product);
-    tensor_destroy(dampening_constant);
-    tensor_destroy(dampening_gradient);
     tensor_destroy(modified_momentum);
-    tensor_destroy(initial_momentum);
     tensor_destroy(nesterov_momentum);
     tensor_destroy(weight_decay_sum);
     tensor_destroy(gradient);
@@ -1124,15 +1133,12 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
     CHECK_NULL_ARGUMENT(parameters, "parameters");
 
     nw_error_t *error = NULL;
-    tensor_t *learning_rate = NULL;
     tensor_t *weight_decay = NULL;
     tensor_t *weight_decay_product = NULL;
     tensor_t *alpha_constant = NULL;
-    tensor_t *alpha_product = NULL;
     tensor_t *one_minus_alpha_constant = NULL;
     tensor_t *squared_current_gradient = NULL;
     tensor_t *square_average = NULL;
-    tensor_t *square_average_initial = NULL;
     tensor_t *one_minus_alpha_product = NULL;
     tensor_t *square_average_telda = NULL;
     tensor_t *temp_optimizer_square_average = NULL;
@@ -1140,25 +1146,21 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
     tensor_t *square_average_telda_root = NULL;
     tensor_t *epsilon_constant = NULL;
     tensor_t *square_average_telda_epsilon = NULL;
-    tensor_t *parameter_update = NULL;
-    tensor_t *momentum_const_buffer = NULL;
     tensor_t *temp_gradient = NULL;
     tensor_t *momentum_constant = NULL;
     tensor_t *momentum_product = NULL;
     tensor_t *updated_momentum = NULL;
     tensor_t *modified_momentum = NULL;
     tensor_t *centered_grad = NULL;
-    tensor_t *alpha_average_grad = NULL;
     tensor_t *average_gradient_squared = NULL;
     tensor_t *average_gradient = NULL;
-    tensor_t *average_gradient_initial = NULL;
     tensor_t *updated_average_grad = NULL;
     tensor_t *weight_decay_sum = NULL;
-    tensor_t *initial_momentum = NULL;
     tensor_t *gradient = NULL;
     datatype_t datatype = parameters->buffer->storage->datatype;
     runtime_t runtime = parameters->buffer->storage->runtime;
     string_t key = string_create("%lu", parameters->id);
+    float64_t alpha;
 
     with_no_gradient(true);
 
@@ -1245,29 +1247,26 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
 
     if (map_contains(optimizer->square_average, key))
     {
-        error = map_get(optimizer->square_average, key, (void **) &square_average_initial);
+        error = map_get(optimizer->square_average, key, (void **) &square_average);
         if (error)
         {
             error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
             goto cleanup;
         }
 
-        error = tensor_multiplication(alpha_constant, square_average_initial, &alpha_product);
+        error = tensor_multiplication_inplace(square_average, alpha_constant);
         if (error)
         {
             error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
             goto cleanup;
         }
 
-        error = tensor_addition(alpha_product, one_minus_alpha_product, &square_average);
+        error = tensor_addition_inplace(square_average, one_minus_alpha_product);
         if (error)
         {
             error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
             goto cleanup;
         }
-
-        tensor_destroy(square_average_initial); 
-        square_average_initial = NULL;
     }
     else
     {
@@ -1277,13 +1276,13 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
             error = ERROR(ERROR_CREATE, string_create("failed create tensor."), error);
             goto cleanup;
         }
-    }
 
-    error = map_set(optimizer->square_average, key, square_average);
-    if (error)
-    {
-        error = ERROR(ERROR_SET, string_create("failed set map entry."), error);
-        goto cleanup;
+        error = optimizer_state_set(optimizer->square_average, key, square_average);
+        if (error)
+        {
+            error = ERROR(ERROR_SET, string_create("failed set map entry."), error);
+            goto cleanup;
+        }
     }
 
     if (optimizer->centered)
@@ -1297,29 +1296,26 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
 
         if (map_contains(optimizer->average_gradient, key))
         {
-            error = map_get(optimizer->average_gradient, key, (void **) &average_gradient_initial);
+            error = map_get(optimizer->average_gradient, key, (void **) &updated_average_grad);
             if (error)
             {
                 error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
                 goto cleanup;
             }
 
-            error = tensor_multiplication(average_gradient_initial, alpha_constant, &alpha_average_grad);
+            error = tensor_multiplication_inplace(updated_average_grad, alpha_constant);
             if (error)
             {
                 error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
                 goto cleanup;
             }
 
-            error = tensor_addition(alpha_average_grad, centered_grad, &updated_average_grad);
+            error = tensor_addition_inplace(updated_average_grad, centered_grad);
             if (error)
             {
                 error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
                 goto cleanup;
             }
-
-            tensor_destroy(average_gradient_initial);
-            average_gradient_initial = NULL;
         }
         else
         {
@@ -1329,13 +1325,13 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
                 error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
                 goto cleanup;
             }
-        }
 
-        error = map_set(optimizer->average_gradient, key, updated_average_grad);
-        if (error)
-        {
-            error = ERROR(ERROR_SET, string_create("failed to set tensor."), error);
-            goto cleanup;
+            error = optimizer_state_set(optimizer->average_gradient, key, updated_average_grad);
+            if (error)
+            {
+                error = ERROR(ERROR_SET, string_create("failed to set tensor."), error);
+                goto cleanup;
+            }
         }
 
         error = tensor_multiplication(updated_average_grad, updated_average_grad, &average_gradient_squared);
@@ -1390,12 +1386,7 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
         goto cleanup;
     }
 
-    error = tensor_constant(optimizer->learning_rate, datatype, runtime, false, false, &learning_rate);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
+    optimizer_alpha(-optimizer_scalar(optimizer->learning_rate, optimizer->datatype), datatype, &alpha);
 
     if (!is_zero(optimizer->momentum, optimizer->datatype))
     {
@@ -1408,36 +1399,26 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
                 goto cleanup;
             }
 
-            error = map_get(optimizer->momentum_buffer, key, (void **) &initial_momentum);
+            error = map_get(optimizer->momentum_buffer, key, (void **) &updated_momentum);
             if (error)
             {
                 error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
                 goto cleanup;
             }
 
-            error = tensor_multiplication(momentum_constant, initial_momentum, &momentum_const_buffer);
+            error = tensor_multiplication_inplace(updated_momentum, momentum_constant);
             if (error)
             {
                 error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
                 goto cleanup;
             }
 
-            error = tensor_addition(momentum_const_buffer, temp_gradient, &updated_momentum);
+            error = tensor_addition_inplace(updated_momentum, temp_gradient);
             if (error)
             {
                 error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
                 goto cleanup;
             }
-
-            tensor_destroy(initial_momentum);
-            initial_momentum = NULL;
-
-            error = map_set(optimizer->momentum_buffer, key, updated_momentum);
-            if (error)
-            {
-                error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
-                goto cleanup;
-            }
         }
         else
         {
@@ -1448,31 +1429,20 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
                 goto cleanup;
             }
 
-            error = map_set(optimizer->momentum_buffer, key, updated_momentum);
+            error = optimizer_state_set(optimizer->momentum_buffer, key, updated_momentum);
             if (error)
             {
                 error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
+                goto cleanup;
             }
         }
 
-        error = tensor_multiplication(learning_rate, updated_momentum, &parameter_update);
-        if (error)
-        {
-            error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-            goto cleanup;
-        }
+        error = tensor_scaled_add_inplace(parameters, updated_momentum, &alpha);
     }
     else
     {
-        error = tensor_multiplication(learning_rate, temp_gradient, &parameter_update);
-        if (error)
-        {
-            error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-            goto cleanup;
-        }
+        error = tensor_scaled_add_inplace(parameters, temp_gradient, &alpha);
     }
-
-    error = tensor_subtraction(parameters, parameter_update, &parameters);
     if (error)
     {
         error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
@@ -1483,14 +1453,11 @@ nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters)
 
 cleanup:
     string_destroy(key);
-    tensor_destroy(learning_rate);
     tensor_destroy(weight_decay);
     tensor_destroy(weight_decay_product);
     tensor_destroy(alpha_constant);
-    tensor_destroy(alpha_product);
     tensor_destroy(one_minus_alpha_constant);
     tensor_destroy(squared_current_gradient);
-    tensor_destroy(square_average_initial);
     tensor_destroy(one_minus_alpha_product);
     tensor_destroy(square_average_telda);
     tensor_destroy(temp_optimizer_square_average);
@@ -1498,19 +1465,14 @@ cleanup:
     tensor_destroy(square_average_telda_root);
     tensor_destroy(epsilon_constant);
     tensor_destroy(square_average_telda_epsilon);
-    tensor_destroy(parameter_update);
-    tensor_destroy(momentum_const_buffer);
     tensor_destroy(temp_gradient);
     tensor_destroy(momentum_constant);
     tensor_destroy(momentum_product);
     tensor_destroy(modified_momentum);
     tensor_destroy(centered_grad);
-    tensor_destroy(alpha_average_grad);
     tensor_destroy(average_gradient_squared);
     tensor_destroy(average_gradient);
-    tensor_destroy(average_gradient_initial);
     tensor_destroy(weight_decay_sum);
-    tensor_destroy(initial_momentum);
     tensor_destroy(gradient);
     return error;
 }
@@ -1535,13 +1497,9 @@ nw_error_t *adam(adam_t *optimizer, tensor_t *parameters)
     tensor_t *beta_2_constant_squared = NULL;
     tensor_t *first_moment = NULL;
     tensor_t *first_moment_part_0 = NULL;
-    tensor_t *first_moment_part_1 = NULL;
-    tensor_t *first_moment_part_2 = NULL;
     tensor_t *gradient_squared = NULL;
     tensor_t *second_moment = NULL;
     tensor_t *second_moment_part_0 = NULL;
-    tensor_t *second_moment_part_1 = NULL;
-    tensor_t *second_moment_part_2 = NULL;
     tensor_t *first_momentum_telda = NULL;
     tensor_t *second_momentum_telda = NULL;
     tensor_t *epsilon_constant = NULL;
@@ -1675,29 +1633,26 @@ nw_error_t *adam(adam_t *optimizer, tensor_t *parameters)
 
     if (map_contains(optimizer->first_moment, key))
     {
-        error = map_get(optimizer->first_moment, key, (void **) &first_moment_part_1);
+        error = map_get(optimizer->first_moment, key, (void **) &first_moment);
         if (error)
         {
             error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
             goto cleanup;
         }
 
-        error = tensor_multiplication(first_moment_part_1, beta_1_constant, &first_moment_part_2);
+        error = tensor_multiplication_inplace(first_moment, beta_1_constant);
         if (error)
         {
             error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
             goto cleanup;
         }
 
-        error = tensor_addition(first_moment_part_0, first_moment_part_2, &first_moment);
+        error = tensor_addition_inplace(first_moment, first_moment_part_0);
         if (error)
         {
             error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
             goto cleanup;
         }
-
-        tensor_destroy(first_moment_part_1);
-        first_moment_part_1 = NULL;
     }
     else
     {
@@ -1707,13 +1662,13 @@ nw_error_t *adam(adam_t *optimizer, tensor_t *parameters)
             error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
             goto cleanup;
         }
-    }
 
-    error = map_set(optimizer->first_moment, key, first_moment);
-    if (error)
-    {
-        error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
-        goto cleanup;
+        error = optimizer_state_set(optimizer->first_moment, key, first_moment);
+        if (error)
+        {
+            error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
+            goto cleanup;
+        }
     }
 
     // second moment
@@ -1733,29 +1688,26 @@ nw_error_t *adam(adam_t *optimizer, tensor_t *parameters)
 
     if (map_contains(optimizer->second_moment, key))
     {
-        error = map_get(optimizer->second_moment, key, (void **) &second_moment_part_1);
+        error = map_get(optimizer->second_moment, key, (void **) &second_moment);
         if (error)
         {
             error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
             goto cleanup;
         }
 
-        error = tensor_multiplication(second_moment_part_1, beta_2_constant, &second_moment_part_2);
+        error = tensor_multiplication_inplace(second_moment, beta_2_constant);
         if (error)
         {
             error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
             goto cleanup;
         }
 
-        error = tensor_addition(second_moment_part_0, second_moment_part_2, &second_moment);
+        error = tensor_addition_inplace(second_moment, second_moment_part_0);
         if (error)
         {
             error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
             goto cleanup;
         }
-
-        tensor_destroy(second_moment_part_1);
-        second_moment_part_1 = NULL;
     }
     else
     {
@@ -1765,13 +1717,13 @@ nw_error_t *adam(adam_t *optimizer, tensor_t *parameters)
             error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
             goto cleanup;
         }
-    }
 
-    error = map_set(optimizer->second_moment, key, second_moment);
-    if (error)
-    {
-        error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
-        goto cleanup;
+        error = optimizer_state_set(optimizer->second_moment, key, second_moment);
+        if (error)
+        {
+            error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
+            goto cleanup;
+        }
     }
 
     //bias correction
@@ -1824,7 +1776,7 @@ nw_error_t *adam(adam_t *optimizer, tensor_t *parameters)
         goto cleanup;
     }
 
-    error = tensor_subtraction(parameters, parameter_update, &parameters);
+    error = tensor_subtraction_inplace(parameters, parameter_update);
     if (error)
     {
         error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
@@ -1848,12 +1800,8 @@ cleanup:
     tensor_destroy(beta_1_constant_squared);
     tensor_destroy(beta_2_constant_squared);
     tensor_destroy(first_moment_part_0);
-    tensor_destroy(first_moment_part_1);
-    tensor_destroy(first_moment_part_2);
     tensor_destroy(gradient_squared);
     tensor_destroy(second_moment_part_0);
-    tensor_destroy(second_moment_part_1);
-    tensor_destroy(second_moment_part_2);
     tensor_destroy(first_momentum_telda);
     tensor_destroy(second_momentum_telda);
     tensor_destroy(epsilon_constant);
@@ -1868,6 +1816,213 @@ cleanup:
     return error; 
 }
 
+/**
+ * @brief Stochastic gradient descent on the rows covered by a row sparse gradient.
+ *        Weight decay and momentum only apply to those rows, momentum buffers of the other rows are left as they are.
+ */
+nw_error_t *sparse_stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer, tensor_t *parameters)
+{
+    CHECK_NULL_ARGUMENT(optimizer, "optimizer");
+    CHECK_NULL_ARGUMENT(parameters, "parameters");
+    CHECK_NULL_ARGUMENT(parameters->gradient, "parameters->gradient");
+    CHECK_NULL_ARGUMENT(parameters->gradient_rows, "parameters->gradient_rows");
+
+    nw_error_t *error = NULL;
+    tensor_t *momentum_buffer = NULL;
+    bool_t initialize = false;
+    string_t key = string_create("%lu", parameters->id);
+
+    if (!is_zero(optimizer->momentum, optimizer->datatype))
+    {
+        if (!map_contains(optimizer->momentum_buffer, key))
+        {
+            error = tensor_zeroes_like(parameters, &momentum_buffer, false, true);
+            if (error)
+            {
+                error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+                goto cleanup;
+            }
+
+            error = map_set(optimizer->momentum_buffer, key, momentum_buffer);
+            if (error)
+            {
+                tensor_destroy(momentum_buffer);
+                error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
+                goto cleanup;
+            }
+            initialize = true;
+        }
+        else
+        {
+            error = map_get(optimizer->momentum_buffer, key, (void **) &momentum_buffer);
+            if (error)
+            {
+                error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
+                goto cleanup;
+            }
+        }
+    }
+
+    error = buffer_sparse_stochastic_gradient_descent(parameters->buffer, parameters->gradient_rows->buffer, parameters->gradient->buffer,
+                                                      (momentum_buffer) ? momentum_buffer->buffer : NULL,
+                                                      optimizer_scalar(optimizer->learning_rate, optimizer->datatype),
+                                                      optimizer_scalar(optimizer->momentum, optimizer->datatype),
+                                                      optimizer_scalar(optimizer->dampening, optimizer->datatype),
+                                                      optimizer_scalar(optimizer->weight_decay, optimizer->datatype),
+                                                      optimizer->nesterov, initialize);
+    if (error)
+    {
+        error = ERROR(ERROR_UPDATE, string_create("failed to update parameters."), error);
+        goto cleanup;
+    }
+
+cleanup:
+
+    string_destroy(key);
+
+    return error;
+}
+
+/**
+ * @brief Lazy Adam on the rows covered by a row sparse gradient.
+ *        Bias correction follows the step count of the parameters, while the moments of a row are decayed
+ *        for the steps it was skipped only when it is next updated, matching dense Adam with zero gradients.
+ *        Rows without a gradient are not moved and do not receive weight decay.
+ */
+nw_error_t *sparse_adam(adam_t *optimizer, tensor_t *parameters)
+{
+    CHECK_NULL_ARGUMENT(optimizer, "optimizer");
+    CHECK_NULL_ARGUMENT(parameters, "parameters");
+    CHECK_NULL_ARGUMENT(parameters->gradient, "parameters->gradient");
+    CHECK_NULL_ARGUMENT(parameters->gradient_rows, "parameters->gradient_rows");
+
+    nw_error_t *error = NULL;
+    tensor_t *first_moment = NULL;
+    tensor_t *second_moment = NULL;
+    tensor_t *row_iteration = NULL;
+    int64_t *iteration = NULL;
+    string_t key = string_create("%lu", parameters->id);
+
+    if (map_contains(optimizer->iteration, key))
+    {
+        error = map_get(optimizer->iteration, key, (void **) &iteration);
+        if (error)
+        {
+            error = ERROR(ERROR_GET, string_create("failed to get iteration."), error);
+            goto cleanup;
+        }
+        (*iteration)++;
+    }
+    else
+    {
+        iteration = (int64_t *) malloc(sizeof(int64_t));
+        if (!iteration)
+        {
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(int64_t)), error);
+            goto cleanup;
+        }
+        *iteration = 1;
+
+        error = map_set(optimizer->iteration, key, (void *) iteration);
+        if (error)
+        {
+            free(iteration);
+            error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
+            goto cleanup;
+        }
+    }
+
+    if (!map_contains(optimizer->row_iteration, key))
+    {
+        error = tensor_zeroes_like(parameters, &first_moment, false, true);
+        if (!error)
+        {
+            error = tensor_zeroes_like(parameters, &second_moment, false, true);
+        }
+        if (!error)
+        {
+            error = tensor_create_zeroes(&row_iteration, parameters->buffer->view.shape, 1, parameters->buffer->storage->runtime, INT64, false, true);
+        }
+        if (error)
+        {
+            tensor_destroy(first_moment);
+            tensor_destroy(second_moment);
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+
+        // Moments left by dense updates are replaced, dense and sparse updates of the same parameters are not mixed.
+        if (map_contains(optimizer->first_moment, key))
+        {
+            tensor_t *moment = NULL;
+            if (!map_get(optimizer->first_moment, key, (void **) &moment))
+            {
+                tensor_destroy(moment);
+            }
+        }
+
+        if (map_contains(optimizer->second_moment, key))
+        {
+            tensor_t *moment = NULL;
+            if (!map_get(optimizer->second_moment, key, (void **) &moment))
+            {
+                tensor_destroy(moment);
+            }
+        }
+
+        error = optimizer_state_set(optimizer->first_moment, key, first_moment);
+        if (!error)
+        {
+            error = optimizer_state_set(optimizer->second_moment, key, second_moment);
+        }
+        if (!error)
+        {
+            error = map_set(optimizer->row_iteration, key, row_iteration);
+        }
+        if (error)
+        {
+            error = ERROR(ERROR_SET, string_create("failed to set map entry."), error);
+            goto cleanup;
+        }
+    }
+    else
+    {
+        error = map_get(optimizer->first_moment, key, (void **) &first_moment);
+        if (!error)
+        {
+            error = map_get(optimizer->second_moment, key, (void **) &second_moment);
+        }
+        if (!error)
+        {
+            error = map_get(optimizer->row_iteration, key, (void **) &row_iteration);
+        }
+        if (error)
+        {
+            error = ERROR(ERROR_GET, string_create("failed to get tensor."), error);
+            goto cleanup;
+        }
+    }
+
+    error = buffer_sparse_adam(parameters->buffer, parameters->gradient_rows->buffer, parameters->gradient->buffer,
+                               first_moment->buffer, second_moment->buffer, row_iteration->buffer, *iteration,
+                               optimizer_scalar(optimizer->learning_rate, optimizer->datatype),
+                               optimizer_scalar(optimizer->beta_1, optimizer->datatype),
+                               optimizer_scalar(optimizer->beta_2, optimizer->datatype),
+                               optimizer_scalar(optimizer->weight_decay, optimizer->datatype),
+                               optimizer_scalar(optimizer->epsilon, optimizer->datatype));
+    if (error)
+    {
+        error = ERROR(ERROR_UPDATE, string_create("failed to update parameters."), error);
+        goto cleanup;
+    }
+
+cleanup:
+
+    string_destroy(key);
+
+    return error;
+}
+
 nw_error_t *clip_gradient_norm_model(model_t *model, void *threshold)
 {
     CHECK_NULL_ARGUMENT(model, "model");
@@ -2163,7 +2318,7 @@ nw_error_t *clip_gradient_norm_parameters(tensor_t *parameters, void *threshold)
             goto cleanup;
         }
 
-        error = tensor_multiplication(parameters->gradient, scale, &parameters->gradient);
+        error = tensor_multiplication_inplace(parameters->gradient, scale);
         if (error)
         {
             error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
@@ -2181,11 +2336,11 @@ cleanup:
     return error;
 }
 
-nw_error_t *zero_gradient_model(model_t *model)
+nw_error_t *zero_gradient_model(model_t *model, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(model, "model");
 
-    nw_error_t *error = zero_gradient_block(model->block);
+    nw_error_t *error = zero_gradient_block(model->block, set_to_none);
     if (error)
     {
         return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
@@ -2194,7 +2349,7 @@ nw_error_t *zero_gradient_model(model_t *model)
     return error;
 }
 
-nw_error_t *zero_gradient_block(block_t *block)
+nw_error_t *zero_gradient_block(block_t *block, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(block, "block");
     CHECK_NULL_ARGUMENT(block->layers, "block->layers");
@@ -2219,26 +2374,26 @@ nw_error_t *zero_gradient_block(block_t *block)
         switch (transform_type)
         {
         case LINEAR:
-            error = zero_gradient_linear(transform->linear);
+            error = zero_gradient_linear(transform->linear, set_to_none);
             break;
         case CONVOLUTION_2D:
         case CONVOLUTION_TRANSPOSE_2D:
-            error = zero_gradient_convolution_2d(transform->convolution_2d);
+            error = zero_gradient_convolution_2d(transform->convolution_2d, set_to_none);
             break;
         case BATCH_NORMALIZATION_2D:
-            error = zero_gradient_batch_normalization_2d(transform->batch_normalization_2d);
+            error = zero_gradient_batch_normalization_2d(transform->batch_normalization_2d, set_to_none);
             break;
         case LAYER_NORMALIZATION:
-            error = zero_gradient_layer_normalization(transform->layer_normalization);
+            error = zero_gradient_layer_normalization(transform->layer_normalization, set_to_none);
             break;
         case EMBEDDING:
-            error = zero_gradient_embedding(transform->embedding);
+            error = zero_gradient_embedding(transform->embedding, set_to_none);
             break;
         case TRANSFORMER_EMBEDDING:
-            error = zero_gradient_transformer_embedding(transform->transformer_embedding);
+            error = zero_gradient_transformer_embedding(transform->transformer_embedding, set_to_none);
             break;
         case CAUSAL_MULTIHEAD_SELF_ATTENTION:
-            error = zero_gradient_causal_multihead_self_attention(transform->causal_multihead_self_attention);
+            error = zero_gradient_causal_multihead_self_attention(transform->causal_multihead_self_attention, set_to_none);
             break;
         case MAX_POOLING_2D:
         case AVERAGE_POOLING_2D:
@@ -2248,7 +2403,7 @@ nw_error_t *zero_gradient_block(block_t *block)
             continue;
         case BLOCK:
         case RESIDUAL_BLOCK:
-            error = zero_gradient_block(transform->block);
+            error = zero_gradient_block(transform->block, set_to_none);
             if (error)
             {
                 return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient parameters."), error);
@@ -2261,82 +2416,175 @@ nw_error_t *zero_gradient_block(block_t *block)
     return error;
 }
 
-nw_error_t *zero_gradient_linear(linear_t *linear)
+nw_error_t *zero_gradient_linear(linear_t *linear, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(linear, "linear");
 
-    zero_gradient_parameters(linear->weights);
-    zero_gradient_parameters(linear->bias);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_parameters(linear->weights, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(linear->bias, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-nw_error_t *zero_gradient_convolution_2d(convolution_2d_t *convolution_2d)
+nw_error_t *zero_gradient_convolution_2d(convolution_2d_t *convolution_2d, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(convolution_2d, "convolution_2d");
 
-    zero_gradient_parameters(convolution_2d->kernel);
-    zero_gradient_parameters(convolution_2d->bias);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_parameters(convolution_2d->kernel, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(convolution_2d->bias, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-nw_error_t *zero_gradient_batch_normalization_2d(batch_normalization_2d_t *batch_normalization_2d)
+nw_error_t *zero_gradient_batch_normalization_2d(batch_normalization_2d_t *batch_normalization_2d, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(batch_normalization_2d, "batch_normalization_2d");
 
-    zero_gradient_parameters(batch_normalization_2d->weights);
-    zero_gradient_parameters(batch_normalization_2d->bias);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_parameters(batch_normalization_2d->weights, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(batch_normalization_2d->bias, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-nw_error_t *zero_gradient_layer_normalization(layer_normalization_t *layer_normalization)
+nw_error_t *zero_gradient_layer_normalization(layer_normalization_t *layer_normalization, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(layer_normalization, "layer_normalization");
 
-    zero_gradient_parameters(layer_normalization->weights);
-    zero_gradient_parameters(layer_normalization->bias);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_parameters(layer_normalization->weights, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(layer_normalization->bias, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-nw_error_t *zero_gradient_embedding(embedding_t *embedding)
+nw_error_t *zero_gradient_embedding(embedding_t *embedding, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(embedding, "embedding");
 
-    zero_gradient_parameters(embedding->weights);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_parameters(embedding->weights, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-nw_error_t *zero_gradient_transformer_embedding(transformer_embedding_t *transformer_embedding)
+nw_error_t *zero_gradient_transformer_embedding(transformer_embedding_t *transformer_embedding, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(transformer_embedding, "transformer_embedding");
 
-    zero_gradient_embedding(transformer_embedding->position_embedding);
-    zero_gradient_embedding(transformer_embedding->token_embedding);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_embedding(transformer_embedding->position_embedding, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_embedding(transformer_embedding->token_embedding, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-nw_error_t *zero_gradient_causal_multihead_self_attention(causal_multihead_self_attention_t *causal_multihead_self_attention)
+nw_error_t *zero_gradient_causal_multihead_self_attention(causal_multihead_self_attention_t *causal_multihead_self_attention, bool_t set_to_none)
 {
     CHECK_NULL_ARGUMENT(causal_multihead_self_attention, "causal_multihead_self_attention");
 
-    zero_gradient_parameters(causal_multihead_self_attention->input_weights);
-    zero_gradient_parameters(causal_multihead_self_attention->input_bias);
-    zero_gradient_parameters(causal_multihead_self_attention->output_weights);
-    zero_gradient_parameters(causal_multihead_self_attention->output_bias);
+    nw_error_t *error = NULL;
+
+    error = zero_gradient_parameters(causal_multihead_self_attention->input_weights, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(causal_multihead_self_attention->input_bias, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(causal_multihead_self_attention->output_weights, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    error = zero_gradient_parameters(causal_multihead_self_attention->output_bias, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
 
     return NULL;
 }
 
-void zero_gradient_parameters(tensor_t *parameters)
+/**
+ * @brief Reset the gradient of `parameters` before the next backward pass.
+ * @param set_to_none Release the gradient instead of keeping its buffer for in place accumulation.
+ */
+nw_error_t *zero_gradient_parameters(tensor_t *parameters, bool_t set_to_none)
 {
-    if (parameters)
+    if (!parameters)
     {
-        tensor_destroy(parameters->gradient);
-        parameters->gradient = NULL;
+        return NULL;
     }
-}
\ No newline at end of file
+
+    nw_error_t *error = tensor_zero_gradient(parameters, set_to_none);
+    if (error)
+    {
+        return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+    }
+
+    return error;
+}
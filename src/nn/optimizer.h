@@ -45,6 +45,7 @@ typedef struct adam_t
     map_t *first_moment;
     map_t *second_moment;
     map_t *iteration;
+    map_t *row_iteration;
 } adam_t;
 
 typedef enum algorithm_type_t
@@ -114,6 +115,8 @@ nw_error_t *update_parameters(optimizer_t *optimizer, tensor_t *parameters);
 nw_error_t *stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer, tensor_t *parameters);
 nw_error_t *rms_prop(rms_prop_t *optimizer, tensor_t *parameters);
 nw_error_t *adam(adam_t *optimizer, tensor_t *parameters);
+nw_error_t *sparse_stochastic_gradient_descent(stochastic_gradient_descent_t *optimizer, tensor_t *parameters);
+nw_error_t *sparse_adam(adam_t *optimizer, tensor_t *parameters);
 
 // Clip Gradient
 nw_error_t *clip_gradient_norm_model(model_t *model, void *threshold);
@@ -128,14 +131,14 @@ nw_error_t *clip_gradient_norm_causal_multihead_self_attention(causal_multihead_
 nw_error_t *clip_gradient_norm_parameters(tensor_t *parameters, void *threshold);
 
 // Zero Gradient
-nw_error_t *zero_gradient_model(model_t *model);
-nw_error_t *zero_gradient_block(block_t *block);
-nw_error_t *zero_gradient_linear(linear_t *linear);
-nw_error_t *zero_gradient_convolution_2d(convolution_2d_t *convolution_2d);
-nw_error_t *zero_gradient_batch_normalization_2d(batch_normalization_2d_t *batch_normalization_2d);
-nw_error_t *zero_gradient_layer_normalization(layer_normalization_t *layer_normalization);
-nw_error_t *zero_gradient_embedding(embedding_t *embedding);
-nw_error_t *zero_gradient_transformer_embedding(transformer_embedding_t *transformer_embedding);
-nw_error_t *zero_gradient_causal_multihead_self_attention(causal_multihead_self_attention_t *causal_multihead_self_attention);
-void zero_gradient_parameters(tensor_t *parameters);
+nw_error_t *zero_gradient_model(model_t *model, bool_t set_to_none);
+nw_error_t *zero_gradient_block(block_t *block, bool_t set_to_none);
+nw_error_t *zero_gradient_linear(linear_t *linear, bool_t set_to_none);
+nw_error_t *zero_gradient_convolution_2d(convolution_2d_t *convolution_2d, bool_t set_to_none);
+nw_error_t *zero_gradient_batch_normalization_2d(batch_normalization_2d_t *batch_normalization_2d, bool_t set_to_none);
+nw_error_t *zero_gradient_layer_normalization(layer_normalization_t *layer_normalization, bool_t set_to_none);
+nw_error_t *zero_gradient_embedding(embedding_t *embedding, bool_t set_to_none);
+nw_error_t *zero_gradient_transformer_embedding(transformer_embedding_t *transformer_embedding, bool_t set_to_none);
+nw_error_t *zero_gradient_causal_multihead_self_attention(causal_multihead_self_attention_t *causal_multihead_self_attention, bool_t set_to_none);
+nw_error_t *zero_gradient_parameters(tensor_t *parameters, bool_t set_to_none);
 #endif
\ No newline at end of file
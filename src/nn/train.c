@@ -77,16 +77,21 @@ nw_error_t *fit(int64_t epochs,
         LOG_NEWLINE;
         for (int64_t j = 0; j < train_iterations; ++j)
         {
-            error = zero_gradient_model(model);
+            // Temporaries of a step come from the step arena, what outlives the step is left behind in a retired arena.
+            runtime_arena_begin();
+
+            error = zero_gradient_model(model, false);
             if (error)
             {
-                return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+                error = ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+                goto cleanup;
             }
 
             error = (*dataloader)(indicies[j] * batch->batch_size, batch, arguments);
             if (error)
             {
-                return ERROR(ERROR_LOAD, string_create("failed to load batch."), error);
+                error = ERROR(ERROR_LOAD, string_create("failed to load batch."), error);
+                goto cleanup;
             }
 
             if (!i && !j)
@@ -97,13 +102,15 @@ nw_error_t *fit(int64_t epochs,
             error = model_forward(model, batch->x, &y_pred);
             if (error)
             {
-                return ERROR(ERROR_FORWARD, string_create("failed model forward pass."), error);
+                error = ERROR(ERROR_FORWARD, string_create("failed model forward pass."), error);
+                goto cleanup;
             }
 
             error = (*criterion)(batch->y, y_pred, &cost);
             if (error)
             {
-                return ERROR(ERROR_CRITERION, string_create("failed model forward pass."), error);
+                error = ERROR(ERROR_CRITERION, string_create("failed model forward pass."), error);
+                goto cleanup;
             }
 
             // if (!((j + 1) % 10))
@@ -122,7 +129,8 @@ nw_error_t *fit(int64_t epochs,
             error = (*metrics)(TRAIN, batch->y, y_pred, cost, i + 1, epochs, j + 1, train_iterations);
             if (error)
             {
-                return ERROR(ERROR_METRICS, string_create("failed to compute metrics."), error);
+                error = ERROR(ERROR_METRICS, string_create("failed to compute metrics."), error);
+                goto cleanup;
             } 
             with_no_gradient(false);
 
@@ -131,20 +139,23 @@ nw_error_t *fit(int64_t epochs,
                 error = clip_gradient_norm_model(model, clip_gradient_norm);
                 if (error)
                 {
-                    return ERROR(ERROR_CLIP_GRADIENT, string_create("failed clip gradient."), error);
+                    error = ERROR(ERROR_CLIP_GRADIENT, string_create("failed clip gradient."), error);
+                    goto cleanup;
                 }
             }
 
             error = tensor_backward(cost, NULL);
             if (error)
             {
-                return ERROR(ERROR_BACKWARD, string_create("failed back propogation."), error);
+                error = ERROR(ERROR_BACKWARD, string_create("failed back propogation."), error);
+                goto cleanup;
             }
 
             error = update_model(optimizer, model);
             if (error)
             {
-                return ERROR(ERROR_STEP, string_create("failed to update weights."), error);
+                error = ERROR(ERROR_STEP, string_create("failed to update weights."), error);
+                goto cleanup;
             }
 
             tensor_destroy(batch->x);
@@ -153,6 +164,8 @@ nw_error_t *fit(int64_t epochs,
             batch->y = NULL;
             y_pred = NULL;
             cost = NULL;
+
+            runtime_arena_end();
         }
 
         if (generate)
@@ -264,6 +277,13 @@ nw_error_t *fit(int64_t epochs,
 
     with_no_gradient(false);
 
+    return error;
+
+cleanup:
+
+    // A failed training step still closes its arena scope.
+    runtime_arena_end();
+
     return error;
 }
 
@@ -26,6 +26,10 @@ extern "C" {
 
 #define NW_CHUNK_SIZE 64
 
+#define NW_GELU_SCALE 0.7978845608028654
+
+#define NW_GELU_COEFFICIENT 0.044715
+
 // CUDA defns.
 static cublasHandle_t cublas_handle = NULL;
 static cusparseHandle_t cusparse_handle = NULL;
@@ -817,6 +821,322 @@ extern "C" void cu_sigmoid(datatype_t datatype, int64_t n, const void *x_data, i
     }
 }
 
+__global__ static void cu_tanh_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        y_data[i * y_stride] = tanhf(x_data[i * x_stride]);
+    }
+}
+
+__global__ static void cu_tanh_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        y_data[i * y_stride] = tanh(x_data[i * x_stride]);
+    }
+}
+
+extern "C" void cu_tanh(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    int block_size;
+    int grid_size;
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_tanh_float32<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float32_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float32_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    case FLOAT64:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_tanh_float64<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float64_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float64_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    default:
+        break;
+    }
+}
+
+__global__ static void cu_gelu_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        float32_t x = x_data[i * x_stride];
+        float32_t u = (float32_t) NW_GELU_SCALE * (x + (float32_t) NW_GELU_COEFFICIENT * x * x * x);
+        y_data[i * y_stride] = (float32_t) 0.5 * x * ((float32_t) 1.0 + tanhf(u));
+    }
+}
+
+__global__ static void cu_gelu_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        float64_t x = x_data[i * x_stride];
+        float64_t u = (float64_t) NW_GELU_SCALE * (x + (float64_t) NW_GELU_COEFFICIENT * x * x * x);
+        y_data[i * y_stride] = (float64_t) 0.5 * x * ((float64_t) 1.0 + tanh(u));
+    }
+}
+
+extern "C" void cu_gelu(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    int block_size;
+    int grid_size;
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_gelu_float32<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float32_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float32_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    case FLOAT64:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_gelu_float64<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float64_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float64_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    default:
+        break;
+    }
+}
+
+__global__ static void cu_tanh_gradient_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        float32_t y = x_data[i * x_stride];
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float32_t) 1.0 - y * y);
+    }
+}
+
+__global__ static void cu_tanh_gradient_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        float64_t y = x_data[i * x_stride];
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float64_t) 1.0 - y * y);
+    }
+}
+
+extern "C" void cu_tanh_gradient(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+{
+    int block_size;
+    int grid_size;
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_tanh_gradient_float32<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float32_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float32_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride,
+                        &((float32_t *) z_data)[z_offset + (i * z_stride)],
+                        (int) z_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    case FLOAT64:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_tanh_gradient_float64<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float64_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float64_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride,
+                        &((float64_t *) z_data)[z_offset + (i * z_stride)],
+                        (int) z_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    default:
+        break;
+    }
+}
+
+__global__ static void cu_gelu_gradient_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        float32_t x = x_data[i * x_stride];
+        float32_t t = tanhf((float32_t) NW_GELU_SCALE * (x + (float32_t) NW_GELU_COEFFICIENT * x * x * x));
+        float32_t du = (float32_t) NW_GELU_SCALE * ((float32_t) 1.0 + (float32_t) 3.0 * (float32_t) NW_GELU_COEFFICIENT * x * x);
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float32_t) 0.5 * ((float32_t) 1.0 + t) + (float32_t) 0.5 * x * ((float32_t) 1.0 - t * t) * du);
+    }
+}
+
+__global__ static void cu_gelu_gradient_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
+{
+    int i = (blockDim.x * blockIdx.x) + threadIdx.x;
+    if (i < n)
+    {
+        float64_t x = x_data[i * x_stride];
+        float64_t t = tanh((float64_t) NW_GELU_SCALE * (x + (float64_t) NW_GELU_COEFFICIENT * x * x * x));
+        float64_t du = (float64_t) NW_GELU_SCALE * ((float64_t) 1.0 + (float64_t) 3.0 * (float64_t) NW_GELU_COEFFICIENT * x * x);
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float64_t) 0.5 * ((float64_t) 1.0 + t) + (float64_t) 0.5 * x * ((float64_t) 1.0 - t * t) * du);
+    }
+}
+
+extern "C" void cu_gelu_gradient(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+{
+    int block_size;
+    int grid_size;
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_gelu_gradient_float32<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float32_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float32_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride,
+                        &((float32_t *) z_data)[z_offset + (i * z_stride)],
+                        (int) z_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    case FLOAT64:
+        block_size = NW_WARP_SIZE * 24;
+
+        grid_size = (MIN(NW_CHUNK_SIZE, n) + block_size - 1) / block_size;
+
+        for (int i = 0, j = 0; i < n; i += NW_CHUNK_SIZE, ++j)
+        {
+            cu_gelu_gradient_float64<<<grid_size,
+                    block_size,
+                    0,
+                    cuda_stream[j % NW_NUM_STREAMS]>>>(
+                        MIN(NW_CHUNK_SIZE, (int) n - i),
+                        &((float64_t *) x_data)[x_offset + (i * x_stride)],
+                        (int) x_stride,
+                        &((float64_t *) y_data)[y_offset + (i * y_stride)],
+                        (int) y_stride,
+                        &((float64_t *) z_data)[z_offset + (i * z_stride)],
+                        (int) z_stride);
+        }
+
+#if SYNCHRONOUS
+        cudaDeviceSynchronize();
+#endif
+        break;
+    default:
+        break;
+    }
+}
+
 extern "C" static void cu_addition_float32(int n,
                                            const float32_t *x_data,
                                            int x_stride,
@@ -955,6 +1275,33 @@ extern "C" void cu_subtraction(datatype_t datatype,
     }
 }
 
+extern "C" void cu_scaled_addition(datatype_t datatype,
+                                   int64_t n,
+                                   const void *alpha,
+                                   const void *x_data,
+                                   int64_t x_stride,
+                                   int64_t x_offset,
+                                   void *y_data,
+                                   int64_t y_stride,
+                                   int64_t y_offset)
+{
+    cudaDeviceSynchronize();
+    switch (datatype)
+    {
+    case FLOAT32:
+        magma_saxpy((magma_int_t) n, *(float32_t *) alpha, (magmaFloat_const_ptr) &((float32_t *) x_data)[x_offset], (magma_int_t) x_stride,
+                    (magmaFloat_ptr) &((float32_t *) y_data)[y_offset], (magma_int_t) y_stride, m_queue[0]);
+        break;
+    case FLOAT64:
+        magma_daxpy((magma_int_t) n, *(float64_t *) alpha, (magmaDouble_const_ptr) &((float64_t *) x_data)[x_offset], (magma_int_t) x_stride,
+                    (magmaDouble_ptr) &((float64_t *) y_data)[y_offset], (magma_int_t) y_stride, m_queue[0]);
+        break;
+    default:
+        break;
+    }
+    magma_queue_sync(m_queue[0]);
+}
+
 __global__ static void cu_multiplication_float32(int n,
                                                  const float32_t *x_data,
                                                  int x_stride,
@@ -1380,17 +1727,21 @@ extern "C" void cu_matrix_multiplication_float32(datatype_t datatype,
                                                  bool_t x_transpose,
                                                  bool_t y_transpose,
                                                  const float32_t *x_data,
+                                                 int64_t x_leading_dimension,
                                                  const float32_t *y_data,
-                                                 float32_t *z_data)
+                                                 int64_t y_leading_dimension,
+                                                 float32_t *z_data,
+                                                 int64_t z_leading_dimension)
 {
     float alpha = 1.0;
     float beta = 0.0;
     cudaDeviceSynchronize();
-    magma_sgemm(x_transpose ? MagmaTrans : MagmaNoTrans,
-            y_transpose ? MagmaTrans : MagmaNoTrans,
+    // Row major z = x * y is column major z^T = y^T * x^T, so the operands and their transpose flags swap.
+    magma_sgemm(y_transpose ? MagmaTrans : MagmaNoTrans,
+            x_transpose ? MagmaTrans : MagmaNoTrans,
             n, m, k, alpha, (magmaFloat_const_ptr) y_data,
-            n, (magmaFloat_const_ptr) x_data, k, beta,
-            (magmaFloat_ptr) z_data, n, m_queue[0]);
+            y_leading_dimension, (magmaFloat_const_ptr) x_data, x_leading_dimension, beta,
+            (magmaFloat_ptr) z_data, z_leading_dimension, m_queue[0]);
     magma_queue_sync(m_queue[0]);
 }
 
@@ -1401,17 +1752,20 @@ extern "C" void cu_matrix_multiplication_float64(datatype_t datatype,
                                                  bool_t x_transpose,
                                                  bool_t y_transpose,
                                                  const float64_t *x_data,
+                                                 int64_t x_leading_dimension,
                                                  const float64_t *y_data,
-                                                 float64_t *z_data)
+                                                 int64_t y_leading_dimension,
+                                                 float64_t *z_data,
+                                                 int64_t z_leading_dimension)
 {
     double alpha = 1.0;
     double beta = 0.0;
     cudaDeviceSynchronize();
-    magma_dgemm(x_transpose ? MagmaTrans : MagmaNoTrans,
-            y_transpose ? MagmaTrans : MagmaNoTrans,
+    magma_dgemm(y_transpose ? MagmaTrans : MagmaNoTrans,
+            x_transpose ? MagmaTrans : MagmaNoTrans,
             n, m, k, alpha, (magmaDouble_const_ptr) y_data,
-            n, (magmaDouble_const_ptr) x_data, k, beta,
-            (magmaDouble_ptr) z_data, n, m_queue[0]);
+            y_leading_dimension, (magmaDouble_const_ptr) x_data, x_leading_dimension, beta,
+            (magmaDouble_ptr) z_data, z_leading_dimension, m_queue[0]);
     magma_queue_sync(m_queue[0]);
 }
 
@@ -1423,10 +1777,13 @@ extern "C" void cu_matrix_multiplication(datatype_t datatype,
                                          bool_t y_transpose,
                                          const void *x_data,
                                          int64_t x_offset,
+                                         int64_t x_leading_dimension,
                                          const void *y_data,
                                          int64_t y_offset,
+                                         int64_t y_leading_dimension,
                                          void *z_data,
-                                         int64_t z_offset)
+                                         int64_t z_offset,
+                                         int64_t z_leading_dimension)
 {
     switch (datatype)
     {
@@ -1438,8 +1795,11 @@ extern "C" void cu_matrix_multiplication(datatype_t datatype,
                                          x_transpose,
                                          y_transpose,
                                          &((float32_t *) x_data)[x_offset],
+                                         x_leading_dimension,
                                          &((float32_t *) y_data)[y_offset],
-                                         &((float32_t *) z_data)[z_offset]);
+                                         y_leading_dimension,
+                                         &((float32_t *) z_data)[z_offset],
+                                         z_leading_dimension);
         break;
     case FLOAT64:
         cu_matrix_multiplication_float64(datatype,
@@ -1449,8 +1809,11 @@ extern "C" void cu_matrix_multiplication(datatype_t datatype,
                                          x_transpose,
                                          y_transpose,
                                          &((float64_t *) x_data)[x_offset],
+                                         x_leading_dimension,
                                          &((float64_t *) y_data)[y_offset],
-                                         &((float64_t *) z_data)[z_offset]);
+                                         y_leading_dimension,
+                                         &((float64_t *) z_data)[z_offset],
+                                         z_leading_dimension);
         break;
     default:
         break;
@@ -10,6 +10,13 @@
 
 #define EPSILON 1e-7
 
+// Alignment of runtime memory, one cache line and a full AVX-512 vector.
+#define NW_MEMORY_ALIGNMENT 64
+
+// Constants of the tanh approximation of GELU, sqrt(2 / pi) and the cubic coefficient.
+#define NW_GELU_SCALE 0.7978845608028654
+#define NW_GELU_COEFFICIENT 0.044715
+
 #ifndef NW_NUM_THREADS
 #define NW_NUM_THREADS 4
 #endif
@@ -25,7 +32,8 @@ nw_error_t *mkl_memory_allocate(void **pp, size_t size)
 {
     CHECK_NULL_ARGUMENT(pp, "pp");
 
-    *pp = malloc(size);
+    // Cache line alignment, aligned_alloc also requires the size to be a multiple of it.
+    *pp = aligned_alloc(NW_MEMORY_ALIGNMENT, (size + NW_MEMORY_ALIGNMENT - 1) / NW_MEMORY_ALIGNMENT * NW_MEMORY_ALIGNMENT);
     if (!*pp)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
@@ -243,6 +251,150 @@ void mkl_sigmoid(datatype_t datatype, int64_t n, const void *x_data, int64_t x_s
     }
 }
 
+static void mkl_tanh_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        y_data[i * y_stride] = tanhf(x_data[i * x_stride]);
+    }
+}
+
+static void mkl_tanh_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        y_data[i * y_stride] = tanh(x_data[i * x_stride]);
+    }
+}
+
+void mkl_tanh(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        mkl_tanh_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    case FLOAT64:
+        mkl_tanh_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    default:
+        break;
+    }
+}
+
+static void mkl_gelu_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        float32_t x = x_data[i * x_stride];
+        float32_t u = (float32_t) NW_GELU_SCALE * (x + (float32_t) NW_GELU_COEFFICIENT * x * x * x);
+        y_data[i * y_stride] = (float32_t) 0.5 * x * ((float32_t) 1.0 + tanhf(u));
+    }
+}
+
+static void mkl_gelu_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        float64_t x = x_data[i * x_stride];
+        float64_t u = (float64_t) NW_GELU_SCALE * (x + (float64_t) NW_GELU_COEFFICIENT * x * x * x);
+        y_data[i * y_stride] = (float64_t) 0.5 * x * ((float64_t) 1.0 + tanh(u));
+    }
+}
+
+void mkl_gelu(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        mkl_gelu_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    case FLOAT64:
+        mkl_gelu_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    default:
+        break;
+    }
+}
+
+static void mkl_tanh_gradient_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        float32_t y = x_data[i * x_stride];
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float32_t) 1.0 - y * y);
+    }
+}
+
+static void mkl_tanh_gradient_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        float64_t y = x_data[i * x_stride];
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float64_t) 1.0 - y * y);
+    }
+}
+
+void mkl_tanh_gradient(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        mkl_tanh_gradient_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride, &((float32_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    case FLOAT64:
+        mkl_tanh_gradient_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride, &((float64_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    default:
+        break;
+    }
+}
+
+static void mkl_gelu_gradient_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        float32_t x = x_data[i * x_stride];
+        float32_t t = tanhf((float32_t) NW_GELU_SCALE * (x + (float32_t) NW_GELU_COEFFICIENT * x * x * x));
+        float32_t du = (float32_t) NW_GELU_SCALE * ((float32_t) 1.0 + (float32_t) 3.0 * (float32_t) NW_GELU_COEFFICIENT * x * x);
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float32_t) 0.5 * ((float32_t) 1.0 + t) + (float32_t) 0.5 * x * ((float32_t) 1.0 - t * t) * du);
+    }
+}
+
+static void mkl_gelu_gradient_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
+{
+    #pragma omp simd
+    for (int i = 0; i < n; ++i)
+    {
+        float64_t x = x_data[i * x_stride];
+        float64_t t = tanh((float64_t) NW_GELU_SCALE * (x + (float64_t) NW_GELU_COEFFICIENT * x * x * x));
+        float64_t du = (float64_t) NW_GELU_SCALE * ((float64_t) 1.0 + (float64_t) 3.0 * (float64_t) NW_GELU_COEFFICIENT * x * x);
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float64_t) 0.5 * ((float64_t) 1.0 + t) + (float64_t) 0.5 * x * ((float64_t) 1.0 - t * t) * du);
+    }
+}
+
+void mkl_gelu_gradient(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        mkl_gelu_gradient_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride, &((float32_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    case FLOAT64:
+        mkl_gelu_gradient_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride, &((float64_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    default:
+        break;
+    }
+}
+
 void mkl_addition(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
 {
     switch (datatype)
@@ -273,6 +425,21 @@ void mkl_subtraction(datatype_t datatype, int64_t n, const void *x_data, int64_t
     }
 }
 
+void mkl_scaled_addition(datatype_t datatype, int64_t n, const void *alpha, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        cblas_saxpy((int) n, *(float32_t *) alpha, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    case FLOAT64:
+        cblas_daxpy((int) n, *(float64_t *) alpha, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    default:
+        break;
+    }
+}
+
 void mkl_multiplication(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
 {
     switch (datatype)
@@ -388,23 +555,88 @@ void mkl_compare_greater(datatype_t datatype, int64_t n, const void *x_data, int
     }
 }
 
-void mkl_matrix_multiplication(datatype_t datatype, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose, const void *x_data, int64_t x_offset, const void *y_data, int64_t y_offset, void *z_data, int64_t z_offset)
+void mkl_matrix_multiplication(datatype_t datatype, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose, 
+                              const void *x_data, int64_t x_offset, int64_t x_leading_dimension,
+                              const void *y_data, int64_t y_offset, int64_t y_leading_dimension,
+                              void *z_data, int64_t z_offset, int64_t z_leading_dimension)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        cblas_sgemm(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (MKL_INT) m, (MKL_INT) n, (MKL_INT) k, 1.0,
+                    &((float32_t *) x_data)[x_offset], (MKL_INT) x_leading_dimension, &((float32_t *) y_data)[y_offset], (MKL_INT) y_leading_dimension, 
+                    0.0, &((float32_t *) z_data)[z_offset], (MKL_INT) z_leading_dimension);
+        break;
+    case FLOAT64:
+        cblas_dgemm(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (MKL_INT) m, (MKL_INT) n, (MKL_INT) k, 1.0, 
+                    &((float64_t *) x_data)[x_offset], (MKL_INT) x_leading_dimension, &((float64_t *) y_data)[y_offset], (MKL_INT) y_leading_dimension, 
+                    0.0, &((float64_t *) z_data)[z_offset], (MKL_INT) z_leading_dimension);
+        break;
+    case BFLOAT16:
+        // Reduced precision operands accumulate into a float32 result.
+        cblas_gemm_bf16bf16f32(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (MKL_INT) m, (MKL_INT) n, (MKL_INT) k, 1.0,
+                               &((const MKL_BF16 *) x_data)[x_offset], (MKL_INT) x_leading_dimension, &((const MKL_BF16 *) y_data)[y_offset], (MKL_INT) y_leading_dimension, 
+                               0.0, &((float32_t *) z_data)[z_offset], (MKL_INT) z_leading_dimension);
+        break;
+    default:
+        break;
+    }
+}
+
+void mkl_batched_matrix_multiplication(datatype_t datatype, int64_t batch_size, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose,
+                                       const void *x_data, int64_t x_offset, int64_t x_leading_dimension, int64_t x_batch_stride,
+                                       const void *y_data, int64_t y_offset, int64_t y_leading_dimension, int64_t y_batch_stride,
+                                       void *z_data, int64_t z_offset, int64_t z_leading_dimension, int64_t z_batch_stride)
 {
     switch (datatype)
     {
     case FLOAT32:
-        cblas_sgemm(CblasRowMajor, (x_transpose) ? CblasTrans: CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (int) m, (int) n, (int) k, 1.0,
-                    &((float32_t *) x_data)[x_offset], (int) k, &((float32_t *) y_data)[y_offset], (int) n, 0.0, &((float32_t *) z_data)[z_offset], (int) n);
+        cblas_sgemm_batch_strided(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, 
+                                  (MKL_INT) m, (MKL_INT) n, (MKL_INT) k, 1.0,
+                                  &((float32_t *) x_data)[x_offset], (MKL_INT) x_leading_dimension, (MKL_INT) x_batch_stride, 
+                                  &((float32_t *) y_data)[y_offset], (MKL_INT) y_leading_dimension, (MKL_INT) y_batch_stride, 0.0, 
+                                  &((float32_t *) z_data)[z_offset], (MKL_INT) z_leading_dimension, (MKL_INT) z_batch_stride, (MKL_INT) batch_size);
         break;
     case FLOAT64:
-        cblas_dgemm(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (int) m, (int) n, (int) k, 1.0, 
-                    &((float64_t *) x_data)[x_offset], (int) k, &((float64_t *) y_data)[y_offset], (int) n, 0.0, &((float64_t *) z_data)[z_offset], (int) n);
+        cblas_dgemm_batch_strided(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, 
+                                  (MKL_INT) m, (MKL_INT) n, (MKL_INT) k, 1.0,
+                                  &((float64_t *) x_data)[x_offset], (MKL_INT) x_leading_dimension, (MKL_INT) x_batch_stride, 
+                                  &((float64_t *) y_data)[y_offset], (MKL_INT) y_leading_dimension, (MKL_INT) y_batch_stride, 0.0, 
+                                  &((float64_t *) z_data)[z_offset], (MKL_INT) z_leading_dimension, (MKL_INT) z_batch_stride, (MKL_INT) batch_size);
+        break;
+    case BFLOAT16:
+        // There is no strided batch variant of the bfloat16 GEMM.
+        for (int64_t i = 0; i < batch_size; ++i)
+        {
+            mkl_matrix_multiplication(datatype, m, k, n, x_transpose, y_transpose,
+                                      x_data, x_offset + i * x_batch_stride, x_leading_dimension,
+                                      y_data, y_offset + i * y_batch_stride, y_leading_dimension,
+                                      z_data, z_offset + i * z_batch_stride, z_leading_dimension);
+        }
         break;
     default:
         break;
     }
 }
 
+void mkl_quantized_matrix_multiplication(int64_t channels, int64_t depth, int64_t n, bool_t channels_last,
+                                         const int8_t *w_data, const uint8_t *x_data, int32_t *z_data)
+{
+    const MKL_INT32 offset = 0;
+
+    if (channels_last)
+    {
+        // Column major view of the row major n x channels result, so the int8 weights stay the A operand.
+        cblas_gemm_s8u8s32(CblasColMajor, CblasTrans, CblasNoTrans, CblasFixOffset, (MKL_INT) channels, (MKL_INT) n, (MKL_INT) depth, 1.0f,
+                           w_data, (MKL_INT) depth, 0, x_data, (MKL_INT) depth, 0, 0.0f, z_data, (MKL_INT) channels, &offset);
+    }
+    else
+    {
+        cblas_gemm_s8u8s32(CblasRowMajor, CblasNoTrans, CblasNoTrans, CblasFixOffset, (MKL_INT) channels, (MKL_INT) n, (MKL_INT) depth, 1.0f,
+                           w_data, (MKL_INT) depth, 0, x_data, (MKL_INT) n, 0, 0.0f, z_data, (MKL_INT) n, &offset);
+    }
+}
+
 static void mkl_summation_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data)
 {
     float32_t temp = 1.0;
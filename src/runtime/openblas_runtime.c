@@ -10,10 +10,23 @@
 
 #define EPSILON 1e-7
 
+// Alignment of runtime memory, one cache line and a full AVX-512 vector.
+#define NW_MEMORY_ALIGNMENT 64
+
+// Constants of the tanh approximation of GELU, sqrt(2 / pi) and the cubic coefficient.
+#define NW_GELU_SCALE 0.7978845608028654
+#define NW_GELU_COEFFICIENT 0.044715
+
 #ifndef NW_NUM_THREADS
 #define NW_NUM_THREADS 4
 #endif
 
+// Elementwise kernels below this many elements stay on the calling thread,
+// the cost of waking the OpenMP team outweighs the work for small tensors.
+#ifndef NW_PARALLEL_THRESHOLD
+#define NW_PARALLEL_THRESHOLD 32768
+#endif
+
 nw_error_t *openblas_create_context(void)
 {
     omp_set_num_threads(NW_NUM_THREADS);
@@ -25,7 +38,8 @@ nw_error_t *openblas_memory_allocate(void **pp, size_t size)
 {
     CHECK_NULL_ARGUMENT(pp, "pp");
 
-    *pp = malloc(size);
+    // Cache line alignment, aligned_alloc also requires the size to be a multiple of it.
+    *pp = aligned_alloc(NW_MEMORY_ALIGNMENT, (size + NW_MEMORY_ALIGNMENT - 1) / NW_MEMORY_ALIGNMENT * NW_MEMORY_ALIGNMENT);
     if (!*pp)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
@@ -41,7 +55,7 @@ void openblas_memory_free(void *p)
 
 static void openblas_exponential_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = expf(x_data[i * x_stride]); 
@@ -50,7 +64,7 @@ static void openblas_exponential_float32(int n, const float32_t *x_data, int x_s
 
 static void openblas_exponential_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = exp(x_data[i * x_stride]); 
@@ -74,7 +88,7 @@ void openblas_exponential(datatype_t datatype, int64_t n, const void *x_data, in
 
 static void openblas_logarithm_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = logf(x_data[i * x_stride]); 
@@ -83,7 +97,7 @@ static void openblas_logarithm_float32(int n, const float32_t *x_data, int x_str
 
 static void openblas_logarithm_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = log(x_data[i * x_stride]); 
@@ -107,7 +121,7 @@ void openblas_logarithm(datatype_t datatype, int64_t n, const void *x_data, int6
 
 static void openblas_sine_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = sinf(x_data[i * x_stride]); 
@@ -116,7 +130,7 @@ static void openblas_sine_float32(int n, const float32_t *x_data, int x_stride,
 
 static void openblas_sine_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = sin(x_data[i * x_stride]); 
@@ -140,7 +154,7 @@ void openblas_sine(datatype_t datatype, int64_t n, const void *x_data, int64_t x
 
 static void openblas_cosine_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = cosf(x_data[i * x_stride]); 
@@ -149,7 +163,7 @@ static void openblas_cosine_float32(int n, const float32_t *x_data, int x_stride
 
 static void openblas_cosine_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = cos(x_data[i * x_stride]); 
@@ -173,7 +187,7 @@ void openblas_cosine(datatype_t datatype, int64_t n, const void *x_data, int64_t
 
 static void openblas_square_root_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = sqrtf(x_data[i * x_stride]); 
@@ -182,7 +196,7 @@ static void openblas_square_root_float32(int n, const float32_t *x_data, int x_s
 
 static void openblas_square_root_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = sqrt(x_data[i * x_stride]); 
@@ -206,7 +220,7 @@ void openblas_square_root(datatype_t datatype, int64_t n, const void *x_data, in
 
 static void openblas_reciprocal_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = 1. / x_data[i * x_stride]; 
@@ -215,7 +229,7 @@ static void openblas_reciprocal_float32(int n, const float32_t *x_data, int x_st
 
 static void openblas_reciprocal_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         y_data[i * y_stride] = 1. / x_data[i * x_stride]; 
@@ -269,7 +283,7 @@ void openblas_negation(datatype_t datatype, int64_t n, const void *x_data, int64
 
 static void openblas_rectified_linear_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         float32_t value = x_data[i * x_stride];
@@ -279,7 +293,7 @@ static void openblas_rectified_linear_float32(int n, const float32_t *x_data, in
 
 static void openblas_rectified_linear_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         float64_t value = x_data[i * x_stride];
@@ -304,7 +318,7 @@ void openblas_rectified_linear(datatype_t datatype, int64_t n, const void *x_dat
 
 static void openblas_sigmoid_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         float32_t x = x_data[i * x_stride];
@@ -321,7 +335,7 @@ static void openblas_sigmoid_float32(int n, const float32_t *x_data, int x_strid
 
 static void openblas_sigmoid_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         float64_t x = x_data[i * x_stride];
@@ -351,6 +365,150 @@ void openblas_sigmoid(datatype_t datatype, int64_t n, const void *x_data, int64_
     }
 }
 
+static void openblas_tanh_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        y_data[i * y_stride] = tanhf(x_data[i * x_stride]);
+    }
+}
+
+static void openblas_tanh_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        y_data[i * y_stride] = tanh(x_data[i * x_stride]);
+    }
+}
+
+void openblas_tanh(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        openblas_tanh_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    case FLOAT64:
+        openblas_tanh_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    default:
+        break;
+    }
+}
+
+static void openblas_gelu_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data, int y_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        float32_t x = x_data[i * x_stride];
+        float32_t u = (float32_t) NW_GELU_SCALE * (x + (float32_t) NW_GELU_COEFFICIENT * x * x * x);
+        y_data[i * y_stride] = (float32_t) 0.5 * x * ((float32_t) 1.0 + tanhf(u));
+    }
+}
+
+static void openblas_gelu_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data, int y_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        float64_t x = x_data[i * x_stride];
+        float64_t u = (float64_t) NW_GELU_SCALE * (x + (float64_t) NW_GELU_COEFFICIENT * x * x * x);
+        y_data[i * y_stride] = (float64_t) 0.5 * x * ((float64_t) 1.0 + tanh(u));
+    }
+}
+
+void openblas_gelu(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        openblas_gelu_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    case FLOAT64:
+        openblas_gelu_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    default:
+        break;
+    }
+}
+
+static void openblas_tanh_gradient_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        float32_t y = x_data[i * x_stride];
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float32_t) 1.0 - y * y);
+    }
+}
+
+static void openblas_tanh_gradient_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        float64_t y = x_data[i * x_stride];
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float64_t) 1.0 - y * y);
+    }
+}
+
+void openblas_tanh_gradient(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        openblas_tanh_gradient_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride, &((float32_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    case FLOAT64:
+        openblas_tanh_gradient_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride, &((float64_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    default:
+        break;
+    }
+}
+
+static void openblas_gelu_gradient_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        float32_t x = x_data[i * x_stride];
+        float32_t t = tanhf((float32_t) NW_GELU_SCALE * (x + (float32_t) NW_GELU_COEFFICIENT * x * x * x));
+        float32_t du = (float32_t) NW_GELU_SCALE * ((float32_t) 1.0 + (float32_t) 3.0 * (float32_t) NW_GELU_COEFFICIENT * x * x);
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float32_t) 0.5 * ((float32_t) 1.0 + t) + (float32_t) 0.5 * x * ((float32_t) 1.0 - t * t) * du);
+    }
+}
+
+static void openblas_gelu_gradient_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
+{
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int i = 0; i < n; ++i)
+    {
+        float64_t x = x_data[i * x_stride];
+        float64_t t = tanh((float64_t) NW_GELU_SCALE * (x + (float64_t) NW_GELU_COEFFICIENT * x * x * x));
+        float64_t du = (float64_t) NW_GELU_SCALE * ((float64_t) 1.0 + (float64_t) 3.0 * (float64_t) NW_GELU_COEFFICIENT * x * x);
+        z_data[i * z_stride] = y_data[i * y_stride] * ((float64_t) 0.5 * ((float64_t) 1.0 + t) + (float64_t) 0.5 * x * ((float64_t) 1.0 - t * t) * du);
+    }
+}
+
+void openblas_gelu_gradient(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        openblas_gelu_gradient_float32((int) n, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride, &((float32_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    case FLOAT64:
+        openblas_gelu_gradient_float64((int) n, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride, &((float64_t *) z_data)[z_offset], (int) z_stride);
+        break;
+    default:
+        break;
+    }
+}
+
 void openblas_addition(datatype_t datatype, int64_t n, const void *x_data, int64_t x_stride, int64_t x_offset, const void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
 {
     switch (datatype)
@@ -385,9 +543,24 @@ void openblas_subtraction(datatype_t datatype, int64_t n, const void *x_data, in
     }
 }
 
+void openblas_scaled_addition(datatype_t datatype, int64_t n, const void *alpha, const void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        cblas_saxpy((int) n, *(float32_t *) alpha, &((float32_t *) x_data)[x_offset], (int) x_stride, &((float32_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    case FLOAT64:
+        cblas_daxpy((int) n, *(float64_t *) alpha, &((float64_t *) x_data)[x_offset], (int) x_stride, &((float64_t *) y_data)[y_offset], (int) y_stride);
+        break;
+    default:
+        break;
+    }
+}
+
 static void openblas_multiplication_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = x_data[i * x_stride] * y_data[i * y_stride];
@@ -396,7 +569,7 @@ static void openblas_multiplication_float32(int n, const float32_t *x_data, int
 
 static void openblas_multiplication_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = x_data[i * x_stride] * y_data[i * y_stride];
@@ -420,7 +593,7 @@ void openblas_multiplication(datatype_t datatype, int64_t n, const void *x_data,
 
 static void openblas_division_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = x_data[i * x_stride] / y_data[i * y_stride];
@@ -429,7 +602,7 @@ static void openblas_division_float32(int n, const float32_t *x_data, int x_stri
 
 static void openblas_division_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = x_data[i * x_stride] / y_data[i * y_stride];
@@ -453,7 +626,7 @@ void openblas_division(datatype_t datatype, int64_t n, const void *x_data, int64
 
 static void openblas_power_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = powf(x_data[i * x_stride], y_data[i * y_stride]);
@@ -462,7 +635,7 @@ static void openblas_power_float32(int n, const float32_t *x_data, int x_stride,
 
 static void openblas_power_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = pow(x_data[i * x_stride], y_data[i * y_stride]);
@@ -486,7 +659,7 @@ void openblas_power(datatype_t datatype, int64_t n, const void *x_data, int64_t
 
 static void openblas_compare_equal_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         float32_t x = x_data[i * x_stride];
@@ -497,7 +670,7 @@ static void openblas_compare_equal_float32(int n, const float32_t *x_data, int x
 
 static void openblas_compare_equal_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         float64_t x = x_data[i * x_stride];
@@ -523,7 +696,7 @@ void openblas_compare_equal(datatype_t datatype, int64_t n, const void *x_data,
 
 static void openblas_compare_greater_float32(int n, const float32_t *x_data, int x_stride, const float32_t *y_data, int y_stride, float32_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = (x_data[i * x_stride] > y_data[i * y_stride]) ? (float32_t) 1.0 : (float32_t) 0.0;
@@ -532,7 +705,7 @@ static void openblas_compare_greater_float32(int n, const float32_t *x_data, int
 
 static void openblas_compare_greater_float64(int n, const float64_t *x_data, int x_stride, const float64_t *y_data, int y_stride, float64_t *z_data, int z_stride)
 {
-    #pragma omp simd
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 0; i < n; ++i)
     {
         z_data[i * z_stride] = (x_data[i * x_stride] > y_data[i * y_stride]) ? (float64_t) 1.0 : (float64_t) 0.0;
@@ -554,23 +727,62 @@ void openblas_compare_greater(datatype_t datatype, int64_t n, const void *x_data
     }
 }
 
-void openblas_matrix_multiplication(datatype_t datatype, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose, const void *x_data, int64_t x_offset, const void *y_data, int64_t y_offset, void *z_data, int64_t z_offset)
+void openblas_matrix_multiplication(datatype_t datatype, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose, 
+                                   const void *x_data, int64_t x_offset, int64_t x_leading_dimension,
+                                   const void *y_data, int64_t y_offset, int64_t y_leading_dimension,
+                                   void *z_data, int64_t z_offset, int64_t z_leading_dimension)
 {
     switch (datatype)
     {
     case FLOAT32:
-        cblas_sgemm(CblasRowMajor, (x_transpose) ? CblasTrans: CblasNoTrans, (y_transpose) ? CblasTrans: CblasNoTrans, (int) m, (int) n, (int) k, 1.0,
-                    &((float *) x_data)[x_offset], (int) k, &((float32_t *) y_data)[y_offset], (int) n, 0.0, &((float32_t *) z_data)[z_offset], (int) n);
+        cblas_sgemm(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (int) m, (int) n, (int) k, 1.0,
+                    &((float32_t *) x_data)[x_offset], (int) x_leading_dimension, &((float32_t *) y_data)[y_offset], (int) y_leading_dimension, 
+                    0.0, &((float32_t *) z_data)[z_offset], (int) z_leading_dimension);
         break;
     case FLOAT64:
-        cblas_dgemm(CblasRowMajor, (x_transpose) ? CblasTrans: CblasNoTrans, (y_transpose) ? CblasTrans: CblasNoTrans, (int) m, (int) n, (int) k, 1.0, 
-                    &((float64_t *) x_data)[x_offset], (int) k, &((float64_t *) y_data)[y_offset], (int) n, 0.0, &((float64_t *) z_data)[z_offset], (int) n);
+        cblas_dgemm(CblasRowMajor, (x_transpose) ? CblasTrans : CblasNoTrans, (y_transpose) ? CblasTrans : CblasNoTrans, (int) m, (int) n, (int) k, 1.0, 
+                    &((float64_t *) x_data)[x_offset], (int) x_leading_dimension, &((float64_t *) y_data)[y_offset], (int) y_leading_dimension, 
+                    0.0, &((float64_t *) z_data)[z_offset], (int) z_leading_dimension);
         break;
     default:
         break;
     }
 }
 
+void openblas_batched_matrix_multiplication(datatype_t datatype, int64_t batch_size, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose,
+                                            const void *x_data, int64_t x_offset, int64_t x_leading_dimension, int64_t x_batch_stride,
+                                            const void *y_data, int64_t y_offset, int64_t y_leading_dimension, int64_t y_batch_stride,
+                                            void *z_data, int64_t z_offset, int64_t z_leading_dimension, int64_t z_batch_stride)
+{
+    // Spread independent products over threads when there are enough of them or when each is too small
+    // for OpenBLAS to thread internally.
+    bool_t parallel = batch_size > 1 && (batch_size >= omp_get_max_threads() || m * k * n < NW_PARALLEL_THRESHOLD * 64);
+
+    // An OpenMP build of OpenBLAS runs each GEMM single threaded inside the parallel region, a pthreads build
+    // would start its own thread pool for every product, so it is limited to one thread while the batch is spread.
+    bool_t serialize = parallel && openblas_get_parallel() == OPENBLAS_THREAD;
+    int threads = openblas_get_num_threads();
+
+    if (serialize)
+    {
+        openblas_set_num_threads(1);
+    }
+
+    #pragma omp parallel for if (parallel)
+    for (int64_t i = 0; i < batch_size; ++i)
+    {
+        openblas_matrix_multiplication(datatype, m, k, n, x_transpose, y_transpose,
+                                       x_data, x_offset + i * x_batch_stride, x_leading_dimension,
+                                       y_data, y_offset + i * y_batch_stride, y_leading_dimension,
+                                       z_data, z_offset + i * z_batch_stride, z_leading_dimension);
+    }
+
+    if (serialize)
+    {
+        openblas_set_num_threads(threads);
+    }
+}
+
 static void openblas_summation_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data)
 {
     float32_t temp = 1.0;
@@ -601,12 +813,10 @@ void openblas_summation(datatype_t datatype, int64_t n, const void *x_data, int6
 static void openblas_maximum_float32(int n, const float32_t *x_data, int x_stride, float32_t *y_data)
 {
     float32_t maximum = *x_data;
-    //#pragma omp parallel for schedule(static, 256)
+    #pragma omp parallel for simd reduction(max:maximum) if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 1; i < n; ++i)
     {
         float32_t candidate = x_data[i * x_stride];
-        // TODO: CAS loop might be faster
-        //#pragma omp critical
         if (maximum < candidate)
         {
             maximum = candidate;
@@ -618,12 +828,10 @@ static void openblas_maximum_float32(int n, const float32_t *x_data, int x_strid
 static void openblas_maximum_float64(int n, const float64_t *x_data, int x_stride, float64_t *y_data)
 {
     float64_t maximum = *x_data;
-    //#pragma omp parallel for schedule(static, 256)
+    #pragma omp parallel for simd reduction(max:maximum) if (n >= NW_PARALLEL_THRESHOLD)
     for (int i = 1; i < n; ++i)
     {
         float64_t candidate = x_data[i * x_stride];
-        // TODO: CAS loop might be faster
-        //#pragma omp critical
         if (maximum < candidate)
         {
             maximum = candidate;
@@ -5,6 +5,86 @@
 #include <cu_runtime.h>
 #endif
 #include <random.h>
+#include <view.h>
+#include <math.h>
+#include <string.h>
+
+// Reductions below this many elements stay on the calling thread, matching the elementwise kernels.
+#ifndef NW_PARALLEL_THRESHOLD
+#define NW_PARALLEL_THRESHOLD 32768
+#endif
+
+// Number of neighbouring outputs accumulated together when the reduced axes are not innermost.
+#define NW_REDUCTION_BLOCK_SIZE 256
+
+// Convolutions with a shallower reduction or fewer output channels than this skip the column matrix and GEMM.
+#define NW_CONVOLUTION_GEMM_DEPTH 64
+#define NW_CONVOLUTION_GEMM_CHANNELS 16
+
+// Winograd F(2x2, 3x3) only amortizes its tile transforms over enough channel pairs.
+#define NW_WINOGRAD_CHANNELS 64
+
+// Weights are quantized symmetrically to int8. Activations use 7 bits so a pair of u8 x s8 products
+// cannot saturate the int16 intermediate of the AVX2 integer GEMM kernels.
+#define NW_QUANTIZATION_WEIGHT_MAXIMUM 127
+#define NW_QUANTIZATION_ACTIVATION_MAXIMUM 127
+
+// Freed runtime memory is kept in size class bins and handed out again to later allocations of the same class.
+// Each power of two is split into NW_ALLOCATOR_SUBCLASSES classes so rounding wastes at most a quarter of a block.
+#define NW_ALLOCATOR_MINIMUM_SIZE 256
+#define NW_ALLOCATOR_SUBCLASSES 4
+#define NW_ALLOCATOR_BINS (NW_ALLOCATOR_SUBCLASSES * 40 + 1)
+#define NW_ALLOCATOR_ALIGNMENT 64
+
+// Upper bound on the size of the step arena of each runtime, allocations beyond it fall back to the cache.
+#ifndef NW_ARENA_LIMIT
+#define NW_ARENA_LIMIT ((size_t) 1 << 30)
+#endif
+
+// Arenas set aside per runtime because memory outlived the step they served, see `runtime_arena_end`.
+#ifndef NW_ARENA_RETIRED
+#define NW_ARENA_RETIRED 4
+#endif
+
+// Upper bound on the bytes cached per runtime, blocks freed beyond it are returned to the system. Zero disables caching.
+#ifndef NW_ALLOCATOR_CACHE_LIMIT
+#define NW_ALLOCATOR_CACHE_LIMIT ((size_t) 1 << 30)
+#endif
+
+typedef struct allocator_bin_t
+{
+    void **blocks;
+    int64_t length;
+    int64_t capacity;
+} allocator_bin_t;
+
+typedef struct allocator_arena_t
+{
+    void *data;
+    size_t capacity;
+    int64_t live;
+} allocator_arena_t;
+
+typedef struct allocator_t
+{
+    allocator_bin_t bins[NW_ALLOCATOR_BINS];
+    size_t bytes_in_use;
+    size_t bytes_cached;
+    uint64_t hits;
+    uint64_t misses;
+    void *arena;
+    size_t arena_capacity;
+    size_t arena_offset;
+    size_t arena_demand;
+    size_t arena_peak;
+    int64_t arena_live;
+    allocator_arena_t arena_retired[NW_ARENA_RETIRED];
+    uint64_t arena_survivors;
+} allocator_t;
+
+static allocator_t allocators[RUNTIMES];
+static int64_t arena_depth = 0;
+static int64_t arena_suspended = 0;
 
 nw_error_t *runtime_create_context(runtime_t runtime)
 {
@@ -38,6 +118,8 @@ nw_error_t *runtime_create_context(runtime_t runtime)
 
 void runtime_destroy_context(runtime_t runtime)
 {
+    runtime_allocator_trim(runtime, 0);
+
     switch (runtime)
     {
     case OPENBLAS_RUNTIME:
@@ -53,64 +135,523 @@ void runtime_destroy_context(runtime_t runtime)
     }
 }
 
-nw_error_t *runtime_malloc(void **data, int64_t n, datatype_t datatype, runtime_t runtime)
+static nw_error_t *runtime_memory_allocate(void **data, size_t size, runtime_t runtime)
 {
-    if (!n)
+    switch (runtime)
     {
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("cannot allocate 0 bytes."), NULL);
+    case OPENBLAS_RUNTIME:
+        return openblas_memory_allocate(data, size);
+    case MKL_RUNTIME:
+        return mkl_memory_allocate(data, size);
+#ifndef CPU_ONLY
+    case CU_RUNTIME:
+        return cu_memory_allocate(data, size);
+#endif
+    default:
+        return ERROR(ERROR_RUNTIME, string_create("unknown runtime %d.", (int) runtime), NULL);
     }
+}
 
-    nw_error_t *error = NULL;
-    size_t size = n * datatype_size(datatype);
-
+static void runtime_memory_free(void *data, runtime_t runtime)
+{
     switch (runtime)
     {
     case OPENBLAS_RUNTIME:
-        error = openblas_memory_allocate(data, size);
+        openblas_memory_free(data);
         break;
     case MKL_RUNTIME:
-        error = mkl_memory_allocate(data, size);
+        mkl_memory_free(data);
         break;
 #ifndef CPU_ONLY
     case CU_RUNTIME:
-        error = cu_memory_allocate(data, size);
+        cu_memory_free(data);
         break;
 #endif
     default:
-        error = ERROR(ERROR_RUNTIME, string_create("unknown runtime %d.", (int) runtime), NULL);
         break;
     }
+}
+
+/**
+ * @brief Round a request up to its size class.
+ * @param size Number of bytes requested.
+ * @param class_size Set to the number of bytes of the size class.
+ * @return Bin of the size class, -1 if the request is too large to be cached.
+ */
+static int64_t runtime_allocator_class(size_t size, size_t *class_size)
+{
+    size_t base = NW_ALLOCATOR_MINIMUM_SIZE;
+    int64_t bin = 0;
+
+    if (size <= base)
+    {
+        *class_size = base;
+        return bin;
+    }
+
+    while (base < size / 2 + size % 2 && bin < NW_ALLOCATOR_BINS)
+    {
+        base *= 2;
+        bin += NW_ALLOCATOR_SUBCLASSES;
+    }
+
+    // Size lies in (base, 2 * base], split into steps of base / NW_ALLOCATOR_SUBCLASSES.
+    size_t step = base / NW_ALLOCATOR_SUBCLASSES;
+    size_t subclass = (size - base + step - 1) / step;
+    bin += subclass;
+
+    if (bin >= NW_ALLOCATOR_BINS)
+    {
+        *class_size = (size + NW_ALLOCATOR_ALIGNMENT - 1) / NW_ALLOCATOR_ALIGNMENT * NW_ALLOCATOR_ALIGNMENT;
+        return -1;
+    }
+
+    *class_size = base + subclass * step;
+    return bin;
+}
+
+static size_t runtime_allocator_bin_size(int64_t bin)
+{
+    size_t base = (size_t) NW_ALLOCATOR_MINIMUM_SIZE << (bin / NW_ALLOCATOR_SUBCLASSES);
+
+    return base + (bin % NW_ALLOCATOR_SUBCLASSES) * (base / NW_ALLOCATOR_SUBCLASSES);
+}
+
+static bool_t runtime_arena_owns(const allocator_t *allocator, const void *data)
+{
+    return allocator->arena && (const char *) data >= (const char *) allocator->arena &&
+           (const char *) data < (const char *) allocator->arena + allocator->arena_capacity;
+}
+
+/**
+ * @brief Find the retired arena `data` was bump allocated from.
+ * @return The retired arena, NULL if `data` does not belong to one.
+ */
+static allocator_arena_t *runtime_arena_retired_owner(allocator_t *allocator, const void *data)
+{
+    for (int64_t i = 0; i < NW_ARENA_RETIRED; ++i)
+    {
+        allocator_arena_t *retired = &allocator->arena_retired[i];
+        if (retired->data && (const char *) data >= (const char *) retired->data &&
+            (const char *) data < (const char *) retired->data + retired->capacity)
+        {
+            return retired;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set the arena aside when memory allocated from it is still alive at the end of a step, so that the
+ *        next step bump allocates from a fresh arena instead of waiting for that memory to be freed.
+ *        The retired arena is released along with the last of its blocks. Without a free slot the arena is kept
+ *        and rewinds once its blocks are gone. Must be called in the `nw_allocator` critical section.
+ */
+static void runtime_arena_retire(allocator_t *allocator)
+{
+    if (!allocator->arena_live)
+    {
+        return;
+    }
+
+    ++allocator->arena_survivors;
+    for (int64_t i = 0; i < NW_ARENA_RETIRED; ++i)
+    {
+        allocator_arena_t *retired = &allocator->arena_retired[i];
+        if (!retired->data)
+        {
+            retired->data = allocator->arena;
+            retired->capacity = allocator->arena_capacity;
+            retired->live = allocator->arena_live;
+            allocator->arena = NULL;
+            allocator->arena_capacity = 0;
+            allocator->arena_offset = 0;
+            allocator->arena_demand = 0;
+            allocator->arena_live = 0;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Bump allocate from the step arena of a runtime.
+ *        While nothing allocated from the arena is alive it is grown to the largest demand of a previous step.
+ * @return The allocated memory, NULL if the arena cannot hold the request.
+ */
+static void *runtime_arena_allocate(allocator_t *allocator, size_t size, runtime_t runtime)
+{
+    void *data = NULL;
+
+    size = (size + NW_ALLOCATOR_ALIGNMENT - 1) / NW_ALLOCATOR_ALIGNMENT * NW_ALLOCATOR_ALIGNMENT;
+
+    #pragma omp critical (nw_allocator)
+    {
+        allocator->arena_demand += size;
+        if (allocator->arena_demand > allocator->arena_peak)
+        {
+            allocator->arena_peak = (allocator->arena_demand < NW_ARENA_LIMIT) ? allocator->arena_demand : NW_ARENA_LIMIT;
+        }
+
+        if (!allocator->arena_live && allocator->arena_peak > allocator->arena_capacity)
+        {
+            runtime_memory_free(allocator->arena, runtime);
+            allocator->arena = NULL;
+            allocator->arena_capacity = 0;
+
+            nw_error_t *error = runtime_memory_allocate(&allocator->arena, allocator->arena_peak, runtime);
+            if (error)
+            {
+                error_destroy(error);
+                allocator->arena = NULL;
+            }
+            else
+            {
+                allocator->arena_capacity = allocator->arena_peak;
+            }
+        }
+
+        if (allocator->arena && allocator->arena_offset + size <= allocator->arena_capacity)
+        {
+            data = (char *) allocator->arena + allocator->arena_offset;
+            allocator->arena_offset += size;
+            ++allocator->arena_live;
+        }
+    }
+
+    return data;
+}
+
+/**
+ * @brief Open a step scope. Until the matching `runtime_arena_end`, memory requested through `runtime_malloc`
+ *        is bump allocated from a per runtime arena instead of the cache. Scopes may nest.
+ *        The arena is reset in O(1) as soon as nothing allocated from it is alive. Memory that outlives
+ *        the scope stays valid, see `runtime_arena_end`. Persistent tensors are created with the arena suspended.
+ */
+void runtime_arena_begin(void)
+{
+    #pragma omp critical (nw_allocator)
+    {
+        ++arena_depth;
+    }
+}
+
+/**
+ * @brief Close the scope opened by `runtime_arena_begin`. Closing the outermost scope ends the step: arenas that
+ *        still hold live memory are retired and counted in `arena_survivors` of `runtime_allocator_statistics`.
+ */
+void runtime_arena_end(void)
+{
+    #pragma omp critical (nw_allocator)
+    {
+        if (arena_depth && !--arena_depth)
+        {
+            for (int64_t i = 0; i < RUNTIMES; ++i)
+            {
+                runtime_arena_retire(&allocators[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Route allocations around the step arena while `suspend` calls are outstanding, for memory that outlives the step.
+ * @param suspend True to suspend the arena, false to undo a previous suspension.
+ */
+void runtime_arena_suspend(bool_t suspend)
+{
+    #pragma omp critical (nw_allocator)
+    {
+        if (suspend)
+        {
+            ++arena_suspended;
+        }
+        else if (arena_suspended)
+        {
+            --arena_suspended;
+        }
+    }
+}
+
+/**
+ * @brief Whether `data` was bump allocated from the step arena of `runtime` or one of its retired arenas.
+ */
+bool_t runtime_arena_contains(void *data, runtime_t runtime)
+{
+    bool_t contains = false;
+
+    if (data && runtime >= 0 && runtime < RUNTIMES)
+    {
+        allocator_t *allocator = &allocators[runtime];
+
+        #pragma omp critical (nw_allocator)
+        {
+            contains = runtime_arena_owns(allocator, data) || runtime_arena_retired_owner(allocator, data);
+        }
+    }
+
+    return contains;
+}
+
+/**
+ * @brief Allocate `n` elements of `datatype` for the runtime, reusing a cached block of the same size class when one is available.
+ *        Blocks are aligned to at least NW_ALLOCATOR_ALIGNMENT bytes on every runtime.
+ * @param data Set to the allocated memory.
+ * @param n Number of elements.
+ * @param datatype Datatype of the elements.
+ * @param runtime Runtime the memory belongs to.
+ * @return Error if `n` is zero, the runtime is unknown or the memory could not be allocated.
+ *         NULL if the memory was allocated successfully.
+ */
+nw_error_t *runtime_malloc(void **data, int64_t n, datatype_t datatype, runtime_t runtime)
+{
+    CHECK_NULL_ARGUMENT(data, "data");
+
+    if (!n)
+    {
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("cannot allocate 0 bytes."), NULL);
+    }
+
+    if (runtime < 0 || runtime >= RUNTIMES)
+    {
+        return ERROR(ERROR_RUNTIME, string_create("unknown runtime %d.", (int) runtime), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    allocator_t *allocator = &allocators[runtime];
+    size_t size = 0;
+    int64_t bin = runtime_allocator_class(n * datatype_size(datatype), &size);
+
+    *data = NULL;
+
+    if (arena_depth && !arena_suspended)
+    {
+        *data = runtime_arena_allocate(allocator, n * datatype_size(datatype), runtime);
+        if (*data)
+        {
+            runtime_synchronize(runtime);
+            return error;
+        }
+    }
+
+    #pragma omp critical (nw_allocator)
+    {
+        if (bin >= 0 && allocator->bins[bin].length)
+        {
+            *data = allocator->bins[bin].blocks[--allocator->bins[bin].length];
+            allocator->bytes_cached -= size;
+            ++allocator->hits;
+        }
+        else
+        {
+            ++allocator->misses;
+        }
+        allocator->bytes_in_use += (*data) ? size : 0;
+    }
+
+    if (*data)
+    {
+        // Queued device work may still reference the block from its previous owner.
+        runtime_synchronize(runtime);
+        return error;
+    }
 
+    error = runtime_memory_allocate(data, size, runtime);
     if (error)
     {
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes for runtime %s.", size, runtime_string(runtime)), error);
+        // Cached blocks of other size classes may be what is holding the memory, release them and try once more.
+        error_destroy(error);
+        runtime_allocator_trim(runtime, 0);
+        error = runtime_memory_allocate(data, size, runtime);
+        if (error)
+        {
+            *data = NULL;
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes for runtime %s.", size, runtime_string(runtime)), error);
+        }
+    }
+
+    #pragma omp critical (nw_allocator)
+    {
+        allocator->bytes_in_use += size;
     }
     
-    return NULL;
+    return error;
+}
+
+/**
+ * @brief Return memory obtained from `runtime_malloc` to the cache of its runtime.
+ *        The block is released to the system when it is too large to be cached or the cache is full.
+ * @param data Memory to free, may be NULL.
+ * @param n Number of elements the memory was allocated with.
+ * @param datatype Datatype the memory was allocated with.
+ * @param runtime Runtime the memory was allocated with.
+ */
+void runtime_free(void *data, int64_t n, datatype_t datatype, runtime_t runtime)
+{
+    if (!data || runtime < 0 || runtime >= RUNTIMES)
+    {
+        return;
+    }
+
+    allocator_t *allocator = &allocators[runtime];
+    size_t size = 0;
+    int64_t bin = runtime_allocator_class(n * datatype_size(datatype), &size);
+    bool_t cached = false;
+    allocator_arena_t *retired = NULL;
+
+    #pragma omp critical (nw_allocator)
+    {
+        if (runtime_arena_owns(allocator, data))
+        {
+            // Arena blocks are only counted, the arena is rewound once the last of them is gone.
+            if (!--allocator->arena_live)
+            {
+                allocator->arena_offset = 0;
+                allocator->arena_demand = 0;
+            }
+            cached = true;
+        }
+        else if ((retired = runtime_arena_retired_owner(allocator, data)))
+        {
+            if (!--retired->live)
+            {
+                runtime_memory_free(retired->data, runtime);
+                retired->data = NULL;
+                retired->capacity = 0;
+            }
+            cached = true;
+        }
+        else
+        {
+            allocator->bytes_in_use -= size;
+            if (bin >= 0 && allocator->bytes_cached + size <= NW_ALLOCATOR_CACHE_LIMIT)
+            {
+                allocator_bin_t *allocator_bin = &allocator->bins[bin];
+                if (allocator_bin->length == allocator_bin->capacity)
+                {
+                    int64_t capacity = (allocator_bin->capacity) ? 2 * allocator_bin->capacity : 8;
+                    void **blocks = (void **) realloc(allocator_bin->blocks, capacity * sizeof(void *));
+                    if (blocks)
+                    {
+                        allocator_bin->blocks = blocks;
+                        allocator_bin->capacity = capacity;
+                    }
+                }
+
+                if (allocator_bin->length < allocator_bin->capacity)
+                {
+                    allocator_bin->blocks[allocator_bin->length++] = data;
+                    allocator->bytes_cached += size;
+                    cached = true;
+                }
+            }
+        }
+    }
+
+    if (!cached)
+    {
+        runtime_memory_free(data, runtime);
+    }
 }
 
-void runtime_free(void *data, runtime_t runtime)
+/**
+ * @brief Free memory the runtime did not allocate itself, such as data adopted by a storage without a copy.
+ *        The memory bypasses the cache.
+ * @param data Memory to free, may be NULL.
+ * @param runtime Runtime the memory belongs to.
+ */
+void runtime_release(void *data, runtime_t runtime)
 {
     if (data)
     {
-        switch (runtime)
+        runtime_memory_free(data, runtime);
+    }
+}
+
+/**
+ * @brief Return cached blocks of a runtime to the system, largest size classes first, until at most `limit` bytes remain cached.
+ * @param runtime Runtime whose cache is trimmed.
+ * @param limit Number of cached bytes to keep, zero releases the whole cache.
+ */
+void runtime_allocator_trim(runtime_t runtime, size_t limit)
+{
+    if (runtime < 0 || runtime >= RUNTIMES)
+    {
+        return;
+    }
+
+    allocator_t *allocator = &allocators[runtime];
+
+    #pragma omp critical (nw_allocator)
+    {
+        for (int64_t bin = NW_ALLOCATOR_BINS - 1; bin >= 0 && allocator->bytes_cached > limit; --bin)
         {
-        case OPENBLAS_RUNTIME:
-            openblas_memory_free(data);
-            break;
-        case MKL_RUNTIME:
-            mkl_memory_free(data);
-            break;
-#ifndef CPU_ONLY
-        case CU_RUNTIME:
-            cu_memory_free(data);
-            break;
-#endif
-        default:
-            break;
+            allocator_bin_t *allocator_bin = &allocator->bins[bin];
+            if (!allocator_bin->length)
+            {
+                continue;
+            }
+
+            size_t size = runtime_allocator_bin_size(bin);
+            while (allocator_bin->length && allocator->bytes_cached > limit)
+            {
+                runtime_memory_free(allocator_bin->blocks[--allocator_bin->length], runtime);
+                allocator->bytes_cached -= size;
+            }
+
+            if (!allocator_bin->length)
+            {
+                free(allocator_bin->blocks);
+                allocator_bin->blocks = NULL;
+                allocator_bin->capacity = 0;
+            }
+        }
+
+        if (!limit && !allocator->arena_live)
+        {
+            runtime_memory_free(allocator->arena, runtime);
+            allocator->arena = NULL;
+            allocator->arena_capacity = 0;
+            allocator->arena_offset = 0;
+            allocator->arena_demand = 0;
+            allocator->arena_peak = 0;
+        }
+    }
+}
+
+/**
+ * @brief Report memory usage of the caching allocator of a runtime.
+ * @param runtime Runtime to report on.
+ * @param statistics Set to the bytes handed out, the bytes cached, the fraction of allocations served from the cache,
+ *                   the size of the step arena and of the retired arenas, and the number of steps that ended with
+ *                   memory of the arena still alive.
+ */
+void runtime_allocator_statistics(runtime_t runtime, allocator_statistics_t *statistics)
+{
+    if (!statistics || runtime < 0 || runtime >= RUNTIMES)
+    {
+        return;
+    }
+
+    allocator_t *allocator = &allocators[runtime];
+
+    #pragma omp critical (nw_allocator)
+    {
+        statistics->bytes_in_use = allocator->bytes_in_use;
+        statistics->bytes_cached = allocator->bytes_cached;
+        statistics->hits = allocator->hits;
+        statistics->misses = allocator->misses;
+        statistics->bytes_arena = allocator->arena_capacity;
+        statistics->bytes_arena_retired = 0;
+        for (int64_t i = 0; i < NW_ARENA_RETIRED; ++i)
+        {
+            statistics->bytes_arena_retired += allocator->arena_retired[i].capacity;
         }
+        statistics->arena_survivors = allocator->arena_survivors;
     }
 
+    uint64_t total = statistics->hits + statistics->misses;
+    statistics->hit_rate = (total) ? (float64_t) statistics->hits / (float64_t) total : 0.0;
 }
 
 void runtime_synchronize(runtime_t runtime)
@@ -130,8 +671,8 @@ void runtime_synchronize(runtime_t runtime)
     }
 }
 
-void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n, 
-                   void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+static void runtime_unary_vector(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n, 
+                                 void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
 {
     switch (runtime)
     {
@@ -165,6 +706,12 @@ void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtim
         case SIGMOID_OPERATION:
             openblas_sigmoid(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
             break;
+        case TANH_OPERATION:
+            openblas_tanh(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+            break;
+        case GELU_OPERATION:
+            openblas_gelu(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+            break;
         case RECIPROCAL_OPERATION:
             openblas_reciprocal(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
             break;
@@ -202,6 +749,12 @@ void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtim
         case SIGMOID_OPERATION:
             mkl_sigmoid(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
             break;
+        case TANH_OPERATION:
+            mkl_tanh(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+            break;
+        case GELU_OPERATION:
+            mkl_gelu(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+            break;
         case RECIPROCAL_OPERATION:
             mkl_reciprocal(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
             break;
@@ -240,6 +793,12 @@ void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtim
         case SIGMOID_OPERATION:
             cu_sigmoid(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
             break;
+        case TANH_OPERATION:
+            cu_tanh(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+            break;
+        case GELU_OPERATION:
+            cu_gelu(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+            break;
         case RECIPROCAL_OPERATION:
             cu_reciprocal(datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
             break;
@@ -253,9 +812,9 @@ void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtim
     }
 }
 
-void runtime_binary_elementwise(binary_operation_type_t binary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
-                                void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset,
-                                void *z_data, int64_t z_stride, int64_t z_offset)
+static void runtime_binary_elementwise_vector(binary_operation_type_t binary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
+                                              void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset,
+                                              void *z_data, int64_t z_stride, int64_t z_offset)
 {
     switch (runtime)
     {
@@ -350,30 +909,397 @@ void runtime_binary_elementwise(binary_operation_type_t binary_operation_type, r
     }
 }
 
-void runtime_matrix_multiplication(runtime_t runtime, datatype_t datatype, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose,
-                                   void *x_data, int64_t x_offset, void *y_data, int64_t y_offset, void *z_data, int64_t z_offset)
+/**
+ * @brief Merge the dimensions of a set of operands that share a common shape into the fewest
+ *        strided dimensions that address the same elements. Dimensions of size one are dropped
+ *        and two adjacent dimensions are merged when every operand steps through them as a single
+ *        run, which also folds together adjacent broadcast (stride zero) dimensions.
+ * @param rank Number of dimensions in `shape`.
+ * @param shape The common shape of the operands.
+ * @param operands Number of operands.
+ * @param strides Array of `operands` stride arrays, each of length `rank`.
+ * @param collapsed_shape Output shape of length at least `rank`.
+ * @param collapsed_strides Output strides laid out as `operands` rows of `rank` entries.
+ * @return Rank of the collapsed shape. Zero if the operands hold a single element.
+ */
+static int64_t runtime_collapse_dimensions(int64_t rank, const int64_t *shape, int64_t operands, const int64_t **strides,
+                                           int64_t *collapsed_shape, int64_t *collapsed_strides)
 {
-    switch (runtime)
-    {
-    case OPENBLAS_RUNTIME:
-        openblas_matrix_multiplication(datatype, m, k, n, x_transpose, y_transpose, x_data, x_offset, y_data, y_offset, z_data, z_offset);
-        break;
-    case MKL_RUNTIME:
-        mkl_matrix_multiplication(datatype, m, k, n, x_transpose, y_transpose, x_data, x_offset, y_data, y_offset, z_data, z_offset);
-        break;
-#ifndef CPU_ONLY
-    case CU_RUNTIME:
-        cu_matrix_multiplication(datatype, m, k, n, x_transpose, y_transpose, x_data, x_offset, y_data, y_offset, z_data, z_offset);
-        break;
-#endif
-    default:
-        break;
-    }
-}
+    int64_t collapsed_rank = 0;
 
-void runtime_where(runtime_t runtime, datatype_t datatype, int64_t n,
-                   void *w_data, int64_t w_stride, int64_t w_offset, void *x_data, int64_t x_stride, int64_t x_offset, 
-                   void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+    for (int64_t i = 0; i < rank; ++i)
+    {
+        if (shape[i] == 1)
+        {
+            continue;
+        }
+
+        bool_t mergeable = collapsed_rank > 0;
+        for (int64_t j = 0; j < operands && mergeable; ++j)
+        {
+            mergeable = collapsed_strides[j * rank + collapsed_rank - 1] == strides[j][i] * shape[i];
+        }
+
+        if (mergeable)
+        {
+            collapsed_shape[collapsed_rank - 1] *= shape[i];
+            for (int64_t j = 0; j < operands; ++j)
+            {
+                collapsed_strides[j * rank + collapsed_rank - 1] = strides[j][i];
+            }
+        }
+        else
+        {
+            collapsed_shape[collapsed_rank] = shape[i];
+            for (int64_t j = 0; j < operands; ++j)
+            {
+                collapsed_strides[j * rank + collapsed_rank] = strides[j][i];
+            }
+            ++collapsed_rank;
+        }
+    }
+
+    return collapsed_rank;
+}
+
+/**
+ * @brief Advance the outer (all but innermost) index of a collapsed iteration space by one row
+ *        and update the offsets of every operand accordingly.
+ * @param rank Rank of the collapsed iteration space.
+ * @param shape The collapsed shape.
+ * @param operands Number of operands.
+ * @param strides The collapsed strides laid out as `operands` rows of `stride_rank` entries.
+ * @param stride_rank Row length of `strides`.
+ * @param index The current outer index of length `rank`.
+ * @param offsets The current offset of each operand.
+ */
+static void runtime_next_row(int64_t rank, const int64_t *shape, int64_t operands, const int64_t *strides, int64_t stride_rank,
+                             int64_t *index, int64_t *offsets)
+{
+    for (int64_t i = rank - 2; i >= 0; --i)
+    {
+        ++index[i];
+        for (int64_t j = 0; j < operands; ++j)
+        {
+            offsets[j] += strides[j * stride_rank + i];
+        }
+
+        if (index[i] < shape[i])
+        {
+            return;
+        }
+
+        index[i] = 0;
+        for (int64_t j = 0; j < operands; ++j)
+        {
+            offsets[j] -= strides[j * stride_rank + i] * shape[i];
+        }
+    }
+}
+
+/**
+ * @brief Compute the offset of every operand for a flat row major index into a collapsed iteration space.
+ * @param index Flat row major index.
+ * @param rank Rank of the iteration space.
+ * @param shape Shape of the iteration space.
+ * @param operands Number of operands.
+ * @param strides The strides laid out as `operands` rows of `stride_rank` entries.
+ * @param stride_rank Row length of `strides`.
+ * @param offsets The offset of each operand relative to its start.
+ */
+static void runtime_index_offsets(int64_t index, int64_t rank, const int64_t *shape, int64_t operands, const int64_t *strides, int64_t stride_rank,
+                                  int64_t *offsets)
+{
+    for (int64_t j = 0; j < operands; ++j)
+    {
+        offsets[j] = 0;
+    }
+
+    for (int64_t i = rank - 1; i >= 0; --i)
+    {
+        int64_t k = index % shape[i];
+        for (int64_t j = 0; j < operands; ++j)
+        {
+            offsets[j] += k * strides[j * stride_rank + i];
+        }
+        index /= shape[i];
+    }
+}
+
+// Largest number of operands walked together by a runtime_iterator_t.
+#define NW_ITERATOR_OPERANDS 4
+
+/**
+ * @brief Walks the rows of an N-d iteration space shared by up to `NW_ITERATOR_OPERANDS` strided operands.
+ *        Dimensions are collapsed first, each step exposes a contiguous run of `n` elements of every operand.
+ */
+typedef struct runtime_iterator_t
+{
+    int64_t rank; /** Rank of the collapsed iteration space. */
+    int64_t operands; /** Number of operands. */
+    int64_t n; /** Length of the innermost run. */
+    int64_t rows; /** Number of innermost runs. */
+    int64_t shape[MAX_RANK]; /** The collapsed shape. */
+    int64_t strides[NW_ITERATOR_OPERANDS * MAX_RANK]; /** The collapsed strides, `operands` rows of `MAX_RANK` entries. */
+    int64_t index[MAX_RANK]; /** The current outer index. */
+    int64_t offsets[NW_ITERATOR_OPERANDS]; /** The current offset of each operand. */
+    int64_t inner_strides[NW_ITERATOR_OPERANDS]; /** The stride of each operand along the innermost run. */
+} runtime_iterator_t;
+
+/**
+ * @brief Initialize an iterator over `shape` positioned at the first row.
+ * @param iterator The iterator to initialize.
+ * @param rank Rank of the iteration space, at most `MAX_RANK`.
+ * @param shape The common shape of the operands.
+ * @param operands Number of operands, at most `NW_ITERATOR_OPERANDS`.
+ * @param strides Array of `operands` stride arrays, each of length `rank`.
+ * @param offsets The starting offset of each operand.
+ */
+static void runtime_iterator_create(runtime_iterator_t *iterator, int64_t rank, const int64_t *shape, int64_t operands,
+                                    const int64_t **strides, const int64_t *offsets)
+{
+    int64_t collapsed_strides[NW_ITERATOR_OPERANDS * MAX(rank, 1)];
+
+    iterator->operands = operands;
+    iterator->rank = runtime_collapse_dimensions(rank, shape, operands, strides, iterator->shape, collapsed_strides);
+    iterator->n = (iterator->rank) ? iterator->shape[iterator->rank - 1] : 1;
+    iterator->rows = 1;
+
+    for (int64_t j = 0; j < operands; ++j)
+    {
+        for (int64_t i = 0; i < iterator->rank; ++i)
+        {
+            iterator->strides[j * MAX_RANK + i] = collapsed_strides[j * rank + i];
+        }
+        iterator->offsets[j] = offsets[j];
+        iterator->inner_strides[j] = (iterator->rank) ? collapsed_strides[j * rank + iterator->rank - 1] : 0;
+    }
+
+    for (int64_t i = 0; i < iterator->rank - 1; ++i)
+    {
+        iterator->rows *= iterator->shape[i];
+        iterator->index[i] = 0;
+    }
+}
+
+/**
+ * @brief Advance the iterator to the next row.
+ * @param iterator The iterator to advance.
+ */
+static inline void runtime_iterator_next(runtime_iterator_t *iterator)
+{
+    runtime_next_row(iterator->rank, iterator->shape, iterator->operands, iterator->strides, MAX_RANK, iterator->index, iterator->offsets);
+}
+
+void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                   void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset)
+{
+    const int64_t *strides[] = {x_strides, y_strides};
+    const int64_t offsets[] = {x_offset, y_offset};
+    runtime_iterator_t iterator;
+
+    runtime_iterator_create(&iterator, rank, shape, 2, strides, offsets);
+    for (int64_t i = 0; i < iterator.rows; ++i)
+    {
+        runtime_unary_vector(unary_operation_type, runtime, datatype, iterator.n, 
+                             x_data, iterator.inner_strides[0], iterator.offsets[0], 
+                             y_data, iterator.inner_strides[1], iterator.offsets[1]);
+        runtime_iterator_next(&iterator);
+    }
+}
+
+void runtime_binary_elementwise(binary_operation_type_t binary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                                void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset,
+                                void *z_data, const int64_t *z_strides, int64_t z_offset)
+{
+    const int64_t *strides[] = {x_strides, y_strides, z_strides};
+    const int64_t offsets[] = {x_offset, y_offset, z_offset};
+    runtime_iterator_t iterator;
+
+    runtime_iterator_create(&iterator, rank, shape, 3, strides, offsets);
+    for (int64_t i = 0; i < iterator.rows; ++i)
+    {
+        runtime_binary_elementwise_vector(binary_operation_type, runtime, datatype, iterator.n, 
+                                          x_data, iterator.inner_strides[0], iterator.offsets[0], 
+                                          y_data, iterator.inner_strides[1], iterator.offsets[1],
+                                          z_data, iterator.inner_strides[2], iterator.offsets[2]);
+        runtime_iterator_next(&iterator);
+    }
+}
+
+static void runtime_scaled_addition_vector(runtime_t runtime, datatype_t datatype, int64_t n, const void *alpha,
+                                           void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset)
+{
+    switch (runtime)
+    {
+    case OPENBLAS_RUNTIME:
+        openblas_scaled_addition(datatype, n, alpha, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+        break;
+    case MKL_RUNTIME:
+        mkl_scaled_addition(datatype, n, alpha, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+        break;
+#ifndef CPU_ONLY
+    case CU_RUNTIME:
+        cu_scaled_addition(datatype, n, alpha, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Accumulate `alpha * x` into `y` in place (axpy). `y` must not broadcast along any dimension.
+ */
+void runtime_scaled_addition(runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape, const void *alpha,
+                             void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset)
+{
+    const int64_t *strides[] = {x_strides, y_strides};
+    const int64_t offsets[] = {x_offset, y_offset};
+    runtime_iterator_t iterator;
+
+    runtime_iterator_create(&iterator, rank, shape, 2, strides, offsets);
+    for (int64_t i = 0; i < iterator.rows; ++i)
+    {
+        runtime_scaled_addition_vector(runtime, datatype, iterator.n, alpha,
+                                       x_data, iterator.inner_strides[0], iterator.offsets[0],
+                                       y_data, iterator.inner_strides[1], iterator.offsets[1]);
+        runtime_iterator_next(&iterator);
+    }
+}
+
+static void runtime_unary_gradient_vector(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
+                                          void *x_data, int64_t x_stride, int64_t x_offset, void *dy_data, int64_t dy_stride, int64_t dy_offset,
+                                          void *dx_data, int64_t dx_stride, int64_t dx_offset)
+{
+    switch (runtime)
+    {
+    case OPENBLAS_RUNTIME:
+        switch (unary_operation_type)
+        {
+        case TANH_OPERATION:
+            openblas_tanh_gradient(datatype, n, x_data, x_stride, x_offset, dy_data, dy_stride, dy_offset, dx_data, dx_stride, dx_offset);
+            break;
+        case GELU_OPERATION:
+            openblas_gelu_gradient(datatype, n, x_data, x_stride, x_offset, dy_data, dy_stride, dy_offset, dx_data, dx_stride, dx_offset);
+            break;
+        default:
+            break;
+        }
+        break;
+    case MKL_RUNTIME:
+        switch (unary_operation_type)
+        {
+        case TANH_OPERATION:
+            mkl_tanh_gradient(datatype, n, x_data, x_stride, x_offset, dy_data, dy_stride, dy_offset, dx_data, dx_stride, dx_offset);
+            break;
+        case GELU_OPERATION:
+            mkl_gelu_gradient(datatype, n, x_data, x_stride, x_offset, dy_data, dy_stride, dy_offset, dx_data, dx_stride, dx_offset);
+            break;
+        default:
+            break;
+        }
+        break;
+#ifndef CPU_ONLY
+    case CU_RUNTIME:
+        switch (unary_operation_type)
+        {
+        case TANH_OPERATION:
+            cu_tanh_gradient(datatype, n, x_data, x_stride, x_offset, dy_data, dy_stride, dy_offset, dx_data, dx_stride, dx_offset);
+            break;
+        case GELU_OPERATION:
+            cu_gelu_gradient(datatype, n, x_data, x_stride, x_offset, dy_data, dy_stride, dy_offset, dx_data, dx_stride, dx_offset);
+            break;
+        default:
+            break;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+void runtime_unary_gradient(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                            void *x_data, const int64_t *x_strides, int64_t x_offset, void *dy_data, const int64_t *dy_strides, int64_t dy_offset,
+                            void *dx_data, const int64_t *dx_strides, int64_t dx_offset)
+{
+    const int64_t *strides[] = {x_strides, dy_strides, dx_strides};
+    const int64_t offsets[] = {x_offset, dy_offset, dx_offset};
+    runtime_iterator_t iterator;
+
+    runtime_iterator_create(&iterator, rank, shape, 3, strides, offsets);
+    for (int64_t i = 0; i < iterator.rows; ++i)
+    {
+        runtime_unary_gradient_vector(unary_operation_type, runtime, datatype, iterator.n, 
+                                      x_data, iterator.inner_strides[0], iterator.offsets[0], 
+                                      dy_data, iterator.inner_strides[1], iterator.offsets[1],
+                                      dx_data, iterator.inner_strides[2], iterator.offsets[2]);
+        runtime_iterator_next(&iterator);
+    }
+}
+
+static void runtime_batched_matrix_multiplication(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t m, int64_t k, int64_t n,
+                                                  bool_t x_transpose, bool_t y_transpose,
+                                                  void *x_data, int64_t x_offset, int64_t x_leading_dimension, int64_t x_batch_stride,
+                                                  void *y_data, int64_t y_offset, int64_t y_leading_dimension, int64_t y_batch_stride,
+                                                  void *z_data, int64_t z_offset, int64_t z_leading_dimension, int64_t z_batch_stride)
+{
+    switch (runtime)
+    {
+    case OPENBLAS_RUNTIME:
+        openblas_batched_matrix_multiplication(datatype, batch_size, m, k, n, x_transpose, y_transpose,
+                                               x_data, x_offset, x_leading_dimension, x_batch_stride, 
+                                               y_data, y_offset, y_leading_dimension, y_batch_stride, 
+                                               z_data, z_offset, z_leading_dimension, z_batch_stride);
+        break;
+    case MKL_RUNTIME:
+        mkl_batched_matrix_multiplication(datatype, batch_size, m, k, n, x_transpose, y_transpose,
+                                          x_data, x_offset, x_leading_dimension, x_batch_stride, 
+                                          y_data, y_offset, y_leading_dimension, y_batch_stride, 
+                                          z_data, z_offset, z_leading_dimension, z_batch_stride);
+        break;
+#ifndef CPU_ONLY
+    case CU_RUNTIME:
+        for (int64_t i = 0; i < batch_size; ++i)
+        {
+            cu_matrix_multiplication(datatype, m, k, n, x_transpose, y_transpose,
+                                     x_data, x_offset + i * x_batch_stride, x_leading_dimension,
+                                     y_data, y_offset + i * y_batch_stride, y_leading_dimension,
+                                     z_data, z_offset + i * z_batch_stride, z_leading_dimension);
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+void runtime_matrix_multiplication(runtime_t runtime, datatype_t datatype, int64_t batch_rank, const int64_t *batch_shape, 
+                                   int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose,
+                                   void *x_data, const int64_t *x_batch_strides, int64_t x_offset, int64_t x_leading_dimension,
+                                   void *y_data, const int64_t *y_batch_strides, int64_t y_offset, int64_t y_leading_dimension,
+                                   void *z_data, const int64_t *z_batch_strides, int64_t z_offset, int64_t z_leading_dimension)
+{
+    const int64_t *strides[] = {x_batch_strides, y_batch_strides, z_batch_strides};
+    const int64_t offsets[] = {x_offset, y_offset, z_offset};
+    runtime_iterator_t iterator;
+
+    // The innermost collapsed batch dimension is a uniformly strided batch, broadcast operands keep a zero stride.
+    runtime_iterator_create(&iterator, batch_rank, batch_shape, 3, strides, offsets);
+    for (int64_t i = 0; i < iterator.rows; ++i)
+    {
+        runtime_batched_matrix_multiplication(runtime, datatype, iterator.n, m, k, n, x_transpose, y_transpose,
+                                              x_data, iterator.offsets[0], x_leading_dimension, iterator.inner_strides[0],
+                                              y_data, iterator.offsets[1], y_leading_dimension, iterator.inner_strides[1],
+                                              z_data, iterator.offsets[2], z_leading_dimension, iterator.inner_strides[2]);
+        runtime_iterator_next(&iterator);
+    }
+}
+
+static void runtime_where(runtime_t runtime, datatype_t datatype, int64_t n,
+                          void *w_data, int64_t w_stride, int64_t w_offset, void *x_data, int64_t x_stride, int64_t x_offset, 
+                          void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
 {
     switch (runtime)
     {
@@ -403,9 +1329,9 @@ void runtime_where(runtime_t runtime, datatype_t datatype, int64_t n,
     }
 }
 
-void runtime_ternary(ternary_operation_type_t ternary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
-                     void *w_data, int64_t w_stride, int64_t w_offset, void *x_data, int64_t x_stride, int64_t x_offset, 
-                     void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
+static void runtime_ternary_vector(ternary_operation_type_t ternary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
+                                   void *w_data, int64_t w_stride, int64_t w_offset, void *x_data, int64_t x_stride, int64_t x_offset, 
+                                   void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset)
 {
     switch (ternary_operation_type)
     {
@@ -417,129 +1343,2648 @@ void runtime_ternary(ternary_operation_type_t ternary_operation_type, runtime_t
     }
 }
 
-void runtime_reduction(reduction_operation_type_t reduction_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
-                       void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_offset)
+void runtime_ternary(ternary_operation_type_t ternary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                     void *w_data, const int64_t *w_strides, int64_t w_offset, void *x_data, const int64_t *x_strides, int64_t x_offset, 
+                     void *y_data, const int64_t *y_strides, int64_t y_offset, void *z_data, const int64_t *z_strides, int64_t z_offset)
 {
-    switch (runtime)
+    const int64_t *strides[] = {w_strides, x_strides, y_strides, z_strides};
+    const int64_t offsets[] = {w_offset, x_offset, y_offset, z_offset};
+    runtime_iterator_t iterator;
+
+    runtime_iterator_create(&iterator, rank, shape, 4, strides, offsets);
+    for (int64_t i = 0; i < iterator.rows; ++i)
     {
-    case OPENBLAS_RUNTIME:
-        switch (reduction_operation_type)
+        runtime_ternary_vector(ternary_operation_type, runtime, datatype, iterator.n, 
+                               w_data, iterator.inner_strides[0], iterator.offsets[0], 
+                               x_data, iterator.inner_strides[1], iterator.offsets[1],
+                               y_data, iterator.inner_strides[2], iterator.offsets[2],
+                               z_data, iterator.inner_strides[3], iterator.offsets[3]);
+        runtime_iterator_next(&iterator);
+    }
+}
+
+static int64_t runtime_reduction_product(int64_t rank, const int64_t *shape)
+{
+    int64_t product = 1;
+
+    for (int64_t i = 0; i < rank; ++i)
+    {
+        product *= shape[i];
+    }
+
+    return product;
+}
+
+static void runtime_reduction_float32(bool_t summation, bool_t vector, 
+                                      int64_t output_rank, const int64_t *output_shape, const int64_t *output_strides, int64_t output_stride_rank,
+                                      int64_t reduction_rank, const int64_t *reduction_shape, const int64_t *reduction_strides,
+                                      const float32_t *x_data, float32_t *y_data)
+{
+    int64_t m = reduction_shape[reduction_rank - 1];
+    int64_t reduction_stride = reduction_strides[reduction_rank - 1];
+    int64_t slices = runtime_reduction_product(reduction_rank - 1, reduction_shape);
+
+    if (!vector)
+    {
+        // The innermost reduction axis is the fastest moving one, each output is one contiguous pass.
+        int64_t outputs = runtime_reduction_product(output_rank, output_shape);
+        bool_t parallel = outputs > 1 && outputs * m * slices >= NW_PARALLEL_THRESHOLD;
+
+        #pragma omp parallel for if (parallel)
+        for (int64_t i = 0; i < outputs; ++i)
         {
-        case MAXIMUM_OPERATION:
-            openblas_maximum(datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            break;
-        case SUMMATION_OPERATION:
-            openblas_summation(datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            break;
-        default:
-            break;
+            int64_t offsets[2];
+            int64_t index[reduction_rank];
+            int64_t x_offset;
+            float32_t accumulator;
+
+            runtime_index_offsets(i, output_rank, output_shape, 2, output_strides, output_stride_rank, offsets);
+            x_offset = offsets[0];
+            accumulator = (summation) ? (float32_t) 0.0 : x_data[x_offset];
+            for (int64_t j = 0; j < reduction_rank; ++j)
+            {
+                index[j] = 0;
+            }
+
+            for (int64_t j = 0; j < slices; ++j)
+            {
+                const float32_t *slice = &x_data[x_offset];
+                if (summation)
+                {
+                    #pragma omp parallel for simd reduction(+:accumulator) if (!parallel && m >= NW_PARALLEL_THRESHOLD)
+                    for (int64_t k = 0; k < m; ++k)
+                    {
+                        accumulator += slice[k * reduction_stride];
+                    }
+                }
+                else
+                {
+                    #pragma omp parallel for simd reduction(max:accumulator) if (!parallel && m >= NW_PARALLEL_THRESHOLD)
+                    for (int64_t k = 0; k < m; ++k)
+                    {
+                        float32_t candidate = slice[k * reduction_stride];
+                        if (accumulator < candidate)
+                        {
+                            accumulator = candidate;
+                        }
+                    }
+                }
+                runtime_next_row(reduction_rank, reduction_shape, 1, reduction_strides, reduction_rank, index, &x_offset);
+            }
+
+            y_data[offsets[1]] = accumulator;
         }
-        break;
-    case MKL_RUNTIME:
-        switch (reduction_operation_type)
+    }
+    else
+    {
+        // An output axis is the fastest moving one, so accumulate a block of neighbouring outputs
+        // at once and stream over the reduced axes one contiguous slice at a time.
+        int64_t n = output_shape[output_rank - 1];
+        int64_t x_stride = output_strides[output_rank - 1];
+        int64_t y_stride = output_strides[output_stride_rank + output_rank - 1];
+        int64_t rows = runtime_reduction_product(output_rank - 1, output_shape);
+        int64_t blocks = (n + NW_REDUCTION_BLOCK_SIZE - 1) / NW_REDUCTION_BLOCK_SIZE;
+
+        #pragma omp parallel for if (rows * blocks > 1 && rows * n * m * slices >= NW_PARALLEL_THRESHOLD)
+        for (int64_t i = 0; i < rows * blocks; ++i)
         {
-        case MAXIMUM_OPERATION:
-            mkl_maximum(datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            break;
-        case SUMMATION_OPERATION:
-            mkl_summation(datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            break;
+            int64_t offsets[2];
+            int64_t index[reduction_rank];
+            int64_t x_offset = 0;
+            int64_t start = (i % blocks) * NW_REDUCTION_BLOCK_SIZE;
+            int64_t length = MIN(NW_REDUCTION_BLOCK_SIZE, n - start);
+            float32_t accumulator[NW_REDUCTION_BLOCK_SIZE];
+
+            runtime_index_offsets(i / blocks, output_rank - 1, output_shape, 2, output_strides, output_stride_rank, offsets);
+            const float32_t *x = &x_data[offsets[0] + start * x_stride];
+            for (int64_t j = 0; j < length; ++j)
+            {
+                accumulator[j] = (summation) ? (float32_t) 0.0 : x[j * x_stride];
+            }
+            for (int64_t j = 0; j < reduction_rank; ++j)
+            {
+                index[j] = 0;
+            }
+
+            for (int64_t j = 0; j < slices; ++j)
+            {
+                for (int64_t k = 0; k < m; ++k)
+                {
+                    const float32_t *slice = &x[x_offset + k * reduction_stride];
+                    if (summation)
+                    {
+                        #pragma omp simd
+                        for (int64_t l = 0; l < length; ++l)
+                        {
+                            accumulator[l] += slice[l * x_stride];
+                        }
+                    }
+                    else
+                    {
+                        #pragma omp simd
+                        for (int64_t l = 0; l < length; ++l)
+                        {
+                            float32_t candidate = slice[l * x_stride];
+                            accumulator[l] = (accumulator[l] < candidate) ? candidate : accumulator[l];
+                        }
+                    }
+                }
+                runtime_next_row(reduction_rank, reduction_shape, 1, reduction_strides, reduction_rank, index, &x_offset);
+            }
+
+            for (int64_t j = 0; j < length; ++j)
+            {
+                y_data[offsets[1] + (start + j) * y_stride] = accumulator[j];
+            }
+        }
+    }
+}
+
+static void runtime_reduction_float64(bool_t summation, bool_t vector, 
+                                      int64_t output_rank, const int64_t *output_shape, const int64_t *output_strides, int64_t output_stride_rank,
+                                      int64_t reduction_rank, const int64_t *reduction_shape, const int64_t *reduction_strides,
+                                      const float64_t *x_data, float64_t *y_data)
+{
+    int64_t m = reduction_shape[reduction_rank - 1];
+    int64_t reduction_stride = reduction_strides[reduction_rank - 1];
+    int64_t slices = runtime_reduction_product(reduction_rank - 1, reduction_shape);
+
+    if (!vector)
+    {
+        // The innermost reduction axis is the fastest moving one, each output is one contiguous pass.
+        int64_t outputs = runtime_reduction_product(output_rank, output_shape);
+        bool_t parallel = outputs > 1 && outputs * m * slices >= NW_PARALLEL_THRESHOLD;
+
+        #pragma omp parallel for if (parallel)
+        for (int64_t i = 0; i < outputs; ++i)
+        {
+            int64_t offsets[2];
+            int64_t index[reduction_rank];
+            int64_t x_offset;
+            float64_t accumulator;
+
+            runtime_index_offsets(i, output_rank, output_shape, 2, output_strides, output_stride_rank, offsets);
+            x_offset = offsets[0];
+            accumulator = (summation) ? (float64_t) 0.0 : x_data[x_offset];
+            for (int64_t j = 0; j < reduction_rank; ++j)
+            {
+                index[j] = 0;
+            }
+
+            for (int64_t j = 0; j < slices; ++j)
+            {
+                const float64_t *slice = &x_data[x_offset];
+                if (summation)
+                {
+                    #pragma omp parallel for simd reduction(+:accumulator) if (!parallel && m >= NW_PARALLEL_THRESHOLD)
+                    for (int64_t k = 0; k < m; ++k)
+                    {
+                        accumulator += slice[k * reduction_stride];
+                    }
+                }
+                else
+                {
+                    #pragma omp parallel for simd reduction(max:accumulator) if (!parallel && m >= NW_PARALLEL_THRESHOLD)
+                    for (int64_t k = 0; k < m; ++k)
+                    {
+                        float64_t candidate = slice[k * reduction_stride];
+                        if (accumulator < candidate)
+                        {
+                            accumulator = candidate;
+                        }
+                    }
+                }
+                runtime_next_row(reduction_rank, reduction_shape, 1, reduction_strides, reduction_rank, index, &x_offset);
+            }
+
+            y_data[offsets[1]] = accumulator;
+        }
+    }
+    else
+    {
+        // An output axis is the fastest moving one, so accumulate a block of neighbouring outputs
+        // at once and stream over the reduced axes one contiguous slice at a time.
+        int64_t n = output_shape[output_rank - 1];
+        int64_t x_stride = output_strides[output_rank - 1];
+        int64_t y_stride = output_strides[output_stride_rank + output_rank - 1];
+        int64_t rows = runtime_reduction_product(output_rank - 1, output_shape);
+        int64_t blocks = (n + NW_REDUCTION_BLOCK_SIZE - 1) / NW_REDUCTION_BLOCK_SIZE;
+
+        #pragma omp parallel for if (rows * blocks > 1 && rows * n * m * slices >= NW_PARALLEL_THRESHOLD)
+        for (int64_t i = 0; i < rows * blocks; ++i)
+        {
+            int64_t offsets[2];
+            int64_t index[reduction_rank];
+            int64_t x_offset = 0;
+            int64_t start = (i % blocks) * NW_REDUCTION_BLOCK_SIZE;
+            int64_t length = MIN(NW_REDUCTION_BLOCK_SIZE, n - start);
+            float64_t accumulator[NW_REDUCTION_BLOCK_SIZE];
+
+            runtime_index_offsets(i / blocks, output_rank - 1, output_shape, 2, output_strides, output_stride_rank, offsets);
+            const float64_t *x = &x_data[offsets[0] + start * x_stride];
+            for (int64_t j = 0; j < length; ++j)
+            {
+                accumulator[j] = (summation) ? (float64_t) 0.0 : x[j * x_stride];
+            }
+            for (int64_t j = 0; j < reduction_rank; ++j)
+            {
+                index[j] = 0;
+            }
+
+            for (int64_t j = 0; j < slices; ++j)
+            {
+                for (int64_t k = 0; k < m; ++k)
+                {
+                    const float64_t *slice = &x[x_offset + k * reduction_stride];
+                    if (summation)
+                    {
+                        #pragma omp simd
+                        for (int64_t l = 0; l < length; ++l)
+                        {
+                            accumulator[l] += slice[l * x_stride];
+                        }
+                    }
+                    else
+                    {
+                        #pragma omp simd
+                        for (int64_t l = 0; l < length; ++l)
+                        {
+                            float64_t candidate = slice[l * x_stride];
+                            accumulator[l] = (accumulator[l] < candidate) ? candidate : accumulator[l];
+                        }
+                    }
+                }
+                runtime_next_row(reduction_rank, reduction_shape, 1, reduction_strides, reduction_rank, index, &x_offset);
+            }
+
+            for (int64_t j = 0; j < length; ++j)
+            {
+                y_data[offsets[1] + (start + j) * y_stride] = accumulator[j];
+            }
+        }
+    }
+}
+
+void runtime_reduction(reduction_operation_type_t reduction_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                       void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset)
+{
+    int64_t length = MAX(rank, 1);
+    int64_t output_count = 0;
+    int64_t reduction_count = 0;
+    int64_t output_shape[length];
+    int64_t output_x_strides[length];
+    int64_t output_y_strides[length];
+    int64_t reduction_shape[length];
+    int64_t reduction_x_strides[length];
+    int64_t collapsed_output_shape[length];
+    int64_t collapsed_output_strides[2 * length];
+    int64_t collapsed_reduction_shape[length];
+    int64_t collapsed_reduction_strides[length];
+
+    // Either set of axes may be empty, keep the scratch arrays defined when nothing is written to them.
+    memset(output_shape, 0, sizeof(output_shape));
+    memset(reduction_shape, 0, sizeof(reduction_shape));
+    memset(collapsed_output_strides, 0, sizeof(collapsed_output_strides));
+    memset(collapsed_reduction_strides, 0, sizeof(collapsed_reduction_strides));
+
+    // Axes with a zero stride in y are reduced, every other axis indexes an output.
+    for (int64_t i = 0; i < rank; ++i)
+    {
+        if (y_strides[i])
+        {
+            output_shape[output_count] = shape[i];
+            output_x_strides[output_count] = x_strides[i];
+            output_y_strides[output_count] = y_strides[i];
+            ++output_count;
+        }
+        else
+        {
+            reduction_shape[reduction_count] = shape[i];
+            reduction_x_strides[reduction_count] = x_strides[i];
+            ++reduction_count;
+        }
+    }
+
+    const int64_t *output_strides[] = {output_x_strides, output_y_strides};
+    const int64_t *reduction_strides[] = {reduction_x_strides};
+    int64_t output_rank = runtime_collapse_dimensions(output_count, output_shape, 2, output_strides, 
+                                                      collapsed_output_shape, collapsed_output_strides);
+    int64_t reduction_rank = runtime_collapse_dimensions(reduction_count, reduction_shape, 1, reduction_strides, 
+                                                         collapsed_reduction_shape, collapsed_reduction_strides);
+
+    // Move the axis with the smallest x stride of each set innermost.
+    for (int64_t i = 0; i + 1 < output_rank; ++i)
+    {
+        if (llabs(collapsed_output_strides[i]) < llabs(collapsed_output_strides[output_rank - 1]))
+        {
+            int64_t temp = collapsed_output_shape[i];
+            collapsed_output_shape[i] = collapsed_output_shape[output_rank - 1];
+            collapsed_output_shape[output_rank - 1] = temp;
+            for (int64_t j = 0; j < 2; ++j)
+            {
+                temp = collapsed_output_strides[j * output_count + i];
+                collapsed_output_strides[j * output_count + i] = collapsed_output_strides[j * output_count + output_rank - 1];
+                collapsed_output_strides[j * output_count + output_rank - 1] = temp;
+            }
+        }
+    }
+
+    for (int64_t i = 0; i + 1 < reduction_rank; ++i)
+    {
+        if (llabs(collapsed_reduction_strides[i]) < llabs(collapsed_reduction_strides[reduction_rank - 1]))
+        {
+            int64_t temp = collapsed_reduction_shape[i];
+            collapsed_reduction_shape[i] = collapsed_reduction_shape[reduction_rank - 1];
+            collapsed_reduction_shape[reduction_rank - 1] = temp;
+            temp = collapsed_reduction_strides[i];
+            collapsed_reduction_strides[i] = collapsed_reduction_strides[reduction_rank - 1];
+            collapsed_reduction_strides[reduction_rank - 1] = temp;
+        }
+    }
+
+    if (!reduction_rank)
+    {
+        collapsed_reduction_shape[0] = 1;
+        collapsed_reduction_strides[0] = 0;
+        reduction_rank = 1;
+    }
+
+    bool_t summation = reduction_operation_type == SUMMATION_OPERATION;
+    bool_t vector = output_rank > 0 && llabs(collapsed_output_strides[output_rank - 1]) < llabs(collapsed_reduction_strides[reduction_rank - 1]);
+
+    switch (runtime)
+    {
+#ifndef CPU_ONLY
+    case CU_RUNTIME:
+        if (!vector && reduction_rank == 1)
+        {
+            int64_t outputs = runtime_reduction_product(output_rank, collapsed_output_shape);
+            for (int64_t i = 0; i < outputs; ++i)
+            {
+                int64_t offsets[2];
+                runtime_index_offsets(i, output_rank, collapsed_output_shape, 2, collapsed_output_strides, output_count, offsets);
+                if (summation)
+                {
+                    cu_summation(datatype, collapsed_reduction_shape[0], x_data, collapsed_reduction_strides[0], x_offset + offsets[0], y_data, y_offset + offsets[1]);
+                }
+                else
+                {
+                    cu_maximum(datatype, collapsed_reduction_shape[0], x_data, collapsed_reduction_strides[0], x_offset + offsets[0], y_data, y_offset + offsets[1]);
+                }
+            }
+            break;
+        }
+        // Storage is managed memory, so reductions over several strided axes fall back to the host.
+        cu_synchronize();
+        // fall through
+#endif
+    case OPENBLAS_RUNTIME:
+    case MKL_RUNTIME:
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_reduction_float32(summation, vector, output_rank, collapsed_output_shape, collapsed_output_strides, output_count,
+                                      reduction_rank, collapsed_reduction_shape, collapsed_reduction_strides,
+                                      &((float32_t *) x_data)[x_offset], &((float32_t *) y_data)[y_offset]);
+            break;
+        case FLOAT64:
+            runtime_reduction_float64(summation, vector, output_rank, collapsed_output_shape, collapsed_output_strides, output_count,
+                                      reduction_rank, collapsed_reduction_shape, collapsed_reduction_strides,
+                                      &((float64_t *) x_data)[x_offset], &((float64_t *) y_data)[y_offset]);
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void runtime_softmax_float32(int64_t n, bool_t logarithm, const float32_t *x_data, int64_t x_stride, float32_t *y_data, int64_t y_stride)
+{
+    // Online maximum and normalizer, the sum is rescaled whenever a new maximum is found.
+    float32_t maximum = x_data[0];
+    float32_t sum = (float32_t) 1.0;
+    for (int64_t i = 1; i < n; ++i)
+    {
+        float32_t value = x_data[i * x_stride];
+        if (value > maximum)
+        {
+            sum = sum * expf(maximum - value) + (float32_t) 1.0;
+            maximum = value;
+        }
+        else
+        {
+            sum += expf(value - maximum);
+        }
+    }
+
+    if (logarithm)
+    {
+        float32_t shift = maximum + logf(sum);
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            y_data[i * y_stride] = x_data[i * x_stride] - shift;
+        }
+    }
+    else
+    {
+        float32_t scale = (float32_t) 1.0 / sum;
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            y_data[i * y_stride] = expf(x_data[i * x_stride] - maximum) * scale;
+        }
+    }
+}
+
+static void runtime_softmax_float64(int64_t n, bool_t logarithm, const float64_t *x_data, int64_t x_stride, float64_t *y_data, int64_t y_stride)
+{
+    float64_t maximum = x_data[0];
+    float64_t sum = (float64_t) 1.0;
+    for (int64_t i = 1; i < n; ++i)
+    {
+        float64_t value = x_data[i * x_stride];
+        if (value > maximum)
+        {
+            sum = sum * exp(maximum - value) + (float64_t) 1.0;
+            maximum = value;
+        }
+        else
+        {
+            sum += exp(value - maximum);
+        }
+    }
+
+    if (logarithm)
+    {
+        float64_t shift = maximum + log(sum);
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            y_data[i * y_stride] = x_data[i * x_stride] - shift;
+        }
+    }
+    else
+    {
+        float64_t scale = (float64_t) 1.0 / sum;
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            y_data[i * y_stride] = exp(x_data[i * x_stride] - maximum) * scale;
+        }
+    }
+}
+
+static void runtime_softmax_backward_float32(int64_t n, bool_t logarithm, const float32_t *y_data, int64_t y_stride, 
+                                             const float32_t *dy_data, int64_t dy_stride, float32_t *dx_data, int64_t dx_stride)
+{
+    float32_t sum = (float32_t) 0.0;
+
+    if (logarithm)
+    {
+        // dx = dy - softmax(x) * sum(dy)
+        #pragma omp simd reduction(+:sum)
+        for (int64_t i = 0; i < n; ++i)
+        {
+            sum += dy_data[i * dy_stride];
+        }
+
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            dx_data[i * dx_stride] = dy_data[i * dy_stride] - expf(y_data[i * y_stride]) * sum;
+        }
+    }
+    else
+    {
+        // dx = y * (dy - sum(dy * y))
+        #pragma omp simd reduction(+:sum)
+        for (int64_t i = 0; i < n; ++i)
+        {
+            sum += dy_data[i * dy_stride] * y_data[i * y_stride];
+        }
+
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            dx_data[i * dx_stride] = y_data[i * y_stride] * (dy_data[i * dy_stride] - sum);
+        }
+    }
+}
+
+static void runtime_softmax_backward_float64(int64_t n, bool_t logarithm, const float64_t *y_data, int64_t y_stride, 
+                                             const float64_t *dy_data, int64_t dy_stride, float64_t *dx_data, int64_t dx_stride)
+{
+    float64_t sum = (float64_t) 0.0;
+
+    if (logarithm)
+    {
+        #pragma omp simd reduction(+:sum)
+        for (int64_t i = 0; i < n; ++i)
+        {
+            sum += dy_data[i * dy_stride];
+        }
+
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            dx_data[i * dx_stride] = dy_data[i * dy_stride] - exp(y_data[i * y_stride]) * sum;
+        }
+    }
+    else
+    {
+        #pragma omp simd reduction(+:sum)
+        for (int64_t i = 0; i < n; ++i)
+        {
+            sum += dy_data[i * dy_stride] * y_data[i * y_stride];
+        }
+
+        #pragma omp simd
+        for (int64_t i = 0; i < n; ++i)
+        {
+            dx_data[i * dx_stride] = y_data[i * y_stride] * (dy_data[i * dy_stride] - sum);
+        }
+    }
+}
+
+/**
+ * @brief Collapse every axis except `axis` of a softmax iteration space.
+ * @param rank Rank of the operands.
+ * @param shape Shape of the operands.
+ * @param axis The softmax axis.
+ * @param operands Number of operands.
+ * @param strides The strides of each operand.
+ * @param collapsed_shape The collapsed shape of the outer axes.
+ * @param collapsed_strides The collapsed outer strides laid out as `operands` rows of `rank` entries.
+ * @param axis_strides The stride of each operand along `axis`.
+ * @param n Length of `axis`.
+ * @param rows Number of independent rows.
+ * @return The collapsed rank of the outer axes.
+ */
+static int64_t runtime_softmax_rows(int64_t rank, const int64_t *shape, int64_t axis, int64_t operands, const int64_t **strides,
+                                    int64_t *collapsed_shape, int64_t *collapsed_strides, int64_t *axis_strides, int64_t *n, int64_t *rows)
+{
+    int64_t length = MAX(rank, 1);
+    int64_t outer_shape[length];
+    int64_t outer_strides[operands][length];
+    const int64_t *outer_stride_pointers[operands];
+
+    for (int64_t i = 0; i < rank; ++i)
+    {
+        outer_shape[i] = (i == axis) ? 1 : shape[i];
+        for (int64_t j = 0; j < operands; ++j)
+        {
+            outer_strides[j][i] = strides[j][i];
+        }
+    }
+
+    for (int64_t j = 0; j < operands; ++j)
+    {
+        outer_stride_pointers[j] = outer_strides[j];
+        axis_strides[j] = (rank) ? strides[j][axis] : 0;
+    }
+
+    *n = (rank) ? shape[axis] : 1;
+    int64_t collapsed_rank = runtime_collapse_dimensions(rank, outer_shape, operands, outer_stride_pointers, collapsed_shape, collapsed_strides);
+    *rows = 1;
+    for (int64_t i = 0; i < collapsed_rank; ++i)
+    {
+        *rows *= collapsed_shape[i];
+    }
+
+    return collapsed_rank;
+}
+
+void runtime_softmax(runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape, int64_t axis, bool_t logarithm,
+                     void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset)
+{
+    int64_t operands = 2;
+    int64_t length = MAX(rank, 1);
+    const int64_t *strides[] = {x_strides, y_strides};
+    int64_t collapsed_shape[length];
+    int64_t collapsed_strides[operands * length];
+    int64_t axis_strides[operands];
+    int64_t n, rows;
+    int64_t collapsed_rank = runtime_softmax_rows(rank, shape, axis, operands, strides, collapsed_shape, collapsed_strides, axis_strides, &n, &rows);
+
+#ifndef CPU_ONLY
+    if (runtime == CU_RUNTIME)
+    {
+        // Storage is managed memory, the rows are normalized on the host.
+        cu_synchronize();
+    }
+#else
+    (void) runtime;
+#endif
+
+    #pragma omp parallel for if (rows > 1 && rows * n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < rows; ++i)
+    {
+        int64_t offsets[operands];
+        runtime_index_offsets(i, collapsed_rank, collapsed_shape, operands, collapsed_strides, length, offsets);
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_softmax_float32(n, logarithm, &((float32_t *) x_data)[x_offset + offsets[0]], axis_strides[0],
+                                    &((float32_t *) y_data)[y_offset + offsets[1]], axis_strides[1]);
+            break;
+        case FLOAT64:
+            runtime_softmax_float64(n, logarithm, &((float64_t *) x_data)[x_offset + offsets[0]], axis_strides[0],
+                                    &((float64_t *) y_data)[y_offset + offsets[1]], axis_strides[1]);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void runtime_softmax_backward(runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape, int64_t axis, bool_t logarithm,
+                              void *y_data, const int64_t *y_strides, int64_t y_offset, void *dy_data, const int64_t *dy_strides, int64_t dy_offset,
+                              void *dx_data, const int64_t *dx_strides, int64_t dx_offset)
+{
+    int64_t operands = 3;
+    int64_t length = MAX(rank, 1);
+    const int64_t *strides[] = {y_strides, dy_strides, dx_strides};
+    int64_t collapsed_shape[length];
+    int64_t collapsed_strides[operands * length];
+    int64_t axis_strides[operands];
+    int64_t n, rows;
+    int64_t collapsed_rank = runtime_softmax_rows(rank, shape, axis, operands, strides, collapsed_shape, collapsed_strides, axis_strides, &n, &rows);
+
+#ifndef CPU_ONLY
+    if (runtime == CU_RUNTIME)
+    {
+        cu_synchronize();
+    }
+#else
+    (void) runtime;
+#endif
+
+    #pragma omp parallel for if (rows > 1 && rows * n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < rows; ++i)
+    {
+        int64_t offsets[operands];
+        runtime_index_offsets(i, collapsed_rank, collapsed_shape, operands, collapsed_strides, length, offsets);
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_softmax_backward_float32(n, logarithm, &((float32_t *) y_data)[y_offset + offsets[0]], axis_strides[0],
+                                             &((float32_t *) dy_data)[dy_offset + offsets[1]], axis_strides[1],
+                                             &((float32_t *) dx_data)[dx_offset + offsets[2]], axis_strides[2]);
+            break;
+        case FLOAT64:
+            runtime_softmax_backward_float64(n, logarithm, &((float64_t *) y_data)[y_offset + offsets[0]], axis_strides[0],
+                                             &((float64_t *) dy_data)[dy_offset + offsets[1]], axis_strides[1],
+                                             &((float64_t *) dx_data)[dx_offset + offsets[2]], axis_strides[2]);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void runtime_convolution_2d_range(int64_t k, int64_t stride, int64_t padding, int64_t size, int64_t output_size, int64_t *begin, int64_t *end)
+{
+    // Outputs whose receptive field at kernel offset k lands inside the image, the rest read padding.
+    int64_t lower = padding - k;
+    int64_t upper = size - 1 + padding - k;
+    *begin = (lower > 0) ? MIN((lower + stride - 1) / stride, output_size) : 0;
+    *end = (upper >= 0) ? MIN(upper / stride + 1, output_size) : 0;
+    *end = MAX(*begin, *end);
+}
+
+static void runtime_image_to_column_float32(const float32_t *x_data, int64_t batch_size, int64_t channels, int64_t height, int64_t width,
+                                            int64_t kernel_size, int64_t output_height, int64_t output_width, int64_t stride, int64_t padding,
+                                            float32_t *y_data, float32_t padding_value)
+{
+    int64_t area = kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+
+    #pragma omp parallel for collapse(2) if (batch_size * channels * area * size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t c = 0; c < channels; ++c)
+        {
+            const float32_t *x_plane = &x_data[(b * channels + c) * height * width];
+            float32_t *y_rows = &y_data[(b * channels + c) * area * size];
+            for (int64_t kh = 0; kh < kernel_size; ++kh)
+            {
+                int64_t h_begin, h_end;
+                runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                for (int64_t kw = 0; kw < kernel_size; ++kw)
+                {
+                    int64_t w_begin, w_end;
+                    int64_t shift = kw - padding;
+                    float32_t *y_plane = &y_rows[(kh * kernel_size + kw) * size];
+                    runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                    for (int64_t h = 0; h < output_height; ++h)
+                    {
+                        float32_t *y_row = &y_plane[h * output_width];
+                        if (h < h_begin || h >= h_end)
+                        {
+                            for (int64_t w = 0; w < output_width; ++w)
+                            {
+                                y_row[w] = padding_value;
+                            }
+                            continue;
+                        }
+
+                        const float32_t *x_row = &x_plane[(h * stride + kh - padding) * width];
+                        for (int64_t w = 0; w < w_begin; ++w)
+                        {
+                            y_row[w] = padding_value;
+                        }
+
+                        if (stride == 1 && w_end > w_begin)
+                        {
+                            memcpy(&y_row[w_begin], &x_row[w_begin + shift], (w_end - w_begin) * sizeof(float32_t));
+                        }
+                        else
+                        {
+                            #pragma omp simd
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                y_row[w] = x_row[w * stride + shift];
+                            }
+                        }
+
+                        for (int64_t w = w_end; w < output_width; ++w)
+                        {
+                            y_row[w] = padding_value;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_column_to_image_float32(const float32_t *x_data, int64_t batch_size, int64_t channels, int64_t height, int64_t width,
+                                            int64_t kernel_size, int64_t output_height, int64_t output_width, int64_t stride, int64_t padding,
+                                            float32_t *y_data)
+{
+    int64_t area = kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+
+    // All column rows of a channel fold back into that channel's plane, so a thread per plane accumulates without races.
+    #pragma omp parallel for collapse(2) if (batch_size * channels * area * size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t c = 0; c < channels; ++c)
+        {
+            const float32_t *x_rows = &x_data[(b * channels + c) * area * size];
+            float32_t *y_plane = &y_data[(b * channels + c) * height * width];
+            for (int64_t kh = 0; kh < kernel_size; ++kh)
+            {
+                int64_t h_begin, h_end;
+                runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                for (int64_t kw = 0; kw < kernel_size; ++kw)
+                {
+                    int64_t w_begin, w_end;
+                    int64_t shift = kw - padding;
+                    const float32_t *x_plane = &x_rows[(kh * kernel_size + kw) * size];
+                    runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                    for (int64_t h = h_begin; h < h_end; ++h)
+                    {
+                        const float32_t *x_row = &x_plane[h * output_width];
+                        float32_t *y_row = &y_plane[(h * stride + kh - padding) * width];
+                        #pragma omp simd
+                        for (int64_t w = w_begin; w < w_end; ++w)
+                        {
+                            y_row[w * stride + shift] += x_row[w];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_image_to_column_float64(const float64_t *x_data, int64_t batch_size, int64_t channels, int64_t height, int64_t width,
+                                            int64_t kernel_size, int64_t output_height, int64_t output_width, int64_t stride, int64_t padding,
+                                            float64_t *y_data, float64_t padding_value)
+{
+    int64_t area = kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+
+    #pragma omp parallel for collapse(2) if (batch_size * channels * area * size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t c = 0; c < channels; ++c)
+        {
+            const float64_t *x_plane = &x_data[(b * channels + c) * height * width];
+            float64_t *y_rows = &y_data[(b * channels + c) * area * size];
+            for (int64_t kh = 0; kh < kernel_size; ++kh)
+            {
+                int64_t h_begin, h_end;
+                runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                for (int64_t kw = 0; kw < kernel_size; ++kw)
+                {
+                    int64_t w_begin, w_end;
+                    int64_t shift = kw - padding;
+                    float64_t *y_plane = &y_rows[(kh * kernel_size + kw) * size];
+                    runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                    for (int64_t h = 0; h < output_height; ++h)
+                    {
+                        float64_t *y_row = &y_plane[h * output_width];
+                        if (h < h_begin || h >= h_end)
+                        {
+                            for (int64_t w = 0; w < output_width; ++w)
+                            {
+                                y_row[w] = padding_value;
+                            }
+                            continue;
+                        }
+
+                        const float64_t *x_row = &x_plane[(h * stride + kh - padding) * width];
+                        for (int64_t w = 0; w < w_begin; ++w)
+                        {
+                            y_row[w] = padding_value;
+                        }
+
+                        if (stride == 1 && w_end > w_begin)
+                        {
+                            memcpy(&y_row[w_begin], &x_row[w_begin + shift], (w_end - w_begin) * sizeof(float64_t));
+                        }
+                        else
+                        {
+                            #pragma omp simd
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                y_row[w] = x_row[w * stride + shift];
+                            }
+                        }
+
+                        for (int64_t w = w_end; w < output_width; ++w)
+                        {
+                            y_row[w] = padding_value;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_column_to_image_float64(const float64_t *x_data, int64_t batch_size, int64_t channels, int64_t height, int64_t width,
+                                            int64_t kernel_size, int64_t output_height, int64_t output_width, int64_t stride, int64_t padding,
+                                            float64_t *y_data)
+{
+    int64_t area = kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+
+    // All column rows of a channel fold back into that channel's plane, so a thread per plane accumulates without races.
+    #pragma omp parallel for collapse(2) if (batch_size * channels * area * size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t c = 0; c < channels; ++c)
+        {
+            const float64_t *x_rows = &x_data[(b * channels + c) * area * size];
+            float64_t *y_plane = &y_data[(b * channels + c) * height * width];
+            for (int64_t kh = 0; kh < kernel_size; ++kh)
+            {
+                int64_t h_begin, h_end;
+                runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                for (int64_t kw = 0; kw < kernel_size; ++kw)
+                {
+                    int64_t w_begin, w_end;
+                    int64_t shift = kw - padding;
+                    const float64_t *x_plane = &x_rows[(kh * kernel_size + kw) * size];
+                    runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                    for (int64_t h = h_begin; h < h_end; ++h)
+                    {
+                        const float64_t *x_row = &x_plane[h * output_width];
+                        float64_t *y_row = &y_plane[(h * stride + kh - padding) * width];
+                        #pragma omp simd
+                        for (int64_t w = w_begin; w < w_end; ++w)
+                        {
+                            y_row[w * stride + shift] += x_row[w];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void runtime_image_to_column(datatype_t datatype, void *x_data, 
+                             int64_t batch_size, int64_t channels, int64_t height, int64_t width, 
+                             int64_t kernel_size, int64_t output_height, int64_t output_width,
+                             int64_t stride, int64_t padding, void *y_data, bool_t inverse, void *padding_value)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        if (inverse)
+        {
+            runtime_column_to_image_float32((float32_t *) x_data, batch_size, channels, height, width, kernel_size, 
+                                            output_height, output_width, stride, padding, (float32_t *) y_data);
+        }
+        else
+        {
+            runtime_image_to_column_float32((float32_t *) x_data, batch_size, channels, height, width, kernel_size, 
+                                            output_height, output_width, stride, padding, (float32_t *) y_data, *(float32_t *) padding_value);
+        }
+        break;
+    case FLOAT64:
+        if (inverse)
+        {
+            runtime_column_to_image_float64((float64_t *) x_data, batch_size, channels, height, width, kernel_size, 
+                                            output_height, output_width, stride, padding, (float64_t *) y_data);
+        }
+        else
+        {
+            runtime_image_to_column_float64((float64_t *) x_data, batch_size, channels, height, width, kernel_size, 
+                                            output_height, output_width, stride, padding, (float64_t *) y_data, *(float64_t *) padding_value);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void runtime_convolution_2d_direct_float32(int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                  int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                  int64_t output_height, int64_t output_width,
+                                                  const float32_t *x_data, const float32_t *w_data, float32_t *y_data)
+{
+    int64_t work = batch_size * out_channels * in_channels * kernel_size * kernel_size * output_height * output_width;
+
+    #pragma omp parallel for collapse(2) if (work >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t o = 0; o < out_channels; ++o)
+        {
+            // Every input channel accumulates into the same output plane, which stays resident in cache.
+            float32_t *y_plane = &y_data[(b * out_channels + o) * output_height * output_width];
+            for (int64_t i = 0; i < output_height * output_width; ++i)
+            {
+                y_plane[i] = (float32_t) 0.0;
+            }
+
+            for (int64_t c = 0; c < in_channels; ++c)
+            {
+                const float32_t *x_plane = &x_data[(b * in_channels + c) * height * width];
+                const float32_t *w_kernel = &w_data[(o * in_channels + c) * kernel_size * kernel_size];
+                for (int64_t kh = 0; kh < kernel_size; ++kh)
+                {
+                    int64_t h_begin, h_end;
+                    runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                    for (int64_t kw = 0; kw < kernel_size; ++kw)
+                    {
+                        int64_t w_begin, w_end;
+                        int64_t shift = kw - padding;
+                        float32_t weight = w_kernel[kh * kernel_size + kw];
+                        runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                        for (int64_t h = h_begin; h < h_end; ++h)
+                        {
+                            const float32_t *x_row = &x_plane[(h * stride + kh - padding) * width];
+                            float32_t *y_row = &y_plane[h * output_width];
+                            #pragma omp simd
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                y_row[w] += weight * x_row[w * stride + shift];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_convolution_2d_direct_backward_input_float32(int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                                 int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                                 int64_t output_height, int64_t output_width,
+                                                                 const float32_t *w_data, const float32_t *dy_data, float32_t *dx_data)
+{
+    int64_t work = batch_size * out_channels * in_channels * kernel_size * kernel_size * output_height * output_width;
+
+    // Each thread owns one input gradient plane, so the strided scatter never races.
+    #pragma omp parallel for collapse(2) if (work >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t c = 0; c < in_channels; ++c)
+        {
+            float32_t *dx_plane = &dx_data[(b * in_channels + c) * height * width];
+            for (int64_t i = 0; i < height * width; ++i)
+            {
+                dx_plane[i] = (float32_t) 0.0;
+            }
+
+            for (int64_t o = 0; o < out_channels; ++o)
+            {
+                const float32_t *dy_plane = &dy_data[(b * out_channels + o) * output_height * output_width];
+                const float32_t *w_kernel = &w_data[(o * in_channels + c) * kernel_size * kernel_size];
+                for (int64_t kh = 0; kh < kernel_size; ++kh)
+                {
+                    int64_t h_begin, h_end;
+                    runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                    for (int64_t kw = 0; kw < kernel_size; ++kw)
+                    {
+                        int64_t w_begin, w_end;
+                        int64_t shift = kw - padding;
+                        float32_t weight = w_kernel[kh * kernel_size + kw];
+                        runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                        for (int64_t h = h_begin; h < h_end; ++h)
+                        {
+                            float32_t *dx_row = &dx_plane[(h * stride + kh - padding) * width];
+                            const float32_t *dy_row = &dy_plane[h * output_width];
+                            #pragma omp simd
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                dx_row[w * stride + shift] += weight * dy_row[w];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_convolution_2d_direct_backward_weight_float32(int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                                  int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                                  int64_t output_height, int64_t output_width,
+                                                                  const float32_t *x_data, const float32_t *dy_data, float32_t *dw_data)
+{
+    int64_t work = batch_size * out_channels * in_channels * kernel_size * kernel_size * output_height * output_width;
+
+    #pragma omp parallel for collapse(2) if (work >= NW_PARALLEL_THRESHOLD)
+    for (int64_t o = 0; o < out_channels; ++o)
+    {
+        for (int64_t c = 0; c < in_channels; ++c)
+        {
+            float32_t *dw_kernel = &dw_data[(o * in_channels + c) * kernel_size * kernel_size];
+            for (int64_t kh = 0; kh < kernel_size; ++kh)
+            {
+                int64_t h_begin, h_end;
+                runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                for (int64_t kw = 0; kw < kernel_size; ++kw)
+                {
+                    int64_t w_begin, w_end;
+                    int64_t shift = kw - padding;
+                    float32_t sum = (float32_t) 0.0;
+                    runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                    for (int64_t b = 0; b < batch_size; ++b)
+                    {
+                        const float32_t *x_plane = &x_data[(b * in_channels + c) * height * width];
+                        const float32_t *dy_plane = &dy_data[(b * out_channels + o) * output_height * output_width];
+                        for (int64_t h = h_begin; h < h_end; ++h)
+                        {
+                            const float32_t *x_row = &x_plane[(h * stride + kh - padding) * width];
+                            const float32_t *dy_row = &dy_plane[h * output_width];
+                            #pragma omp simd reduction(+:sum)
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                sum += dy_row[w] * x_row[w * stride + shift];
+                            }
+                        }
+                    }
+                    dw_kernel[kh * kernel_size + kw] = sum;
+                }
+            }
+        }
+    }
+}
+
+static void runtime_winograd_weight_float32(int64_t in_channels, int64_t out_channels, const float32_t *w_data, float32_t *u_data)
+{
+    int64_t channels = in_channels * out_channels;
+
+    #pragma omp parallel for if (channels * 16 >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < channels; ++i)
+    {
+        // U = G g G^T with G = [1 0 0; 1/2 1/2 1/2; 1/2 -1/2 1/2; 0 0 1].
+        const float32_t *g = &w_data[i * 9];
+        float32_t t[4][3];
+        for (int64_t j = 0; j < 3; ++j)
+        {
+            t[0][j] = g[j];
+            t[1][j] = (float32_t) 0.5 * (g[j] + g[3 + j] + g[6 + j]);
+            t[2][j] = (float32_t) 0.5 * (g[j] - g[3 + j] + g[6 + j]);
+            t[3][j] = g[6 + j];
+        }
+
+        for (int64_t r = 0; r < 4; ++r)
+        {
+            float32_t u[] = {t[r][0], 
+                             (float32_t) 0.5 * (t[r][0] + t[r][1] + t[r][2]),
+                             (float32_t) 0.5 * (t[r][0] - t[r][1] + t[r][2]),
+                             t[r][2]};
+            for (int64_t s = 0; s < 4; ++s)
+            {
+                u_data[(r * 4 + s) * channels + i] = u[s];
+            }
+        }
+    }
+}
+
+static void runtime_winograd_input_float32(int64_t in_channels, int64_t height, int64_t width, int64_t padding,
+                                           int64_t tiles_height, int64_t tiles_width, const float32_t *x_data, float32_t *v_data)
+{
+    int64_t tiles = tiles_height * tiles_width;
+
+    #pragma omp parallel for collapse(2) if (in_channels * tiles * 16 >= NW_PARALLEL_THRESHOLD)
+    for (int64_t c = 0; c < in_channels; ++c)
+    {
+        for (int64_t p = 0; p < tiles; ++p)
+        {
+            // V = B^T d B with B^T = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1] on the zero padded 4x4 input tile.
+            const float32_t *x_plane = &x_data[c * height * width];
+            int64_t row = (p / tiles_width) * 2 - padding;
+            int64_t column = (p % tiles_width) * 2 - padding;
+            float32_t d[4][4];
+            float32_t t[4][4];
+            for (int64_t i = 0; i < 4; ++i)
+            {
+                for (int64_t j = 0; j < 4; ++j)
+                {
+                    bool_t inside = row + i >= 0 && row + i < height && column + j >= 0 && column + j < width;
+                    d[i][j] = (inside) ? x_plane[(row + i) * width + column + j] : (float32_t) 0.0;
+                }
+            }
+
+            for (int64_t j = 0; j < 4; ++j)
+            {
+                t[0][j] = d[0][j] - d[2][j];
+                t[1][j] = d[1][j] + d[2][j];
+                t[2][j] = d[2][j] - d[1][j];
+                t[3][j] = d[1][j] - d[3][j];
+            }
+
+            for (int64_t i = 0; i < 4; ++i)
+            {
+                float32_t v[] = {t[i][0] - t[i][2], t[i][1] + t[i][2], t[i][2] - t[i][1], t[i][1] - t[i][3]};
+                for (int64_t j = 0; j < 4; ++j)
+                {
+                    v_data[((i * 4 + j) * in_channels + c) * tiles + p] = v[j];
+                }
+            }
+        }
+    }
+}
+
+static void runtime_winograd_output_float32(int64_t out_channels, int64_t output_height, int64_t output_width,
+                                            int64_t tiles_height, int64_t tiles_width, const float32_t *m_data, float32_t *y_data)
+{
+    int64_t tiles = tiles_height * tiles_width;
+
+    #pragma omp parallel for collapse(2) if (out_channels * tiles * 16 >= NW_PARALLEL_THRESHOLD)
+    for (int64_t o = 0; o < out_channels; ++o)
+    {
+        for (int64_t p = 0; p < tiles; ++p)
+        {
+            // Y = A^T M A with A^T = [1 1 1 0; 0 1 -1 -1], edge tiles drop the rows and columns past the output.
+            float32_t *y_plane = &y_data[o * output_height * output_width];
+            int64_t row = (p / tiles_width) * 2;
+            int64_t column = (p % tiles_width) * 2;
+            float32_t m[4][4];
+            float32_t t[2][4];
+            for (int64_t i = 0; i < 16; ++i)
+            {
+                m[i / 4][i % 4] = m_data[(i * out_channels + o) * tiles + p];
+            }
+
+            for (int64_t j = 0; j < 4; ++j)
+            {
+                t[0][j] = m[0][j] + m[1][j] + m[2][j];
+                t[1][j] = m[1][j] - m[2][j] - m[3][j];
+            }
+
+            for (int64_t i = 0; i < 2 && row + i < output_height; ++i)
+            {
+                float32_t y[] = {t[i][0] + t[i][1] + t[i][2], t[i][1] - t[i][2] - t[i][3]};
+                for (int64_t j = 0; j < 2 && column + j < output_width; ++j)
+                {
+                    y_plane[(row + i) * output_width + column + j] = y[j];
+                }
+            }
+        }
+    }
+}
+
+static void runtime_convolution_2d_direct_float64(int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                  int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                  int64_t output_height, int64_t output_width,
+                                                  const float64_t *x_data, const float64_t *w_data, float64_t *y_data)
+{
+    int64_t work = batch_size * out_channels * in_channels * kernel_size * kernel_size * output_height * output_width;
+
+    #pragma omp parallel for collapse(2) if (work >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t o = 0; o < out_channels; ++o)
+        {
+            // Every input channel accumulates into the same output plane, which stays resident in cache.
+            float64_t *y_plane = &y_data[(b * out_channels + o) * output_height * output_width];
+            for (int64_t i = 0; i < output_height * output_width; ++i)
+            {
+                y_plane[i] = (float64_t) 0.0;
+            }
+
+            for (int64_t c = 0; c < in_channels; ++c)
+            {
+                const float64_t *x_plane = &x_data[(b * in_channels + c) * height * width];
+                const float64_t *w_kernel = &w_data[(o * in_channels + c) * kernel_size * kernel_size];
+                for (int64_t kh = 0; kh < kernel_size; ++kh)
+                {
+                    int64_t h_begin, h_end;
+                    runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                    for (int64_t kw = 0; kw < kernel_size; ++kw)
+                    {
+                        int64_t w_begin, w_end;
+                        int64_t shift = kw - padding;
+                        float64_t weight = w_kernel[kh * kernel_size + kw];
+                        runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                        for (int64_t h = h_begin; h < h_end; ++h)
+                        {
+                            const float64_t *x_row = &x_plane[(h * stride + kh - padding) * width];
+                            float64_t *y_row = &y_plane[h * output_width];
+                            #pragma omp simd
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                y_row[w] += weight * x_row[w * stride + shift];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_convolution_2d_direct_backward_input_float64(int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                                 int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                                 int64_t output_height, int64_t output_width,
+                                                                 const float64_t *w_data, const float64_t *dy_data, float64_t *dx_data)
+{
+    int64_t work = batch_size * out_channels * in_channels * kernel_size * kernel_size * output_height * output_width;
+
+    // Each thread owns one input gradient plane, so the strided scatter never races.
+    #pragma omp parallel for collapse(2) if (work >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        for (int64_t c = 0; c < in_channels; ++c)
+        {
+            float64_t *dx_plane = &dx_data[(b * in_channels + c) * height * width];
+            for (int64_t i = 0; i < height * width; ++i)
+            {
+                dx_plane[i] = (float64_t) 0.0;
+            }
+
+            for (int64_t o = 0; o < out_channels; ++o)
+            {
+                const float64_t *dy_plane = &dy_data[(b * out_channels + o) * output_height * output_width];
+                const float64_t *w_kernel = &w_data[(o * in_channels + c) * kernel_size * kernel_size];
+                for (int64_t kh = 0; kh < kernel_size; ++kh)
+                {
+                    int64_t h_begin, h_end;
+                    runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                    for (int64_t kw = 0; kw < kernel_size; ++kw)
+                    {
+                        int64_t w_begin, w_end;
+                        int64_t shift = kw - padding;
+                        float64_t weight = w_kernel[kh * kernel_size + kw];
+                        runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                        for (int64_t h = h_begin; h < h_end; ++h)
+                        {
+                            float64_t *dx_row = &dx_plane[(h * stride + kh - padding) * width];
+                            const float64_t *dy_row = &dy_plane[h * output_width];
+                            #pragma omp simd
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                dx_row[w * stride + shift] += weight * dy_row[w];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_convolution_2d_direct_backward_weight_float64(int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                                  int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                                  int64_t output_height, int64_t output_width,
+                                                                  const float64_t *x_data, const float64_t *dy_data, float64_t *dw_data)
+{
+    int64_t work = batch_size * out_channels * in_channels * kernel_size * kernel_size * output_height * output_width;
+
+    #pragma omp parallel for collapse(2) if (work >= NW_PARALLEL_THRESHOLD)
+    for (int64_t o = 0; o < out_channels; ++o)
+    {
+        for (int64_t c = 0; c < in_channels; ++c)
+        {
+            float64_t *dw_kernel = &dw_data[(o * in_channels + c) * kernel_size * kernel_size];
+            for (int64_t kh = 0; kh < kernel_size; ++kh)
+            {
+                int64_t h_begin, h_end;
+                runtime_convolution_2d_range(kh, stride, padding, height, output_height, &h_begin, &h_end);
+                for (int64_t kw = 0; kw < kernel_size; ++kw)
+                {
+                    int64_t w_begin, w_end;
+                    int64_t shift = kw - padding;
+                    float64_t sum = (float64_t) 0.0;
+                    runtime_convolution_2d_range(kw, stride, padding, width, output_width, &w_begin, &w_end);
+                    for (int64_t b = 0; b < batch_size; ++b)
+                    {
+                        const float64_t *x_plane = &x_data[(b * in_channels + c) * height * width];
+                        const float64_t *dy_plane = &dy_data[(b * out_channels + o) * output_height * output_width];
+                        for (int64_t h = h_begin; h < h_end; ++h)
+                        {
+                            const float64_t *x_row = &x_plane[(h * stride + kh - padding) * width];
+                            const float64_t *dy_row = &dy_plane[h * output_width];
+                            #pragma omp simd reduction(+:sum)
+                            for (int64_t w = w_begin; w < w_end; ++w)
+                            {
+                                sum += dy_row[w] * x_row[w * stride + shift];
+                            }
+                        }
+                    }
+                    dw_kernel[kh * kernel_size + kw] = sum;
+                }
+            }
+        }
+    }
+}
+
+static void runtime_winograd_weight_float64(int64_t in_channels, int64_t out_channels, const float64_t *w_data, float64_t *u_data)
+{
+    int64_t channels = in_channels * out_channels;
+
+    #pragma omp parallel for if (channels * 16 >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < channels; ++i)
+    {
+        // U = G g G^T with G = [1 0 0; 1/2 1/2 1/2; 1/2 -1/2 1/2; 0 0 1].
+        const float64_t *g = &w_data[i * 9];
+        float64_t t[4][3];
+        for (int64_t j = 0; j < 3; ++j)
+        {
+            t[0][j] = g[j];
+            t[1][j] = (float64_t) 0.5 * (g[j] + g[3 + j] + g[6 + j]);
+            t[2][j] = (float64_t) 0.5 * (g[j] - g[3 + j] + g[6 + j]);
+            t[3][j] = g[6 + j];
+        }
+
+        for (int64_t r = 0; r < 4; ++r)
+        {
+            float64_t u[] = {t[r][0], 
+                             (float64_t) 0.5 * (t[r][0] + t[r][1] + t[r][2]),
+                             (float64_t) 0.5 * (t[r][0] - t[r][1] + t[r][2]),
+                             t[r][2]};
+            for (int64_t s = 0; s < 4; ++s)
+            {
+                u_data[(r * 4 + s) * channels + i] = u[s];
+            }
+        }
+    }
+}
+
+static void runtime_winograd_input_float64(int64_t in_channels, int64_t height, int64_t width, int64_t padding,
+                                           int64_t tiles_height, int64_t tiles_width, const float64_t *x_data, float64_t *v_data)
+{
+    int64_t tiles = tiles_height * tiles_width;
+
+    #pragma omp parallel for collapse(2) if (in_channels * tiles * 16 >= NW_PARALLEL_THRESHOLD)
+    for (int64_t c = 0; c < in_channels; ++c)
+    {
+        for (int64_t p = 0; p < tiles; ++p)
+        {
+            // V = B^T d B with B^T = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1] on the zero padded 4x4 input tile.
+            const float64_t *x_plane = &x_data[c * height * width];
+            int64_t row = (p / tiles_width) * 2 - padding;
+            int64_t column = (p % tiles_width) * 2 - padding;
+            float64_t d[4][4];
+            float64_t t[4][4];
+            for (int64_t i = 0; i < 4; ++i)
+            {
+                for (int64_t j = 0; j < 4; ++j)
+                {
+                    bool_t inside = row + i >= 0 && row + i < height && column + j >= 0 && column + j < width;
+                    d[i][j] = (inside) ? x_plane[(row + i) * width + column + j] : (float64_t) 0.0;
+                }
+            }
+
+            for (int64_t j = 0; j < 4; ++j)
+            {
+                t[0][j] = d[0][j] - d[2][j];
+                t[1][j] = d[1][j] + d[2][j];
+                t[2][j] = d[2][j] - d[1][j];
+                t[3][j] = d[1][j] - d[3][j];
+            }
+
+            for (int64_t i = 0; i < 4; ++i)
+            {
+                float64_t v[] = {t[i][0] - t[i][2], t[i][1] + t[i][2], t[i][2] - t[i][1], t[i][1] - t[i][3]};
+                for (int64_t j = 0; j < 4; ++j)
+                {
+                    v_data[((i * 4 + j) * in_channels + c) * tiles + p] = v[j];
+                }
+            }
+        }
+    }
+}
+
+static void runtime_winograd_output_float64(int64_t out_channels, int64_t output_height, int64_t output_width,
+                                            int64_t tiles_height, int64_t tiles_width, const float64_t *m_data, float64_t *y_data)
+{
+    int64_t tiles = tiles_height * tiles_width;
+
+    #pragma omp parallel for collapse(2) if (out_channels * tiles * 16 >= NW_PARALLEL_THRESHOLD)
+    for (int64_t o = 0; o < out_channels; ++o)
+    {
+        for (int64_t p = 0; p < tiles; ++p)
+        {
+            // Y = A^T M A with A^T = [1 1 1 0; 0 1 -1 -1], edge tiles drop the rows and columns past the output.
+            float64_t *y_plane = &y_data[o * output_height * output_width];
+            int64_t row = (p / tiles_width) * 2;
+            int64_t column = (p % tiles_width) * 2;
+            float64_t m[4][4];
+            float64_t t[2][4];
+            for (int64_t i = 0; i < 16; ++i)
+            {
+                m[i / 4][i % 4] = m_data[(i * out_channels + o) * tiles + p];
+            }
+
+            for (int64_t j = 0; j < 4; ++j)
+            {
+                t[0][j] = m[0][j] + m[1][j] + m[2][j];
+                t[1][j] = m[1][j] - m[2][j] - m[3][j];
+            }
+
+            for (int64_t i = 0; i < 2 && row + i < output_height; ++i)
+            {
+                float64_t y[] = {t[i][0] + t[i][1] + t[i][2], t[i][1] - t[i][2] - t[i][3]};
+                for (int64_t j = 0; j < 2 && column + j < output_width; ++j)
+                {
+                    y_plane[(row + i) * output_width + column + j] = y[j];
+                }
+            }
+        }
+    }
+}
+
+typedef enum convolution_algorithm_t
+{
+    IMAGE_TO_COLUMN_CONVOLUTION,
+    DIRECT_CONVOLUTION,
+    WINOGRAD_CONVOLUTION,
+} convolution_algorithm_t;
+
+static convolution_algorithm_t runtime_convolution_2d_algorithm(int64_t in_channels, int64_t out_channels, int64_t kernel_size, int64_t stride)
+{
+    if (kernel_size == 3 && stride == 1 && in_channels * out_channels >= NW_WINOGRAD_CHANNELS)
+    {
+        return WINOGRAD_CONVOLUTION;
+    }
+
+    if (in_channels * kernel_size * kernel_size < NW_CONVOLUTION_GEMM_DEPTH || out_channels < NW_CONVOLUTION_GEMM_CHANNELS)
+    {
+        return DIRECT_CONVOLUTION;
+    }
+
+    return IMAGE_TO_COLUMN_CONVOLUTION;
+}
+
+static void *runtime_convolution_2d_zero(datatype_t datatype)
+{
+    static float32_t zero_float32 = 0.0;
+    static float64_t zero_float64 = 0.0;
+
+    return (datatype == FLOAT32) ? (void *) &zero_float32 : (void *) &zero_float64;
+}
+
+static void *runtime_convolution_2d_element(void *data, int64_t offset, datatype_t datatype)
+{
+    return (void *) ((char *) data + offset * (int64_t) datatype_size(datatype));
+}
+
+static nw_error_t *runtime_convolution_2d_winograd(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                   int64_t out_channels, int64_t padding, int64_t output_height, int64_t output_width,
+                                                   void *x_data, int64_t x_offset, void *w_data, int64_t w_offset, void *y_data, int64_t y_offset)
+{
+    nw_error_t *error = NULL;
+    int64_t tiles_height = (output_height + 1) / 2;
+    int64_t tiles_width = (output_width + 1) / 2;
+    int64_t tiles = tiles_height * tiles_width;
+    void *u_data = NULL;
+    void *v_data = NULL;
+    void *m_data = NULL;
+
+    error = runtime_malloc(&u_data, 16 * out_channels * in_channels, datatype, runtime);
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate winograd weights."), error);
+        goto cleanup;
+    }
+
+    error = runtime_malloc(&v_data, 16 * in_channels * tiles, datatype, runtime);
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate winograd input tiles."), error);
+        goto cleanup;
+    }
+
+    error = runtime_malloc(&m_data, 16 * out_channels * tiles, datatype, runtime);
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate winograd output tiles."), error);
+        goto cleanup;
+    }
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        runtime_winograd_weight_float32(in_channels, out_channels, &((float32_t *) w_data)[w_offset], (float32_t *) u_data);
+        break;
+    case FLOAT64:
+        runtime_winograd_weight_float64(in_channels, out_channels, &((float64_t *) w_data)[w_offset], (float64_t *) u_data);
+        break;
+    default:
+        break;
+    }
+
+    // One image at a time keeps the transformed tiles at 4x the image instead of 9x for image to column.
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        int64_t x_image = x_offset + b * in_channels * height * width;
+        int64_t y_image = y_offset + b * out_channels * output_height * output_width;
+
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_winograd_input_float32(in_channels, height, width, padding, tiles_height, tiles_width, &((float32_t *) x_data)[x_image], (float32_t *) v_data);
+            break;
+        case FLOAT64:
+            runtime_winograd_input_float64(in_channels, height, width, padding, tiles_height, tiles_width, &((float64_t *) x_data)[x_image], (float64_t *) v_data);
+            break;
+        default:
+            break;
+        }
+
+        // Sixteen independent (out_channels x in_channels) x (in_channels x tiles) products, one per transform coordinate.
+        runtime_batched_matrix_multiplication(runtime, datatype, 16, out_channels, in_channels, tiles, false, false,
+                                              u_data, 0, in_channels, out_channels * in_channels,
+                                              v_data, 0, tiles, in_channels * tiles,
+                                              m_data, 0, tiles, out_channels * tiles);
+        runtime_synchronize(runtime);
+
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_winograd_output_float32(out_channels, output_height, output_width, tiles_height, tiles_width, (float32_t *) m_data, &((float32_t *) y_data)[y_image]);
+            break;
+        case FLOAT64:
+            runtime_winograd_output_float64(out_channels, output_height, output_width, tiles_height, tiles_width, (float64_t *) m_data, &((float64_t *) y_data)[y_image]);
+            break;
+        default:
+            break;
+        }
+    }
+
+cleanup:
+
+    runtime_free(u_data, 16 * out_channels * in_channels, datatype, runtime);
+    runtime_free(v_data, 16 * in_channels * tiles, datatype, runtime);
+    runtime_free(m_data, 16 * out_channels * tiles, datatype, runtime);
+
+    return error;
+}
+
+static nw_error_t *runtime_convolution_2d_image_to_column(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                          int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding, int64_t output_height, int64_t output_width,
+                                                          void *x_data, int64_t x_offset, void *w_data, int64_t w_offset, void *y_data, int64_t y_offset)
+{
+    nw_error_t *error = NULL;
+    int64_t depth = in_channels * kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+    void *column_data = NULL;
+
+    // The column matrix is built per image so the workspace does not scale with the batch.
+    error = runtime_malloc(&column_data, depth * size, datatype, runtime);
+    if (error)
+    {
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate column matrix."), error);
+    }
+
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        runtime_image_to_column(datatype, runtime_convolution_2d_element(x_data, x_offset + b * in_channels * height * width, datatype),
+                                1, in_channels, height, width, kernel_size, output_height, output_width, stride, padding,
+                                column_data, false, runtime_convolution_2d_zero(datatype));
+        runtime_batched_matrix_multiplication(runtime, datatype, 1, out_channels, depth, size, false, false,
+                                              w_data, w_offset, depth, 0,
+                                              column_data, 0, size, 0,
+                                              y_data, y_offset + b * out_channels * size, size, 0);
+        runtime_synchronize(runtime);
+    }
+
+    runtime_free(column_data, depth * size, datatype, runtime);
+
+    return error;
+}
+
+nw_error_t *runtime_convolution_2d(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                   int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                   void *x_data, int64_t x_offset, void *w_data, int64_t w_offset, void *y_data, int64_t y_offset)
+{
+    nw_error_t *error = NULL;
+    int64_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    int64_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+
+    // Storage is host accessible for every runtime, only the GEMM calls are dispatched to the backend.
+    runtime_synchronize(runtime);
+
+    switch (runtime_convolution_2d_algorithm(in_channels, out_channels, kernel_size, stride))
+    {
+    case WINOGRAD_CONVOLUTION:
+        error = runtime_convolution_2d_winograd(runtime, datatype, batch_size, in_channels, height, width, out_channels, padding, output_height, output_width,
+                                                x_data, x_offset, w_data, w_offset, y_data, y_offset);
+        break;
+    case IMAGE_TO_COLUMN_CONVOLUTION:
+        error = runtime_convolution_2d_image_to_column(runtime, datatype, batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding,
+                                                       output_height, output_width, x_data, x_offset, w_data, w_offset, y_data, y_offset);
+        break;
+    case DIRECT_CONVOLUTION:
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_convolution_2d_direct_float32(batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding, output_height, output_width,
+                                                  &((float32_t *) x_data)[x_offset], &((float32_t *) w_data)[w_offset], &((float32_t *) y_data)[y_offset]);
+            break;
+        case FLOAT64:
+            runtime_convolution_2d_direct_float64(batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding, output_height, output_width,
+                                                  &((float64_t *) x_data)[x_offset], &((float64_t *) w_data)[w_offset], &((float64_t *) y_data)[y_offset]);
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (error)
+    {
+        return ERROR(ERROR_CONVOLUTION, string_create("failed to convolve."), error);
+    }
+
+    return error;
+}
+
+static nw_error_t *runtime_convolution_2d_backward_input(runtime_t runtime, datatype_t datatype, convolution_algorithm_t algorithm,
+                                                         int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                         int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                         int64_t output_height, int64_t output_width,
+                                                         void *w_data, int64_t w_offset, void *dy_data, int64_t dy_offset, void *dx_data, int64_t dx_offset)
+{
+    nw_error_t *error = NULL;
+    int64_t area = kernel_size * kernel_size;
+    int64_t depth = in_channels * area;
+    int64_t size = output_height * output_width;
+    int64_t element_size = (int64_t) datatype_size(datatype);
+    void *workspace_data = NULL;
+
+    if (stride == 1 && padding < kernel_size)
+    {
+        // With unit stride the input gradient is a full convolution of the output gradient with the
+        // spatially flipped, channel transposed kernel, so it reuses the forward algorithms.
+        error = runtime_malloc(&workspace_data, out_channels * depth, datatype, runtime);
+        if (error)
+        {
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate flipped kernel."), error);
+        }
+
+        for (int64_t o = 0; o < out_channels; ++o)
+        {
+            for (int64_t c = 0; c < in_channels; ++c)
+            {
+                for (int64_t i = 0; i < area; ++i)
+                {
+                    memcpy(runtime_convolution_2d_element(workspace_data, (c * out_channels + o) * area + area - 1 - i, datatype),
+                           runtime_convolution_2d_element(w_data, w_offset + (o * in_channels + c) * area + i, datatype), element_size);
+                }
+            }
+        }
+
+        error = runtime_convolution_2d(runtime, datatype, batch_size, out_channels, output_height, output_width, in_channels, kernel_size, 1, kernel_size - 1 - padding,
+                                       dy_data, dy_offset, workspace_data, 0, dx_data, dx_offset);
+        runtime_free(workspace_data, out_channels * depth, datatype, runtime);
+
+        return error;
+    }
+
+    switch (algorithm)
+    {
+    case IMAGE_TO_COLUMN_CONVOLUTION:
+    case WINOGRAD_CONVOLUTION:
+        error = runtime_malloc(&workspace_data, depth * size, datatype, runtime);
+        if (error)
+        {
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate column matrix."), error);
+        }
+
+        runtime_zeroes(runtime_convolution_2d_element(dx_data, dx_offset, datatype), batch_size * in_channels * height * width, datatype);
+        for (int64_t b = 0; b < batch_size; ++b)
+        {
+            runtime_batched_matrix_multiplication(runtime, datatype, 1, depth, out_channels, size, true, false,
+                                                  w_data, w_offset, depth, 0,
+                                                  dy_data, dy_offset + b * out_channels * size, size, 0,
+                                                  workspace_data, 0, size, 0);
+            runtime_synchronize(runtime);
+            runtime_image_to_column(datatype, workspace_data, 1, in_channels, height, width, kernel_size, output_height, output_width, stride, padding, 
+                                    runtime_convolution_2d_element(dx_data, dx_offset + b * in_channels * height * width, datatype), true, NULL);
+        }
+
+        runtime_free(workspace_data, depth * size, datatype, runtime);
+        break;
+    case DIRECT_CONVOLUTION:
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_convolution_2d_direct_backward_input_float32(batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding, output_height, output_width,
+                                                                 &((float32_t *) w_data)[w_offset], &((float32_t *) dy_data)[dy_offset], &((float32_t *) dx_data)[dx_offset]);
+            break;
+        case FLOAT64:
+            runtime_convolution_2d_direct_backward_input_float64(batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding, output_height, output_width,
+                                                                 &((float64_t *) w_data)[w_offset], &((float64_t *) dy_data)[dy_offset], &((float64_t *) dx_data)[dx_offset]);
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return error;
+}
+
+static nw_error_t *runtime_convolution_2d_backward_weight(runtime_t runtime, datatype_t datatype, convolution_algorithm_t algorithm,
+                                                          int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                                          int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                          int64_t output_height, int64_t output_width,
+                                                          void *x_data, int64_t x_offset, void *dy_data, int64_t dy_offset, void *dw_data, int64_t dw_offset)
+{
+    nw_error_t *error = NULL;
+    int64_t depth = in_channels * kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+    void *column_data = NULL;
+    void *product_data = NULL;
+
+    if (algorithm == DIRECT_CONVOLUTION)
+    {
+        switch (datatype)
+        {
+        case FLOAT32:
+            runtime_convolution_2d_direct_backward_weight_float32(batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding, output_height, output_width,
+                                                                  &((float32_t *) x_data)[x_offset], &((float32_t *) dy_data)[dy_offset], &((float32_t *) dw_data)[dw_offset]);
+            break;
+        case FLOAT64:
+            runtime_convolution_2d_direct_backward_weight_float64(batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding, output_height, output_width,
+                                                                  &((float64_t *) x_data)[x_offset], &((float64_t *) dy_data)[dy_offset], &((float64_t *) dw_data)[dw_offset]);
+            break;
+        default:
+            break;
+        }
+
+        return error;
+    }
+
+    // Winograd has no cheaper weight gradient than a GEMM over the column matrix, so both share this path.
+    error = runtime_malloc(&column_data, depth * size, datatype, runtime);
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate column matrix."), error);
+        goto cleanup;
+    }
+
+    if (batch_size > 1)
+    {
+        error = runtime_malloc(&product_data, out_channels * depth, datatype, runtime);
+        if (error)
+        {
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate weight gradient."), error);
+            goto cleanup;
+        }
+    }
+
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        runtime_image_to_column(datatype, runtime_convolution_2d_element(x_data, x_offset + b * in_channels * height * width, datatype),
+                                1, in_channels, height, width, kernel_size, output_height, output_width, stride, padding,
+                                column_data, false, runtime_convolution_2d_zero(datatype));
+        runtime_batched_matrix_multiplication(runtime, datatype, 1, out_channels, size, depth, false, true,
+                                              dy_data, dy_offset + b * out_channels * size, size, 0,
+                                              column_data, 0, size, 0,
+                                              (b) ? product_data : dw_data, (b) ? 0 : dw_offset, depth, 0);
+        if (b)
+        {
+            runtime_binary_elementwise_vector(ADDITION_OPERATION, runtime, datatype, out_channels * depth, 
+                                              dw_data, 1, dw_offset, product_data, 1, 0, dw_data, 1, dw_offset);
+        }
+        runtime_synchronize(runtime);
+    }
+
+cleanup:
+
+    runtime_free(column_data, depth * size, datatype, runtime);
+    runtime_free(product_data, out_channels * depth, datatype, runtime);
+
+    return error;
+}
+
+nw_error_t *runtime_convolution_2d_backward(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                            int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                            void *x_data, int64_t x_offset, void *w_data, int64_t w_offset, void *dy_data, int64_t dy_offset,
+                                            void *dx_data, int64_t dx_offset, void *dw_data, int64_t dw_offset)
+{
+    nw_error_t *error = NULL;
+    int64_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    int64_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    convolution_algorithm_t algorithm = runtime_convolution_2d_algorithm(in_channels, out_channels, kernel_size, stride);
+
+    runtime_synchronize(runtime);
+
+    if (dx_data)
+    {
+        error = runtime_convolution_2d_backward_input(runtime, datatype, algorithm, batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding,
+                                                      output_height, output_width, w_data, w_offset, dy_data, dy_offset, dx_data, dx_offset);
+        if (error)
+        {
+            return ERROR(ERROR_CONVOLUTION, string_create("failed to compute convolution input gradient."), error);
+        }
+    }
+
+    if (dw_data)
+    {
+        error = runtime_convolution_2d_backward_weight(runtime, datatype, algorithm, batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding,
+                                                       output_height, output_width, x_data, x_offset, dy_data, dy_offset, dw_data, dw_offset);
+        if (error)
+        {
+            return ERROR(ERROR_CONVOLUTION, string_create("failed to compute convolution weight gradient."), error);
+        }
+    }
+
+    return error;
+}
+
+static void runtime_max_pool_2d_float32(int64_t planes, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                        int64_t output_height, int64_t output_width, const float32_t *x_data, float32_t *y_data, int32_t *indices)
+{
+    #pragma omp parallel for if (planes * output_height * output_width * kernel_size * kernel_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        const float32_t *x_plane = &x_data[p * height * width];
+        for (int64_t h = 0; h < output_height; ++h)
+        {
+            int64_t h_begin = MAX(h * stride - padding, 0);
+            int64_t h_end = MIN(h * stride - padding + kernel_size, height);
+            for (int64_t w = 0; w < output_width; ++w)
+            {
+                int64_t w_begin = MAX(w * stride - padding, 0);
+                int64_t w_end = MIN(w * stride - padding + kernel_size, width);
+                int64_t index = -1;
+                float32_t maximum = -INFINITY;
+                for (int64_t i = h_begin; i < h_end; ++i)
+                {
+                    for (int64_t j = w_begin; j < w_end; ++j)
+                    {
+                        if (index < 0 || x_plane[i * width + j] > maximum)
+                        {
+                            maximum = x_plane[i * width + j];
+                            index = i * width + j;
+                        }
+                    }
+                }
+
+                y_data[(p * output_height + h) * output_width + w] = maximum;
+                if (indices)
+                {
+                    indices[(p * output_height + h) * output_width + w] = (int32_t) index;
+                }
+            }
+        }
+    }
+}
+
+static void runtime_max_pool_2d_backward_float32(int64_t planes, int64_t height, int64_t width, int64_t output_height, int64_t output_width,
+                                                 const int32_t *indices, const float32_t *dy_data, float32_t *dx_data)
+{
+    // Windows only overlap inside a plane, so one thread per plane scatters without races.
+    #pragma omp parallel for if (planes * height * width >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        float32_t *dx_plane = &dx_data[p * height * width];
+        for (int64_t i = 0; i < height * width; ++i)
+        {
+            dx_plane[i] = (float32_t) 0.0;
+        }
+
+        for (int64_t i = p * output_height * output_width; i < (p + 1) * output_height * output_width; ++i)
+        {
+            if (indices[i] >= 0)
+            {
+                dx_plane[indices[i]] += dy_data[i];
+            }
+        }
+    }
+}
+
+static void runtime_average_pool_2d_float32(int64_t planes, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                            int64_t output_height, int64_t output_width, const float32_t *x_data, float32_t *y_data)
+{
+    // Padding counts towards the window size, as it did when pooling was a mean over the zero padded columns.
+    float32_t scale = (float32_t) 1.0 / (float32_t) (kernel_size * kernel_size);
+
+    #pragma omp parallel for if (planes * output_height * output_width * kernel_size * kernel_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        const float32_t *x_plane = &x_data[p * height * width];
+        for (int64_t h = 0; h < output_height; ++h)
+        {
+            int64_t h_begin = MAX(h * stride - padding, 0);
+            int64_t h_end = MIN(h * stride - padding + kernel_size, height);
+            for (int64_t w = 0; w < output_width; ++w)
+            {
+                int64_t w_begin = MAX(w * stride - padding, 0);
+                int64_t w_end = MIN(w * stride - padding + kernel_size, width);
+                float32_t sum = (float32_t) 0.0;
+                for (int64_t i = h_begin; i < h_end; ++i)
+                {
+                    for (int64_t j = w_begin; j < w_end; ++j)
+                    {
+                        sum += x_plane[i * width + j];
+                    }
+                }
+                y_data[(p * output_height + h) * output_width + w] = sum * scale;
+            }
+        }
+    }
+}
+
+static void runtime_average_pool_2d_backward_float32(int64_t planes, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                     int64_t output_height, int64_t output_width, const float32_t *dy_data, float32_t *dx_data)
+{
+    float32_t scale = (float32_t) 1.0 / (float32_t) (kernel_size * kernel_size);
+
+    #pragma omp parallel for if (planes * output_height * output_width * kernel_size * kernel_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        float32_t *dx_plane = &dx_data[p * height * width];
+        for (int64_t i = 0; i < height * width; ++i)
+        {
+            dx_plane[i] = (float32_t) 0.0;
+        }
+
+        for (int64_t h = 0; h < output_height; ++h)
+        {
+            int64_t h_begin = MAX(h * stride - padding, 0);
+            int64_t h_end = MIN(h * stride - padding + kernel_size, height);
+            for (int64_t w = 0; w < output_width; ++w)
+            {
+                int64_t w_begin = MAX(w * stride - padding, 0);
+                int64_t w_end = MIN(w * stride - padding + kernel_size, width);
+                float32_t value = dy_data[(p * output_height + h) * output_width + w] * scale;
+                for (int64_t i = h_begin; i < h_end; ++i)
+                {
+                    for (int64_t j = w_begin; j < w_end; ++j)
+                    {
+                        dx_plane[i * width + j] += value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void runtime_max_pool_2d_float64(int64_t planes, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                        int64_t output_height, int64_t output_width, const float64_t *x_data, float64_t *y_data, int32_t *indices)
+{
+    #pragma omp parallel for if (planes * output_height * output_width * kernel_size * kernel_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        const float64_t *x_plane = &x_data[p * height * width];
+        for (int64_t h = 0; h < output_height; ++h)
+        {
+            int64_t h_begin = MAX(h * stride - padding, 0);
+            int64_t h_end = MIN(h * stride - padding + kernel_size, height);
+            for (int64_t w = 0; w < output_width; ++w)
+            {
+                int64_t w_begin = MAX(w * stride - padding, 0);
+                int64_t w_end = MIN(w * stride - padding + kernel_size, width);
+                int64_t index = -1;
+                float64_t maximum = -INFINITY;
+                for (int64_t i = h_begin; i < h_end; ++i)
+                {
+                    for (int64_t j = w_begin; j < w_end; ++j)
+                    {
+                        if (index < 0 || x_plane[i * width + j] > maximum)
+                        {
+                            maximum = x_plane[i * width + j];
+                            index = i * width + j;
+                        }
+                    }
+                }
+
+                y_data[(p * output_height + h) * output_width + w] = maximum;
+                if (indices)
+                {
+                    indices[(p * output_height + h) * output_width + w] = (int32_t) index;
+                }
+            }
+        }
+    }
+}
+
+static void runtime_max_pool_2d_backward_float64(int64_t planes, int64_t height, int64_t width, int64_t output_height, int64_t output_width,
+                                                 const int32_t *indices, const float64_t *dy_data, float64_t *dx_data)
+{
+    // Windows only overlap inside a plane, so one thread per plane scatters without races.
+    #pragma omp parallel for if (planes * height * width >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        float64_t *dx_plane = &dx_data[p * height * width];
+        for (int64_t i = 0; i < height * width; ++i)
+        {
+            dx_plane[i] = (float64_t) 0.0;
+        }
+
+        for (int64_t i = p * output_height * output_width; i < (p + 1) * output_height * output_width; ++i)
+        {
+            if (indices[i] >= 0)
+            {
+                dx_plane[indices[i]] += dy_data[i];
+            }
+        }
+    }
+}
+
+static void runtime_average_pool_2d_float64(int64_t planes, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                            int64_t output_height, int64_t output_width, const float64_t *x_data, float64_t *y_data)
+{
+    // Padding counts towards the window size, as it did when pooling was a mean over the zero padded columns.
+    float64_t scale = (float64_t) 1.0 / (float64_t) (kernel_size * kernel_size);
+
+    #pragma omp parallel for if (planes * output_height * output_width * kernel_size * kernel_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        const float64_t *x_plane = &x_data[p * height * width];
+        for (int64_t h = 0; h < output_height; ++h)
+        {
+            int64_t h_begin = MAX(h * stride - padding, 0);
+            int64_t h_end = MIN(h * stride - padding + kernel_size, height);
+            for (int64_t w = 0; w < output_width; ++w)
+            {
+                int64_t w_begin = MAX(w * stride - padding, 0);
+                int64_t w_end = MIN(w * stride - padding + kernel_size, width);
+                float64_t sum = (float64_t) 0.0;
+                for (int64_t i = h_begin; i < h_end; ++i)
+                {
+                    for (int64_t j = w_begin; j < w_end; ++j)
+                    {
+                        sum += x_plane[i * width + j];
+                    }
+                }
+                y_data[(p * output_height + h) * output_width + w] = sum * scale;
+            }
+        }
+    }
+}
+
+static void runtime_average_pool_2d_backward_float64(int64_t planes, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                                     int64_t output_height, int64_t output_width, const float64_t *dy_data, float64_t *dx_data)
+{
+    float64_t scale = (float64_t) 1.0 / (float64_t) (kernel_size * kernel_size);
+
+    #pragma omp parallel for if (planes * output_height * output_width * kernel_size * kernel_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t p = 0; p < planes; ++p)
+    {
+        float64_t *dx_plane = &dx_data[p * height * width];
+        for (int64_t i = 0; i < height * width; ++i)
+        {
+            dx_plane[i] = (float64_t) 0.0;
+        }
+
+        for (int64_t h = 0; h < output_height; ++h)
+        {
+            int64_t h_begin = MAX(h * stride - padding, 0);
+            int64_t h_end = MIN(h * stride - padding + kernel_size, height);
+            for (int64_t w = 0; w < output_width; ++w)
+            {
+                int64_t w_begin = MAX(w * stride - padding, 0);
+                int64_t w_end = MIN(w * stride - padding + kernel_size, width);
+                float64_t value = dy_data[(p * output_height + h) * output_width + w] * scale;
+                for (int64_t i = h_begin; i < h_end; ++i)
+                {
+                    for (int64_t j = w_begin; j < w_end; ++j)
+                    {
+                        dx_plane[i * width + j] += value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void runtime_pooling_2d(structure_operation_type_t structure_operation_type, runtime_t runtime, datatype_t datatype, 
+                        int64_t batch_size, int64_t channels, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                        void *x_data, int64_t x_offset, void *y_data, int64_t y_offset, int32_t *indices)
+{
+    int64_t planes = batch_size * channels;
+    int64_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    int64_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    bool_t maximum = structure_operation_type == MAX_POOL_2D_OPERATION;
+
+    // Pooling runs on the host for every runtime, storage is host accessible.
+    runtime_synchronize(runtime);
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        if (maximum)
+        {
+            runtime_max_pool_2d_float32(planes, height, width, kernel_size, stride, padding, output_height, output_width,
+                                        &((float32_t *) x_data)[x_offset], &((float32_t *) y_data)[y_offset], indices);
+        }
+        else
+        {
+            runtime_average_pool_2d_float32(planes, height, width, kernel_size, stride, padding, output_height, output_width,
+                                            &((float32_t *) x_data)[x_offset], &((float32_t *) y_data)[y_offset]);
+        }
+        break;
+    case FLOAT64:
+        if (maximum)
+        {
+            runtime_max_pool_2d_float64(planes, height, width, kernel_size, stride, padding, output_height, output_width,
+                                        &((float64_t *) x_data)[x_offset], &((float64_t *) y_data)[y_offset], indices);
+        }
+        else
+        {
+            runtime_average_pool_2d_float64(planes, height, width, kernel_size, stride, padding, output_height, output_width,
+                                            &((float64_t *) x_data)[x_offset], &((float64_t *) y_data)[y_offset]);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void runtime_pooling_2d_backward(structure_operation_type_t structure_operation_type, runtime_t runtime, datatype_t datatype, 
+                                 int64_t batch_size, int64_t channels, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                 const int32_t *indices, void *dy_data, int64_t dy_offset, void *dx_data, int64_t dx_offset)
+{
+    int64_t planes = batch_size * channels;
+    int64_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    int64_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    bool_t maximum = structure_operation_type == MAX_POOL_2D_OPERATION;
+
+    runtime_synchronize(runtime);
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        if (maximum)
+        {
+            runtime_max_pool_2d_backward_float32(planes, height, width, output_height, output_width, indices,
+                                                 &((float32_t *) dy_data)[dy_offset], &((float32_t *) dx_data)[dx_offset]);
+        }
+        else
+        {
+            runtime_average_pool_2d_backward_float32(planes, height, width, kernel_size, stride, padding, output_height, output_width,
+                                                     &((float32_t *) dy_data)[dy_offset], &((float32_t *) dx_data)[dx_offset]);
+        }
+        break;
+    case FLOAT64:
+        if (maximum)
+        {
+            runtime_max_pool_2d_backward_float64(planes, height, width, output_height, output_width, indices,
+                                                 &((float64_t *) dy_data)[dy_offset], &((float64_t *) dx_data)[dx_offset]);
+        }
+        else
+        {
+            runtime_average_pool_2d_backward_float64(planes, height, width, kernel_size, stride, padding, output_height, output_width,
+                                                     &((float64_t *) dy_data)[dy_offset], &((float64_t *) dx_data)[dx_offset]);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void runtime_embedding(runtime_t runtime, datatype_t datatype, int64_t n, int64_t embedding_size, const int64_t *indices,
+                       void *w_data, int64_t w_offset, void *y_data, int64_t y_offset)
+{
+    size_t size = datatype_size(datatype);
+    size_t row = (size_t) embedding_size * size;
+    const char *w_rows = (const char *) w_data + (size_t) w_offset * size;
+    char *y_rows = (char *) y_data + (size_t) y_offset * size;
+
+    runtime_synchronize(runtime);
+
+    // Rows are copied bitwise, so the storage datatype is never converted.
+    #pragma omp parallel for if (n * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        memcpy(&y_rows[(size_t) i * row], &w_rows[(size_t) indices[i] * row], row);
+    }
+}
+
+#define NW_EMBEDDING_COLUMNS 16
+
+static void runtime_embedding_backward_float32(int64_t n, int64_t vocabulary_size, int64_t embedding_size, const int64_t *indices,
+                                               const float32_t *dy_data, float32_t *dw_data, bool_t zero)
+{
+    int64_t blocks = (embedding_size + NW_EMBEDDING_COLUMNS - 1) / NW_EMBEDDING_COLUMNS;
+
+    // Each thread owns a block of columns, so repeated indices accumulate without races.
+    #pragma omp parallel for if (blocks > 1 && (n + vocabulary_size) * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < blocks; ++b)
+    {
+        int64_t begin = b * NW_EMBEDDING_COLUMNS;
+        int64_t end = MIN(begin + NW_EMBEDDING_COLUMNS, embedding_size);
+
+        for (int64_t v = 0; zero && v < vocabulary_size; ++v)
+        {
+            for (int64_t j = begin; j < end; ++j)
+            {
+                dw_data[v * embedding_size + j] = (float32_t) 0.0;
+            }
+        }
+
+        for (int64_t i = 0; i < n; ++i)
+        {
+            float32_t *dw_row = &dw_data[indices[i] * embedding_size];
+            const float32_t *dy_row = &dy_data[i * embedding_size];
+            for (int64_t j = begin; j < end; ++j)
+            {
+                dw_row[j] += dy_row[j];
+            }
+        }
+    }
+}
+
+static void runtime_embedding_backward_float64(int64_t n, int64_t vocabulary_size, int64_t embedding_size, const int64_t *indices,
+                                               const float64_t *dy_data, float64_t *dw_data, bool_t zero)
+{
+    int64_t blocks = (embedding_size + NW_EMBEDDING_COLUMNS - 1) / NW_EMBEDDING_COLUMNS;
+
+    // Each thread owns a block of columns, so repeated indices accumulate without races.
+    #pragma omp parallel for if (blocks > 1 && (n + vocabulary_size) * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t b = 0; b < blocks; ++b)
+    {
+        int64_t begin = b * NW_EMBEDDING_COLUMNS;
+        int64_t end = MIN(begin + NW_EMBEDDING_COLUMNS, embedding_size);
+
+        for (int64_t v = 0; zero && v < vocabulary_size; ++v)
+        {
+            for (int64_t j = begin; j < end; ++j)
+            {
+                dw_data[v * embedding_size + j] = (float64_t) 0.0;
+            }
+        }
+
+        for (int64_t i = 0; i < n; ++i)
+        {
+            float64_t *dw_row = &dw_data[indices[i] * embedding_size];
+            const float64_t *dy_row = &dy_data[i * embedding_size];
+            for (int64_t j = begin; j < end; ++j)
+            {
+                dw_row[j] += dy_row[j];
+            }
+        }
+    }
+}
+
+void runtime_embedding_backward(runtime_t runtime, datatype_t datatype, int64_t n, int64_t vocabulary_size, int64_t embedding_size, const int64_t *indices,
+                                void *dy_data, int64_t dy_offset, void *dw_data, int64_t dw_offset, bool_t zero)
+{
+    runtime_synchronize(runtime);
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        runtime_embedding_backward_float32(n, vocabulary_size, embedding_size, indices, &((float32_t *) dy_data)[dy_offset], &((float32_t *) dw_data)[dw_offset], zero);
+        break;
+    case FLOAT64:
+        runtime_embedding_backward_float64(n, vocabulary_size, embedding_size, indices, &((float64_t *) dy_data)[dy_offset], &((float64_t *) dw_data)[dw_offset], zero);
+        break;
+    default:
+        break;
+    }
+}
+
+static void runtime_sparse_stochastic_gradient_descent_float32(int64_t n, int64_t embedding_size, const int64_t *rows, const float32_t *g_data,
+                                                                float32_t *w_data, float32_t *m_data, float32_t learning_rate, float32_t momentum,
+                                                                float32_t dampening, float32_t weight_decay, bool_t nesterov, bool_t initialize)
+{
+    #pragma omp parallel for if (n * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        float32_t *w_row = &w_data[rows[i] * embedding_size];
+        float32_t *m_row = (m_data) ? &m_data[rows[i] * embedding_size] : NULL;
+        const float32_t *g_row = &g_data[i * embedding_size];
+        for (int64_t j = 0; j < embedding_size; ++j)
+        {
+            float32_t g = g_row[j] + weight_decay * w_row[j];
+            if (m_row)
+            {
+                m_row[j] = (initialize) ? g : momentum * m_row[j] + ((float32_t) 1.0 - dampening) * g;
+                g = (nesterov) ? g + momentum * m_row[j] : m_row[j];
+            }
+            w_row[j] -= learning_rate * g;
+        }
+    }
+}
+
+static void runtime_sparse_stochastic_gradient_descent_float64(int64_t n, int64_t embedding_size, const int64_t *rows, const float64_t *g_data,
+                                                                float64_t *w_data, float64_t *m_data, float64_t learning_rate, float64_t momentum,
+                                                                float64_t dampening, float64_t weight_decay, bool_t nesterov, bool_t initialize)
+{
+    #pragma omp parallel for if (n * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        float64_t *w_row = &w_data[rows[i] * embedding_size];
+        float64_t *m_row = (m_data) ? &m_data[rows[i] * embedding_size] : NULL;
+        const float64_t *g_row = &g_data[i * embedding_size];
+        for (int64_t j = 0; j < embedding_size; ++j)
+        {
+            float64_t g = g_row[j] + weight_decay * w_row[j];
+            if (m_row)
+            {
+                m_row[j] = (initialize) ? g : momentum * m_row[j] + ((float64_t) 1.0 - dampening) * g;
+                g = (nesterov) ? g + momentum * m_row[j] : m_row[j];
+            }
+            w_row[j] -= learning_rate * g;
+        }
+    }
+}
+
+/**
+ * @brief Stochastic gradient descent applied only to the rows of `w_data` listed in `rows`.
+ *        Momentum buffers of the other rows are left as they are.
+ */
+void runtime_sparse_stochastic_gradient_descent(runtime_t runtime, datatype_t datatype, int64_t n, int64_t embedding_size, const int64_t *rows,
+                                                void *g_data, int64_t g_offset, void *w_data, int64_t w_offset, void *m_data, int64_t m_offset,
+                                                float64_t learning_rate, float64_t momentum, float64_t dampening, float64_t weight_decay,
+                                                bool_t nesterov, bool_t initialize)
+{
+    runtime_synchronize(runtime);
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        runtime_sparse_stochastic_gradient_descent_float32(n, embedding_size, rows, &((float32_t *) g_data)[g_offset], &((float32_t *) w_data)[w_offset],
+                                                           (m_data) ? &((float32_t *) m_data)[m_offset] : NULL, (float32_t) learning_rate, (float32_t) momentum,
+                                                           (float32_t) dampening, (float32_t) weight_decay, nesterov, initialize);
+        break;
+    case FLOAT64:
+        runtime_sparse_stochastic_gradient_descent_float64(n, embedding_size, rows, &((float64_t *) g_data)[g_offset], &((float64_t *) w_data)[w_offset],
+                                                           (m_data) ? &((float64_t *) m_data)[m_offset] : NULL, learning_rate, momentum,
+                                                           dampening, weight_decay, nesterov, initialize);
+        break;
+    default:
+        break;
+    }
+}
+
+static void runtime_sparse_adam_float32(int64_t n, int64_t embedding_size, const int64_t *rows, const float32_t *g_data, float32_t *w_data,
+                                        float32_t *m_data, float32_t *v_data, int64_t *steps, int64_t step, float32_t learning_rate,
+                                        float32_t beta_1, float32_t beta_2, float32_t weight_decay, float32_t epsilon)
+{
+    float32_t correction_1 = (float32_t) 1.0 - powf(beta_1, (float32_t) step);
+    float32_t correction_2 = (float32_t) 1.0 - powf(beta_2, (float32_t) step);
+
+    #pragma omp parallel for if (n * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        float32_t *w_row = &w_data[rows[i] * embedding_size];
+        float32_t *m_row = &m_data[rows[i] * embedding_size];
+        float32_t *v_row = &v_data[rows[i] * embedding_size];
+        const float32_t *g_row = &g_data[i * embedding_size];
+        // Moments of a row skipped since its last update decay as if it had received zero gradients.
+        int64_t skipped = step - steps[rows[i]] - 1;
+        float32_t decay_1 = (skipped > 0) ? powf(beta_1, (float32_t) skipped) : (float32_t) 1.0;
+        float32_t decay_2 = (skipped > 0) ? powf(beta_2, (float32_t) skipped) : (float32_t) 1.0;
+        for (int64_t j = 0; j < embedding_size; ++j)
+        {
+            float32_t g = g_row[j] + weight_decay * w_row[j];
+            m_row[j] = beta_1 * decay_1 * m_row[j] + ((float32_t) 1.0 - beta_1) * g;
+            v_row[j] = beta_2 * decay_2 * v_row[j] + ((float32_t) 1.0 - beta_2) * g * g;
+            w_row[j] -= learning_rate * (m_row[j] / correction_1) / (sqrtf(v_row[j] / correction_2) + epsilon);
+        }
+        steps[rows[i]] = step;
+    }
+}
+
+static void runtime_sparse_adam_float64(int64_t n, int64_t embedding_size, const int64_t *rows, const float64_t *g_data, float64_t *w_data,
+                                        float64_t *m_data, float64_t *v_data, int64_t *steps, int64_t step, float64_t learning_rate,
+                                        float64_t beta_1, float64_t beta_2, float64_t weight_decay, float64_t epsilon)
+{
+    float64_t correction_1 = (float64_t) 1.0 - pow(beta_1, (float64_t) step);
+    float64_t correction_2 = (float64_t) 1.0 - pow(beta_2, (float64_t) step);
+
+    #pragma omp parallel for if (n * embedding_size >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        float64_t *w_row = &w_data[rows[i] * embedding_size];
+        float64_t *m_row = &m_data[rows[i] * embedding_size];
+        float64_t *v_row = &v_data[rows[i] * embedding_size];
+        const float64_t *g_row = &g_data[i * embedding_size];
+        // Moments of a row skipped since its last update decay as if it had received zero gradients.
+        int64_t skipped = step - steps[rows[i]] - 1;
+        float64_t decay_1 = (skipped > 0) ? pow(beta_1, (float64_t) skipped) : (float64_t) 1.0;
+        float64_t decay_2 = (skipped > 0) ? pow(beta_2, (float64_t) skipped) : (float64_t) 1.0;
+        for (int64_t j = 0; j < embedding_size; ++j)
+        {
+            float64_t g = g_row[j] + weight_decay * w_row[j];
+            m_row[j] = beta_1 * decay_1 * m_row[j] + ((float64_t) 1.0 - beta_1) * g;
+            v_row[j] = beta_2 * decay_2 * v_row[j] + ((float64_t) 1.0 - beta_2) * g * g;
+            w_row[j] -= learning_rate * (m_row[j] / correction_1) / (sqrt(v_row[j] / correction_2) + epsilon);
+        }
+        steps[rows[i]] = step;
+    }
+}
+
+/**
+ * @brief Lazy Adam applied only to the rows of `w_data` listed in `rows`.
+ *        `steps` holds the step each row was last updated at and is advanced to `step`.
+ */
+void runtime_sparse_adam(runtime_t runtime, datatype_t datatype, int64_t n, int64_t embedding_size, const int64_t *rows,
+                         void *g_data, int64_t g_offset, void *w_data, int64_t w_offset, void *m_data, int64_t m_offset, void *v_data, int64_t v_offset,
+                         int64_t *steps, int64_t step, float64_t learning_rate, float64_t beta_1, float64_t beta_2, float64_t weight_decay, float64_t epsilon)
+{
+    runtime_synchronize(runtime);
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        runtime_sparse_adam_float32(n, embedding_size, rows, &((float32_t *) g_data)[g_offset], &((float32_t *) w_data)[w_offset],
+                                    &((float32_t *) m_data)[m_offset], &((float32_t *) v_data)[v_offset], steps, step, (float32_t) learning_rate,
+                                    (float32_t) beta_1, (float32_t) beta_2, (float32_t) weight_decay, (float32_t) epsilon);
+        break;
+    case FLOAT64:
+        runtime_sparse_adam_float64(n, embedding_size, rows, &((float64_t *) g_data)[g_offset], &((float64_t *) w_data)[w_offset],
+                                    &((float64_t *) m_data)[m_offset], &((float64_t *) v_data)[v_offset], steps, step, learning_rate,
+                                    beta_1, beta_2, weight_decay, epsilon);
+        break;
+    default:
+        break;
+    }
+}
+
+string_t runtime_string(runtime_t runtime)
+{
+    switch (runtime)
+    {
+    case OPENBLAS_RUNTIME:
+        return "OPENBLAS_RUNTIME"; 
+    case MKL_RUNTIME:
+        return "MKL_RUNTIME";
+    case CU_RUNTIME:
+        return "CU_RUNTIME";
+    default:
+        return "RUNTIME";
+    }
+}
+
+static inline float64_t runtime_convert_load(datatype_t datatype, const void *data, int64_t i)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        return (float64_t) ((const float32_t *) data)[i];
+    case FLOAT64:
+        return ((const float64_t *) data)[i];
+    case BFLOAT16:
+        return (float64_t) bfloat16_to_float32(((const bfloat16_t *) data)[i]);
+    case FLOAT16:
+        return (float64_t) float16_to_float32(((const float16_t *) data)[i]);
+    case INT32:
+        return (float64_t) ((const int32_t *) data)[i];
+    case INT64:
+        return (float64_t) ((const int64_t *) data)[i];
+    default:
+        return 0.0;
+    }
+}
+
+static inline void runtime_convert_store(datatype_t datatype, void *data, int64_t i, float64_t value)
+{
+    switch (datatype)
+    {
+    case FLOAT32:
+        ((float32_t *) data)[i] = (float32_t) value;
+        break;
+    case FLOAT64:
+        ((float64_t *) data)[i] = value;
+        break;
+    case BFLOAT16:
+        ((bfloat16_t *) data)[i] = float32_to_bfloat16((float32_t) value);
+        break;
+    case FLOAT16:
+        ((float16_t *) data)[i] = float32_to_float16((float32_t) value);
+        break;
+    case INT32:
+        ((int32_t *) data)[i] = (int32_t) lrint(value);
+        break;
+    case INT64:
+        ((int64_t *) data)[i] = (int64_t) llrint(value);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Convert `n` contiguous elements between datatypes, rounding to nearest even when narrowing.
+ *        Floating point values stored into integer datatypes are rounded to the nearest integer.
+ */
+void runtime_convert(datatype_t source_datatype, const void *source, datatype_t destination_datatype, void *destination, int64_t n)
+{
+    if (source_datatype == destination_datatype)
+    {
+        memcpy(destination, source, n * datatype_size(source_datatype));
+        return;
+    }
+
+    // Reduced precision storage round trips through float32 on every kernel, so those get dedicated loops.
+    if (destination_datatype == FLOAT32)
+    {
+        switch (source_datatype)
+        {
+        case BFLOAT16:
+            #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+            for (int64_t i = 0; i < n; ++i)
+            {
+                ((float32_t *) destination)[i] = bfloat16_to_float32(((const bfloat16_t *) source)[i]);
+            }
+            return;
+        case FLOAT16:
+            #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+            for (int64_t i = 0; i < n; ++i)
+            {
+                ((float32_t *) destination)[i] = float16_to_float32(((const float16_t *) source)[i]);
+            }
+            return;
         default:
             break;
         }
-        break;
-#ifndef CPU_ONLY
-    case CU_RUNTIME:
-        switch (reduction_operation_type)
+    }
+
+    if (source_datatype == FLOAT32)
+    {
+        switch (destination_datatype)
         {
-        case MAXIMUM_OPERATION:
-            cu_maximum(datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            break;
-        case SUMMATION_OPERATION:
-            cu_summation(datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            break;
+        case BFLOAT16:
+            #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+            for (int64_t i = 0; i < n; ++i)
+            {
+                ((bfloat16_t *) destination)[i] = float32_to_bfloat16(((const float32_t *) source)[i]);
+            }
+            return;
+        case FLOAT16:
+            #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+            for (int64_t i = 0; i < n; ++i)
+            {
+                ((float16_t *) destination)[i] = float32_to_float16(((const float32_t *) source)[i]);
+            }
+            return;
         default:
             break;
         }
-        break;
-#endif
-    default:
-        break;
     }
-}
 
-void runtime_image_to_column(datatype_t datatype, void *x_data, 
-                             int64_t batch_size, int64_t channels, int64_t height, int64_t width, 
-                             int64_t kernel_size, int64_t output_height, int64_t output_width,
-                             int64_t stride, int64_t padding, void *y_data, bool_t inverse, void *padding_value)
-{
-    for (int64_t b = 0; b < batch_size; ++b)
+    // Indices are widened and narrowed natively, so int64 values above 2^53 survive the round trip.
+    if (source_datatype == INT32 && destination_datatype == INT64)
     {
-        int64_t b_offset_column = b * kernel_size * kernel_size * channels * output_height * output_width; 
-        int64_t b_offset_image = b * channels * height * width;
-        for (int64_t c = 0; c < channels * kernel_size * kernel_size; ++c) 
+        #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+        for (int64_t i = 0; i < n; ++i)
         {
-            int64_t w_offset = c % kernel_size;
-            int64_t h_offset = (c / kernel_size) % kernel_size;
-            int64_t channel = c / kernel_size / kernel_size;
-            for (int64_t h = 0; h < output_height; ++h)
-            {
-                int64_t row = h_offset + h * stride - padding;
-                for (int64_t w = 0; w < output_width; ++w)
-                {
-                    int64_t column = w_offset + w * stride - padding;
-                    int64_t column_index = b_offset_column + (c * output_height + h) * output_width + w;
-                    int64_t image_index = column + width * (row + height * channel) + b_offset_image;
-                    bool_t outside_boundary = row < 0 || column < 0 || row >= height || column >= width;
-                    if (inverse)
-                    {
-                        if (!outside_boundary)
-                        {
-                            switch (datatype)
-                            {
-                            case FLOAT32:
-                                ((float32_t *) y_data)[image_index] += ((float32_t *) x_data)[column_index];
-                                break;
-                            case FLOAT64:
-                                ((float64_t *) y_data)[image_index] += ((float64_t *) x_data)[column_index];
-                                break;
-                            default:
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        switch (datatype)
-                        {
-                        case FLOAT32:
-                            ((float32_t *) y_data)[column_index] = (outside_boundary) ? *(float32_t *) padding_value : ((float32_t *) x_data)[image_index];
-                            break;
-                        case FLOAT64:
-                            ((float64_t *) y_data)[column_index] = (outside_boundary) ? *(float64_t *) padding_value : ((float64_t *) x_data)[image_index];
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-                }
-            }
+            ((int64_t *) destination)[i] = (int64_t) ((const int32_t *) source)[i];
         }
+        return;
     }
-}
 
-string_t runtime_string(runtime_t runtime)
-{
-    switch (runtime)
+    if (source_datatype == INT64 && destination_datatype == INT32)
     {
-    case OPENBLAS_RUNTIME:
-        return "OPENBLAS_RUNTIME"; 
-    case MKL_RUNTIME:
-        return "MKL_RUNTIME";
-    case CU_RUNTIME:
-        return "CU_RUNTIME";
-    default:
-        return "RUNTIME";
+        #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+        for (int64_t i = 0; i < n; ++i)
+        {
+            ((int32_t *) destination)[i] = (int32_t) ((const int64_t *) source)[i];
+        }
+        return;
+    }
+
+    // Every other pair goes through float64, which is exact for all float32, int32 and int64 indices below 2^53.
+    #pragma omp parallel for if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        runtime_convert_store(destination_datatype, destination, i, runtime_convert_load(source_datatype, source, i));
     }
 }
 
@@ -625,38 +4070,461 @@ void runtime_arange(void *data, datatype_t datatype, void *start, void *stop, vo
     }
 }
 
+static void runtime_uniform_float32(float32_t *data, int64_t n, uint64_t seed, uint64_t offset, float32_t lower_bound, float32_t upper_bound)
+{
+    int64_t blocks = (n + 3) / 4;
+    float32_t range = upper_bound - lower_bound;
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < blocks; ++i)
+    {
+        uint32_t bits[4];
+        philox(seed, offset + (uint64_t) i, bits);
+        for (int64_t j = 0; j < 4; ++j)
+        {
+            if (4 * i + j < n)
+            {
+                data[4 * i + j] = philox_uniformf(bits[j]) * range + lower_bound;
+            }
+        }
+    }
+}
+
+static void runtime_uniform_float64(float64_t *data, int64_t n, uint64_t seed, uint64_t offset, float64_t lower_bound, float64_t upper_bound)
+{
+    int64_t blocks = (n + 1) / 2;
+    float64_t range = upper_bound - lower_bound;
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < blocks; ++i)
+    {
+        uint32_t bits[4];
+        philox(seed, offset + (uint64_t) i, bits);
+        data[2 * i] = philox_uniform(bits[0], bits[1]) * range + lower_bound;
+        if (2 * i + 1 < n)
+        {
+            data[2 * i + 1] = philox_uniform(bits[2], bits[3]) * range + lower_bound;
+        }
+    }
+}
+
+/**
+ * @brief Fill with uniform samples from the global Philox stream. Element i is a pure
+ *        function of (seed, offset, i), so the result does not depend on the thread count.
+ */
 void runtime_uniform(void *data, int64_t n, datatype_t datatype, void *lower_bound, void *upper_bound)
 {
-    for (int64_t i = 0; i < n; ++i)
+    switch (datatype)
     {
-        switch (datatype)
+    case FLOAT32:
+        runtime_uniform_float32((float32_t *) data, n, get_seed(), random_reserve((uint64_t) (n + 3) / 4),
+                                *(float32_t *) lower_bound, *(float32_t *) upper_bound);
+        break;
+    case FLOAT64:
+        runtime_uniform_float64((float64_t *) data, n, get_seed(), random_reserve((uint64_t) (n + 1) / 2),
+                                *(float64_t *) lower_bound, *(float64_t *) upper_bound);
+        break;
+    default:
+        break;
+    }
+}
+
+static void runtime_normal_float32(float32_t *data, int64_t n, uint64_t seed, uint64_t offset, float32_t mean, float32_t standard_deviation)
+{
+    int64_t blocks = (n + 3) / 4;
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < blocks; ++i)
+    {
+        uint32_t bits[4];
+        float32_t samples[4];
+        philox(seed, offset + (uint64_t) i, bits);
+        for (int64_t j = 0; j < 4; j += 2)
         {
-        case FLOAT32:
-            ((float32_t *) data)[i] = uniformf(*(float32_t *) lower_bound, *(float32_t *) upper_bound);
-            break;
-        case FLOAT64:
-            ((float64_t *) data)[i] = uniform(*(float64_t *) lower_bound, *(float64_t *) upper_bound);
-            break;
-        default:
-            break;
+            float32_t radius = standard_deviation * sqrtf(-2.0f * logf(philox_uniformf(bits[j])));
+            float32_t theta = (float32_t) RANDOM_TWO_PI * philox_uniformf(bits[j + 1]);
+            samples[j] = mean + radius * cosf(theta);
+            samples[j + 1] = mean + radius * sinf(theta);
+        }
+        for (int64_t j = 0; j < 4; ++j)
+        {
+            if (4 * i + j < n)
+            {
+                data[4 * i + j] = samples[j];
+            }
+        }
+    }
+}
+
+static void runtime_normal_float64(float64_t *data, int64_t n, uint64_t seed, uint64_t offset, float64_t mean, float64_t standard_deviation)
+{
+    int64_t blocks = (n + 1) / 2;
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < blocks; ++i)
+    {
+        uint32_t bits[4];
+        philox(seed, offset + (uint64_t) i, bits);
+        float64_t radius = standard_deviation * sqrt(-2.0 * log(philox_uniform(bits[0], bits[1])));
+        float64_t theta = RANDOM_TWO_PI * philox_uniform(bits[2], bits[3]);
+        data[2 * i] = mean + radius * cos(theta);
+        if (2 * i + 1 < n)
+        {
+            data[2 * i + 1] = mean + radius * sin(theta);
         }
     }
 }
 
+/**
+ * @brief Fill with normal samples using the Box-Muller transform over the global Philox stream.
+ */
 void runtime_normal(void *data, int64_t n, datatype_t datatype, void *mean, void *standard_deviation)
 {
+    switch (datatype)
+    {
+    case FLOAT32:
+        runtime_normal_float32((float32_t *) data, n, get_seed(), random_reserve((uint64_t) (n + 3) / 4),
+                               *(float32_t *) mean, *(float32_t *) standard_deviation);
+        break;
+    case FLOAT64:
+        runtime_normal_float64((float64_t *) data, n, get_seed(), random_reserve((uint64_t) (n + 1) / 2),
+                               *(float64_t *) mean, *(float64_t *) standard_deviation);
+        break;
+    default:
+        break;
+    }
+}
+
+static void runtime_dropout_float32(int64_t n, uint64_t seed, uint64_t offset, uint32_t threshold, const float32_t *x_data, float32_t *y_data)
+{
+    int64_t blocks = (n + 3) / 4;
+    float32_t scale = (float32_t) (0x1p32 / (0x1p32 - (float64_t) threshold));
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < blocks; ++i)
+    {
+        uint32_t bits[4];
+        philox(seed, offset + (uint64_t) i, bits);
+        for (int64_t j = 0; j < 4; ++j)
+        {
+            if (4 * i + j < n)
+            {
+                y_data[4 * i + j] = (bits[j] >= threshold) ? scale * x_data[4 * i + j] : (float32_t) 0.0;
+            }
+        }
+    }
+}
+
+static void runtime_dropout_float64(int64_t n, uint64_t seed, uint64_t offset, uint32_t threshold, const float64_t *x_data, float64_t *y_data)
+{
+    int64_t blocks = (n + 3) / 4;
+    float64_t scale = 0x1p32 / (0x1p32 - (float64_t) threshold);
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < blocks; ++i)
+    {
+        uint32_t bits[4];
+        philox(seed, offset + (uint64_t) i, bits);
+        for (int64_t j = 0; j < 4; ++j)
+        {
+            if (4 * i + j < n)
+            {
+                y_data[4 * i + j] = (bits[j] >= threshold) ? scale * x_data[4 * i + j] : (float64_t) 0.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Zero each element whose Philox word falls below `threshold` and scale the survivors by 2^32 / (2^32 - threshold).
+ *        The mask is a pure function of (seed, offset, element index), so the backward pass replays this
+ *        kernel on the incoming gradient instead of storing it.
+ * @param n Number of contiguous elements.
+ * @param seed Generator key the mask was drawn with.
+ * @param offset First Philox counter of the mask, one counter covers four elements.
+ * @param threshold Drop probability scaled to 2^32.
+ */
+void runtime_dropout(runtime_t runtime, datatype_t datatype, int64_t n, uint64_t seed, uint64_t offset, uint32_t threshold,
+                     void *x_data, int64_t x_offset, void *y_data, int64_t y_offset)
+{
+    runtime_synchronize(runtime);
+
+    switch (datatype)
+    {
+    case FLOAT32:
+        runtime_dropout_float32(n, seed, offset, threshold, &((float32_t *) x_data)[x_offset], &((float32_t *) y_data)[y_offset]);
+        break;
+    case FLOAT64:
+        runtime_dropout_float64(n, seed, offset, threshold, &((float64_t *) x_data)[x_offset], &((float64_t *) y_data)[y_offset]);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Symmetric per channel quantization of a weight matrix to int8.
+ *        Each channel is scaled by its largest magnitude so it spans [-127, 127], which keeps zero exact
+ *        and lets the weight zero point drop out of the GEMM.
+ * @param channels Number of output channels.
+ * @param features Number of weights in each channel.
+ * @param x_data Weights, element (c, f) is at `c * channel_stride + f * feature_stride`.
+ * @param y_data Quantized weights, channels x features.
+ * @param scales Per channel dequantization scale.
+ * @param sums Per channel sum of the quantized weights, used to remove the activation zero point after the GEMM.
+ */
+void runtime_quantize_channels(int64_t channels, int64_t features, const float32_t *x_data, int64_t channel_stride, int64_t feature_stride,
+                               int8_t *y_data, float32_t *scales, int32_t *sums)
+{
+    #pragma omp parallel for if (channels * features >= NW_PARALLEL_THRESHOLD)
+    for (int64_t c = 0; c < channels; ++c)
+    {
+        const float32_t *x_channel = &x_data[c * channel_stride];
+        int8_t *y_channel = &y_data[c * features];
+        float32_t maximum = 0.0f;
+        int32_t sum = 0;
+
+        for (int64_t f = 0; f < features; ++f)
+        {
+            maximum = MAX(maximum, fabsf(x_channel[f * feature_stride]));
+        }
+
+        float32_t scale = (maximum > 0.0f) ? maximum / (float32_t) NW_QUANTIZATION_WEIGHT_MAXIMUM : 1.0f;
+        float32_t inverse = 1.0f / scale;
+        for (int64_t f = 0; f < features; ++f)
+        {
+            int32_t q = (int32_t) lrintf(x_channel[f * feature_stride] * inverse);
+            q = MIN(MAX(q, -NW_QUANTIZATION_WEIGHT_MAXIMUM), NW_QUANTIZATION_WEIGHT_MAXIMUM);
+            y_channel[f] = (int8_t) q;
+            sum += q;
+        }
+
+        scales[c] = scale;
+        sums[c] = sum;
+    }
+}
+
+/**
+ * @brief Dynamic asymmetric quantization parameters of an activation tensor.
+ *        The range always contains zero so padding and rectified activations are represented exactly.
+ */
+static void runtime_quantization_range(int64_t n, const float32_t *x_data, float32_t *scale, int32_t *zero_point)
+{
+    float32_t minimum = 0.0f;
+    float32_t maximum = 0.0f;
+
+    #pragma omp parallel for simd reduction(min:minimum) reduction(max:maximum) if (n >= NW_PARALLEL_THRESHOLD)
     for (int64_t i = 0; i < n; ++i)
     {
-        switch (datatype)
+        minimum = MIN(minimum, x_data[i]);
+        maximum = MAX(maximum, x_data[i]);
+    }
+
+    *scale = (maximum > minimum) ? (maximum - minimum) / (float32_t) NW_QUANTIZATION_ACTIVATION_MAXIMUM : 1.0f;
+    *zero_point = MIN(MAX((int32_t) lrintf(-minimum / *scale), 0), NW_QUANTIZATION_ACTIVATION_MAXIMUM);
+}
+
+static void runtime_quantize_activation(int64_t n, const float32_t *x_data, float32_t scale, int32_t zero_point, uint8_t *y_data)
+{
+    float32_t inverse = 1.0f / scale;
+
+    #pragma omp parallel for simd if (n >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        int32_t q = (int32_t) lrintf(x_data[i] * inverse) + zero_point;
+        y_data[i] = (uint8_t) MIN(MAX(q, 0), NW_QUANTIZATION_ACTIVATION_MAXIMUM);
+    }
+}
+
+static void runtime_quantized_matrix_multiplication_portable(int64_t channels, int64_t depth, int64_t n, bool_t channels_last,
+                                                             const int8_t *w_data, const uint8_t *x_data, int32_t *z_data)
+{
+    if (channels_last)
+    {
+        #pragma omp parallel for collapse(2) if (channels * depth * n >= NW_PARALLEL_THRESHOLD)
+        for (int64_t j = 0; j < n; ++j)
         {
-        case FLOAT32:
-            ((float32_t *) data)[i] = normalf(*(float32_t *) mean, *(float32_t *) standard_deviation);
-            break;
-        case FLOAT64:
-            ((float64_t *) data)[i] = normal(*(float64_t *) mean, *(float64_t *) standard_deviation);
-            break;
-        default:
-            break;
+            for (int64_t c = 0; c < channels; ++c)
+            {
+                const int8_t *w_row = &w_data[c * depth];
+                const uint8_t *x_row = &x_data[j * depth];
+                int32_t sum = 0;
+
+                #pragma omp simd reduction(+:sum)
+                for (int64_t p = 0; p < depth; ++p)
+                {
+                    sum += (int32_t) w_row[p] * (int32_t) x_row[p];
+                }
+
+                z_data[j * channels + c] = sum;
+            }
+        }
+    }
+    else
+    {
+        #pragma omp parallel for if (channels * depth * n >= NW_PARALLEL_THRESHOLD)
+        for (int64_t c = 0; c < channels; ++c)
+        {
+            const int8_t *w_row = &w_data[c * depth];
+            int32_t *z_row = &z_data[c * n];
+
+            for (int64_t j = 0; j < n; ++j)
+            {
+                z_row[j] = 0;
+            }
+
+            for (int64_t p = 0; p < depth; ++p)
+            {
+                int32_t w = (int32_t) w_row[p];
+                const uint8_t *x_row = &x_data[p * n];
+                if (!w)
+                {
+                    continue;
+                }
+
+                #pragma omp simd
+                for (int64_t j = 0; j < n; ++j)
+                {
+                    z_row[j] += w * (int32_t) x_row[j];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Integer GEMM of int8 weights with uint8 activations accumulated in int32.
+ *        With `channels_last` the activations are n x depth and the result is n x channels (linear),
+ *        otherwise the activations are depth x n and the result is channels x n (convolution).
+ */
+static void runtime_quantized_matrix_multiplication(runtime_t runtime, int64_t channels, int64_t depth, int64_t n, bool_t channels_last,
+                                                    const int8_t *w_data, const uint8_t *x_data, int32_t *z_data)
+{
+    switch (runtime)
+    {
+    case MKL_RUNTIME:
+        mkl_quantized_matrix_multiplication(channels, depth, n, channels_last, w_data, x_data, z_data);
+        break;
+    default:
+        // OpenBLAS has no integer GEMM and the CUDA runtime's managed storage is host accessible.
+        runtime_quantized_matrix_multiplication_portable(channels, depth, n, channels_last, w_data, x_data, z_data);
+        break;
+    }
+}
+
+/**
+ * @brief Fully connected layer on int8 weights, y = x * w^T + b, with the activations quantized on the fly.
+ * @param rows Number of rows of `x` (all leading dimensions flattened).
+ * @param w_data Per channel quantized weights, out_features x in_features.
+ * @param b_data Optional bias of length out_features.
+ * @param y_data Output, rows x out_features.
+ */
+nw_error_t *runtime_quantized_linear(runtime_t runtime, int64_t rows, int64_t in_features, int64_t out_features,
+                                     const float32_t *x_data, const int8_t *w_data, const float32_t *w_scales, const int32_t *w_sums,
+                                     const float32_t *b_data, float32_t *y_data)
+{
+    nw_error_t *error = NULL;
+    uint8_t *q_data = NULL;
+    int32_t *z_data = NULL;
+    float32_t scale;
+    int32_t zero_point;
+
+    q_data = (uint8_t *) malloc((size_t) (rows * in_features) * sizeof(uint8_t));
+    z_data = (int32_t *) malloc((size_t) (rows * out_features) * sizeof(int32_t));
+    if (!q_data || !z_data)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate quantization workspace."), NULL);
+        goto cleanup;
+    }
+
+    runtime_synchronize(runtime);
+    runtime_quantization_range(rows * in_features, x_data, &scale, &zero_point);
+    runtime_quantize_activation(rows * in_features, x_data, scale, zero_point, q_data);
+    runtime_quantized_matrix_multiplication(runtime, out_features, in_features, rows, true, w_data, q_data, z_data);
+
+    #pragma omp parallel for collapse(2) if (rows * out_features >= NW_PARALLEL_THRESHOLD)
+    for (int64_t i = 0; i < rows; ++i)
+    {
+        for (int64_t c = 0; c < out_features; ++c)
+        {
+            int32_t z = z_data[i * out_features + c] - zero_point * w_sums[c];
+            y_data[i * out_features + c] = scale * w_scales[c] * (float32_t) z + ((b_data) ? b_data[c] : 0.0f);
+        }
+    }
+
+cleanup:
+
+    free(q_data);
+    free(z_data);
+
+    return error;
+}
+
+/**
+ * @brief 2D convolution on int8 weights through image to column and the integer GEMM.
+ *        The activation scale is taken over the whole input so every image shares one quantization,
+ *        and the zero padding of the column matrix maps exactly onto the zero point.
+ * @param w_data Per channel quantized kernel, out_channels x (in_channels * kernel_size * kernel_size).
+ * @param b_data Optional bias of length out_channels.
+ */
+nw_error_t *runtime_quantized_convolution_2d(runtime_t runtime, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                             int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                             const float32_t *x_data, const int8_t *w_data, const float32_t *w_scales, const int32_t *w_sums,
+                                             const float32_t *b_data, float32_t *y_data)
+{
+    nw_error_t *error = NULL;
+    int64_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    int64_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    int64_t depth = in_channels * kernel_size * kernel_size;
+    int64_t size = output_height * output_width;
+    float32_t *column_data = NULL;
+    uint8_t *q_data = NULL;
+    int32_t *z_data = NULL;
+    float32_t zero = 0.0f;
+    float32_t scale;
+    int32_t zero_point;
+
+    column_data = (float32_t *) malloc((size_t) (depth * size) * sizeof(float32_t));
+    q_data = (uint8_t *) malloc((size_t) (depth * size) * sizeof(uint8_t));
+    z_data = (int32_t *) malloc((size_t) (out_channels * size) * sizeof(int32_t));
+    if (!column_data || !q_data || !z_data)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate quantization workspace."), NULL);
+        goto cleanup;
+    }
+
+    runtime_synchronize(runtime);
+    runtime_quantization_range(batch_size * in_channels * height * width, x_data, &scale, &zero_point);
+
+    for (int64_t b = 0; b < batch_size; ++b)
+    {
+        float32_t *y_image = &y_data[b * out_channels * size];
+
+        runtime_image_to_column(FLOAT32, (void *) &x_data[b * in_channels * height * width], 1, in_channels, height, width,
+                                kernel_size, output_height, output_width, stride, padding, column_data, false, &zero);
+        runtime_quantize_activation(depth * size, column_data, scale, zero_point, q_data);
+        runtime_quantized_matrix_multiplication(runtime, out_channels, depth, size, false, w_data, q_data, z_data);
+
+        #pragma omp parallel for if (out_channels * size >= NW_PARALLEL_THRESHOLD)
+        for (int64_t c = 0; c < out_channels; ++c)
+        {
+            float32_t channel_scale = scale * w_scales[c];
+            int32_t correction = zero_point * w_sums[c];
+            float32_t bias = (b_data) ? b_data[c] : 0.0f;
+
+            #pragma omp simd
+            for (int64_t s = 0; s < size; ++s)
+            {
+                y_image[c * size + s] = channel_scale * (float32_t) (z_data[c * size + s] - correction) + bias;
+            }
         }
     }
+
+cleanup:
+
+    free(column_data);
+    free(q_data);
+    free(z_data);
+
+    return error;
 }
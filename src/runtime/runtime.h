@@ -26,32 +26,100 @@ typedef enum runtime_t
 
 #define EPSILON 1e-7
 
+typedef struct allocator_statistics_t
+{
+    size_t bytes_in_use;
+    size_t bytes_cached;
+    uint64_t hits;
+    uint64_t misses;
+    float64_t hit_rate;
+    size_t bytes_arena;
+    size_t bytes_arena_retired;
+    uint64_t arena_survivors;
+} allocator_statistics_t;
+
 nw_error_t *runtime_create_context(runtime_t runtime);
 void runtime_destroy_context(runtime_t runtime);
 nw_error_t *runtime_malloc(void **data, int64_t n, datatype_t datatype, runtime_t runtime);
-void runtime_free(void *data, runtime_t runtime);
+void runtime_free(void *data, int64_t n, datatype_t datatype, runtime_t runtime);
+void runtime_release(void *data, runtime_t runtime);
+void runtime_allocator_trim(runtime_t runtime, size_t limit);
+void runtime_allocator_statistics(runtime_t runtime, allocator_statistics_t *statistics);
+void runtime_arena_begin(void);
+void runtime_arena_end(void);
+void runtime_arena_suspend(bool_t suspend);
+bool_t runtime_arena_contains(void *data, runtime_t runtime);
 void runtime_synchronize(runtime_t runtime);
-void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n, 
-                   void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset);
-void runtime_binary_elementwise(binary_operation_type_t binary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
-                                void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_stride, int64_t y_offset,
-                                void *z_data, int64_t z_stride, int64_t z_offset);
-void runtime_ternary(ternary_operation_type_t ternary_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
-                     void *w_data, int64_t w_stride, int64_t w_offset, void *x_data, int64_t x_stride, int64_t x_offset, 
-                     void *y_data, int64_t y_stride, int64_t y_offset, void *z_data, int64_t z_stride, int64_t z_offset);
-void runtime_matrix_multiplication(runtime_t runtime, datatype_t datatype, int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose,
-                                   void *x_data, int64_t x_offset, void *y_data, int64_t y_offset, void *z_data, int64_t z_offset);
-void runtime_reduction(reduction_operation_type_t reduction_operation_type, runtime_t runtime, datatype_t datatype, int64_t n,
-                       void *x_data, int64_t x_stride, int64_t x_offset, void *y_data, int64_t y_offset);
+void runtime_unary(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                   void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset);
+void runtime_unary_gradient(unary_operation_type_t unary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                            void *x_data, const int64_t *x_strides, int64_t x_offset, void *dy_data, const int64_t *dy_strides, int64_t dy_offset,
+                            void *dx_data, const int64_t *dx_strides, int64_t dx_offset);
+void runtime_binary_elementwise(binary_operation_type_t binary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                                void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset,
+                                void *z_data, const int64_t *z_strides, int64_t z_offset);
+void runtime_scaled_addition(runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape, const void *alpha,
+                             void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset);
+void runtime_ternary(ternary_operation_type_t ternary_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                     void *w_data, const int64_t *w_strides, int64_t w_offset, void *x_data, const int64_t *x_strides, int64_t x_offset, 
+                     void *y_data, const int64_t *y_strides, int64_t y_offset, void *z_data, const int64_t *z_strides, int64_t z_offset);
+void runtime_matrix_multiplication(runtime_t runtime, datatype_t datatype, int64_t batch_rank, const int64_t *batch_shape, 
+                                   int64_t m, int64_t k, int64_t n, bool_t x_transpose, bool_t y_transpose,
+                                   void *x_data, const int64_t *x_batch_strides, int64_t x_offset, int64_t x_leading_dimension,
+                                   void *y_data, const int64_t *y_batch_strides, int64_t y_offset, int64_t y_leading_dimension,
+                                   void *z_data, const int64_t *z_batch_strides, int64_t z_offset, int64_t z_leading_dimension);
+void runtime_reduction(reduction_operation_type_t reduction_operation_type, runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape,
+                       void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset);
+void runtime_softmax(runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape, int64_t axis, bool_t logarithm,
+                     void *x_data, const int64_t *x_strides, int64_t x_offset, void *y_data, const int64_t *y_strides, int64_t y_offset);
+void runtime_softmax_backward(runtime_t runtime, datatype_t datatype, int64_t rank, const int64_t *shape, int64_t axis, bool_t logarithm,
+                              void *y_data, const int64_t *y_strides, int64_t y_offset, void *dy_data, const int64_t *dy_strides, int64_t dy_offset,
+                              void *dx_data, const int64_t *dx_strides, int64_t dx_offset);
+nw_error_t *runtime_convolution_2d(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                   int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                   void *x_data, int64_t x_offset, void *w_data, int64_t w_offset, void *y_data, int64_t y_offset);
+nw_error_t *runtime_convolution_2d_backward(runtime_t runtime, datatype_t datatype, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                            int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                            void *x_data, int64_t x_offset, void *w_data, int64_t w_offset, void *dy_data, int64_t dy_offset,
+                                            void *dx_data, int64_t dx_offset, void *dw_data, int64_t dw_offset);
+void runtime_pooling_2d(structure_operation_type_t structure_operation_type, runtime_t runtime, datatype_t datatype, 
+                        int64_t batch_size, int64_t channels, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                        void *x_data, int64_t x_offset, void *y_data, int64_t y_offset, int32_t *indices);
+void runtime_pooling_2d_backward(structure_operation_type_t structure_operation_type, runtime_t runtime, datatype_t datatype, 
+                                 int64_t batch_size, int64_t channels, int64_t height, int64_t width, int64_t kernel_size, int64_t stride, int64_t padding,
+                                 const int32_t *indices, void *dy_data, int64_t dy_offset, void *dx_data, int64_t dx_offset);
+void runtime_embedding(runtime_t runtime, datatype_t datatype, int64_t n, int64_t embedding_size, const int64_t *indices,
+                       void *w_data, int64_t w_offset, void *y_data, int64_t y_offset);
+void runtime_embedding_backward(runtime_t runtime, datatype_t datatype, int64_t n, int64_t vocabulary_size, int64_t embedding_size, const int64_t *indices,
+                                void *dy_data, int64_t dy_offset, void *dw_data, int64_t dw_offset, bool_t zero);
+void runtime_sparse_stochastic_gradient_descent(runtime_t runtime, datatype_t datatype, int64_t n, int64_t embedding_size, const int64_t *rows,
+                                                void *g_data, int64_t g_offset, void *w_data, int64_t w_offset, void *m_data, int64_t m_offset,
+                                                float64_t learning_rate, float64_t momentum, float64_t dampening, float64_t weight_decay,
+                                                bool_t nesterov, bool_t initialize);
+void runtime_sparse_adam(runtime_t runtime, datatype_t datatype, int64_t n, int64_t embedding_size, const int64_t *rows,
+                         void *g_data, int64_t g_offset, void *w_data, int64_t w_offset, void *m_data, int64_t m_offset, void *v_data, int64_t v_offset,
+                         int64_t *steps, int64_t step, float64_t learning_rate, float64_t beta_1, float64_t beta_2, float64_t weight_decay, float64_t epsilon);
 string_t runtime_string(runtime_t runtime);
+void runtime_convert(datatype_t source_datatype, const void *source, datatype_t destination_datatype, void *destination, int64_t n);
 void runtime_zeroes(void *data, int64_t n, datatype_t datatype);
 void runtime_ones(void *data, int64_t n, datatype_t datatype);
 void runtime_arange(void *data, datatype_t datatype, void *start, void *stop, void *step);
 void runtime_uniform(void *data, int64_t n, datatype_t datatype, void *lower_bound, void *upper_bound);
 void runtime_normal(void *data, int64_t n, datatype_t datatype, void *mean, void *standard_deviation);
+void runtime_dropout(runtime_t runtime, datatype_t datatype, int64_t n, uint64_t seed, uint64_t offset, uint32_t threshold,
+                     void *x_data, int64_t x_offset, void *y_data, int64_t y_offset);
 void runtime_image_to_column(datatype_t datatype, void *x_data, 
                              int64_t batch_size, int64_t channels, int64_t height, int64_t width, 
                              int64_t kernel_size, int64_t output_height, int64_t output_width,
                              int64_t stride, int64_t padding, void *y_data, bool_t inverse, void *padding_value);
+void runtime_quantize_channels(int64_t channels, int64_t features, const float32_t *x_data, int64_t channel_stride, int64_t feature_stride,
+                               int8_t *y_data, float32_t *scales, int32_t *sums);
+nw_error_t *runtime_quantized_linear(runtime_t runtime, int64_t rows, int64_t in_features, int64_t out_features,
+                                     const float32_t *x_data, const int8_t *w_data, const float32_t *w_scales, const int32_t *w_sums,
+                                     const float32_t *b_data, float32_t *y_data);
+nw_error_t *runtime_quantized_convolution_2d(runtime_t runtime, int64_t batch_size, int64_t in_channels, int64_t height, int64_t width,
+                                             int64_t out_channels, int64_t kernel_size, int64_t stride, int64_t padding,
+                                             const float32_t *x_data, const int8_t *w_data, const float32_t *w_scales, const int32_t *w_sums,
+                                             const float32_t *b_data, float32_t *y_data);
 
 #endif
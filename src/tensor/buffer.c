@@ -1,27 +1,29 @@
 #include <buffer.h>
 #include <view.h>
+#include <slab.h>
 #include <string.h>
-#include <sort.h>
 
 nw_error_t *storage_create(storage_t **storage, runtime_t runtime, datatype_t datatype, int64_t n, void *data, bool_t copy)
 {
     CHECK_NULL_ARGUMENT(storage, "storage");
 
-    *storage = (storage_t *) malloc(sizeof(storage_t));
-    if (!*storage)
+    if (!n)
     {
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(storage_t)), NULL);
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("storage must store more than 0 bytes of data."), NULL);
     }
 
-    if (!n)
+    *storage = (storage_t *) slab_malloc(sizeof(storage_t));
+    if (!*storage)
     {
-        return ERROR(ERROR_MEMORY_ALLOCATION, "storage must store more than 0 bytes of data.", NULL);
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(storage_t)), NULL);
     }
 
     (*storage)->runtime = runtime;
     (*storage)->datatype = datatype;
     (*storage)->n = n;
     (*storage)->reference_count = 0;
+    (*storage)->allocated = copy;
+    (*storage)->version = 0;
 
     runtime_synchronize(runtime);
 
@@ -30,7 +32,7 @@ nw_error_t *storage_create(storage_t **storage, runtime_t runtime, datatype_t da
         nw_error_t *error = runtime_malloc(&(*storage)->data, n, datatype, runtime);
         if (error)
         {
-            free(*storage);
+            slab_free(*storage, sizeof(storage_t));
             return ERROR(ERROR_MEMORY_ALLOCATION,
                          string_create("failed to allocate buffer data for runtime %s and datatype %s.",
                          runtime_string(runtime), datatype_string(datatype)), error);
@@ -57,8 +59,15 @@ void storage_destroy(storage_t *storage)
     {
         if (storage->reference_count < 2)
         {
-            runtime_free(storage->data, storage->runtime);
-            free(storage);
+            if (storage->allocated)
+            {
+                runtime_free(storage->data, storage->n, storage->datatype, storage->runtime);
+            }
+            else
+            {
+                runtime_release(storage->data, storage->runtime);
+            }
+            slab_free(storage, sizeof(storage_t));
         }
         else
         {
@@ -67,7 +76,7 @@ void storage_destroy(storage_t *storage)
     }
 }
 
-nw_error_t *buffer_create(buffer_t **buffer, view_t *view, storage_t *storage, bool_t copy)
+nw_error_t *buffer_create(buffer_t **buffer, const view_t *view, storage_t *storage, bool_t copy)
 {
     CHECK_NULL_ARGUMENT(buffer, "buffer");
     CHECK_NULL_ARGUMENT(view, "view");
@@ -75,20 +84,20 @@ nw_error_t *buffer_create(buffer_t **buffer, view_t *view, storage_t *storage, b
 
     nw_error_t *error = NULL;
 
-    *buffer = (buffer_t *) malloc(sizeof(buffer_t));
+    *buffer = (buffer_t *) slab_malloc(sizeof(buffer_t));
     if (!*buffer)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate buffer of size %zu bytes.", sizeof(buffer_t)), NULL);
     }
 
-    (*buffer)->view = view;
+    (*buffer)->view = *view;
 
     if (copy)
     {
         error = storage_create(&(*buffer)->storage, storage->runtime, storage->datatype, storage->n, storage->data, copy);
         if (error)
         {
-            free(*buffer);
+            slab_free(*buffer, sizeof(buffer_t));
             return ERROR(ERROR_CREATE, string_create("failed to create storage copy."), error);
         }
     }
@@ -106,9 +115,85 @@ void buffer_destroy(buffer_t *buffer)
     if (buffer)
     {
         storage_destroy(buffer->storage);
-        view_destroy(buffer->view);
-        free(buffer);
+        slab_free(buffer, sizeof(buffer_t));
+    }
+}
+
+/**
+ * @brief Move the storage of a buffer out of the step arena so it can outlive the step.
+ *        Buffers sharing the storage see the new memory. Storage outside the arena is left as is.
+ * @param buffer Buffer whose storage is moved.
+ * @return Error if the buffer is NULL or the memory could not be allocated.
+ *         NULL if the storage does not live in the arena or was moved successfully.
+ */
+nw_error_t *buffer_persist(buffer_t *buffer)
+{
+    CHECK_NULL_ARGUMENT(buffer, "buffer");
+    CHECK_NULL_ARGUMENT(buffer->storage, "buffer->storage");
+
+    nw_error_t *error = NULL;
+    storage_t *storage = buffer->storage;
+    void *data = NULL;
+
+    if (!storage->allocated || !runtime_arena_contains(storage->data, storage->runtime))
+    {
+        return error;
+    }
+
+    runtime_arena_suspend(true);
+    error = runtime_malloc(&data, storage->n, storage->datatype, storage->runtime);
+    runtime_arena_suspend(false);
+    if (error)
+    {
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate buffer data for runtime %s and datatype %s.",
+                     runtime_string(storage->runtime), datatype_string(storage->datatype)), error);
+    }
+
+    runtime_synchronize(storage->runtime);
+    memcpy(data, storage->data, storage->n * datatype_size(storage->datatype));
+    runtime_free(storage->data, storage->n, storage->datatype, storage->runtime);
+    storage->data = data;
+
+    return error;
+}
+
+/**
+ * @brief Overwrite the elements of a contiguous buffer with zeroes in place.
+ *        Zero is all bits clear in every datatype, so the elements are cleared with memset without conversion.
+ * @param buffer Buffer whose elements are cleared.
+ * @return Error if the buffer is NULL or not contiguous.
+ *         NULL if the elements were cleared.
+ */
+nw_error_t *buffer_zero(buffer_t *buffer)
+{
+    CHECK_NULL_ARGUMENT(buffer, "buffer");
+    CHECK_NULL_ARGUMENT(buffer->storage, "buffer->storage");
+
+    nw_error_t *error = NULL;
+    bool_t is_contiguous;
+    int64_t n;
+
+    error = view_is_contiguous(&buffer->view, &is_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to determine if view is contiguous."), error);
+    }
+
+    if (!is_contiguous)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("cannot zero a buffer that is not contiguous."), NULL);
+    }
+
+    error = view_logical_size(&buffer->view, &n);
+    if (error)
+    {
+        return ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
     }
+
+    runtime_synchronize(buffer->storage->runtime);
+    memset((char *) buffer->storage->data + buffer->view.offset * datatype_size(buffer->storage->datatype), 0, n * datatype_size(buffer->storage->datatype));
+
+    return error;
 }
 
 nw_error_t *storage_save(storage_t *storage, FILE *file)
@@ -146,7 +231,7 @@ nw_error_t *storage_load(storage_t **storage, FILE *file)
 
     nw_error_t *error = NULL;
 
-    *storage = (storage_t *) malloc(sizeof(storage_t));
+    *storage = (storage_t *) slab_malloc(sizeof(storage_t));
     if (!*storage)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(storage_t)), NULL);
@@ -155,6 +240,8 @@ nw_error_t *storage_load(storage_t **storage, FILE *file)
 
     (*storage)->reference_count = 0;
     (*storage)->data = NULL;
+    (*storage)->allocated = true;
+    (*storage)->version = 0;
 
     if (!fread(&(*storage)->n, sizeof(int64_t), 1, file))
     {
@@ -209,7 +296,7 @@ nw_error_t *buffer_save(buffer_t *buffer, FILE *file)
 
     nw_error_t *error = NULL;
 
-    error = view_save(buffer->view, file);
+    error = view_save(&buffer->view, file);
     if (error)
     {
         return ERROR(ERROR_SAVE, string_create("failed to save view."), error);
@@ -231,14 +318,13 @@ nw_error_t *buffer_load(buffer_t **buffer, FILE *file)
 
     nw_error_t *error = NULL;
 
-    *buffer = (buffer_t *) malloc(sizeof(buffer_t));
+    *buffer = (buffer_t *) slab_malloc(sizeof(buffer_t));
     if (!*buffer)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate buffer of size %zu bytes.", sizeof(buffer_t)), NULL);
         goto cleanup;
     }
 
-    (*buffer)->view = NULL;
     (*buffer)->storage = NULL;
 
     error = view_load(&(*buffer)->view, file);
@@ -264,33 +350,159 @@ cleanup:
     return error;
 }
 
+/**
+ * @brief Get the data of a storage in its compute datatype. Reduced precision and integer storage is
+ *        expanded into a copy of the elements in [begin, end) that must be handed back to
+ *        `storage_compute_release`, other storage is returned in place.
+ *        A copy starts at element `begin` of the storage, see `buffer_compute_acquire` for the offsets to index it with.
+ * @param storage Storage to read.
+ * @param begin First element of the storage that is accessed.
+ * @param end One past the last element of the storage that is accessed.
+ * @param copy Whether the current contents are needed. Results that are fully overwritten skip the conversion.
+ * @param data Set to the data in the compute datatype.
+ * @return Error if the arguments are NULL or the copy could not be allocated.
+ *         NULL if the data was acquired successfully.
+ */
+static nw_error_t *storage_compute_acquire(storage_t *storage, int64_t begin, int64_t end, bool_t copy, void **data)
+{
+    CHECK_NULL_ARGUMENT(storage, "storage");
+    CHECK_NULL_ARGUMENT(data, "data");
+
+    nw_error_t *error = NULL;
+    datatype_t datatype = datatype_compute(storage->datatype);
+    int64_t n = end - begin;
+
+    if (datatype == storage->datatype)
+    {
+        *data = storage->data;
+        return error;
+    }
+
+    error = runtime_malloc(data, MAX(n, 1), datatype, storage->runtime);
+    if (error)
+    {
+        *data = NULL;
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %s copy of %s storage.", 
+                     datatype_string(datatype), datatype_string(storage->datatype)), error);
+    }
+
+    if (copy && n > 0)
+    {
+        runtime_synchronize(storage->runtime);
+        runtime_convert(storage->datatype, (char *) storage->data + begin * datatype_size(storage->datatype), datatype, *data, n);
+    }
+
+    return error;
+}
+
+/**
+ * @brief Release data acquired with `storage_compute_acquire`.
+ * @param storage Storage the data was acquired from.
+ * @param begin First element of the storage given to `storage_compute_acquire`.
+ * @param end One past the last element of the storage given to `storage_compute_acquire`.
+ * @param data The acquired data, may be NULL.
+ * @param store Whether to round the elements in [begin, end) back into the storage.
+ */
+static void storage_compute_release(storage_t *storage, int64_t begin, int64_t end, void *data, bool_t store)
+{
+    if (storage && data && datatype_compute(storage->datatype) != storage->datatype)
+    {
+        datatype_t datatype = datatype_compute(storage->datatype);
+        int64_t n = end - begin;
+
+        if (store && n > 0)
+        {
+            runtime_synchronize(storage->runtime);
+            runtime_convert(datatype, data, storage->datatype, (char *) storage->data + begin * datatype_size(storage->datatype), n);
+        }
+        runtime_free(data, MAX(n, 1), datatype, storage->runtime);
+    }
+}
+
+/**
+ * @brief Find the range of storage elements [begin, end) a view can reach, from its lowest to its highest
+ *        strided element.
+ */
+static void view_storage_span(const view_t *view, int64_t *begin, int64_t *end)
+{
+    *begin = view->offset;
+    *end = view->offset + 1;
+
+    for (int64_t i = 0; i < view->rank; ++i)
+    {
+        if (!view->shape[i])
+        {
+            *end = *begin;
+            return;
+        }
+
+        int64_t extent = (view->shape[i] - 1) * view->strides[i];
+        if (extent < 0)
+        {
+            *begin += extent;
+        }
+        else
+        {
+            *end += extent;
+        }
+    }
+}
+
+/**
+ * @brief Get the data of a buffer in its compute datatype. Only the span of storage the view of the buffer
+ *        covers is converted, see `storage_compute_acquire`.
+ * @param offset Set to the offset of the view into the acquired data, which is the view offset
+ *               rebased to the start of the span for converted storage.
+ */
+static nw_error_t *buffer_compute_acquire(buffer_t *buffer, bool_t copy, void **data, int64_t *offset)
+{
+    CHECK_NULL_ARGUMENT(buffer, "buffer");
+    CHECK_NULL_ARGUMENT(buffer->storage, "buffer->storage");
+    CHECK_NULL_ARGUMENT(offset, "offset");
+
+    int64_t begin, end;
+    view_storage_span(&buffer->view, &begin, &end);
+
+    *offset = buffer->view.offset;
+    if (datatype_compute(buffer->storage->datatype) != buffer->storage->datatype)
+    {
+        *offset -= begin;
+    }
+
+    return storage_compute_acquire(buffer->storage, begin, end, copy, data);
+}
+
+/**
+ * @brief Release data acquired with `buffer_compute_acquire`. The view of the buffer must not have changed.
+ */
+static void buffer_compute_release(buffer_t *buffer, void *data, bool_t store)
+{
+    if (buffer)
+    {
+        int64_t begin, end;
+        view_storage_span(&buffer->view, &begin, &end);
+        storage_compute_release(buffer->storage, begin, end, data, store);
+    }
+}
+
 nw_error_t *buffer_unary(unary_operation_type_t unary_operation_type, buffer_t *x_buffer, buffer_t **y_buffer)
 {
     CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
     CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
-    CHECK_NULL_ARGUMENT(x_buffer->view, "x_buffer->view");
-    CHECK_NULL_ARGUMENT(x_buffer->view->strides, "x_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(x_buffer->view->shape, "x_buffer->view->shape");
     CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
     CHECK_NULL_ARGUMENT(x_buffer->storage->data, "x_buffer->storage->data");
 
     nw_error_t *error = NULL;
     bool_t overwrite = (bool_t) *y_buffer;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, y_offset;
 
     if (unary_operation_type == AS_OPERATION)
     {
-        view_t *view = NULL;
-
-        error = view_copy(x_buffer->view, &view);
-        if (error)
-        {
-            return ERROR(ERROR_COPY, string_create("failed to copy view."), error);
-        }
-
-        error = buffer_create(y_buffer, view, x_buffer->storage, false);
+        error = buffer_create(y_buffer, &x_buffer->view, x_buffer->storage, false);
         if (error)
         {
-            view_destroy(view);
             return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
         }
 
@@ -299,7 +511,7 @@ nw_error_t *buffer_unary(unary_operation_type_t unary_operation_type, buffer_t *
 
     if (!overwrite)
     {
-        error = buffer_creation(EMPTY_OPERATION, y_buffer, x_buffer->view->shape, x_buffer->view->rank, NULL, 
+        error = buffer_creation(EMPTY_OPERATION, y_buffer, x_buffer->view.shape, x_buffer->view.rank, NULL, 
                                 0, x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, 0);
         if (error)
         {
@@ -308,127 +520,31 @@ nw_error_t *buffer_unary(unary_operation_type_t unary_operation_type, buffer_t *
         }
     }
 
-    datatype_t datatype = (*y_buffer)->storage->datatype;
-    runtime_t runtime = (*y_buffer)->storage->runtime;
-    int64_t rank = (*y_buffer)->view->rank;
-    void *x_data = x_buffer->storage->data;
-    void *y_data = (*y_buffer)->storage->data;
-
-    int64_t n;
-    int64_t x_stride;
-    int64_t y_stride;
-    int64_t x_offset;
-    int64_t y_offset;
-
-    switch (rank)
-    {
-    case 0:
-        n = 1;
-        x_stride = 0;
-        y_stride = 0;
-        x_offset = x_buffer->view->offset;
-        y_offset = (*y_buffer)->view->offset;
-        runtime_unary(unary_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
-        break;
-    case 1:
-        n = (*y_buffer)->view->shape[0];
-        x_stride = x_buffer->view->strides[0];
-        y_stride = (*y_buffer)->view->strides[0];
-        x_offset = x_buffer->view->offset;
-        y_offset = (*y_buffer)->view->offset;
-        runtime_unary(unary_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
-        break;
-    case 2:
-        for (int64_t i = 0; i < (*y_buffer)->view->shape[0]; ++i)
-        {
-            n = (*y_buffer)->view->shape[1];
-            x_stride = x_buffer->view->strides[1];
-            y_stride = (*y_buffer)->view->strides[1];
-            x_offset = x_buffer->view->offset
-                       + i * x_buffer->view->strides[0];
-            y_offset = (*y_buffer)->view->offset
-                       + i * (*y_buffer)->view->strides[0];
-            runtime_unary(unary_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
-        }
-        break;
-    case 3:
-        for (int64_t i = 0; i < (*y_buffer)->view->shape[0]; ++i)
-        {
-            for (int64_t j = 0; j < (*y_buffer)->view->shape[1]; ++j)
-            {
-                n = (*y_buffer)->view->shape[2];
-                x_stride = x_buffer->view->strides[2];
-                y_stride = (*y_buffer)->view->strides[2];
-                x_offset = x_buffer->view->offset
-                           + i * x_buffer->view->strides[0]
-                           + j * x_buffer->view->strides[1];
-                y_offset = (*y_buffer)->view->offset
-                           + i * (*y_buffer)->view->strides[0]
-                           + j * (*y_buffer)->view->strides[1];
-                runtime_unary(unary_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
-            }
-        }
-        break;
-    case 4:
-        for (int64_t i = 0; i < (*y_buffer)->view->shape[0]; ++i)
-        {
-            for (int64_t j = 0; j < (*y_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t k = 0; k < (*y_buffer)->view->shape[2]; ++k)
-                {
-                    n = (*y_buffer)->view->shape[3];
-                    x_stride = x_buffer->view->strides[3];
-                    y_stride = (*y_buffer)->view->strides[3];
-                    x_offset = x_buffer->view->offset
-                               + i * x_buffer->view->strides[0]
-                               + j * x_buffer->view->strides[1]
-                               + k * x_buffer->view->strides[2];
-                    y_offset = (*y_buffer)->view->offset
-                               + i * (*y_buffer)->view->strides[0]
-                               + j * (*y_buffer)->view->strides[1]
-                               + k * (*y_buffer)->view->strides[2];
-                    runtime_unary(unary_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
-                }
-            }
-        }
-        break;
-    case 5:
-        for (int64_t i = 0; i < (*y_buffer)->view->shape[0]; ++i)
-        {
-            for (int64_t j = 0; j < (*y_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t k = 0; k < (*y_buffer)->view->shape[2]; ++k)
-                {
-                    for (int64_t l = 0; l < (*y_buffer)->view->shape[3]; ++l)
-                    {
-                        n = (*y_buffer)->view->shape[4];
-                        x_stride = x_buffer->view->strides[4];
-                        y_stride = (*y_buffer)->view->strides[4];
-                        x_offset = x_buffer->view->offset
-                                   + i * x_buffer->view->strides[0]
-                                   + j * x_buffer->view->strides[1]
-                                   + k * x_buffer->view->strides[2]
-                                   + l * x_buffer->view->strides[3];
-                        y_offset = (*y_buffer)->view->offset
-                                   + i * (*y_buffer)->view->strides[0]
-                                   + j * (*y_buffer)->view->strides[1]
-                                   + k * (*y_buffer)->view->strides[2]
-                                   + l * (*y_buffer)->view->strides[3];
-                        runtime_unary(unary_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_stride, y_offset);
-                    }
-                }
-            }
-        }
-        break;
-    default:
-        error = ERROR(ERROR_RANK, string_create("unsupported rank %d", (int) rank), NULL);
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire((*y_buffer), overwrite, &y_data, &y_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
         goto cleanup;
     }
 
+    runtime_unary(unary_operation_type, (*y_buffer)->storage->runtime, datatype_compute((*y_buffer)->storage->datatype),
+                  (*y_buffer)->view.rank, (*y_buffer)->view.shape,
+                  x_data, x_buffer->view.strides, x_offset,
+                  y_data, (*y_buffer)->view.strides, y_offset);
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release((*y_buffer), y_data, true);
+
     return error;
 
 cleanup:
 
+    buffer_compute_release(x_buffer, x_data, false);
+
     if (!overwrite)
     {
         buffer_destroy(*y_buffer);
@@ -437,17 +553,68 @@ cleanup:
     return error;
 }
 
+nw_error_t *buffer_unary_gradient(unary_operation_type_t unary_operation_type, buffer_t *x_buffer, buffer_t *gradient_buffer, buffer_t **result)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(gradient_buffer, "gradient_buffer");
+    CHECK_NULL_ARGUMENT(gradient_buffer->storage, "gradient_buffer->storage");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+
+    if (!view_shapes_equal(&x_buffer->view, &gradient_buffer->view))
+    {
+        return ERROR(ERROR_SHAPE, string_create("gradient shape does not match operand."), NULL);
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, result, x_buffer->view.shape, x_buffer->view.rank, NULL, 
+                            0, x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+    }
+
+    void *x_data = NULL;
+    void *gradient_data = NULL;
+    void *result_data = NULL;
+    int64_t x_offset, gradient_offset, result_offset;
+
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(gradient_buffer, true, &gradient_data, &gradient_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*result), false, &result_data, &result_offset);
+    }
+    if (error)
+    {
+        buffer_compute_release(x_buffer, x_data, false);
+        buffer_compute_release(gradient_buffer, gradient_data, false);
+        buffer_destroy(*result);
+        *result = NULL;
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+    }
+
+    runtime_unary_gradient(unary_operation_type, x_buffer->storage->runtime, datatype_compute(x_buffer->storage->datatype), x_buffer->view.rank, x_buffer->view.shape,
+                           x_data, x_buffer->view.strides, x_offset,
+                           gradient_data, gradient_buffer->view.strides, gradient_offset,
+                           result_data, (*result)->view.strides, result_offset);
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(gradient_buffer, gradient_data, false);
+    buffer_compute_release((*result), result_data, true);
+
+    return error;
+}
+
 static nw_error_t *buffer_matrix_multiplication(buffer_t *x_buffer, buffer_t *y_buffer, buffer_t **z_buffer)
 {
     CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
     CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
     CHECK_NULL_ARGUMENT(z_buffer, "z_buffer");
-    CHECK_NULL_ARGUMENT(x_buffer->view, "x_buffer->view");
-    CHECK_NULL_ARGUMENT(y_buffer->view, "y_buffer->view");
-    CHECK_NULL_ARGUMENT(x_buffer->view->strides, "x_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(y_buffer->view->strides, "y_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(x_buffer->view->shape, "x_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(y_buffer->view->shape, "y_buffer->view->shape");
     CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
     CHECK_NULL_ARGUMENT(y_buffer->storage, "y_buffer->storage");
     CHECK_NULL_ARGUMENT(x_buffer->storage->data, "x_buffer->storage->data");
@@ -455,9 +622,16 @@ static nw_error_t *buffer_matrix_multiplication(buffer_t *x_buffer, buffer_t *y_
 
     nw_error_t *error = NULL;
     bool_t overwrite = (bool_t) *z_buffer;
-    view_t *view = NULL;
+    view_t view;
+    buffer_t *x_contiguous = NULL;
+    buffer_t *y_contiguous = NULL;
     runtime_t runtime;
     datatype_t datatype;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    void *z_data = NULL;
+    int64_t x_offset, y_offset, z_offset;
+    bool_t operands_acquired = true;
 
     if (x_buffer->storage->datatype != y_buffer->storage->datatype)
     {
@@ -481,15 +655,15 @@ static nw_error_t *buffer_matrix_multiplication(buffer_t *x_buffer, buffer_t *y_
 
     if (!overwrite)
     {
-        error = view_matrix_multiplication(x_buffer->view, y_buffer->view, &view);
+        error = view_matrix_multiplication(&x_buffer->view, &y_buffer->view, &view);
         if (error)
         {
             error = ERROR(ERROR_SHAPE, string_create("incompatible shapes for matrix multiplication."), error);
             goto cleanup;
         }
 
-        error = buffer_creation(EMPTY_OPERATION, z_buffer, view->shape, view->rank,
-                                view->strides, view->offset, runtime, datatype, NULL, 0, NULL);
+        error = buffer_creation(EMPTY_OPERATION, z_buffer, view.shape, view.rank,
+                                view.strides, view.offset, runtime, datatype, NULL, 0, NULL);
         if (error)
         {
             error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
@@ -497,113 +671,136 @@ static nw_error_t *buffer_matrix_multiplication(buffer_t *x_buffer, buffer_t *y_
         }
     }
 
-    void *x_data = x_buffer->storage->data;
-    void *y_data = y_buffer->storage->data;
-    void *z_data = (*z_buffer)->storage->data;
-    int64_t m = x_buffer->view->shape[x_buffer->view->rank - 2];
-    int64_t k = x_buffer->view->shape[x_buffer->view->rank - 1];
-    int64_t n = y_buffer->view->shape[y_buffer->view->rank - 1];
-    bool_t x_transpose = false; 
-    bool_t y_transpose = false;  
-    int64_t x_offset;
-    int64_t y_offset;
-    int64_t z_offset;
-
-    switch ((*z_buffer)->view->rank)
-    {
-    case 2:
-        x_offset = x_buffer->view->offset;
-        y_offset = y_buffer->view->offset;
-        z_offset = (*z_buffer)->view->offset;
-        runtime_matrix_multiplication(runtime, datatype, m, k, n,
-                                      x_transpose, y_transpose, 
-                                      x_data, x_offset, 
-                                      y_data, y_offset,
-                                      z_data, z_offset);
-        break;
-    case 3:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
-        {
-            x_offset = x_buffer->view->offset
-                       + i * x_buffer->view->strides[0];
-            y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[0];
-            z_offset = (*z_buffer)->view->offset
-                       + i * (*z_buffer)->view->strides[0];
-            runtime_matrix_multiplication(runtime, datatype, m, k, n,
-                                          x_transpose, y_transpose, 
-                                          x_data, x_offset, 
-                                          y_data, y_offset,
-                                          z_data, z_offset);
+    int64_t rank = (*z_buffer)->view.rank;
+    if (rank < 2 || x_buffer->view.rank != rank || y_buffer->view.rank != rank)
+    {
+        error = ERROR(ERROR_RANK, string_create("unsupported rank %d", (int) rank), NULL);
+        goto cleanup;
+    }
+
+    int64_t m = x_buffer->view.shape[rank - 2];
+    int64_t k = x_buffer->view.shape[rank - 1];
+    int64_t n = y_buffer->view.shape[rank - 1];
+    bool_t x_compatible, y_compatible, z_compatible;
+    bool_t x_transpose, y_transpose, z_transpose;
+    int64_t x_leading_dimension, y_leading_dimension, z_leading_dimension;
+
+    // Transposed and row strided operands are read in place by BLAS, anything else is copied first.
+    error = view_matrix_layout(&x_buffer->view, &x_compatible, &x_transpose, &x_leading_dimension);
+    if (!error && !x_compatible)
+    {
+        error = buffer_unary(CONTIGUOUS_OPERATION, x_buffer, &x_contiguous);
+        if (!error)
+        {
+            x_buffer = x_contiguous;
+            error = view_matrix_layout(&x_buffer->view, &x_compatible, &x_transpose, &x_leading_dimension);
         }
-        break;
-    case 4:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare matrix operand."), error);
+        goto cleanup;
+    }
+
+    error = view_matrix_layout(&y_buffer->view, &y_compatible, &y_transpose, &y_leading_dimension);
+    if (!error && !y_compatible)
+    {
+        error = buffer_unary(CONTIGUOUS_OPERATION, y_buffer, &y_contiguous);
+        if (!error)
         {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                x_offset = x_buffer->view->offset
-                           + i * x_buffer->view->strides[0]
-                           + j * x_buffer->view->strides[1];
-                y_offset = y_buffer->view->offset
-                           + i * y_buffer->view->strides[0]
-                           + j * y_buffer->view->strides[1];
-                z_offset = (*z_buffer)->view->offset
-                           + i * (*z_buffer)->view->strides[0]
-                           + j * (*z_buffer)->view->strides[1];
-                runtime_matrix_multiplication(runtime, datatype, m, k, n,
-                                              x_transpose, y_transpose, 
-                                              x_data, x_offset, 
-                                              y_data, y_offset,
-                                              z_data, z_offset);
-            }
+            y_buffer = y_contiguous;
+            error = view_matrix_layout(&y_buffer->view, &y_compatible, &y_transpose, &y_leading_dimension);
         }
-        break;
-    case 5:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare matrix operand."), error);
+        goto cleanup;
+    }
+
+    error = view_matrix_layout(&(*z_buffer)->view, &z_compatible, &z_transpose, &z_leading_dimension);
+    if (error)
+    {
+        error = ERROR(ERROR_CONTIGUOUS, string_create("failed to determine layout of result."), error);
+        goto cleanup;
+    }
+
+    if (!z_compatible)
+    {
+        error = ERROR(ERROR_CONTIGUOUS, string_create("result of matrix multiplication must be row or column major."), NULL);
+        goto cleanup;
+    }
+
+    // MKL multiplies bfloat16 operands in place and accumulates into a float32 result, 
+    // other reduced precision operands are expanded to float32 first.
+    if (datatype == BFLOAT16 && runtime == MKL_RUNTIME)
+    {
+        x_data = x_buffer->storage->data;
+        y_data = y_buffer->storage->data;
+        x_offset = x_buffer->view.offset;
+        y_offset = y_buffer->view.offset;
+        operands_acquired = false;
+    }
+    else
+    {
+        error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+        if (!error)
         {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t l = 0; l < (*z_buffer)->view->shape[2]; ++l)
-                {
-                    x_offset = x_buffer->view->offset
-                               + i * x_buffer->view->strides[0]
-                               + j * x_buffer->view->strides[1]
-                               + l * x_buffer->view->strides[2];
-                    y_offset = y_buffer->view->offset
-                               + i * y_buffer->view->strides[0]
-                               + j * y_buffer->view->strides[1]
-                               + l * y_buffer->view->strides[2];
-                    z_offset = (*z_buffer)->view->offset
-                               + i * (*z_buffer)->view->strides[0]
-                               + j * (*z_buffer)->view->strides[1]
-                               + l * (*z_buffer)->view->strides[2];
-                    runtime_matrix_multiplication(runtime, datatype, m, k, n,
-                                                  x_transpose, y_transpose, 
-                                                  x_data, x_offset, 
-                                                  y_data, y_offset,
-                                                  z_data, z_offset);
-                }
-            }
+            error = buffer_compute_acquire(y_buffer, true, &y_data, &y_offset);
         }
-        break;
-    default:
-        error = ERROR(ERROR_RANK, string_create("unsupported rank %d", (int) (*z_buffer)->view->rank), NULL);
+        datatype = datatype_compute(datatype);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*z_buffer), overwrite, &z_data, &z_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
         goto cleanup;
     }
 
-    view_destroy(view);
+    if (z_transpose)
+    {
+        // A column major result z is the row major result z^T = y^T * x^T.
+        runtime_matrix_multiplication(runtime, datatype, rank - 2, (*z_buffer)->view.shape, n, k, m, !y_transpose, !x_transpose,
+                                      y_data, y_buffer->view.strides, y_offset, y_leading_dimension,
+                                      x_data, x_buffer->view.strides, x_offset, x_leading_dimension,
+                                      z_data, (*z_buffer)->view.strides, z_offset, z_leading_dimension);
+    }
+    else
+    {
+        runtime_matrix_multiplication(runtime, datatype, rank - 2, (*z_buffer)->view.shape, m, k, n, x_transpose, y_transpose,
+                                      x_data, x_buffer->view.strides, x_offset, x_leading_dimension,
+                                      y_data, y_buffer->view.strides, y_offset, y_leading_dimension,
+                                      z_data, (*z_buffer)->view.strides, z_offset, z_leading_dimension);
+    }
 
+    if (operands_acquired)
+    {
+        buffer_compute_release(x_buffer, x_data, false);
+        buffer_compute_release(y_buffer, y_data, false);
+    }
+    buffer_compute_release((*z_buffer), z_data, true);
+    buffer_destroy(x_contiguous);
+    buffer_destroy(y_contiguous);
     return error;
 
 cleanup:
 
+    if (operands_acquired)
+    {
+        buffer_compute_release(x_buffer, x_data, false);
+        buffer_compute_release(y_buffer, y_data, false);
+    }
+
     if (!overwrite)
     {
         buffer_destroy(*z_buffer);
     }
 
-    view_destroy(view);
+    buffer_destroy(x_contiguous);
+    buffer_destroy(y_contiguous);
 
     return error;
 }
@@ -613,12 +810,6 @@ static nw_error_t *buffer_binary_elementwise(binary_operation_type_t binary_oper
     CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
     CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
     CHECK_NULL_ARGUMENT(z_buffer, "z_buffer");
-    CHECK_NULL_ARGUMENT(x_buffer->view, "x_buffer->view");
-    CHECK_NULL_ARGUMENT(y_buffer->view, "y_buffer->view");
-    CHECK_NULL_ARGUMENT(x_buffer->view->strides, "x_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(y_buffer->view->strides, "y_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(x_buffer->view->shape, "x_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(y_buffer->view->shape, "y_buffer->view->shape");
     CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
     CHECK_NULL_ARGUMENT(y_buffer->storage, "y_buffer->storage");
     CHECK_NULL_ARGUMENT(x_buffer->storage->data, "x_buffer->storage->data");
@@ -626,10 +817,14 @@ static nw_error_t *buffer_binary_elementwise(binary_operation_type_t binary_oper
 
     nw_error_t *error = NULL;
     bool_t overwrite = (bool_t) *z_buffer;
-    int64_t rank = MAX(x_buffer->view->rank, y_buffer->view->rank);
+    int64_t rank = MAX(x_buffer->view.rank, y_buffer->view.rank);
     int64_t shape[rank];
     runtime_t runtime;
     datatype_t datatype;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    void *z_data = NULL;
+    int64_t x_offset, y_offset, z_offset;
 
     if (x_buffer->storage->datatype != y_buffer->storage->datatype)
     {
@@ -653,14 +848,14 @@ static nw_error_t *buffer_binary_elementwise(binary_operation_type_t binary_oper
 
     if (!overwrite)
     {
-        if (!view_shapes_equal(x_buffer->view, y_buffer->view))
+        if (!view_shapes_equal(&x_buffer->view, &y_buffer->view))
         {
             error = ERROR(ERROR_SHAPE, string_create("incompatible tensor shapes."), NULL);
             goto cleanup;
         }
         else
         {
-            memcpy(shape, x_buffer->view->shape, rank * sizeof(int64_t));
+            memcpy(shape, x_buffer->view.shape, rank * sizeof(int64_t));
         }
 
         error = buffer_creation(EMPTY_OPERATION, z_buffer, shape, rank, NULL, 0, runtime, datatype, NULL, 0, NULL);
@@ -671,176 +866,38 @@ static nw_error_t *buffer_binary_elementwise(binary_operation_type_t binary_oper
         }
     }
 
-    void *x_data = x_buffer->storage->data;
-    void *y_data = y_buffer->storage->data;
-    void *z_data = (*z_buffer)->storage->data;
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(y_buffer, true, &y_data, &y_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*z_buffer), overwrite, &z_data, &z_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
 
-    int64_t n;
-    int64_t x_stride;
-    int64_t y_stride;
-    int64_t z_stride;
-    int64_t x_offset;
-    int64_t y_offset;
-    int64_t z_offset;
-
-    switch (rank)
-    {
-    case 0:
-        n = 1;
-        x_stride = 0;
-        y_stride = 0;
-        z_stride = 0;
-        x_offset = x_buffer->view->offset;
-        y_offset = y_buffer->view->offset;
-        z_offset = (*z_buffer)->view->offset;
-        runtime_binary_elementwise(binary_operation_type, 
-                                   runtime, datatype, n, 
-                                   x_data, x_stride, x_offset, 
-                                   y_data, y_stride, y_offset,
-                                   z_data, z_stride, z_offset);
-        break;
-    case 1:
-        n = (*z_buffer)->view->shape[0];
-        x_stride = x_buffer->view->strides[0];
-        y_stride = y_buffer->view->strides[0];
-        z_stride = (*z_buffer)->view->strides[0];
-        x_offset = x_buffer->view->offset;
-        y_offset = y_buffer->view->offset;
-        z_offset = (*z_buffer)->view->offset;
-        runtime_binary_elementwise(binary_operation_type, 
-                                   runtime, datatype, n, 
-                                   x_data, x_stride, x_offset, 
-                                   y_data, y_stride, y_offset,
-                                   z_data, z_stride, z_offset);
-        break;
-    case 2:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
-        {
-            n = (*z_buffer)->view->shape[1];
-            x_stride = x_buffer->view->strides[1];
-            y_stride = y_buffer->view->strides[1];
-            z_stride = (*z_buffer)->view->strides[1];
-            x_offset = x_buffer->view->offset
-                       + i * x_buffer->view->strides[0];
-            y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[0];
-            z_offset = (*z_buffer)->view->offset
-                       + i * (*z_buffer)->view->strides[0];
-            runtime_binary_elementwise(binary_operation_type, 
-                                       runtime, datatype, n, 
-                                       x_data, x_stride, x_offset, 
-                                       y_data, y_stride, y_offset,
-                                       z_data, z_stride, z_offset);
-        }
-        break;
-    case 3:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
-        {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                n = (*z_buffer)->view->shape[2];
-                x_stride = x_buffer->view->strides[2];
-                y_stride = y_buffer->view->strides[2];
-                z_stride = (*z_buffer)->view->strides[2];
-                x_offset = x_buffer->view->offset
-                           + i * x_buffer->view->strides[0]
-                           + j * x_buffer->view->strides[1];
-                y_offset = y_buffer->view->offset
-                           + i * y_buffer->view->strides[0]
-                           + j * y_buffer->view->strides[1];
-                z_offset = (*z_buffer)->view->offset
-                           + i * (*z_buffer)->view->strides[0]
-                           + j * (*z_buffer)->view->strides[1];
-
-                runtime_binary_elementwise(binary_operation_type, 
-                                           runtime, datatype, n, 
-                                           x_data, x_stride, x_offset, 
-                                           y_data, y_stride, y_offset,
-                                           z_data, z_stride, z_offset);
-            }
-        }
-        break;
-    case 4:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
-        {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t k = 0; k < (*z_buffer)->view->shape[2]; ++k)
-                {
-                    n = (*z_buffer)->view->shape[3];
-                    x_stride = x_buffer->view->strides[3];
-                    y_stride = y_buffer->view->strides[3];
-                    z_stride = (*z_buffer)->view->strides[3];
-                    x_offset = x_buffer->view->offset
-                               + i * x_buffer->view->strides[0]
-                               + j * x_buffer->view->strides[1]
-                               + k * x_buffer->view->strides[2];
-                    y_offset = y_buffer->view->offset
-                               + i * y_buffer->view->strides[0]
-                               + j * y_buffer->view->strides[1]
-                               + k * y_buffer->view->strides[2];
-                    z_offset = (*z_buffer)->view->offset
-                               + i * (*z_buffer)->view->strides[0]
-                               + j * (*z_buffer)->view->strides[1]
-                               + k * (*z_buffer)->view->strides[2];
-
-                    runtime_binary_elementwise(binary_operation_type, 
-                                               runtime, datatype, n, 
-                                               x_data, x_stride, x_offset, 
-                                               y_data, y_stride, y_offset,
-                                               z_data, z_stride, z_offset);
-                }
-            }
-        }
-        break;
-    case 5:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
-        {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t k = 0; k < (*z_buffer)->view->shape[2]; ++k)
-                {
-                    for (int64_t l = 0; l < (*z_buffer)->view->shape[3]; ++l)
-                    {
-                        n = (*z_buffer)->view->shape[4];
-                        x_stride = x_buffer->view->strides[4];
-                        y_stride = y_buffer->view->strides[4];
-                        z_stride = (*z_buffer)->view->strides[4];
-                        x_offset = x_buffer->view->offset
-                                   + i * x_buffer->view->strides[0]
-                                   + j * x_buffer->view->strides[1]
-                                   + k * x_buffer->view->strides[2]
-                                   + l * x_buffer->view->strides[3];
-                        y_offset = y_buffer->view->offset
-                                   + i * y_buffer->view->strides[0]
-                                   + j * y_buffer->view->strides[1]
-                                   + k * y_buffer->view->strides[2]
-                                   + l * y_buffer->view->strides[3];
-                        z_offset = (*z_buffer)->view->offset
-                                   + i * (*z_buffer)->view->strides[0]
-                                   + j * (*z_buffer)->view->strides[1]
-                                   + k * (*z_buffer)->view->strides[2]
-                                   + l * (*z_buffer)->view->strides[3];
-
-                        runtime_binary_elementwise(binary_operation_type, 
-                                                   runtime, datatype, n, 
-                                                   x_data, x_stride, x_offset, 
-                                                   y_data, y_stride, y_offset,
-                                                   z_data, z_stride, z_offset);
-                    }
-                }
-            }
-        }
-        break;
-    default:
-        error = ERROR(ERROR_RANK, string_create("unsupported rank %d", (int) rank), NULL);
-        goto cleanup;
-    }
+    runtime_binary_elementwise(binary_operation_type, runtime, datatype_compute(datatype),
+                               (*z_buffer)->view.rank, (*z_buffer)->view.shape,
+                               x_data, x_buffer->view.strides, x_offset,
+                               y_data, y_buffer->view.strides, y_offset,
+                               z_data, (*z_buffer)->view.strides, z_offset);
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(y_buffer, y_data, false);
+    buffer_compute_release((*z_buffer), z_data, true);
 
     return error;
 
 cleanup:
 
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(y_buffer, y_data, false);
+
     if (!overwrite)
     {
         buffer_destroy(*z_buffer);
@@ -880,78 +937,265 @@ nw_error_t *buffer_binary(binary_operation_type_t operation_type, buffer_t *x_bu
     return error;
 }
 
-nw_error_t *buffer_ternary(ternary_operation_type_t ternary_operation_type, buffer_t *w_buffer, buffer_t *x_buffer, buffer_t *y_buffer, buffer_t **z_buffer)
+/**
+ * @brief Broadcast `y_buffer` to the shape of `x_buffer` so the two can be combined in place into `x_buffer`.
+ *        The expanded buffer shares the storage of `y_buffer` and is not reference counted.
+ * @param x_buffer The buffer that is written in place.
+ * @param y_buffer The operand broadcast to the shape of `x_buffer`.
+ * @param y_expanded The expanded operand.
+ * @return Error if datatypes or runtimes differ, if `x_buffer` broadcasts along a dimension, 
+ *         or if `y_buffer` cannot be expanded to the shape of `x_buffer`.
+ *         NULL if the operand was expanded successfully.
+ */
+static nw_error_t *buffer_inplace_operand(const buffer_t *x_buffer, const buffer_t *y_buffer, buffer_t *y_expanded)
 {
-    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
     CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
     CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
-    CHECK_NULL_ARGUMENT(z_buffer, "z_buffer");
-    CHECK_NULL_ARGUMENT(w_buffer->view, "w_buffer->view");
-    CHECK_NULL_ARGUMENT(x_buffer->view, "x_buffer->view");
-    CHECK_NULL_ARGUMENT(y_buffer->view, "y_buffer->view");
-    CHECK_NULL_ARGUMENT(w_buffer->view->strides, "w_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(x_buffer->view->strides, "x_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(y_buffer->view->strides, "y_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(w_buffer->view->shape, "w_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(x_buffer->view->shape, "x_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(y_buffer->view->shape, "y_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(w_buffer->storage, "w_buffer->storage");
     CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
     CHECK_NULL_ARGUMENT(y_buffer->storage, "y_buffer->storage");
-    CHECK_NULL_ARGUMENT(w_buffer->storage->data, "w_buffer->storage->data");
-    CHECK_NULL_ARGUMENT(x_buffer->storage->data, "x_buffer->storage->data");
-    CHECK_NULL_ARGUMENT(y_buffer->storage->data, "y_buffer->storage->data");
 
     nw_error_t *error = NULL;
-    bool_t overwrite = (bool_t) *z_buffer;
-    int64_t rank;
 
-    if (x_buffer->view->rank != y_buffer->view->rank || y_buffer->view->rank != w_buffer->view->rank)
+    if (x_buffer->storage->datatype != y_buffer->storage->datatype)
     {
-        return ERROR(ERROR_RANK, string_create("ranks are incompatible."), NULL);
+        return ERROR(ERROR_DATATYPE, string_create("datatypes are incompatible."), NULL);
     }
-    else
+
+    if (x_buffer->storage->runtime != y_buffer->storage->runtime)
     {
-        rank = w_buffer->view->rank;
+        return ERROR(ERROR_RUNTIME, string_create("runtimes are incompatible."), NULL);
     }
 
-    int64_t shape[rank];
-    runtime_t runtime;
-    datatype_t datatype;
+    for (int64_t i = 0; i < x_buffer->view.rank; ++i)
+    {
+        if (!x_buffer->view.strides[i] && x_buffer->view.shape[i] > 1)
+        {
+            return ERROR(ERROR_SHAPE, string_create("unable to write in place to a broadcasted buffer."), NULL);
+        }
+    }
 
-    if (x_buffer->storage->datatype != y_buffer->storage->datatype || y_buffer->storage->datatype != w_buffer->storage->datatype)
+    error = view_expand(&y_buffer->view, &y_expanded->view, x_buffer->view.shape, x_buffer->view.rank);
+    if (error)
     {
-        error = ERROR(ERROR_DATATYPE, string_create("datatypes are incompatible."), NULL);
-        goto cleanup;
+        return ERROR(ERROR_EXPAND, string_create("failed to expand view."), error);
     }
-    else
+    y_expanded->storage = y_buffer->storage;
+
+    return error;
+}
+
+/**
+ * @brief Apply an elementwise binary operation in place, `x_buffer = x_buffer op y_buffer`.
+ *        `y_buffer` is broadcast to the shape of `x_buffer` and must not partially overlap it.
+ * @param operation_type Addition, subtraction, multiplication or division.
+ * @param x_buffer The first operand, overwritten with the result.
+ * @param y_buffer The second operand.
+ * @return Error if the operation is not elementwise arithmetic or the operands are incompatible.
+ *         NULL if the operation was applied successfully.
+ */
+nw_error_t *buffer_binary_inplace(binary_operation_type_t operation_type, buffer_t *x_buffer, buffer_t *y_buffer)
+{
+    nw_error_t *error = NULL;
+    buffer_t y_expanded;
+
+    switch (operation_type)
     {
-        datatype = w_buffer->storage->datatype;
+    case ADDITION_OPERATION:
+    case SUBTRACTION_OPERATION:
+    case MULTIPLICATION_OPERATION:
+    case DIVISION_OPERATION:
+        break;
+    default:
+        return ERROR(ERROR_OPERATION_TYPE, string_create("unsupported in place operation type %d.", (int) operation_type), NULL);
     }
 
-    if (x_buffer->storage->runtime != y_buffer->storage->runtime || y_buffer->storage->runtime != w_buffer->storage->runtime)
+    error = buffer_inplace_operand(x_buffer, y_buffer, &y_expanded);
+    if (error)
     {
-        error = ERROR(ERROR_RUNTIME, string_create("runtimes are incompatible."), NULL);
+        return ERROR(ERROR_BROADCAST, string_create("failed to broadcast operand."), error);
+    }
+
+    error = buffer_binary_elementwise(operation_type, x_buffer, &y_expanded, &x_buffer);
+    if (error)
+    {
+        return ERROR(ERROR_BINARY, string_create("failed binary operation."), error);
+    }
+
+    return error;
+}
+
+/**
+ * @brief Accumulate a scaled operand in place, `x_buffer = x_buffer + alpha * y_buffer` (axpy).
+ *        `y_buffer` is broadcast to the shape of `x_buffer` and must not partially overlap it.
+ * @param x_buffer The accumulator, overwritten with the result.
+ * @param y_buffer The operand that is scaled.
+ * @param alpha Scalar in the compute datatype of the buffers.
+ * @return Error if the operands are incompatible or compute data could not be acquired.
+ *         NULL if the operand was accumulated successfully.
+ */
+nw_error_t *buffer_scaled_addition(buffer_t *x_buffer, buffer_t *y_buffer, void *alpha)
+{
+    CHECK_NULL_ARGUMENT(alpha, "alpha");
+
+    nw_error_t *error = NULL;
+    buffer_t y_expanded;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, y_offset;
+
+    error = buffer_inplace_operand(x_buffer, y_buffer, &y_expanded);
+    if (error)
+    {
+        return ERROR(ERROR_BROADCAST, string_create("failed to broadcast operand."), error);
+    }
+
+    error = buffer_compute_acquire(y_buffer, true, &y_data, &y_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    }
+    if (error)
+    {
+        buffer_compute_release(y_buffer, y_data, false);
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+    }
+
+    runtime_scaled_addition(x_buffer->storage->runtime, datatype_compute(x_buffer->storage->datatype),
+                            x_buffer->view.rank, x_buffer->view.shape, alpha,
+                            y_data, y_expanded.view.strides, y_offset,
+                            x_data, x_buffer->view.strides, x_offset);
+
+    buffer_compute_release(y_buffer, y_data, false);
+    buffer_compute_release(x_buffer, x_data, true);
+
+    return error;
+}
+
+static nw_error_t *buffer_contiguous_image(buffer_t *x_buffer, buffer_t **x_contiguous)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_contiguous, "x_contiguous");
+
+    nw_error_t *error = NULL;
+    bool_t is_contiguous;
+
+    *x_contiguous = NULL;
+
+    if (x_buffer->view.rank != 4)
+    {
+        return ERROR(ERROR_RANK, string_create("images must be rank 4, got rank %d.", (int) x_buffer->view.rank), NULL);
+    }
+
+    // Convolution and pooling kernels walk dense NCHW planes, anything else is copied first.
+    error = view_is_contiguous(&x_buffer->view, &is_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to determine if view is contiguous."), error);
+    }
+
+    if (!is_contiguous)
+    {
+        error = buffer_unary(CONTIGUOUS_OPERATION, x_buffer, x_contiguous);
+        if (error)
+        {
+            return ERROR(ERROR_CONTIGUOUS, string_create("failed to make buffer contiguous."), error);
+        }
+    }
+
+    return error;
+}
+
+/**
+ * @brief Convolve a batch of images with a bank of square kernels.
+ * @param x_buffer Images of shape (batch_size, in_channels, height, width).
+ * @param w_buffer Kernels of shape (out_channels, in_channels, kernel_size, kernel_size).
+ * @param stride Step between neighbouring receptive fields.
+ * @param padding Implicit zero padding on each side of the images.
+ * @param y_buffer Result of shape (batch_size, out_channels, output_height, output_width). Created when NULL.
+ * @return Error if the operands are NULL, have incompatible shapes, datatypes or runtimes.
+ *         Error if the convolution failed.
+ *         NULL if the convolution was computed successfully.
+ */
+nw_error_t *buffer_convolution_2d(buffer_t *x_buffer, buffer_t *w_buffer, int64_t stride, int64_t padding, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(w_buffer->storage, "w_buffer->storage");
+
+    nw_error_t *error = NULL;
+    bool_t overwrite = (bool_t) *y_buffer;
+    buffer_t *x_contiguous = NULL;
+    buffer_t *w_contiguous = NULL;
+    void *x_data = NULL;
+    void *w_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, w_offset, y_offset;
+    runtime_t runtime = x_buffer->storage->runtime;
+    datatype_t datatype = x_buffer->storage->datatype;
+
+    if (w_buffer->storage->datatype != datatype)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("datatypes are incompatible."), NULL);
+    }
+
+    if (w_buffer->storage->runtime != runtime)
+    {
+        return ERROR(ERROR_RUNTIME, string_create("runtimes are incompatible."), NULL);
+    }
+
+    error = buffer_contiguous_image(x_buffer, &x_contiguous);
+    if (!error)
+    {
+        error = buffer_contiguous_image(w_buffer, &w_contiguous);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_CONVOLUTION, string_create("failed to prepare convolution operands."), error);
         goto cleanup;
     }
-    else
+
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+    w_buffer = (w_contiguous) ? w_contiguous : w_buffer;
+
+    int64_t batch_size = x_buffer->view.shape[0];
+    int64_t in_channels = x_buffer->view.shape[1];
+    int64_t height = x_buffer->view.shape[2];
+    int64_t width = x_buffer->view.shape[3];
+    int64_t out_channels = w_buffer->view.shape[0];
+    int64_t kernel_size = w_buffer->view.shape[2];
+    int64_t output_height = (stride > 0) ? (height + 2 * padding - kernel_size) / stride + 1 : 0;
+    int64_t output_width = (stride > 0) ? (width + 2 * padding - kernel_size) / stride + 1 : 0;
+    int64_t shape[] = {batch_size, out_channels, output_height, output_width};
+
+    if (w_buffer->view.shape[1] != in_channels || w_buffer->view.shape[3] != kernel_size || 
+        stride < 1 || padding < 0 || height + 2 * padding < kernel_size || width + 2 * padding < kernel_size)
     {
-        runtime = w_buffer->storage->runtime;
+        error = ERROR(ERROR_SHAPE, string_create("incompatible convolution shapes."), NULL);
+        goto cleanup;
     }
 
-    if (!overwrite)
+    if (overwrite)
     {
-        if (!view_shapes_equal(x_buffer->view, y_buffer->view) || !view_shapes_equal(y_buffer->view, w_buffer->view))
+        bool_t is_contiguous;
+
+        error = view_is_contiguous(&(*y_buffer)->view, &is_contiguous);
+        if (error)
         {
-            error = ERROR(ERROR_SHAPE, string_create("incompatible tensor shapes."), NULL);
+            error = ERROR(ERROR_CONTIGUOUS, string_create("failed to determine if view is contiguous."), error);
             goto cleanup;
         }
-        else
+
+        if (!is_contiguous || !view_has_shape(&(*y_buffer)->view, shape, 4))
         {
-            memcpy(shape, w_buffer->view->shape, rank * sizeof(int64_t));
+            error = ERROR(ERROR_SHAPE, string_create("result of convolution must be contiguous with the output shape."), NULL);
+            goto cleanup;
         }
-
-        error = buffer_creation(EMPTY_OPERATION, z_buffer, shape, rank, NULL, 0, runtime, datatype, NULL, 0, NULL);
+    }
+    else
+    {
+        error = buffer_creation(EMPTY_OPERATION, y_buffer, shape, 4, NULL, 0, runtime, datatype, NULL, 0, NULL);
         if (error)
         {
             error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
@@ -959,206 +1203,1671 @@ nw_error_t *buffer_ternary(ternary_operation_type_t ternary_operation_type, buff
         }
     }
 
-    void *w_data = w_buffer->storage->data;
-    void *x_data = x_buffer->storage->data;
-    void *y_data = y_buffer->storage->data;
-    void *z_data = (*z_buffer)->storage->data;
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(w_buffer, true, &w_data, &w_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*y_buffer), overwrite, &y_data, &y_offset);
+    }
+    if (!error)
+    {
+        error = runtime_convolution_2d(runtime, datatype_compute(datatype), batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding,
+                                       x_data, x_offset, w_data, w_offset, y_data, y_offset);
+    }
+    buffer_compute_release((*y_buffer), y_data, !error);
+    if (error)
+    {
+        if (!overwrite)
+        {
+            buffer_destroy(*y_buffer);
+            *y_buffer = NULL;
+        }
+        error = ERROR(ERROR_CONVOLUTION, string_create("failed to convolve."), error);
+        goto cleanup;
+    }
+
+cleanup:
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(w_buffer, w_data, false);
+    buffer_destroy(x_contiguous);
+    buffer_destroy(w_contiguous);
 
-    int64_t n;
-    int64_t w_stride;
-    int64_t x_stride;
-    int64_t y_stride;
-    int64_t z_stride;
-    int64_t w_offset;
-    int64_t x_offset;
-    int64_t y_offset;
-    int64_t z_offset;
-
-    switch (rank)
-    {
-    case 0:
-        n = 1;
-        w_stride = 0;
-        x_stride = 0;
-        y_stride = 0;
-        z_stride = 0;
-        w_offset = w_buffer->view->offset;
-        x_offset = x_buffer->view->offset;
-        y_offset = y_buffer->view->offset;
-        z_offset = (*z_buffer)->view->offset;
-        runtime_ternary(ternary_operation_type, 
-                        runtime, datatype, n, 
-                        w_data, w_stride, w_offset, 
-                        x_data, x_stride, x_offset, 
-                        y_data, y_stride, y_offset,
-                        z_data, z_stride, z_offset);
-        break;
-    case 1:
-        n = (*z_buffer)->view->shape[0];
-        w_stride = w_buffer->view->strides[0];
-        x_stride = x_buffer->view->strides[0];
-        y_stride = y_buffer->view->strides[0];
-        z_stride = (*z_buffer)->view->strides[0];
-        w_offset = w_buffer->view->offset;
-        x_offset = x_buffer->view->offset;
-        y_offset = y_buffer->view->offset;
-        z_offset = (*z_buffer)->view->offset;
-        runtime_ternary(ternary_operation_type, 
-                        runtime, datatype, n, 
-                        w_data, w_stride, w_offset, 
-                        x_data, x_stride, x_offset, 
-                        y_data, y_stride, y_offset,
-                        z_data, z_stride, z_offset);
-        break;
-    case 2:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
-        {
-            n = (*z_buffer)->view->shape[1];
-            w_stride = w_buffer->view->strides[1];
-            x_stride = x_buffer->view->strides[1];
-            y_stride = y_buffer->view->strides[1];
-            z_stride = (*z_buffer)->view->strides[1];
-            w_offset = w_buffer->view->offset
-                       + i * w_buffer->view->strides[0];
-            x_offset = x_buffer->view->offset
-                       + i * x_buffer->view->strides[0];
-            y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[0];
-            z_offset = (*z_buffer)->view->offset
-                       + i * (*z_buffer)->view->strides[0];
-            runtime_ternary(ternary_operation_type, 
-                            runtime, datatype, n, 
-                            w_data, w_stride, w_offset, 
-                            x_data, x_stride, x_offset, 
-                            y_data, y_stride, y_offset,
-                            z_data, z_stride, z_offset);
+    return error;
+}
+
+/**
+ * @brief Gradients of `buffer_convolution_2d` with respect to its images and kernels.
+ * @param x_buffer Images the convolution was applied to.
+ * @param w_buffer Kernels the convolution was applied with.
+ * @param gradient_buffer Gradient with respect to the convolution output.
+ * @param stride Stride of the convolution.
+ * @param padding Padding of the convolution.
+ * @param x_gradient_buffer Created with the gradient of the images. Skipped when NULL.
+ * @param w_gradient_buffer Created with the gradient of the kernels. Skipped when NULL.
+ * @return Error if the operands are NULL or have incompatible shapes.
+ *         Error if the gradients failed to compute.
+ *         NULL if the gradients were computed successfully.
+ */
+nw_error_t *buffer_convolution_2d_backward(buffer_t *x_buffer, buffer_t *w_buffer, buffer_t *gradient_buffer, int64_t stride, int64_t padding,
+                                           buffer_t **x_gradient_buffer, buffer_t **w_gradient_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(gradient_buffer, "gradient_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    buffer_t *w_contiguous = NULL;
+    buffer_t *gradient_contiguous = NULL;
+    buffer_t *x_gradient = NULL;
+    buffer_t *w_gradient = NULL;
+    void *x_data = NULL;
+    void *w_data = NULL;
+    void *gradient_data = NULL;
+    void *x_gradient_data = NULL;
+    void *w_gradient_data = NULL;
+    int64_t x_offset, w_offset, gradient_offset, x_gradient_offset = 0, w_gradient_offset = 0;
+    runtime_t runtime = x_buffer->storage->runtime;
+    datatype_t datatype = x_buffer->storage->datatype;
+
+    error = buffer_contiguous_image(x_buffer, &x_contiguous);
+    if (!error)
+    {
+        error = buffer_contiguous_image(w_buffer, &w_contiguous);
+    }
+    if (!error)
+    {
+        error = buffer_contiguous_image(gradient_buffer, &gradient_contiguous);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_CONVOLUTION, string_create("failed to prepare convolution operands."), error);
+        goto cleanup;
+    }
+
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+    w_buffer = (w_contiguous) ? w_contiguous : w_buffer;
+    gradient_buffer = (gradient_contiguous) ? gradient_contiguous : gradient_buffer;
+
+    int64_t batch_size = x_buffer->view.shape[0];
+    int64_t in_channels = x_buffer->view.shape[1];
+    int64_t height = x_buffer->view.shape[2];
+    int64_t width = x_buffer->view.shape[3];
+    int64_t out_channels = w_buffer->view.shape[0];
+    int64_t kernel_size = w_buffer->view.shape[2];
+    int64_t output_height = (stride > 0) ? (height + 2 * padding - kernel_size) / stride + 1 : 0;
+    int64_t output_width = (stride > 0) ? (width + 2 * padding - kernel_size) / stride + 1 : 0;
+
+    if (w_buffer->view.shape[1] != in_channels || w_buffer->view.shape[3] != kernel_size || stride < 1 || padding < 0 ||
+        !view_has_shape(&gradient_buffer->view, (int64_t[]){batch_size, out_channels, output_height, output_width}, 4))
+    {
+        error = ERROR(ERROR_SHAPE, string_create("incompatible convolution gradient shapes."), NULL);
+        goto cleanup;
+    }
+
+    if (x_gradient_buffer)
+    {
+        error = buffer_creation(EMPTY_OPERATION, &x_gradient, x_buffer->view.shape, 4, NULL, 0, runtime, datatype, NULL, 0, NULL);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+            goto cleanup;
         }
-        break;
-    case 3:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
+    }
+
+    if (w_gradient_buffer)
+    {
+        error = buffer_creation(EMPTY_OPERATION, &w_gradient, w_buffer->view.shape, 4, NULL, 0, runtime, datatype, NULL, 0, NULL);
+        if (error)
         {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                n = (*z_buffer)->view->shape[2];
-                w_stride = w_buffer->view->strides[2];
-                x_stride = x_buffer->view->strides[2];
-                y_stride = y_buffer->view->strides[2];
-                z_stride = (*z_buffer)->view->strides[2];
-                w_offset = w_buffer->view->offset
-                           + i * w_buffer->view->strides[0]
-                           + j * w_buffer->view->strides[1];
-                x_offset = x_buffer->view->offset
-                           + i * x_buffer->view->strides[0]
-                           + j * x_buffer->view->strides[1];
-                y_offset = y_buffer->view->offset
-                           + i * y_buffer->view->strides[0]
-                           + j * y_buffer->view->strides[1];
-                z_offset = (*z_buffer)->view->offset
-                           + i * (*z_buffer)->view->strides[0]
-                           + j * (*z_buffer)->view->strides[1];
-
-                runtime_ternary(ternary_operation_type, 
-                                runtime, datatype, n, 
-                                w_data, w_stride, w_offset, 
-                                x_data, x_stride, x_offset, 
-                                y_data, y_stride, y_offset,
-                                z_data, z_stride, z_offset);
-            }
+            error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+            goto cleanup;
+        }
+    }
+
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(w_buffer, true, &w_data, &w_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire(gradient_buffer, true, &gradient_data, &gradient_offset);
+    }
+    if (!error && x_gradient)
+    {
+        error = buffer_compute_acquire(x_gradient, false, &x_gradient_data, &x_gradient_offset);
+    }
+    if (!error && w_gradient)
+    {
+        error = buffer_compute_acquire(w_gradient, false, &w_gradient_data, &w_gradient_offset);
+    }
+    if (!error)
+    {
+        error = runtime_convolution_2d_backward(runtime, datatype_compute(datatype), batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding,
+                                                x_data, x_offset, w_data, w_offset, gradient_data, gradient_offset,
+                                                x_gradient_data, x_gradient_offset, w_gradient_data, w_gradient_offset);
+    }
+    if (x_gradient)
+    {
+        buffer_compute_release(x_gradient, x_gradient_data, !error);
+    }
+    if (w_gradient)
+    {
+        buffer_compute_release(w_gradient, w_gradient_data, !error);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_CONVOLUTION, string_create("failed to compute convolution gradients."), error);
+        goto cleanup;
+    }
+
+    if (x_gradient_buffer)
+    {
+        *x_gradient_buffer = x_gradient;
+        x_gradient = NULL;
+    }
+
+    if (w_gradient_buffer)
+    {
+        *w_gradient_buffer = w_gradient;
+        w_gradient = NULL;
+    }
+
+cleanup:
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(w_buffer, w_data, false);
+    buffer_compute_release(gradient_buffer, gradient_data, false);
+    buffer_destroy(x_contiguous);
+    buffer_destroy(w_contiguous);
+    buffer_destroy(gradient_contiguous);
+    buffer_destroy(x_gradient);
+    buffer_destroy(w_gradient);
+
+    return error;
+}
+
+/**
+ * @brief Max or average pool each plane of a batch of images.
+ * @param structure_operation_type Either `MAX_POOL_2D_OPERATION` or `AVERAGE_POOL_2D_OPERATION`.
+ * @param x_buffer Images of shape (batch_size, channels, height, width).
+ * @param kernel_size Height and width of the pooling window.
+ * @param stride Step between neighbouring windows.
+ * @param padding Implicit padding on each side of the images, never selected by max pooling.
+ * @param y_buffer Created with the pooled images.
+ * @param indices Allocated with the argmax of every max pooling window as an offset into its plane. Skipped when NULL.
+ * @return Error if the arguments are NULL or the shapes are invalid.
+ *         NULL if the images were pooled successfully.
+ */
+nw_error_t *buffer_pooling_2d(structure_operation_type_t structure_operation_type, buffer_t *x_buffer, int64_t kernel_size, int64_t stride, int64_t padding,
+                              buffer_t **y_buffer, int32_t **indices)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, y_offset;
+    runtime_t runtime = x_buffer->storage->runtime;
+    datatype_t datatype = x_buffer->storage->datatype;
+
+    error = buffer_contiguous_image(x_buffer, &x_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare pooling operand."), error);
+    }
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+
+    int64_t batch_size = x_buffer->view.shape[0];
+    int64_t channels = x_buffer->view.shape[1];
+    int64_t height = x_buffer->view.shape[2];
+    int64_t width = x_buffer->view.shape[3];
+    int64_t output_height = (stride > 0) ? (height + 2 * padding - kernel_size) / stride + 1 : 0;
+    int64_t output_width = (stride > 0) ? (width + 2 * padding - kernel_size) / stride + 1 : 0;
+    int64_t n = batch_size * channels * output_height * output_width;
+
+    if (kernel_size < 1 || stride < 1 || padding < 0 || height + 2 * padding < kernel_size || width + 2 * padding < kernel_size || height * width > INT32_MAX)
+    {
+        error = ERROR(ERROR_SHAPE, string_create("invalid pooling arguments."), NULL);
+        goto cleanup;
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, (int64_t[]){batch_size, channels, output_height, output_width}, 4, NULL, 0, runtime, datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    if (indices && structure_operation_type == MAX_POOL_2D_OPERATION)
+    {
+        *indices = (int32_t *) malloc(n * sizeof(int32_t));
+        if (!*indices)
+        {
+            buffer_destroy(*y_buffer);
+            *y_buffer = NULL;
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", n * sizeof(int32_t)), NULL);
+            goto cleanup;
+        }
+    }
+
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire((*y_buffer), false, &y_data, &y_offset);
+    }
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        if (indices && structure_operation_type == MAX_POOL_2D_OPERATION)
+        {
+            free(*indices);
+            *indices = NULL;
+        }
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_pooling_2d(structure_operation_type, runtime, datatype_compute(datatype), batch_size, channels, height, width, kernel_size, stride, padding,
+                       x_data, x_offset, y_data, y_offset, 
+                       (indices && structure_operation_type == MAX_POOL_2D_OPERATION) ? *indices : NULL);
+
+    buffer_compute_release((*y_buffer), y_data, true);
+
+cleanup:
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_destroy(x_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief Gradient of `buffer_pooling_2d` with respect to the images.
+ * @param structure_operation_type Either `MAX_POOL_2D_OPERATION` or `AVERAGE_POOL_2D_OPERATION`.
+ * @param x_buffer Images that were pooled, only their shape is read.
+ * @param gradient_buffer Gradient with respect to the pooled images.
+ * @param kernel_size Height and width of the pooling window.
+ * @param stride Step between neighbouring windows.
+ * @param padding Implicit padding on each side of the images.
+ * @param indices Argmax offsets written by the max pooling forward pass.
+ * @param result Created with the gradient of the images.
+ * @return Error if the arguments are NULL or the shapes are invalid.
+ *         NULL if the gradient was computed successfully.
+ */
+nw_error_t *buffer_pooling_2d_backward(structure_operation_type_t structure_operation_type, buffer_t *x_buffer, buffer_t *gradient_buffer,
+                                       int64_t kernel_size, int64_t stride, int64_t padding, const int32_t *indices, buffer_t **result)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(gradient_buffer, "gradient_buffer");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    if (structure_operation_type == MAX_POOL_2D_OPERATION)
+    {
+        CHECK_NULL_ARGUMENT(indices, "indices");
+    }
+
+    if (x_buffer->view.rank != 4 || kernel_size < 1 || stride < 1)
+    {
+        return ERROR(ERROR_SHAPE, string_create("invalid pooling arguments."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *gradient_contiguous = NULL;
+    void *gradient_data = NULL;
+    void *result_data = NULL;
+    int64_t gradient_offset, result_offset;
+    int64_t batch_size = x_buffer->view.shape[0];
+    int64_t channels = x_buffer->view.shape[1];
+    int64_t height = x_buffer->view.shape[2];
+    int64_t width = x_buffer->view.shape[3];
+    int64_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    int64_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+
+    if (!view_has_shape(&gradient_buffer->view, (int64_t[]){batch_size, channels, output_height, output_width}, 4))
+    {
+        return ERROR(ERROR_SHAPE, string_create("gradient shape does not match pooling output."), NULL);
+    }
+
+    error = buffer_contiguous_image(gradient_buffer, &gradient_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare pooling gradient."), error);
+    }
+    gradient_buffer = (gradient_contiguous) ? gradient_contiguous : gradient_buffer;
+
+    error = buffer_creation(EMPTY_OPERATION, result, x_buffer->view.shape, 4, NULL, 0, x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    error = buffer_compute_acquire(gradient_buffer, true, &gradient_data, &gradient_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire((*result), false, &result_data, &result_offset);
+    }
+    if (error)
+    {
+        buffer_destroy(*result);
+        *result = NULL;
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_pooling_2d_backward(structure_operation_type, x_buffer->storage->runtime, datatype_compute(x_buffer->storage->datatype),
+                                batch_size, channels, height, width, kernel_size, stride, padding, indices,
+                                gradient_data, gradient_offset, result_data, result_offset);
+
+    buffer_compute_release((*result), result_data, true);
+
+cleanup:
+
+    buffer_compute_release(gradient_buffer, gradient_data, false);
+    buffer_destroy(gradient_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief Drop elements with a mask drawn inline from the Philox stream and rescale the rest.
+ *        The backward pass calls this again on the gradient with the same seed and offset.
+ * @param x_buffer Operand of any shape, copied to a contiguous layout first if needed.
+ * @param seed Generator key of the mask.
+ * @param offset First Philox counter of the mask.
+ * @param threshold Drop probability scaled to 2^32.
+ * @param y_buffer Created with the result, same shape as `x_buffer`.
+ * @return Error if the arguments are NULL.
+ *         NULL if dropout was applied successfully.
+ */
+nw_error_t *buffer_dropout(buffer_t *x_buffer, uint64_t seed, uint64_t offset, uint32_t threshold, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, y_offset;
+    bool_t is_contiguous;
+    int64_t n;
+
+    // The mask is indexed by logical position, so strided operands are packed first.
+    error = view_is_contiguous(&x_buffer->view, &is_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to determine if view is contiguous."), error);
+    }
+
+    if (!is_contiguous)
+    {
+        error = buffer_unary(CONTIGUOUS_OPERATION, x_buffer, &x_contiguous);
+        if (error)
+        {
+            return ERROR(ERROR_CONTIGUOUS, string_create("failed to make buffer contiguous."), error);
+        }
+        x_buffer = x_contiguous;
+    }
+
+    error = view_logical_size(&x_buffer->view, &n);
+    if (error)
+    {
+        error = ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
+        goto cleanup;
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, x_buffer->view.shape, x_buffer->view.rank, NULL, 0, 
+                            x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire((*y_buffer), false, &y_data, &y_offset);
+    }
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_dropout(x_buffer->storage->runtime, datatype_compute(x_buffer->storage->datatype), n, seed, offset, threshold,
+                    x_data, x_offset, y_data, y_offset);
+
+    buffer_compute_release((*y_buffer), y_data, true);
+
+cleanup:
+
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_destroy(x_contiguous);
+
+    return error;
+}
+
+static nw_error_t *buffer_contiguous(buffer_t *x_buffer, buffer_t **x_contiguous)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_contiguous, "x_contiguous");
+
+    nw_error_t *error = NULL;
+    bool_t is_contiguous;
+
+    *x_contiguous = NULL;
+
+    error = view_is_contiguous(&x_buffer->view, &is_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to determine if view is contiguous."), error);
+    }
+
+    if (!is_contiguous)
+    {
+        error = buffer_unary(CONTIGUOUS_OPERATION, x_buffer, x_contiguous);
+        if (error)
+        {
+            return ERROR(ERROR_CONTIGUOUS, string_create("failed to make buffer contiguous."), error);
+        }
+    }
+
+    return error;
+}
+
+/**
+ * @brief Copy a buffer into a new contiguous buffer of another datatype.
+ *        Floating point values cast to an integer datatype are rounded to the nearest integer.
+ */
+nw_error_t *buffer_cast(buffer_t *x_buffer, datatype_t datatype, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    int64_t n;
+
+    error = buffer_contiguous(x_buffer, &x_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare cast operand."), error);
+    }
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+
+    error = view_logical_size(&x_buffer->view, &n);
+    if (error)
+    {
+        error = ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
+        goto cleanup;
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, x_buffer->view.shape, x_buffer->view.rank, NULL, 0, 
+                            x_buffer->storage->runtime, datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    runtime_synchronize(x_buffer->storage->runtime);
+    runtime_convert(x_buffer->storage->datatype, (const char *) x_buffer->storage->data + x_buffer->view.offset * datatype_size(x_buffer->storage->datatype),
+                    datatype, (char *) (*y_buffer)->storage->data + (*y_buffer)->view.offset * datatype_size(datatype), n);
+
+cleanup:
+
+    buffer_destroy(x_contiguous);
+
+    return error;
+}
+
+static inline int64_t buffer_integer_load(const buffer_t *x_buffer, int64_t index)
+{
+    return (x_buffer->storage->datatype == INT32) ? (int64_t) ((const int32_t *) x_buffer->storage->data)[index] : 
+                                                    ((const int64_t *) x_buffer->storage->data)[index];
+}
+
+/**
+ * @brief Read the elements of an int32 or int64 buffer as int64 in logical order.
+ *        The values are read natively from any view, without a float64 compute copy.
+ * @param x_buffer Integer buffer to read.
+ * @param n Number of elements in the view of `x_buffer`.
+ * @param values Filled with the `n` elements.
+ */
+static void buffer_integer_read(const buffer_t *x_buffer, int64_t n, int64_t *values)
+{
+    const view_t *view = &x_buffer->view;
+
+    for (int64_t i = 0; i < n; ++i)
+    {
+        int64_t index = view->offset;
+        int64_t remainder = i;
+
+        for (int64_t j = view->rank - 1; j >= 0; --j)
+        {
+            index += (remainder % view->shape[j]) * view->strides[j];
+            remainder /= view->shape[j];
+        }
+
+        values[i] = buffer_integer_load(x_buffer, index);
+    }
+}
+
+/**
+ * @brief Read embedding indices as contiguous int64 and check they address a row of the weights.
+ * @param x_buffer Indices of any shape and datatype.
+ * @param vocabulary_size Number of rows in the weights.
+ * @param x_indices Created with an int64 copy of the indices when `x_buffer` is not already contiguous int64, NULL otherwise.
+ *                  Integer indices are widened natively, other datatypes are cast.
+ * @param indices Points at the first index.
+ */
+static nw_error_t *buffer_embedding_indices(buffer_t *x_buffer, int64_t vocabulary_size, buffer_t **x_indices, const int64_t **indices)
+{
+    nw_error_t *error = NULL;
+    bool_t is_contiguous;
+    int64_t n;
+
+    *x_indices = NULL;
+
+    error = view_is_contiguous(&x_buffer->view, &is_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to determine if view is contiguous."), error);
+    }
+
+    error = view_logical_size(&x_buffer->view, &n);
+    if (error)
+    {
+        return ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
+    }
+
+    if (datatype_is_integer(x_buffer->storage->datatype) && (!is_contiguous || x_buffer->storage->datatype != INT64))
+    {
+        error = buffer_creation(EMPTY_OPERATION, x_indices, x_buffer->view.shape, x_buffer->view.rank, NULL, 0, 
+                                x_buffer->storage->runtime, INT64, NULL, 0, NULL);
+        if (error)
+        {
+            return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        }
+
+        runtime_synchronize(x_buffer->storage->runtime);
+        buffer_integer_read(x_buffer, n, (int64_t *) (*x_indices)->storage->data);
+        x_buffer = *x_indices;
+    }
+    else if (!is_contiguous || x_buffer->storage->datatype != INT64)
+    {
+        error = buffer_cast(x_buffer, INT64, x_indices);
+        if (error)
+        {
+            return ERROR(ERROR_DATATYPE, string_create("failed to cast indices."), error);
+        }
+        x_buffer = *x_indices;
+    }
+
+    runtime_synchronize(x_buffer->storage->runtime);
+    *indices = &((const int64_t *) x_buffer->storage->data)[x_buffer->view.offset];
+    for (int64_t i = 0; i < n; ++i)
+    {
+        if ((*indices)[i] < 0 || (*indices)[i] >= vocabulary_size)
+        {
+            error = ERROR(ERROR_EMBEDDING, string_create("index %ld out of range of vocabulary size %ld.", (*indices)[i], vocabulary_size), NULL);
+            goto cleanup;
+        }
+    }
+
+    return error;
+
+cleanup:
+
+    buffer_destroy(*x_indices);
+    *x_indices = NULL;
+
+    return error;
+}
+
+/**
+ * @brief Gather rows of the weights by index.
+ * @param w_buffer Weights of shape (vocabulary_size, embedding_size).
+ * @param x_buffer Indices of any shape, cast to int64 if stored in another datatype.
+ * @param y_buffer Created with the gathered rows, of shape (*x_shape, embedding_size).
+ * @return Error if the arguments are NULL, the shapes are invalid or an index is out of range.
+ *         NULL if the rows were gathered successfully.
+ */
+nw_error_t *buffer_embedding(buffer_t *w_buffer, buffer_t *x_buffer, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(w_buffer->storage, "w_buffer->storage");
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    int64_t rank = x_buffer->view.rank;
+
+    if (w_buffer->view.rank != 2 || rank >= MAX_RANK)
+    {
+        return ERROR(ERROR_RANK, string_create("embedding expects rank 2 weights and indices of rank below %d.", (int) MAX_RANK), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *w_contiguous = NULL;
+    buffer_t *x_indices = NULL;
+    const int64_t *indices = NULL;
+    int64_t vocabulary_size = w_buffer->view.shape[0];
+    int64_t embedding_size = w_buffer->view.shape[1];
+    int64_t shape[rank + 1];
+    int64_t n;
+
+    error = buffer_contiguous(w_buffer, &w_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare embedding weights."), error);
+    }
+    w_buffer = (w_contiguous) ? w_contiguous : w_buffer;
+
+    error = buffer_embedding_indices(x_buffer, vocabulary_size, &x_indices, &indices);
+    if (error)
+    {
+        error = ERROR(ERROR_EMBEDDING, string_create("failed to prepare embedding indices."), error);
+        goto cleanup;
+    }
+
+    error = view_logical_size(&x_buffer->view, &n);
+    if (error)
+    {
+        error = ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
+        goto cleanup;
+    }
+
+    for (int64_t i = 0; i < rank; ++i)
+    {
+        shape[i] = x_buffer->view.shape[i];
+    }
+    shape[rank] = embedding_size;
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, shape, rank + 1, NULL, 0, w_buffer->storage->runtime, w_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    runtime_embedding(w_buffer->storage->runtime, w_buffer->storage->datatype, n, embedding_size, indices,
+                      w_buffer->storage->data, w_buffer->view.offset, (*y_buffer)->storage->data, (*y_buffer)->view.offset);
+
+cleanup:
+
+    buffer_destroy(w_contiguous);
+    buffer_destroy(x_indices);
+
+    return error;
+}
+
+static int buffer_compare_rows(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sorted distinct rows among `indices` and the position of every index among them.
+ * @param indices Row indices, may repeat.
+ * @param n Number of indices.
+ * @param runtime Runtime of the rows buffer.
+ * @param rows Created with the sorted distinct rows as a rank 1 int64 buffer.
+ * @param positions Allocated with the position in `rows` of every index, freed by the caller.
+ */
+static nw_error_t *buffer_sparse_rows(const int64_t *indices, int64_t n, runtime_t runtime, buffer_t **rows, int64_t **positions)
+{
+    nw_error_t *error = NULL;
+    int64_t *sorted = NULL;
+    size_t size = (size_t) MAX(n, 1) * sizeof(int64_t);
+    int64_t k = 0;
+
+    *rows = NULL;
+    *positions = NULL;
+
+    sorted = (int64_t *) malloc(size);
+    *positions = (int64_t *) malloc(size);
+    if (!sorted || !*positions)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
+        goto cleanup;
+    }
+
+    memcpy(sorted, indices, (size_t) n * sizeof(int64_t));
+    qsort(sorted, (size_t) n, sizeof(int64_t), buffer_compare_rows);
+    for (int64_t i = 0; i < n; ++i)
+    {
+        if (!k || sorted[k - 1] != sorted[i])
+        {
+            sorted[k++] = sorted[i];
+        }
+    }
+
+    for (int64_t i = 0; i < n; ++i)
+    {
+        (*positions)[i] = (const int64_t *) bsearch(&indices[i], sorted, (size_t) k, sizeof(int64_t), buffer_compare_rows) - sorted;
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, rows, (int64_t[]){k}, 1, NULL, 0, runtime, INT64, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+    memcpy((*rows)->storage->data, sorted, (size_t) k * sizeof(int64_t));
+
+    free(sorted);
+
+    return error;
+
+cleanup:
+
+    free(sorted);
+    free(*positions);
+    *positions = NULL;
+
+    return error;
+}
+
+/**
+ * @brief Add rows of a gradient into the rows of another buffer selected by `positions`.
+ * @param gradient_buffer Rows to add, contiguous with `n` rows of `embedding_size` elements.
+ * @param result Buffer the rows are added into.
+ * @param zero Whether `result` is zeroed first.
+ */
+static nw_error_t *buffer_scatter_rows(buffer_t *gradient_buffer, int64_t n, int64_t embedding_size, const int64_t *positions, buffer_t *result, bool_t zero)
+{
+    nw_error_t *error = NULL;
+    void *gradient_data = NULL;
+    void *result_data = NULL;
+    int64_t gradient_offset, result_offset;
+    int64_t rows = result->view.shape[0];
+
+    error = buffer_compute_acquire(gradient_buffer, true, &gradient_data, &gradient_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(result, !zero, &result_data, &result_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_embedding_backward(result->storage->runtime, datatype_compute(result->storage->datatype), n, rows, embedding_size, positions,
+                               gradient_data, gradient_offset, result_data, result_offset, zero);
+
+    buffer_compute_release(result, result_data, true);
+
+cleanup:
+
+    buffer_compute_release(gradient_buffer, gradient_data, false);
+
+    return error;
+}
+
+/**
+ * @brief Gradient of `buffer_embedding` with respect to the weights.
+ *        Rows of the gradient are added into the rows they were gathered from.
+ * @param w_buffer Weights that were gathered from, only their shape and datatype are read.
+ * @param x_buffer Indices that were gathered.
+ * @param gradient_buffer Gradient with respect to the gathered rows.
+ * @param result Created with the gradient of the weights. Dense with zero rows when `rows` is NULL,
+ *               otherwise only the gathered rows of shape (rows, embedding_size).
+ * @param rows Optionally created with the sorted distinct rows that were gathered.
+ * @return Error if the arguments are NULL or the shapes are invalid.
+ *         NULL if the gradient was computed successfully.
+ */
+nw_error_t *buffer_embedding_backward(buffer_t *w_buffer, buffer_t *x_buffer, buffer_t *gradient_buffer, buffer_t **result, buffer_t **rows)
+{
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(w_buffer->storage, "w_buffer->storage");
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(gradient_buffer, "gradient_buffer");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    if (w_buffer->view.rank != 2)
+    {
+        return ERROR(ERROR_RANK, string_create("embedding expects rank 2 weights."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *gradient_contiguous = NULL;
+    buffer_t *x_indices = NULL;
+    const int64_t *indices = NULL;
+    int64_t *positions = NULL;
+    int64_t vocabulary_size = w_buffer->view.shape[0];
+    int64_t embedding_size = w_buffer->view.shape[1];
+    int64_t n;
+
+    error = view_logical_size(&x_buffer->view, &n);
+    if (error)
+    {
+        return ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
+    }
+
+    if (gradient_buffer->view.rank != x_buffer->view.rank + 1 || gradient_buffer->view.shape[x_buffer->view.rank] != embedding_size)
+    {
+        return ERROR(ERROR_SHAPE, string_create("gradient shape does not match embedding output."), NULL);
+    }
+
+    error = buffer_contiguous(gradient_buffer, &gradient_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare embedding gradient."), error);
+    }
+    gradient_buffer = (gradient_contiguous) ? gradient_contiguous : gradient_buffer;
+
+    error = buffer_embedding_indices(x_buffer, vocabulary_size, &x_indices, &indices);
+    if (error)
+    {
+        error = ERROR(ERROR_EMBEDDING, string_create("failed to prepare embedding indices."), error);
+        goto cleanup;
+    }
+
+    if (rows)
+    {
+        error = buffer_sparse_rows(indices, n, w_buffer->storage->runtime, rows, &positions);
+        if (error)
+        {
+            error = ERROR(ERROR_EMBEDDING, string_create("failed to collect embedding rows."), error);
+            goto cleanup;
+        }
+        indices = positions;
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, result, (int64_t[]){(rows) ? (*rows)->view.shape[0] : vocabulary_size, embedding_size}, 2, NULL, 0,
+                            w_buffer->storage->runtime, w_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    error = buffer_scatter_rows(gradient_buffer, n, embedding_size, indices, *result, true);
+    if (error)
+    {
+        error = ERROR(ERROR_EMBEDDING, string_create("failed to accumulate embedding rows."), error);
+        goto cleanup;
+    }
+
+cleanup:
+
+    if (error)
+    {
+        buffer_destroy(*result);
+        *result = NULL;
+        if (rows)
+        {
+            buffer_destroy(*rows);
+            *rows = NULL;
+        }
+    }
+    free(positions);
+    buffer_destroy(gradient_contiguous);
+    buffer_destroy(x_indices);
+
+    return error;
+}
+
+/**
+ * @brief Sum two row sparse gradients.
+ * @param x_rows Sorted distinct rows of the first gradient.
+ * @param x_buffer Values of the first gradient, one row per entry of `x_rows`.
+ * @param y_rows Sorted distinct rows of the second gradient.
+ * @param y_buffer Values of the second gradient, one row per entry of `y_rows`.
+ * @param z_rows Created with the union of the rows.
+ * @param z_buffer Created with the summed values.
+ */
+nw_error_t *buffer_sparse_accumulate(buffer_t *x_rows, buffer_t *x_buffer, buffer_t *y_rows, buffer_t *y_buffer, buffer_t **z_rows, buffer_t **z_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_rows, "x_rows");
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(y_rows, "y_rows");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+    CHECK_NULL_ARGUMENT(z_rows, "z_rows");
+    CHECK_NULL_ARGUMENT(z_buffer, "z_buffer");
+
+    if (x_buffer->view.rank != 2 || y_buffer->view.rank != 2 || x_buffer->view.shape[1] != y_buffer->view.shape[1] ||
+        x_buffer->storage->datatype != y_buffer->storage->datatype)
+    {
+        return ERROR(ERROR_SHAPE, string_create("sparse gradients do not match."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    buffer_t *y_contiguous = NULL;
+    int64_t *positions = NULL;
+    int64_t m = x_rows->view.shape[0];
+    int64_t n = y_rows->view.shape[0];
+    int64_t embedding_size = x_buffer->view.shape[1];
+    size_t size = (size_t) MAX(m + n, 1) * sizeof(int64_t);
+    const int64_t *x_data = NULL;
+    const int64_t *y_data = NULL;
+    int64_t *union_rows = NULL;
+    int64_t k = 0;
+
+    *z_rows = NULL;
+    *z_buffer = NULL;
+
+    error = buffer_contiguous(x_buffer, &x_contiguous);
+    if (!error)
+    {
+        error = buffer_contiguous(y_buffer, &y_contiguous);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare sparse gradients."), error);
+        goto cleanup;
+    }
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+    y_buffer = (y_contiguous) ? y_contiguous : y_buffer;
+
+    positions = (int64_t *) malloc(2 * size);
+    if (!positions)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", 2 * size), NULL);
+        goto cleanup;
+    }
+    union_rows = &positions[m + n];
+
+    // Both row lists are sorted, so their union is a single merge.
+    runtime_synchronize(x_rows->storage->runtime);
+    x_data = &((const int64_t *) x_rows->storage->data)[x_rows->view.offset];
+    y_data = &((const int64_t *) y_rows->storage->data)[y_rows->view.offset];
+    for (int64_t i = 0, j = 0; i < m || j < n; ++k)
+    {
+        if (j >= n || (i < m && x_data[i] < y_data[j]))
+        {
+            union_rows[k] = x_data[i];
+            positions[i++] = k;
+        }
+        else if (i >= m || y_data[j] < x_data[i])
+        {
+            union_rows[k] = y_data[j];
+            positions[m + j++] = k;
+        }
+        else
+        {
+            union_rows[k] = x_data[i];
+            positions[i++] = k;
+            positions[m + j++] = k;
+        }
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, z_rows, (int64_t[]){k}, 1, NULL, 0, x_rows->storage->runtime, INT64, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+    memcpy((*z_rows)->storage->data, union_rows, (size_t) k * sizeof(int64_t));
+
+    error = buffer_creation(EMPTY_OPERATION, z_buffer, (int64_t[]){k, embedding_size}, 2, NULL, 0, x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    error = buffer_scatter_rows(x_buffer, m, embedding_size, positions, *z_buffer, true);
+    if (!error)
+    {
+        error = buffer_scatter_rows(y_buffer, n, embedding_size, &positions[m], *z_buffer, false);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_ADDITION, string_create("failed to add sparse gradients."), error);
+        goto cleanup;
+    }
+
+cleanup:
+
+    if (error)
+    {
+        buffer_destroy(*z_rows);
+        buffer_destroy(*z_buffer);
+        *z_rows = NULL;
+        *z_buffer = NULL;
+    }
+    free(positions);
+    buffer_destroy(x_contiguous);
+    buffer_destroy(y_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief Expand a row sparse gradient to a dense buffer with zero rows elsewhere.
+ * @param rows Sorted distinct rows of the gradient.
+ * @param x_buffer Values of the gradient, one row per entry of `rows`.
+ * @param size Number of rows of the dense buffer.
+ * @param y_buffer Created with the dense gradient.
+ */
+nw_error_t *buffer_sparse_to_dense(buffer_t *rows, buffer_t *x_buffer, int64_t size, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(rows, "rows");
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    if (x_buffer->view.rank != 2)
+    {
+        return ERROR(ERROR_RANK, string_create("sparse gradient must be rank 2."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    int64_t n = rows->view.shape[0];
+    int64_t embedding_size = x_buffer->view.shape[1];
+
+    *y_buffer = NULL;
+
+    error = buffer_contiguous(x_buffer, &x_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare sparse gradient."), error);
+    }
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, (int64_t[]){size, embedding_size}, 2, NULL, 0, x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    runtime_synchronize(rows->storage->runtime);
+    error = buffer_scatter_rows(x_buffer, n, embedding_size, &((const int64_t *) rows->storage->data)[rows->view.offset], *y_buffer, true);
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        error = ERROR(ERROR_EMBEDDING, string_create("failed to scatter sparse gradient."), error);
+        goto cleanup;
+    }
+
+cleanup:
+
+    buffer_destroy(x_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief Stochastic gradient descent on the rows of `w_buffer` that have a sparse gradient.
+ * @param w_buffer Contiguous parameters, updated in place.
+ * @param rows Sorted distinct rows of the gradient.
+ * @param g_buffer Values of the gradient, one row per entry of `rows`.
+ * @param m_buffer Contiguous momentum buffer shaped like `w_buffer`, NULL without momentum.
+ * @param initialize Whether the momentum buffer is being started, the gradient is then copied into it.
+ */
+nw_error_t *buffer_sparse_stochastic_gradient_descent(buffer_t *w_buffer, buffer_t *rows, buffer_t *g_buffer, buffer_t *m_buffer,
+                                                      float64_t learning_rate, float64_t momentum, float64_t dampening, float64_t weight_decay,
+                                                      bool_t nesterov, bool_t initialize)
+{
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(rows, "rows");
+    CHECK_NULL_ARGUMENT(g_buffer, "g_buffer");
+
+    nw_error_t *error = NULL;
+    buffer_t *g_contiguous = NULL;
+    void *w_data = NULL;
+    void *g_data = NULL;
+    void *m_data = NULL;
+    int64_t w_offset, g_offset, m_offset = 0;
+    datatype_t datatype = w_buffer->storage->datatype;
+
+    error = buffer_contiguous(g_buffer, &g_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare sparse gradient."), error);
+    }
+    g_buffer = (g_contiguous) ? g_contiguous : g_buffer;
+
+    error = buffer_compute_acquire(w_buffer, true, &w_data, &w_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(g_buffer, true, &g_data, &g_offset);
+    }
+    if (!error && m_buffer)
+    {
+        error = buffer_compute_acquire(m_buffer, true, &m_data, &m_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_sparse_stochastic_gradient_descent(w_buffer->storage->runtime, datatype_compute(datatype), rows->view.shape[0], w_buffer->view.shape[1],
+                                               &((const int64_t *) rows->storage->data)[rows->view.offset], g_data, g_offset,
+                                               w_data, w_offset, m_data, m_offset,
+                                               learning_rate, momentum, dampening, weight_decay, nesterov, initialize);
+
+cleanup:
+
+    buffer_compute_release(w_buffer, w_data, !error);
+    buffer_compute_release(g_buffer, g_data, false);
+    if (m_buffer)
+    {
+        buffer_compute_release(m_buffer, m_data, !error);
+    }
+    buffer_destroy(g_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief Lazy Adam on the rows of `w_buffer` that have a sparse gradient.
+ * @param w_buffer Contiguous parameters, updated in place.
+ * @param rows Sorted distinct rows of the gradient.
+ * @param g_buffer Values of the gradient, one row per entry of `rows`.
+ * @param m_buffer Contiguous first moment shaped like `w_buffer`.
+ * @param v_buffer Contiguous second moment shaped like `w_buffer`.
+ * @param steps Contiguous int64 buffer with the step each row of `w_buffer` was last updated at.
+ * @param step Current step of the parameters, starting at 1.
+ */
+nw_error_t *buffer_sparse_adam(buffer_t *w_buffer, buffer_t *rows, buffer_t *g_buffer, buffer_t *m_buffer, buffer_t *v_buffer, buffer_t *steps, int64_t step,
+                               float64_t learning_rate, float64_t beta_1, float64_t beta_2, float64_t weight_decay, float64_t epsilon)
+{
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(rows, "rows");
+    CHECK_NULL_ARGUMENT(g_buffer, "g_buffer");
+    CHECK_NULL_ARGUMENT(m_buffer, "m_buffer");
+    CHECK_NULL_ARGUMENT(v_buffer, "v_buffer");
+    CHECK_NULL_ARGUMENT(steps, "steps");
+
+    if (steps->storage->datatype != INT64)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("row steps must be int64."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *g_contiguous = NULL;
+    void *w_data = NULL;
+    void *g_data = NULL;
+    void *m_data = NULL;
+    void *v_data = NULL;
+    int64_t w_offset, g_offset, m_offset, v_offset;
+    datatype_t datatype = w_buffer->storage->datatype;
+
+    error = buffer_contiguous(g_buffer, &g_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare sparse gradient."), error);
+    }
+    g_buffer = (g_contiguous) ? g_contiguous : g_buffer;
+
+    error = buffer_compute_acquire(w_buffer, true, &w_data, &w_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(g_buffer, true, &g_data, &g_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire(m_buffer, true, &m_data, &m_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire(v_buffer, true, &v_data, &v_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_sparse_adam(w_buffer->storage->runtime, datatype_compute(datatype), rows->view.shape[0], w_buffer->view.shape[1],
+                        &((const int64_t *) rows->storage->data)[rows->view.offset], g_data, g_offset,
+                        w_data, w_offset, m_data, m_offset, v_data, v_offset,
+                        &((int64_t *) steps->storage->data)[steps->view.offset], step, learning_rate, beta_1, beta_2, weight_decay, epsilon);
+
+cleanup:
+
+    buffer_compute_release(w_buffer, w_data, !error);
+    buffer_compute_release(g_buffer, g_data, false);
+    buffer_compute_release(m_buffer, m_data, !error);
+    buffer_compute_release(v_buffer, v_data, !error);
+    buffer_destroy(g_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief Quantize a weight buffer to int8 with one scale per output channel.
+ * @param buffer Weights. With `channels_last` a (in_features, out_features) linear weight matrix,
+ *               otherwise a kernel whose leading dimension is the output channels.
+ * @param channels_last Whether output channels are the last dimension of `buffer`.
+ * @param quantization The quantized weights, always laid out channels x features.
+ */
+nw_error_t *buffer_quantize(buffer_t *buffer, bool_t channels_last, quantization_t **quantization)
+{
+    CHECK_NULL_ARGUMENT(buffer, "buffer");
+    CHECK_NULL_ARGUMENT(buffer->storage, "buffer->storage");
+    CHECK_NULL_ARGUMENT(quantization, "quantization");
+
+    nw_error_t *error = NULL;
+    buffer_t *contiguous = NULL;
+    void *data = NULL;
+    int64_t offset;
+    int64_t rank = buffer->view.rank;
+    int64_t channels, features;
+
+    if (datatype_compute(buffer->storage->datatype) != FLOAT32)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("quantization requires float32 compute, got %s.", datatype_string(buffer->storage->datatype)), NULL);
+    }
+
+    if (rank < 2 || (channels_last && rank != 2))
+    {
+        return ERROR(ERROR_RANK, string_create("unsupported weight rank %d.", (int) rank), NULL);
+    }
+
+    error = buffer_contiguous(buffer, &contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare weights."), error);
+    }
+    buffer = (contiguous) ? contiguous : buffer;
+
+    channels = (channels_last) ? buffer->view.shape[1] : buffer->view.shape[0];
+    features = array_product(buffer->view.shape, rank) / channels;
+
+    *quantization = (quantization_t *) malloc(sizeof(quantization_t));
+    if (!*quantization)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(quantization_t)), NULL);
+        goto cleanup;
+    }
+
+    (*quantization)->channels = channels;
+    (*quantization)->features = features;
+    (*quantization)->data = (int8_t *) malloc((size_t) (channels * features) * sizeof(int8_t));
+    (*quantization)->scales = (float32_t *) malloc((size_t) channels * sizeof(float32_t));
+    (*quantization)->sums = (int32_t *) malloc((size_t) channels * sizeof(int32_t));
+    if (!(*quantization)->data || !(*quantization)->scales || !(*quantization)->sums)
+    {
+        quantization_destroy(*quantization);
+        *quantization = NULL;
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate quantized weights."), NULL);
+        goto cleanup;
+    }
+
+    error = buffer_compute_acquire(buffer, true, &data, &offset);
+    if (error)
+    {
+        quantization_destroy(*quantization);
+        *quantization = NULL;
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    runtime_synchronize(buffer->storage->runtime);
+    runtime_quantize_channels(channels, features, &((float32_t *) data)[offset],
+                              (channels_last) ? 1 : features, (channels_last) ? channels : 1,
+                              (*quantization)->data, (*quantization)->scales, (*quantization)->sums);
+
+cleanup:
+
+    buffer_compute_release(buffer, data, false);
+    buffer_destroy(contiguous);
+
+    return error;
+}
+
+void quantization_destroy(quantization_t *quantization)
+{
+    if (quantization)
+    {
+        free(quantization->data);
+        free(quantization->scales);
+        free(quantization->sums);
+        free(quantization);
+    }
+}
+
+static nw_error_t *buffer_quantized_bias(buffer_t *b_buffer, int64_t channels, void **b_data, int64_t *b_offset)
+{
+    *b_data = NULL;
+
+    if (!b_buffer)
+    {
+        return NULL;
+    }
+    CHECK_NULL_ARGUMENT(b_buffer->storage, "b_buffer->storage");
+
+    // A single channel bias has a zero stride.
+    if (b_buffer->view.rank != 1 || b_buffer->view.shape[0] != channels || (channels > 1 && b_buffer->view.strides[0] != 1))
+    {
+        return ERROR(ERROR_SHAPE, string_create("bias must be a contiguous vector of length %d.", (int) channels), NULL);
+    }
+
+    if (datatype_compute(b_buffer->storage->datatype) != FLOAT32)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("quantized layers require float32 compute, got %s.", datatype_string(b_buffer->storage->datatype)), NULL);
+    }
+
+    return buffer_compute_acquire(b_buffer, true, b_data, b_offset);
+}
+
+/**
+ * @brief Fully connected layer with int8 weights, y = x * w + b, for inference. The activations are
+ *        quantized dynamically and all leading dimensions of x are treated as rows.
+ */
+nw_error_t *buffer_quantized_linear(buffer_t *x_buffer, const quantization_t *quantization, buffer_t *b_buffer, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(quantization, "quantization");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    void *x_data = NULL;
+    void *b_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, b_offset, y_offset;
+    int64_t rank = x_buffer->view.rank;
+    int64_t shape[MAX_RANK];
+    int64_t rows;
+
+    if (datatype_compute(x_buffer->storage->datatype) != FLOAT32)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("quantized layers require float32 compute, got %s.", datatype_string(x_buffer->storage->datatype)), NULL);
+    }
+
+    if (rank < 1 || x_buffer->view.shape[rank - 1] != quantization->features)
+    {
+        return ERROR(ERROR_SHAPE, string_create("input features do not match quantized weights."), NULL);
+    }
+
+    error = buffer_contiguous(x_buffer, &x_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare linear operand."), error);
+    }
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+
+    memcpy(shape, x_buffer->view.shape, (size_t) rank * sizeof(int64_t));
+    shape[rank - 1] = quantization->channels;
+    rows = array_product(shape, rank - 1);
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, shape, rank, NULL, 0, x_buffer->storage->runtime, x_buffer->storage->datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_quantized_bias(b_buffer, quantization->channels, &b_data, &b_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*y_buffer), false, &y_data, &y_offset);
+    }
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    error = runtime_quantized_linear(x_buffer->storage->runtime, rows, quantization->features, quantization->channels,
+                                     &((float32_t *) x_data)[x_offset], quantization->data, quantization->scales, quantization->sums,
+                                     (b_data) ? &((float32_t *) b_data)[b_offset] : NULL, &((float32_t *) y_data)[y_offset]);
+    buffer_compute_release((*y_buffer), y_data, !error);
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        error = ERROR(ERROR_QUANTIZATION, string_create("failed to apply quantized linear layer."), error);
+    }
+
+cleanup:
+
+    buffer_compute_release(x_buffer, x_data, false);
+    if (b_buffer)
+    {
+        buffer_compute_release(b_buffer, b_data, false);
+    }
+    buffer_destroy(x_contiguous);
+
+    return error;
+}
+
+/**
+ * @brief 2D convolution with int8 weights for inference. The activations are quantized dynamically.
+ */
+nw_error_t *buffer_quantized_convolution_2d(buffer_t *x_buffer, const quantization_t *quantization, buffer_t *b_buffer,
+                                            int64_t kernel_size, int64_t stride, int64_t padding, buffer_t **y_buffer)
+{
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(quantization, "quantization");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_contiguous = NULL;
+    void *x_data = NULL;
+    void *b_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, b_offset, y_offset;
+    runtime_t runtime = x_buffer->storage->runtime;
+    datatype_t datatype = x_buffer->storage->datatype;
+
+    if (datatype_compute(datatype) != FLOAT32)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("quantized layers require float32 compute, got %s.", datatype_string(datatype)), NULL);
+    }
+
+    error = buffer_contiguous_image(x_buffer, &x_contiguous);
+    if (error)
+    {
+        return ERROR(ERROR_CONTIGUOUS, string_create("failed to prepare convolution operand."), error);
+    }
+    x_buffer = (x_contiguous) ? x_contiguous : x_buffer;
+
+    int64_t batch_size = x_buffer->view.shape[0];
+    int64_t in_channels = x_buffer->view.shape[1];
+    int64_t height = x_buffer->view.shape[2];
+    int64_t width = x_buffer->view.shape[3];
+    int64_t out_channels = quantization->channels;
+    int64_t output_height = (stride > 0) ? (height + 2 * padding - kernel_size) / stride + 1 : 0;
+    int64_t output_width = (stride > 0) ? (width + 2 * padding - kernel_size) / stride + 1 : 0;
+
+    if (kernel_size < 1 || stride < 1 || padding < 0 || height + 2 * padding < kernel_size || width + 2 * padding < kernel_size ||
+        in_channels * kernel_size * kernel_size != quantization->features)
+    {
+        error = ERROR(ERROR_SHAPE, string_create("invalid quantized convolution arguments."), NULL);
+        goto cleanup;
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, y_buffer, (int64_t[]){batch_size, out_channels, output_height, output_width}, 4, NULL, 0, runtime, datatype, NULL, 0, NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        goto cleanup;
+    }
+
+    error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_quantized_bias(b_buffer, out_channels, &b_data, &b_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*y_buffer), false, &y_data, &y_offset);
+    }
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
+
+    error = runtime_quantized_convolution_2d(runtime, batch_size, in_channels, height, width, out_channels, kernel_size, stride, padding,
+                                             &((float32_t *) x_data)[x_offset], quantization->data, quantization->scales, quantization->sums,
+                                             (b_data) ? &((float32_t *) b_data)[b_offset] : NULL, &((float32_t *) y_data)[y_offset]);
+    buffer_compute_release((*y_buffer), y_data, !error);
+    if (error)
+    {
+        buffer_destroy(*y_buffer);
+        *y_buffer = NULL;
+        error = ERROR(ERROR_QUANTIZATION, string_create("failed to apply quantized convolution."), error);
+    }
+
+cleanup:
+
+    buffer_compute_release(x_buffer, x_data, false);
+    if (b_buffer)
+    {
+        buffer_compute_release(b_buffer, b_data, false);
+    }
+    buffer_destroy(x_contiguous);
+
+    return error;
+}
+
+nw_error_t *buffer_ternary(ternary_operation_type_t ternary_operation_type, buffer_t *w_buffer, buffer_t *x_buffer, buffer_t *y_buffer, buffer_t **z_buffer)
+{
+    CHECK_NULL_ARGUMENT(w_buffer, "w_buffer");
+    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
+    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
+    CHECK_NULL_ARGUMENT(z_buffer, "z_buffer");
+    CHECK_NULL_ARGUMENT(w_buffer->storage, "w_buffer->storage");
+    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
+    CHECK_NULL_ARGUMENT(y_buffer->storage, "y_buffer->storage");
+    CHECK_NULL_ARGUMENT(w_buffer->storage->data, "w_buffer->storage->data");
+    CHECK_NULL_ARGUMENT(x_buffer->storage->data, "x_buffer->storage->data");
+    CHECK_NULL_ARGUMENT(y_buffer->storage->data, "y_buffer->storage->data");
+
+    nw_error_t *error = NULL;
+    bool_t overwrite = (bool_t) *z_buffer;
+    int64_t rank;
+
+    if (x_buffer->view.rank != y_buffer->view.rank || y_buffer->view.rank != w_buffer->view.rank)
+    {
+        return ERROR(ERROR_RANK, string_create("ranks are incompatible."), NULL);
+    }
+    else
+    {
+        rank = w_buffer->view.rank;
+    }
+
+    int64_t shape[rank];
+    runtime_t runtime;
+    datatype_t datatype;
+    void *w_data = NULL;
+    void *x_data = NULL;
+    void *y_data = NULL;
+    void *z_data = NULL;
+    int64_t w_offset, x_offset, y_offset, z_offset;
+
+    if (x_buffer->storage->datatype != y_buffer->storage->datatype || y_buffer->storage->datatype != w_buffer->storage->datatype)
+    {
+        error = ERROR(ERROR_DATATYPE, string_create("datatypes are incompatible."), NULL);
+        goto cleanup;
+    }
+    else
+    {
+        datatype = w_buffer->storage->datatype;
+    }
+
+    if (x_buffer->storage->runtime != y_buffer->storage->runtime || y_buffer->storage->runtime != w_buffer->storage->runtime)
+    {
+        error = ERROR(ERROR_RUNTIME, string_create("runtimes are incompatible."), NULL);
+        goto cleanup;
+    }
+    else
+    {
+        runtime = w_buffer->storage->runtime;
+    }
+
+    if (!overwrite)
+    {
+        if (!view_shapes_equal(&x_buffer->view, &y_buffer->view) || !view_shapes_equal(&y_buffer->view, &w_buffer->view))
+        {
+            error = ERROR(ERROR_SHAPE, string_create("incompatible tensor shapes."), NULL);
+            goto cleanup;
         }
-        break;
-    case 4:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
+        else
         {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t k = 0; k < (*z_buffer)->view->shape[2]; ++k)
-                {
-                    n = (*z_buffer)->view->shape[3];
-                    w_stride = w_buffer->view->strides[3];
-                    x_stride = x_buffer->view->strides[3];
-                    y_stride = y_buffer->view->strides[3];
-                    z_stride = (*z_buffer)->view->strides[3];
-                    w_offset = w_buffer->view->offset
-                               + i * w_buffer->view->strides[0]
-                               + j * w_buffer->view->strides[1]
-                               + k * w_buffer->view->strides[2];
-                    x_offset = x_buffer->view->offset
-                               + i * x_buffer->view->strides[0]
-                               + j * x_buffer->view->strides[1]
-                               + k * x_buffer->view->strides[2];
-                    y_offset = y_buffer->view->offset
-                               + i * y_buffer->view->strides[0]
-                               + j * y_buffer->view->strides[1]
-                               + k * y_buffer->view->strides[2];
-                    z_offset = (*z_buffer)->view->offset
-                               + i * (*z_buffer)->view->strides[0]
-                               + j * (*z_buffer)->view->strides[1]
-                               + k * (*z_buffer)->view->strides[2];
-
-                    runtime_ternary(ternary_operation_type, 
-                                    runtime, datatype, n, 
-                                    w_data, w_stride, w_offset, 
-                                    x_data, x_stride, x_offset, 
-                                    y_data, y_stride, y_offset,
-                                    z_data, z_stride, z_offset);
-                }
-            }
+            memcpy(shape, w_buffer->view.shape, rank * sizeof(int64_t));
         }
-        break;
-    case 5:
-        for (int64_t i = 0; i < (*z_buffer)->view->shape[0]; ++i)
+
+        error = buffer_creation(EMPTY_OPERATION, z_buffer, shape, rank, NULL, 0, runtime, datatype, NULL, 0, NULL);
+        if (error)
         {
-            for (int64_t j = 0; j < (*z_buffer)->view->shape[1]; ++j)
-            {
-                for (int64_t k = 0; k < (*z_buffer)->view->shape[2]; ++k)
-                {
-                    for (int64_t l = 0; l < (*z_buffer)->view->shape[3]; ++l)
-                    {
-                        n = (*z_buffer)->view->shape[4];
-                        w_stride = w_buffer->view->strides[4];
-                        x_stride = x_buffer->view->strides[4];
-                        y_stride = y_buffer->view->strides[4];
-                        z_stride = (*z_buffer)->view->strides[4];
-                        w_offset = w_buffer->view->offset
-                                   + i * w_buffer->view->strides[0]
-                                   + j * w_buffer->view->strides[1]
-                                   + k * w_buffer->view->strides[2]
-                                   + l * w_buffer->view->strides[3];
-                        x_offset = x_buffer->view->offset
-                                   + i * x_buffer->view->strides[0]
-                                   + j * x_buffer->view->strides[1]
-                                   + k * x_buffer->view->strides[2]
-                                   + l * x_buffer->view->strides[3];
-                        y_offset = y_buffer->view->offset
-                                   + i * y_buffer->view->strides[0]
-                                   + j * y_buffer->view->strides[1]
-                                   + k * y_buffer->view->strides[2]
-                                   + l * y_buffer->view->strides[3];
-                        z_offset = (*z_buffer)->view->offset
-                                   + i * (*z_buffer)->view->strides[0]
-                                   + j * (*z_buffer)->view->strides[1]
-                                   + k * (*z_buffer)->view->strides[2]
-                                   + l * (*z_buffer)->view->strides[3];
-                        runtime_ternary(ternary_operation_type, 
-                                        runtime, datatype, n, 
-                                        w_data, w_stride, w_offset, 
-                                        x_data, x_stride, x_offset, 
-                                        y_data, y_stride, y_offset,
-                                        z_data, z_stride, z_offset);
-                    }
-                }
-            }
+            error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+            goto cleanup;
         }
-        break;
-    default:
-        error = ERROR(ERROR_RANK, string_create("unsupported rank %d", (int) rank), NULL);
+    }
+
+    error = buffer_compute_acquire(w_buffer, true, &w_data, &w_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(x_buffer, true, &x_data, &x_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire(y_buffer, true, &y_data, &y_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*z_buffer), overwrite, &z_data, &z_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
         goto cleanup;
     }
 
+    runtime_ternary(ternary_operation_type, runtime, datatype_compute(datatype),
+                    (*z_buffer)->view.rank, (*z_buffer)->view.shape,
+                    w_data, w_buffer->view.strides, w_offset,
+                    x_data, x_buffer->view.strides, x_offset,
+                    y_data, y_buffer->view.strides, y_offset,
+                    z_data, (*z_buffer)->view.strides, z_offset);
+
+    buffer_compute_release(w_buffer, w_data, false);
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(y_buffer, y_data, false);
+    buffer_compute_release((*z_buffer), z_data, true);
+
     return error;
 
 cleanup:
 
+    buffer_compute_release(w_buffer, w_data, false);
+    buffer_compute_release(x_buffer, x_data, false);
+    buffer_compute_release(y_buffer, y_data, false);
+
     if (!overwrite)
     {
         buffer_destroy(*z_buffer);
@@ -1167,217 +2876,9 @@ cleanup:
     return error;
 }
 
-static nw_error_t *runtime_reduction_dimension(reduction_operation_type_t reduction_operation_type, buffer_t *x_buffer, buffer_t *y_buffer, int64_t axis, bool_t keep_dimension)
-{
-    CHECK_NULL_ARGUMENT(x_buffer, "x_buffer");
-    CHECK_NULL_ARGUMENT(y_buffer, "y_buffer");
-    CHECK_NULL_ARGUMENT(x_buffer->view, "x_buffer->view");
-    CHECK_NULL_ARGUMENT(y_buffer->view, "y_buffer->view");
-    CHECK_NULL_ARGUMENT(x_buffer->view->strides, "x_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(y_buffer->view->strides, "y_buffer->view->strides");
-    CHECK_NULL_ARGUMENT(x_buffer->view->shape, "x_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(y_buffer->view->shape, "y_buffer->view->shape");
-    CHECK_NULL_ARGUMENT(x_buffer->storage, "x_buffer->storage");
-    CHECK_NULL_ARGUMENT(y_buffer->storage, "y_buffer->storage");
-    CHECK_NULL_ARGUMENT(x_buffer->storage->data, "x_buffer->storage->data");
-    CHECK_NULL_ARGUMENT(y_buffer->storage->data, "y_buffer->storage->data");
-
-    int64_t idim;
-    int64_t jdim;
-    int64_t kdim;
-    int64_t ldim;
-
-    datatype_t datatype = x_buffer->storage->datatype;
-    runtime_t runtime = x_buffer->storage->runtime;
-    int64_t rank = x_buffer->view->rank;
-    int64_t n = x_buffer->view->shape[axis];
-    void *x_data = x_buffer->storage->data;
-    void *y_data = y_buffer->storage->data;
-    int64_t x_stride = x_buffer->view->strides[axis];
-    int64_t x_offset;
-    int64_t y_offset;
-
-    switch (rank)
-    {
-    case 1:
-        x_offset = x_buffer->view->offset;
-        y_offset = y_buffer->view->offset;
-        runtime_reduction(reduction_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-        break;
-    case 2:
-        switch (axis)
-        {
-        case 0:
-            idim = 1;
-            break;
-        case 1:
-            idim = 0;
-            break;
-        default:
-            return ERROR(ERROR_AXIS, string_create("invalid axis dimension."), NULL);
-        }
-        
-        for (int64_t i = 0; i < x_buffer->view->shape[idim]; ++i)
-        {
-            x_offset = x_buffer->view->offset
-                       + i * x_buffer->view->strides[idim];
-            y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[(idim >= axis && !keep_dimension) ? idim - 1 : idim];
-            runtime_reduction(reduction_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-        }
-        break;
-    case 3:
-        switch (axis)
-        {
-        case 0:
-            idim = 1;
-            jdim = 2;
-            break;
-        case 1:
-            idim = 0;
-            jdim = 2;
-            break;
-        case 2:
-            idim = 0;
-            jdim = 1;
-            break;
-        default:
-            return ERROR(ERROR_AXIS, string_create("invalid axis dimension."), NULL);
-        }
-        
-        for (int64_t i = 0; i < x_buffer->view->shape[idim]; ++i)
-        {
-            for (int64_t j = 0; j < x_buffer->view->shape[jdim]; ++j)
-            {
-                x_offset = x_buffer->view->offset
-                           + i * x_buffer->view->strides[idim]
-                           + j * x_buffer->view->strides[jdim];
-                y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[(idim >= axis && !keep_dimension) ? idim - 1 : idim]
-                       + j * y_buffer->view->strides[(jdim >= axis && !keep_dimension) ? jdim - 1 : jdim];
-                runtime_reduction(reduction_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-            }
-        }
-
-        break;
-    case 4:
-        switch (axis)
-        {
-        case 0:
-            idim = 1;
-            jdim = 2;
-            kdim = 3;
-            break;
-        case 1:
-            idim = 0;
-            jdim = 2;
-            kdim = 3;
-            break;
-        case 2:
-            idim = 0;
-            jdim = 1;
-            kdim = 3;
-            break;
-        case 3:
-            idim = 0;
-            jdim = 1;
-            kdim = 2;
-            break;
-        default:
-            return ERROR(ERROR_AXIS, string_create("invalid axis dimension."), NULL);
-        }
-        
-        for (int64_t i = 0; i < x_buffer->view->shape[idim]; ++i)
-        {
-            for (int64_t j = 0; j < x_buffer->view->shape[jdim]; ++j)
-            {
-                for (int64_t k = 0; k < x_buffer->view->shape[kdim]; ++k)
-                {
-                    x_offset = x_buffer->view->offset
-                               + i * x_buffer->view->strides[idim]
-                               + j * x_buffer->view->strides[jdim]
-                               + k * x_buffer->view->strides[kdim];
-                    y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[(idim >= axis && !keep_dimension) ? idim - 1 : idim]
-                       + j * y_buffer->view->strides[(jdim >= axis && !keep_dimension) ? jdim - 1 : jdim]
-                       + k * y_buffer->view->strides[(kdim >= axis && !keep_dimension) ? kdim - 1 : kdim];
-                    runtime_reduction(reduction_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-                }
-            }
-        }
-        break;
-    case 5:
-        switch (axis)
-        {
-        case 0:
-            idim = 1;
-            jdim = 2;
-            kdim = 3;
-            ldim = 4;
-            break;
-        case 1:
-            idim = 0;
-            jdim = 2;
-            kdim = 3;
-            ldim = 4;
-            break;
-        case 2:
-            idim = 0;
-            jdim = 1;
-            kdim = 3;
-            ldim = 4;
-            break;
-        case 3:
-            idim = 0;
-            jdim = 1;
-            kdim = 2;
-            ldim = 4;
-            break;
-        case 4:
-            idim = 0;
-            jdim = 1;
-            kdim = 2;
-            ldim = 3;
-            break;
-        default:
-            return ERROR(ERROR_AXIS, string_create("invalid axis dimension."), NULL);
-        }
-        
-        for (int64_t i = 0; i < x_buffer->view->shape[idim]; ++i)
-        {
-            for (int64_t j = 0; j < x_buffer->view->shape[jdim]; ++j)
-            {
-                for (int64_t k = 0; k < x_buffer->view->shape[kdim]; ++k)
-                {
-                    for (int64_t l = 0; l < x_buffer->view->shape[ldim]; ++l)
-                    {
-                        x_offset = x_buffer->view->offset
-                                   + i * x_buffer->view->strides[idim]
-                                   + j * x_buffer->view->strides[jdim]
-                                   + k * x_buffer->view->strides[kdim]
-                                   + l * x_buffer->view->strides[ldim];
-                        y_offset = y_buffer->view->offset
-                       + i * y_buffer->view->strides[(idim >= axis && !keep_dimension) ? idim - 1 : idim]
-                       + j * y_buffer->view->strides[(jdim >= axis && !keep_dimension) ? jdim - 1 : jdim]
-                       + k * y_buffer->view->strides[(kdim >= axis && !keep_dimension) ? kdim - 1 : kdim]
-                       + l * y_buffer->view->strides[(ldim >= axis && !keep_dimension) ? ldim - 1 : ldim];
-                        runtime_reduction(reduction_operation_type, runtime, datatype, n, x_data, x_stride, x_offset, y_data, y_offset);
-                    }
-                }
-            }
-        }
-        break;
-    default:
-        return ERROR(ERROR_RANK, string_create("unsupported rank %d", (int) x_buffer->view->rank), NULL);
-    }
-
-    return NULL;
-}
-
 nw_error_t *buffer_reduction(reduction_operation_type_t reduction_operation_type, buffer_t *x, int64_t *axis, int64_t length, buffer_t **result, bool_t keep_dimension)
 {
     CHECK_NULL_ARGUMENT(x, "x");
-    CHECK_NULL_ARGUMENT(x->view, "x->view");
     CHECK_NULL_ARGUMENT(x->storage, "x->storage");
     CHECK_NULL_ARGUMENT(axis, "axis");
     CHECK_NULL_ARGUMENT(result, "result");
@@ -1385,114 +2886,230 @@ nw_error_t *buffer_reduction(reduction_operation_type_t reduction_operation_type
 
     nw_error_t *error = NULL;
     bool_t overwrite = (bool_t) *result;
-    datatype_t datatype = x->storage->datatype;
-    runtime_t runtime = x->storage->runtime;
-    buffer_t *intermediate_buffer = NULL;
-    view_t *reduced_view = NULL;
-    int64_t sorted_axis[length];
+    view_t reduced_view;
+    int64_t rank = x->view.rank;
+    bool_t reduced[MAX(rank, 1)];
+    int64_t shape[MAX(rank, 1)];
+    int64_t y_strides[MAX(rank, 1)];
+    void *x_data = NULL;
+    void *y_data = NULL;
+    int64_t x_offset, y_offset;
 
     if (!overwrite)
     {
-        error = view_reduce(x->view, &reduced_view, axis, length, keep_dimension);
+        error = view_reduce(&x->view, &reduced_view, axis, length, keep_dimension);
         if (error)
         {
             error = ERROR(ERROR_REDUCTION, string_create("failed to reduce tensor."), error);
             goto cleanup;
         }
 
-        error = buffer_creation(EMPTY_OPERATION, result, reduced_view->shape, reduced_view->rank, reduced_view->strides, reduced_view->offset, x->storage->runtime, x->storage->datatype, NULL, 0, NULL);
+        error = buffer_creation(EMPTY_OPERATION, result, reduced_view.shape, reduced_view.rank, reduced_view.strides, reduced_view.offset, x->storage->runtime, x->storage->datatype, NULL, 0, NULL);
         if (error)
         {
             error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
             goto cleanup;
         }
-
-        view_destroy(reduced_view);
-        reduced_view = NULL;
     }
 
-    error = descending_sort(axis, length, sorted_axis);
-    if (error)
+    for (int64_t i = 0; i < rank; ++i)
     {
-        error = ERROR(ERROR_SORT, string_create("failed to sort axis"), error);
-        goto cleanup;
+        reduced[i] = false;
     }
 
     for (int64_t i = 0; i < length; ++i)
     {
-        error = view_reduce(x->view, &reduced_view, &sorted_axis[i], (int64_t) 1, keep_dimension);
-        if (error)
+        if (axis[i] < 0 || axis[i] >= rank)
         {
-            error = ERROR(ERROR_REDUCTION, string_create("failed to reduce tensor."), error);
+            error = ERROR(ERROR_AXIS, string_create("axis %d out of range of tensor of rank %d.", (int) axis[i], (int) rank), NULL);
             goto cleanup;
         }
+        reduced[axis[i]] = true;
+    }
 
-        if (i + 1 < length)
+    if ((*result)->view.rank != ((keep_dimension) ? rank : rank - length))
+    {
+        error = ERROR(ERROR_RANK, string_create("result rank %d does not match reduction.", (int) (*result)->view.rank), NULL);
+        goto cleanup;
+    }
+
+    // Align the result with x, reduced axes get a zero stride so every element of x maps onto its output.
+    // A kept axis that is broadcast in the result holds the same value everywhere, so it is computed once.
+    for (int64_t i = 0, j = 0; i < rank; ++i)
+    {
+        shape[i] = x->view.shape[i];
+        if (reduced[i])
         {
-            error = buffer_creation(EMPTY_OPERATION, &intermediate_buffer, reduced_view->shape, reduced_view->rank, 
-                                    reduced_view->strides, reduced_view->offset, runtime, datatype, NULL, 0, NULL);
-            if (error)
-            {
-                error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
-                goto cleanup;
-            }
+            y_strides[i] = 0;
+            j += (keep_dimension) ? 1 : 0;
         }
         else
         {
-            intermediate_buffer = *result;
-        }
-
-        error = runtime_reduction_dimension(reduction_operation_type, x, intermediate_buffer, sorted_axis[i], keep_dimension);
-        if (error)
-        {
-            error = ERROR(ERROR_REDUCTION, string_create("failed to reduce tensor dimension."), error);
-            goto cleanup;
+            y_strides[i] = (*result)->view.strides[j++];
+            if (!y_strides[i])
+            {
+                shape[i] = 1;
+            }
         }
+    }
 
-        if (i > 0)
-        {
-            buffer_destroy(x);
-        }
+    error = buffer_compute_acquire(x, true, &x_data, &x_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire((*result), overwrite, &y_data, &y_offset);
+    }
+    if (error)
+    {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        goto cleanup;
+    }
 
-        x = intermediate_buffer;
+    runtime_reduction(reduction_operation_type, x->storage->runtime, datatype_compute(x->storage->datatype), rank, shape,
+                      x_data, x->view.strides, x_offset, y_data, y_strides, y_offset);
 
-        view_destroy(reduced_view);
-        reduced_view = NULL;
-    }
+    buffer_compute_release(x, x_data, false);
+    buffer_compute_release((*result), y_data, true);
 
     return error; 
 
 cleanup:
 
-    if (intermediate_buffer != *result)
-    {
-        buffer_destroy(intermediate_buffer);
-    }
+    buffer_compute_release(x, x_data, false);
 
     if (!overwrite)
     {
         buffer_destroy(*result);
     }
 
-    view_destroy(reduced_view);
+    return error;
+}
+
+/**
+ * @brief Index of the first maximum along an axis of an integer buffer. The values are read natively
+ *        instead of through the float64 compute copy, so large int64 values compare exactly.
+ * @param x Int32 or int64 buffer.
+ * @param axis Axis to search, ignored for scalars.
+ * @param result Created with the int64 indices.
+ * @param keep_dimension Whether the searched axis is kept with size 1.
+ * @return Error if the arguments are NULL, `x` is not an integer buffer or `axis` is out of range.
+ *         NULL if the indices were found successfully.
+ */
+nw_error_t *buffer_argument_maximum(buffer_t *x, int64_t axis, buffer_t **result, bool_t keep_dimension)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(x->storage, "x->storage");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+    view_t reduced_view;
+    int64_t rank = x->view.rank;
+    const int64_t *shape = x->view.shape;
+    const int64_t *strides = x->view.strides;
+    int64_t outer = 1;
+    int64_t inner = 1;
+    int64_t dimension = 1;
+    int64_t *y_data = NULL;
+
+    if (!datatype_is_integer(x->storage->datatype))
+    {
+        return ERROR(ERROR_DATATYPE, string_create("unsupported datatype %s.", datatype_string(x->storage->datatype)), NULL);
+    }
+
+    if (!rank)
+    {
+        axis = 0;
+        error = view_copy(&x->view, &reduced_view);
+    }
+    else if (axis < 0 || axis >= rank)
+    {
+        return ERROR(ERROR_AXIS, string_create("axis %d out of range of tensor of rank %d.", (int) axis, (int) rank), NULL);
+    }
+    else
+    {
+        error = view_reduce(&x->view, &reduced_view, &axis, 1, keep_dimension);
+    }
+    if (error)
+    {
+        return ERROR(ERROR_REDUCTION, string_create("failed to reduce tensor."), error);
+    }
+
+    error = buffer_creation(EMPTY_OPERATION, result, reduced_view.shape, reduced_view.rank, NULL, 0, x->storage->runtime, INT64, NULL, 0, NULL);
+    if (error)
+    {
+        return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+    }
+
+    for (int64_t i = 0; i < rank; ++i)
+    {
+        if (i < axis)
+        {
+            outer *= shape[i];
+        }
+        else if (i > axis)
+        {
+            inner *= shape[i];
+        }
+        else
+        {
+            dimension = shape[i];
+        }
+    }
+
+    runtime_synchronize(x->storage->runtime);
+    y_data = &((int64_t *) (*result)->storage->data)[(*result)->view.offset];
+
+    for (int64_t i = 0; i < outer; ++i)
+    {
+        for (int64_t j = 0; j < inner; ++j)
+        {
+            int64_t index = x->view.offset;
+            int64_t remainder = j;
+            int64_t maximum;
+
+            for (int64_t k = rank - 1; k > axis; --k)
+            {
+                index += (remainder % shape[k]) * strides[k];
+                remainder /= shape[k];
+            }
+
+            remainder = i;
+            for (int64_t k = axis - 1; k >= 0; --k)
+            {
+                index += (remainder % shape[k]) * strides[k];
+                remainder /= shape[k];
+            }
+
+            y_data[i * inner + j] = 0;
+            maximum = buffer_integer_load(x, index);
+            for (int64_t k = 1; k < dimension; ++k)
+            {
+                int64_t value = buffer_integer_load(x, index + k * strides[axis]);
+                if (value > maximum)
+                {
+                    maximum = value;
+                    y_data[i * inner + j] = k;
+                }
+            }
+        }
+    }
 
     return error;
 }
 
 static void runtime_padding(const buffer_t *x, buffer_t *y, int64_t *arguments, int64_t length, int64_t index, bool_t in_bounds, int64_t x_offset, int64_t y_offset)
 {
-    if (!x->view->rank)
+    if (!x->view.rank)
     {
         return;
     }
 
-    for (int64_t i  = 0; i < y->view->shape[index]; ++i)
+    for (int64_t i  = 0; i < y->view.shape[index]; ++i)
     {
         int64_t offset_i = i - arguments[2 * index]; 
-        bool_t in_bounds_i = in_bounds && offset_i >= 0 && offset_i < x->view->shape[index];
-        int64_t x_offset_i = x_offset + offset_i * x->view->strides[index];
-        int64_t y_offset_i = y_offset + i * y->view->strides[index];
-        if (index == x->view->rank - 1)
+        bool_t in_bounds_i = in_bounds && offset_i >= 0 && offset_i < x->view.shape[index];
+        int64_t x_offset_i = x_offset + offset_i * x->view.strides[index];
+        int64_t y_offset_i = y_offset + i * y->view.strides[index];
+        if (index == x->view.rank - 1)
         {
             switch (x->storage->datatype)
             {
@@ -1502,6 +3119,17 @@ static void runtime_padding(const buffer_t *x, buffer_t *y, int64_t *arguments,
             case FLOAT64:
                 ((float64_t *) y->storage->data)[y_offset_i] = (in_bounds_i) ? ((float64_t *) x->storage->data)[x_offset_i] : (float64_t) 0.0;
                 break;
+            case BFLOAT16:
+            case FLOAT16:
+                // Positive zero is all bits clear in both half precision formats.
+                ((uint16_t *) y->storage->data)[y_offset_i] = (in_bounds_i) ? ((uint16_t *) x->storage->data)[x_offset_i] : (uint16_t) 0;
+                break;
+            case INT32:
+                ((int32_t *) y->storage->data)[y_offset_i] = (in_bounds_i) ? ((int32_t *) x->storage->data)[x_offset_i] : (int32_t) 0;
+                break;
+            case INT64:
+                ((int64_t *) y->storage->data)[y_offset_i] = (in_bounds_i) ? ((int64_t *) x->storage->data)[x_offset_i] : (int64_t) 0;
+                break;
             default:
                 break;
             }
@@ -1516,11 +3144,11 @@ static void runtime_padding(const buffer_t *x, buffer_t *y, int64_t *arguments,
 nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type, buffer_t *x, int64_t *arguments, int64_t length, buffer_t **result)
 {
     nw_error_t *error = NULL;
-    view_t *view = NULL;
+    view_t view;
 
     if (structure_operation_type == EXPAND_OPERATION)
     {
-        error = view_expand(x->view, &view, arguments, length);
+        error = view_expand(&x->view, &view, arguments, length);
         if (error)
         {
             return ERROR(ERROR_EXPAND, string_create("failed to expand."), error);
@@ -1529,7 +3157,7 @@ nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type
     }
     else if (structure_operation_type == PERMUTE_OPERATION)
     {
-        error = view_permute(x->view, &view, arguments, length);
+        error = view_permute(&x->view, &view, arguments, length);
         if (error)
         {
             return ERROR(ERROR_PERMUTE, string_create("failed to permute."), error);
@@ -1537,7 +3165,7 @@ nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type
     }
     else if (structure_operation_type == RESHAPE_OPERATION)
     {
-        error = view_create(&view, x->view->offset, length, arguments, NULL);
+        error = view_create(&view, x->view.offset, length, arguments, NULL);
         if (error)
         {
             return ERROR(ERROR_CREATE, string_create("failed to create view."), error);
@@ -1545,7 +3173,7 @@ nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type
     }
     else if (structure_operation_type == SLICE_OPERATION)
     {
-        error = view_slice(x->view, &view, arguments, length);
+        error = view_slice(&x->view, &view, arguments, length);
         if (error)
         {
             return ERROR(ERROR_SLICE, string_create("failed to slice."), error);
@@ -1553,28 +3181,26 @@ nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type
     }
     else if (structure_operation_type == PADDING_OPERATION)
     {
-        error = view_padding(x->view, &view, arguments, length);
+        error = view_padding(&x->view, &view, arguments, length);
         if (error)
         {
             return ERROR(ERROR_SLICE, string_create("failed to slice."), error);
         }
 
-        error = buffer_creation(EMPTY_OPERATION, result, view->shape, view->rank, view->strides, view->offset, 
+        error = buffer_creation(EMPTY_OPERATION, result, view.shape, view.rank, view.strides, view.offset, 
                                 x->storage->runtime, x->storage->datatype, NULL, 0, NULL);
         if (error)
         {
             return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
         }
 
-        runtime_padding(x, *result, arguments, length, 0, true, x->view->offset, (*result)->view->offset);
-
-        view_destroy(view);
+        runtime_padding(x, *result, arguments, length, 0, true, x->view.offset, (*result)->view.offset);
 
         return error;
     }
     else if (structure_operation_type == IMAGE_TO_COLUMN_OPERATION || structure_operation_type == COLUMN_TO_IMAGE_OPERATION)
     {
-        int64_t batch_size = x->view->shape[0];
+        int64_t batch_size = x->view.shape[0];
         int64_t kernel_size = arguments[0];
         int64_t stride = arguments[1];
         int64_t padding = arguments[2];
@@ -1591,13 +3217,16 @@ nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type
         int64_t *shape = (im2col) ? 
                           (int64_t[]){batch_size, channels * kernel_size * kernel_size, output_height * output_width} :
                           (int64_t[]){batch_size, channels, height, width};
-        void *value = malloc(datatype_size(datatype));
+        void *x_data = NULL;
+        void *y_data = NULL;
+        int64_t x_offset, y_offset;
+        void *value = malloc(datatype_size(datatype_compute(datatype)));
         if (!value)
         {
-            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", datatype_size(datatype)), NULL);
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", datatype_size(datatype_compute(datatype))), NULL);
         }
 
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) value = (float32_t) padding_value;
@@ -1615,20 +3244,137 @@ nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type
             free(value);
             return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
         }
-        runtime_image_to_column(datatype, x->storage->data, batch_size, channels, height, width, kernel_size, 
-                                output_height, output_width, stride, padding, (*result)->storage->data, !im2col, value);
+        error = buffer_compute_acquire(x, true, &x_data, &x_offset);
+        if (!error)
+        {
+            error = buffer_compute_acquire((*result), true, &y_data, &y_offset);
+        }
+        if (error)
+        {
+            buffer_compute_release(x, x_data, false);
+            buffer_destroy(*result);
+            *result = NULL;
+            free(value);
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        }
 
+        // The kernel indexes from the start of its arguments, so step to the first element of the views.
+        runtime_image_to_column(datatype_compute(datatype), (char *) x_data + x_offset * datatype_size(datatype_compute(datatype)), batch_size, channels, height, width, kernel_size, 
+                                output_height, output_width, stride, padding, 
+                                (char *) y_data + y_offset * datatype_size(datatype_compute(datatype)), !im2col, value);
 
+        buffer_compute_release(x, x_data, false);
+        buffer_compute_release((*result), y_data, true);
         free(value);
         return error;
     }
+    else if (structure_operation_type == SOFTMAX_OPERATION || structure_operation_type == LOGSOFTMAX_OPERATION)
+    {
+        if (length != 1 || (x->view.rank && (arguments[0] < 0 || arguments[0] >= x->view.rank)))
+        {
+            return ERROR(ERROR_AXIS, string_create("invalid softmax axis."), NULL);
+        }
+
+        error = buffer_creation(EMPTY_OPERATION, result, x->view.shape, x->view.rank, NULL, 0, x->storage->runtime, x->storage->datatype, NULL, 0, NULL);
+        if (error)
+        {
+            return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+        }
+
+        void *x_data = NULL;
+        void *y_data = NULL;
+        int64_t x_offset, y_offset;
+
+        error = buffer_compute_acquire(x, true, &x_data, &x_offset);
+        if (!error)
+        {
+            error = buffer_compute_acquire((*result), false, &y_data, &y_offset);
+        }
+        if (error)
+        {
+            buffer_compute_release(x, x_data, false);
+            buffer_destroy(*result);
+            *result = NULL;
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+        }
+
+        runtime_softmax(x->storage->runtime, datatype_compute(x->storage->datatype), x->view.rank, x->view.shape, arguments[0], 
+                        structure_operation_type == LOGSOFTMAX_OPERATION,
+                        x_data, x->view.strides, x_offset, y_data, (*result)->view.strides, y_offset);
+
+        buffer_compute_release(x, x_data, false);
+        buffer_compute_release((*result), y_data, true);
+
+        return error;
+    }
+
+    error = buffer_create(result, &view, x->storage, false);
+    if (error)
+    {
+        return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
+    }
+
+    return error;
+}
+
+nw_error_t *buffer_softmax_backward(structure_operation_type_t structure_operation_type, buffer_t *y, buffer_t *gradient, int64_t axis, buffer_t **result)
+{
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(y->storage, "y->storage");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+    CHECK_NULL_ARGUMENT(gradient->storage, "gradient->storage");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+
+    if (!view_shapes_equal(&y->view, &gradient->view))
+    {
+        return ERROR(ERROR_SHAPE, string_create("gradient shape does not match softmax output."), NULL);
+    }
+
+    if (y->view.rank && (axis < 0 || axis >= y->view.rank))
+    {
+        return ERROR(ERROR_AXIS, string_create("invalid softmax axis."), NULL);
+    }
 
-    error = buffer_create(result, view, x->storage, false);
+    error = buffer_creation(EMPTY_OPERATION, result, y->view.shape, y->view.rank, NULL, 0, y->storage->runtime, y->storage->datatype, NULL, 0, NULL);
     if (error)
     {
         return ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
     }
 
+    void *y_data = NULL;
+    void *gradient_data = NULL;
+    void *result_data = NULL;
+    int64_t y_offset, gradient_offset, result_offset;
+
+    error = buffer_compute_acquire(y, true, &y_data, &y_offset);
+    if (!error)
+    {
+        error = buffer_compute_acquire(gradient, true, &gradient_data, &gradient_offset);
+    }
+    if (!error)
+    {
+        error = buffer_compute_acquire((*result), false, &result_data, &result_offset);
+    }
+    if (error)
+    {
+        buffer_compute_release(y, y_data, false);
+        buffer_compute_release(gradient, gradient_data, false);
+        buffer_destroy(*result);
+        *result = NULL;
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+    }
+
+    runtime_softmax_backward(y->storage->runtime, datatype_compute(y->storage->datatype), y->view.rank, y->view.shape, axis, 
+                             structure_operation_type == LOGSOFTMAX_OPERATION,
+                             y_data, y->view.strides, y_offset, gradient_data, gradient->view.strides, gradient_offset,
+                             result_data, (*result)->view.strides, result_offset);
+
+    buffer_compute_release(y, y_data, false);
+    buffer_compute_release(gradient, gradient_data, false);
+    buffer_compute_release((*result), result_data, true);
+
     return error;
 }
 
@@ -1639,7 +3385,7 @@ static nw_error_t *buffer_create_empty(buffer_t **buffer, const int64_t *shape,
     CHECK_NULL_ARGUMENT(shape, "shape");
 
     nw_error_t *error = NULL;
-    view_t *view = NULL;
+    view_t view;
     storage_t *storage = NULL;
     int64_t n = 0;
 
@@ -1650,7 +3396,7 @@ static nw_error_t *buffer_create_empty(buffer_t **buffer, const int64_t *shape,
         goto cleanup;
     }
 
-    error = view_physical_size(view, &n);
+    error = view_physical_size(&view, &n);
     if (error)
     {
         error = ERROR(ERROR_N, string_create("failed to obtain storage size."), error);
@@ -1664,7 +3410,7 @@ static nw_error_t *buffer_create_empty(buffer_t **buffer, const int64_t *shape,
         goto cleanup;
     }
 
-    error = buffer_create(buffer, view, storage, false);
+    error = buffer_create(buffer, &view, storage, false);
     if (error)
     {
         error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
@@ -1674,8 +3420,6 @@ static nw_error_t *buffer_create_empty(buffer_t **buffer, const int64_t *shape,
     return error;
 
 cleanup:
-
-    view_destroy(view);
     storage_destroy(storage);
 
     return error;
@@ -1688,7 +3432,7 @@ static nw_error_t *buffer_create_nonempty(buffer_t **buffer, const int64_t *shap
     CHECK_NULL_ARGUMENT(shape, "shape");
 
     nw_error_t *error = NULL;
-    view_t *view = NULL;
+    view_t view;
     storage_t *storage = NULL;
     int64_t n = 0;
 
@@ -1699,7 +3443,7 @@ static nw_error_t *buffer_create_nonempty(buffer_t **buffer, const int64_t *shap
         goto cleanup;
     }
 
-    error = view_physical_size(view, &n);
+    error = view_physical_size(&view, &n);
     if (error)
     {
         error = ERROR(ERROR_N, string_create("failed to obtain storage size."), error);
@@ -1713,7 +3457,7 @@ static nw_error_t *buffer_create_nonempty(buffer_t **buffer, const int64_t *shap
         goto cleanup;
     }
 
-    error = buffer_create(buffer, view, storage, false);
+    error = buffer_create(buffer, &view, storage, false);
     if (error)
     {
         error = ERROR(ERROR_CREATE, string_create("failed to create buffer."), error);
@@ -1723,8 +3467,6 @@ static nw_error_t *buffer_create_nonempty(buffer_t **buffer, const int64_t *shap
     return error;
 
 cleanup:
-
-    view_destroy(view);
     storage_destroy(storage);
 
     return error;
@@ -1741,6 +3483,7 @@ static nw_error_t *buffer_create_init(buffer_t **buffer, creation_operation_type
     }
 
     nw_error_t *error = NULL;
+    void *data = NULL;
     *buffer = NULL;
 
     error = buffer_create_empty(buffer, shape, rank, strides, offset, runtime, datatype);
@@ -1750,20 +3493,31 @@ static nw_error_t *buffer_create_init(buffer_t **buffer, creation_operation_type
         goto cleanup;
     }
 
+    // Reduced precision buffers are initialized in float32 and rounded, scalar arguments are float32.
+    if (creation_operation_type != EMPTY_OPERATION)
+    {
+        error = storage_compute_acquire((*buffer)->storage, 0, (*buffer)->storage->n, false, &data);
+        if (error)
+        {
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to acquire compute data."), error);
+            goto cleanup;
+        }
+    }
+
     switch (creation_operation_type)
     {
     case EMPTY_OPERATION:
         break;
     case ZEROES_OPERATION:
-        runtime_zeroes((*buffer)->storage->data, (*buffer)->storage->n, (*buffer)->storage->datatype);
+        runtime_zeroes(data, (*buffer)->storage->n, datatype_compute(datatype));
         break;
     case ONES_OPERATION:
-        runtime_ones((*buffer)->storage->data, (*buffer)->storage->n, (*buffer)->storage->datatype);
+        runtime_ones(data, (*buffer)->storage->n, datatype_compute(datatype));
         break;
     case UNIFORM_OPERATION:
         if (length == 2)
         {
-            runtime_uniform((*buffer)->storage->data, (*buffer)->storage->n, (*buffer)->storage->datatype, arguments[0], arguments[1]);
+            runtime_uniform(data, (*buffer)->storage->n, datatype_compute(datatype), arguments[0], arguments[1]);
         }
         else
         {
@@ -1773,7 +3527,7 @@ static nw_error_t *buffer_create_init(buffer_t **buffer, creation_operation_type
     case NORMAL_OPERATION:
         if (length == 2)
         {
-            runtime_normal((*buffer)->storage->data, (*buffer)->storage->n, (*buffer)->storage->datatype, arguments[0], arguments[1]);
+            runtime_normal(data, (*buffer)->storage->n, datatype_compute(datatype), arguments[0], arguments[1]);
         }
         else
         {
@@ -1783,7 +3537,7 @@ static nw_error_t *buffer_create_init(buffer_t **buffer, creation_operation_type
     case ARANGE_OPERATION:
         if (length == 3)
         {
-            runtime_arange((*buffer)->storage->data, (*buffer)->storage->datatype, arguments[0], arguments[1], arguments[2]);
+            runtime_arange(data, datatype_compute(datatype), arguments[0], arguments[1], arguments[2]);
         }
         else
         {
@@ -1795,6 +3549,8 @@ static nw_error_t *buffer_create_init(buffer_t **buffer, creation_operation_type
         break;
     }
 
+    storage_compute_release((*buffer)->storage, 0, (*buffer)->storage->n, data, !error);
+
     if (error)
     {
         error = ERROR(ERROR_INITIALIZATION, string_create("failed to initialize buffer."), error);
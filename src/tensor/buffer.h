@@ -8,8 +8,7 @@
 
 #include <errors.h>
 #include <runtime.h>
-
-typedef struct view_t view_t;
+#include <view.h>
 
 typedef struct storage_t
 {
@@ -18,25 +17,66 @@ typedef struct storage_t
     datatype_t datatype;
     int64_t n;
     void *data;
+    bool_t allocated;
+    uint64_t version;
 } storage_t;
 
 typedef struct buffer_t
 {
-    view_t *view;
+    view_t view;
     storage_t *storage;
 } buffer_t;
 
-nw_error_t *buffer_create(buffer_t **buffer, view_t *view, storage_t *storage, bool_t copy);
+typedef struct quantization_t
+{
+    int64_t channels;
+    int64_t features;
+    int8_t *data;
+    float32_t *scales;
+    int32_t *sums;
+} quantization_t;
+
+nw_error_t *buffer_create(buffer_t **buffer, const view_t *view, storage_t *storage, bool_t copy);
 void buffer_destroy(buffer_t *buffer);
+nw_error_t *buffer_persist(buffer_t *buffer);
+nw_error_t *buffer_zero(buffer_t *buffer);
 nw_error_t *storage_create(storage_t **storage, runtime_t runtime, datatype_t datatype, int64_t n, void *data, bool_t copy);
 void storage_destroy(storage_t *storage);
 nw_error_t *buffer_save(buffer_t *buffer, FILE *file);
 nw_error_t *buffer_load(buffer_t **buffer, FILE *file);
 nw_error_t *buffer_unary(unary_operation_type_t unary_operation_type, buffer_t *x_buffer, buffer_t **y_buffer);
+nw_error_t *buffer_unary_gradient(unary_operation_type_t unary_operation_type, buffer_t *x_buffer, buffer_t *gradient_buffer, buffer_t **result);
 nw_error_t *buffer_binary(binary_operation_type_t operation_type, buffer_t *x_buffer, buffer_t *y_buffer, buffer_t **z_buffer);
+nw_error_t *buffer_binary_inplace(binary_operation_type_t operation_type, buffer_t *x_buffer, buffer_t *y_buffer);
+nw_error_t *buffer_scaled_addition(buffer_t *x_buffer, buffer_t *y_buffer, void *alpha);
+nw_error_t *buffer_convolution_2d(buffer_t *x_buffer, buffer_t *w_buffer, int64_t stride, int64_t padding, buffer_t **y_buffer);
+nw_error_t *buffer_convolution_2d_backward(buffer_t *x_buffer, buffer_t *w_buffer, buffer_t *gradient_buffer, int64_t stride, int64_t padding,
+                                           buffer_t **x_gradient_buffer, buffer_t **w_gradient_buffer);
+nw_error_t *buffer_pooling_2d(structure_operation_type_t structure_operation_type, buffer_t *x_buffer, int64_t kernel_size, int64_t stride, int64_t padding,
+                              buffer_t **y_buffer, int32_t **indices);
+nw_error_t *buffer_pooling_2d_backward(structure_operation_type_t structure_operation_type, buffer_t *x_buffer, buffer_t *gradient_buffer,
+                                       int64_t kernel_size, int64_t stride, int64_t padding, const int32_t *indices, buffer_t **result);
+nw_error_t *buffer_dropout(buffer_t *x_buffer, uint64_t seed, uint64_t offset, uint32_t threshold, buffer_t **y_buffer);
+nw_error_t *buffer_cast(buffer_t *x_buffer, datatype_t datatype, buffer_t **y_buffer);
+nw_error_t *buffer_embedding(buffer_t *w_buffer, buffer_t *x_buffer, buffer_t **y_buffer);
+nw_error_t *buffer_embedding_backward(buffer_t *w_buffer, buffer_t *x_buffer, buffer_t *gradient_buffer, buffer_t **result, buffer_t **rows);
+nw_error_t *buffer_sparse_accumulate(buffer_t *x_rows, buffer_t *x_buffer, buffer_t *y_rows, buffer_t *y_buffer, buffer_t **z_rows, buffer_t **z_buffer);
+nw_error_t *buffer_sparse_to_dense(buffer_t *rows, buffer_t *x_buffer, int64_t size, buffer_t **y_buffer);
+nw_error_t *buffer_sparse_stochastic_gradient_descent(buffer_t *w_buffer, buffer_t *rows, buffer_t *g_buffer, buffer_t *m_buffer,
+                                                      float64_t learning_rate, float64_t momentum, float64_t dampening, float64_t weight_decay,
+                                                      bool_t nesterov, bool_t initialize);
+nw_error_t *buffer_sparse_adam(buffer_t *w_buffer, buffer_t *rows, buffer_t *g_buffer, buffer_t *m_buffer, buffer_t *v_buffer, buffer_t *steps, int64_t step,
+                               float64_t learning_rate, float64_t beta_1, float64_t beta_2, float64_t weight_decay, float64_t epsilon);
+nw_error_t *buffer_quantize(buffer_t *buffer, bool_t channels_last, quantization_t **quantization);
+void quantization_destroy(quantization_t *quantization);
+nw_error_t *buffer_quantized_linear(buffer_t *x_buffer, const quantization_t *quantization, buffer_t *b_buffer, buffer_t **y_buffer);
+nw_error_t *buffer_quantized_convolution_2d(buffer_t *x_buffer, const quantization_t *quantization, buffer_t *b_buffer,
+                                            int64_t kernel_size, int64_t stride, int64_t padding, buffer_t **y_buffer);
 nw_error_t *buffer_ternary(ternary_operation_type_t operation_type, buffer_t *w_buffer, buffer_t *x_buffer, buffer_t *y_buffer, buffer_t **z_buffer);
 nw_error_t *buffer_reduction(reduction_operation_type_t reduction_operation_type, buffer_t *x, int64_t *axis, int64_t length, buffer_t **result, bool_t keep_dimension);
+nw_error_t *buffer_argument_maximum(buffer_t *x, int64_t axis, buffer_t **result, bool_t keep_dimension);
 nw_error_t *buffer_structure(structure_operation_type_t structure_operation_type, buffer_t *x, int64_t *arguments, int64_t length, buffer_t **result);
+nw_error_t *buffer_softmax_backward(structure_operation_type_t structure_operation_type, buffer_t *y, buffer_t *gradient, int64_t axis, buffer_t **result);
 nw_error_t *buffer_creation(creation_operation_type_t creation_operation_type, buffer_t **buffer, const int64_t *shape, int64_t rank, const int64_t *strides,
                             int64_t offset, const runtime_t runtime, datatype_t datatype, void **arguments, int64_t length, void *data);
 #endif
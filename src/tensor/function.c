@@ -7,6 +7,7 @@
 #include <tensor.h>
 #include <view.h>
 #include <buffer.h>
+#include <slab.h>
 #include <string.h>
 #include <sort.h>
 #include <graph.h>
@@ -325,7 +326,7 @@ static nw_error_t *square_root_operation_backward(tensor_t *x, tensor_t *result,
     tensor_t *x_gradient_j = NULL;
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
 
     if (x->requires_gradient)
     {
@@ -336,7 +337,7 @@ static nw_error_t *square_root_operation_backward(tensor_t *x, tensor_t *result,
             goto cleanup;
         }
 
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) value = (float32_t) 2.0;
@@ -567,7 +568,6 @@ static nw_error_t *rectified_linear_operation_backward(tensor_t *x, tensor_t *gr
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
 
     nw_error_t *error = NULL;
@@ -578,9 +578,9 @@ static nw_error_t *rectified_linear_operation_backward(tensor_t *x, tensor_t *gr
     tensor_t *x_gradient_k = NULL;
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
-    int64_t *shape = x->buffer->view->shape;
-    int64_t rank = x->buffer->view->rank;
-    size_t size = datatype_size(datatype);
+    int64_t *shape = x->buffer->view.shape;
+    int64_t rank = x->buffer->view.rank;
+    size_t size = datatype_size(datatype_compute(datatype));
 
     if (x->requires_gradient)
     {
@@ -591,7 +591,7 @@ static nw_error_t *rectified_linear_operation_backward(tensor_t *x, tensor_t *gr
             goto cleanup;
         }
 
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) value = (float32_t) 0.0;
@@ -683,7 +683,7 @@ static nw_error_t *sigmoid_operation_backward(tensor_t *x, tensor_t *result, ten
     tensor_t *x_gradient_k = NULL;
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
 
     if (x->requires_gradient)
     {
@@ -694,7 +694,7 @@ static nw_error_t *sigmoid_operation_backward(tensor_t *x, tensor_t *result, ten
             goto cleanup;
         }
 
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) value = (float32_t) 1.0;
@@ -754,6 +754,126 @@ cleanup:
     return error;
 }
 
+static nw_error_t *tanh_operation_forward(tensor_t *x, tensor_t *result)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+
+    error = buffer_unary(TANH_OPERATION, x->buffer, &result->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_TANH, string_create("failed to run tanh operation."), error);
+    }
+    
+    return error;
+}
+
+static nw_error_t *tanh_operation_backward(tensor_t *x, tensor_t *result, tensor_t *gradient)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(result, "result");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_gradient_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+
+    if (x->requires_gradient)
+    {
+        // The derivative is evaluated from the saved output in the same kernel that applies the chain rule.
+        error = buffer_unary_gradient(TANH_OPERATION, result->buffer, gradient->buffer, &x_gradient_buffer);
+        if (error)
+        {
+            error = ERROR(ERROR_TANH, string_create("failed to compute tanh gradient."), error);
+            goto cleanup;
+        }
+
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(x, x_gradient);
+        if (error) 
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    tensor_destroy(x_gradient);
+
+    return error;
+}
+
+static nw_error_t *gelu_operation_forward(tensor_t *x, tensor_t *result)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+
+    error = buffer_unary(GELU_OPERATION, x->buffer, &result->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_GELU, string_create("failed to run gelu operation."), error);
+    }
+    
+    return error;
+}
+
+static nw_error_t *gelu_operation_backward(tensor_t *x, tensor_t *result, tensor_t *gradient)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(result, "result");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    nw_error_t *error = NULL;
+    buffer_t *x_gradient_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+
+    if (x->requires_gradient)
+    {
+        // The derivative is evaluated from the saved input in the same kernel that applies the chain rule.
+        error = buffer_unary_gradient(GELU_OPERATION, x->buffer, gradient->buffer, &x_gradient_buffer);
+        if (error)
+        {
+            error = ERROR(ERROR_GELU, string_create("failed to compute gelu gradient."), error);
+            goto cleanup;
+        }
+
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(x, x_gradient);
+        if (error) 
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    tensor_destroy(x_gradient);
+
+    return error;
+}
+
 static nw_error_t *as_operation_forward(tensor_t *x, tensor_t *result)
 {
     CHECK_NULL_ARGUMENT(x, "x");
@@ -809,6 +929,12 @@ static nw_error_t *unary_operation_forward(unary_operation_t *unary_operation, t
     case SIGMOID_OPERATION:
         error = sigmoid_operation_forward(unary_operation->x, result);
         break;
+    case TANH_OPERATION:
+        error = tanh_operation_forward(unary_operation->x, result);
+        break;
+    case GELU_OPERATION:
+        error = gelu_operation_forward(unary_operation->x, result);
+        break;
     case AS_OPERATION:
         error = as_operation_forward(unary_operation->x, result);
         break;
@@ -866,6 +992,12 @@ static nw_error_t *unary_operation_backward(unary_operation_t *unary_operation,
     case SIGMOID_OPERATION:
         error = sigmoid_operation_backward(unary_operation->x, result, gradient);
         break;
+    case TANH_OPERATION:
+        error = tanh_operation_backward(unary_operation->x, result, gradient);
+        break;
+    case GELU_OPERATION:
+        error = gelu_operation_backward(unary_operation->x, result, gradient);
+        break;
     case AS_OPERATION:
         break;
     default:
@@ -1290,10 +1422,7 @@ static nw_error_t *matrix_multiplication_operation_backward(tensor_t *x, tensor_
     CHECK_NULL_ARGUMENT(y, "y");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(y->buffer, "y->buffer");
-    CHECK_NULL_ARGUMENT(y->buffer->view, "y->buffer->view");
-
     nw_error_t *error = NULL;
     tensor_t *x_gradient = NULL;
     tensor_t *x_gradient_i = NULL;
@@ -1302,7 +1431,7 @@ static nw_error_t *matrix_multiplication_operation_backward(tensor_t *x, tensor_
 
     if (x->requires_gradient)
     {
-        int64_t rank = y->buffer->view->rank;
+        int64_t rank = y->buffer->view.rank;
 
         error = tensor_transpose(y, &x_gradient_i, rank - 2, rank - 1);
         if (error)
@@ -1328,7 +1457,7 @@ static nw_error_t *matrix_multiplication_operation_backward(tensor_t *x, tensor_
 
     if (y->requires_gradient)
     {
-        int64_t rank = x->buffer->view->rank;
+        int64_t rank = x->buffer->view.rank;
 
         error = tensor_transpose(x, &y_gradient_i, rank - 2, rank - 1);
         if (error)
@@ -1362,6 +1491,184 @@ cleanup:
     return error;
 }
 
+static nw_error_t *convolution_2d_operation_forward(tensor_t *x, tensor_t *y, int64_t *arguments, int64_t length, tensor_t *result)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(arguments, "arguments");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    if (length != 2)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("convolution expects a stride and padding."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+
+    error = buffer_convolution_2d(x->buffer, y->buffer, arguments[0], arguments[1], &result->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_CONVOLUTION, string_create("failed to run convolution operation."), error);
+    }
+
+    return error;
+}
+
+static nw_error_t *convolution_2d_operation_backward(tensor_t *x, tensor_t *y, int64_t *arguments, int64_t length, tensor_t *gradient)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(arguments, "arguments");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    if (length != 2)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("convolution expects a stride and padding."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *x_gradient_buffer = NULL;
+    buffer_t *y_gradient_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+    tensor_t *y_gradient = NULL;
+
+    error = buffer_convolution_2d_backward(x->buffer, y->buffer, gradient->buffer, arguments[0], arguments[1],
+                                           (x->requires_gradient) ? &x_gradient_buffer : NULL,
+                                           (y->requires_gradient) ? &y_gradient_buffer : NULL);
+    if (error)
+    {
+        error = ERROR(ERROR_CONVOLUTION, string_create("failed to compute convolution gradients."), error);
+        goto cleanup;
+    }
+
+    if (x->requires_gradient)
+    {
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(x, x_gradient);
+        if (error) 
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+    if (y->requires_gradient)
+    {
+        error = tensor_create(&y_gradient, y_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        y_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(y, y_gradient);
+        if (error) 
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    buffer_destroy(y_gradient_buffer);
+    tensor_destroy(x_gradient);
+    tensor_destroy(y_gradient);
+
+    return error;
+}
+
+static nw_error_t *embedding_operation_forward(tensor_t *x, tensor_t *y, tensor_t *result)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+
+    error = buffer_embedding(x->buffer, y->buffer, &result->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_EMBEDDING, string_create("failed to run embedding operation."), error);
+    }
+
+    return error;
+}
+
+static nw_error_t *embedding_operation_backward(tensor_t *x, tensor_t *y, int64_t *arguments, int64_t length, tensor_t *gradient)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    nw_error_t *error = NULL;
+    bool_t sparse = length > 0 && arguments[0];
+    buffer_t *x_gradient_buffer = NULL;
+    buffer_t *x_rows_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+    tensor_t *x_rows = NULL;
+
+    // Indices are not differentiable, only the weights receive a gradient.
+    if (x->requires_gradient)
+    {
+        error = buffer_embedding_backward(x->buffer, y->buffer, gradient->buffer, &x_gradient_buffer, (sparse) ? &x_rows_buffer : NULL);
+        if (error)
+        {
+            error = ERROR(ERROR_EMBEDDING, string_create("failed to compute embedding gradient."), error);
+            goto cleanup;
+        }
+
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        if (sparse)
+        {
+            error = tensor_create(&x_rows, x_rows_buffer, NULL, NULL, false, false);
+            if (error)
+            {
+                error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+                goto cleanup;
+            }
+            x_rows_buffer = NULL;
+
+            error = tensor_accumulate_sparse_gradient(x, x_rows, x_gradient);
+        }
+        else
+        {
+            error = tensor_accumulate_gradient(x, x_gradient);
+        }
+
+        if (error) 
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    buffer_destroy(x_rows_buffer);
+    tensor_destroy(x_gradient);
+    tensor_destroy(x_rows);
+
+    return error;
+}
+
 static nw_error_t *compare_equal_operation_forward(const tensor_t *x, const tensor_t *y, tensor_t *result)
 {
     CHECK_NULL_ARGUMENT(x, "x");
@@ -1429,6 +1736,12 @@ static nw_error_t *binary_operation_forward(binary_operation_t *binary_operation
     case COMPARE_GREATER_OPERATION:
         error = compare_greater_operation_forward(binary_operation->x, binary_operation->y, result);
         break;
+    case CONVOLUTION_2D_OPERATION:
+        error = convolution_2d_operation_forward(binary_operation->x, binary_operation->y, binary_operation->arguments, binary_operation->length, result);
+        break;
+    case EMBEDDING_OPERATION:
+        error = embedding_operation_forward(binary_operation->x, binary_operation->y, result);
+        break;
     default:
         error = ERROR(ERROR_OPERATION_TYPE, string_create("unsupported binary operation type %d.", (int) binary_operation->operation_type), NULL);
         break;
@@ -1472,6 +1785,12 @@ static nw_error_t *binary_operation_backward(binary_operation_t *binary_operatio
     case MATRIX_MULTIPLICATION_OPERATION:
         error = matrix_multiplication_operation_backward(binary_operation->x, binary_operation->y, gradient);
         break;
+    case CONVOLUTION_2D_OPERATION:
+        error = convolution_2d_operation_backward(binary_operation->x, binary_operation->y, binary_operation->arguments, binary_operation->length, gradient);
+        break;
+    case EMBEDDING_OPERATION:
+        error = embedding_operation_backward(binary_operation->x, binary_operation->y, binary_operation->arguments, binary_operation->length, gradient);
+        break;
     case COMPARE_EQUAL_OPERATION:
     case COMPARE_GREATER_OPERATION:
         break;
@@ -1512,10 +1831,7 @@ static nw_error_t *where_operation_backward(tensor_t *w, tensor_t *x, tensor_t *
     CHECK_NULL_ARGUMENT(y, "y");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(y->buffer, "y->buffer");
-    CHECK_NULL_ARGUMENT(y->buffer->view, "y->buffer->view");
-
     nw_error_t *error = NULL;
     tensor_t *x_gradient = NULL;
     tensor_t *y_gradient = NULL;
@@ -1652,20 +1968,20 @@ static nw_error_t *summation_operation_backward(tensor_t *x, int64_t *axis, int6
     nw_error_t *error = NULL;
     tensor_t *x_gradient = NULL;
     tensor_t *x_gradient_i = NULL;
-    view_t *view = NULL;
+    view_t view;
 
     if (x->requires_gradient)
     {
         if (!keep_dimension)
         {
-            error = view_recover_dimensions(gradient->buffer->view, &view, axis, length);
+            error = view_recover_dimensions(&gradient->buffer->view, &view, axis, length);
             if (error)
             {
                 error = ERROR(ERROR_REDUCTION, string_create("failed to recover reduce dimensions."), error);
                 goto cleanup;
             }
 
-            error = tensor_reshape(gradient, &x_gradient_i, view->shape, view->rank);
+            error = tensor_reshape(gradient, &x_gradient_i, view.shape, view.rank);
             if (error)
             {
                 error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
@@ -1677,7 +1993,7 @@ static nw_error_t *summation_operation_backward(tensor_t *x, int64_t *axis, int6
             x_gradient_i = gradient;
         }
 
-        error = tensor_expand(x_gradient_i, x->buffer->view->shape, x->buffer->view->rank, &x_gradient);
+        error = tensor_expand(x_gradient_i, x->buffer->view.shape, x->buffer->view.rank, &x_gradient);
         if (error)
         {
             error = ERROR(ERROR_EXPAND, string_create("failed to expand gradient."), error);
@@ -1704,8 +2020,6 @@ cleanup:
         tensor_destroy(x_gradient_i);
     }
 
-    view_destroy(view);
-
     return error; 
 }
 
@@ -1742,36 +2056,36 @@ static nw_error_t *maximum_operation_backward(tensor_t *x, int64_t *axis, int64_
     tensor_t *x_gradient_n = NULL;
     tensor_t *x_gradient_o = NULL;
     tensor_t *x_gradient_p = NULL;
-    view_t *result_view = NULL;
-    view_t *gradient_view = NULL;
+    view_t result_view;
+    view_t gradient_view;
 
     if (x->requires_gradient)
     {
         if (!keep_dimension)
         {
 
-            error = view_recover_dimensions(result->buffer->view, &result_view,  axis, length);
+            error = view_recover_dimensions(&result->buffer->view, &result_view,  axis, length);
             if (error)
             {
                 error = ERROR(ERROR_REDUCTION, string_create("failed to recover from reduce dimensions."), error);
                 goto cleanup;
             }
 
-            error = view_recover_dimensions(gradient->buffer->view, &gradient_view, axis, length);
+            error = view_recover_dimensions(&gradient->buffer->view, &gradient_view, axis, length);
             if (error)
             {
                 error = ERROR(ERROR_REDUCTION, string_create("failed to recover from reduce dimensions."), error);
                 goto cleanup;
             }
 
-            error = tensor_reshape(result, &x_gradient_k, result_view->shape, result_view->rank);
+            error = tensor_reshape(result, &x_gradient_k, result_view.shape, result_view.rank);
             if (error)
             {
                 error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
                 goto cleanup;
             }
             
-            error = tensor_reshape(gradient, &x_gradient_l, gradient_view->shape, gradient_view->rank);
+            error = tensor_reshape(gradient, &x_gradient_l, gradient_view.shape, gradient_view.rank);
             if (error)
             {
                 error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
@@ -1784,7 +2098,7 @@ static nw_error_t *maximum_operation_backward(tensor_t *x, int64_t *axis, int64_
             x_gradient_l = gradient;
         }
 
-        error = tensor_expand(x_gradient_k, x->buffer->view->shape, x->buffer->view->rank, &x_gradient_m);
+        error = tensor_expand(x_gradient_k, x->buffer->view.shape, x->buffer->view.rank, &x_gradient_m);
         if (error)
         {
             error = ERROR(ERROR_EXPAND, string_create("failed to expand tensor."), error);
@@ -1848,8 +2162,6 @@ cleanup:
     tensor_destroy(x_gradient_o);    
     tensor_destroy(x_gradient_p);    
     tensor_destroy(x_gradient);    
-    view_destroy(result_view);
-    view_destroy(gradient_view);
 
     return error; 
 }
@@ -1944,7 +2256,7 @@ static nw_error_t *expand_operation_backward(tensor_t *x, int64_t *shape, int64_
 
     if (x->requires_gradient)
     {
-        error = view_reduce_axis(x->buffer->view, shape, length, &axis_keep_dimension, &length_keep_dimension, &axis_remove_dimension, &length_remove_dimension);
+        error = view_reduce_axis(&x->buffer->view, shape, length, &axis_keep_dimension, &length_keep_dimension, &axis_remove_dimension, &length_remove_dimension);
         if (error)
         {
             error = ERROR(ERROR_REDUCTION, string_create("failed to get reduction axes."), error);
@@ -2087,7 +2399,6 @@ static nw_error_t *reshape_operation_backward(tensor_t *x, tensor_t *gradient)
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
 
     nw_error_t *error = NULL;
@@ -2095,7 +2406,7 @@ static nw_error_t *reshape_operation_backward(tensor_t *x, tensor_t *gradient)
 
     if (x->requires_gradient)
     {
-        error = tensor_reshape(gradient, &x_gradient, x->buffer->view->shape, x->buffer->view->rank);        
+        error = tensor_reshape(gradient, &x_gradient, x->buffer->view.shape, x->buffer->view.rank);        
         if (error)
         {
             error = ERROR(ERROR_RESHAPE, string_create("failed to reshape gradient."), error);
@@ -2150,7 +2461,7 @@ static nw_error_t *slice_operation_backward(tensor_t *x, int64_t *arguments, int
 
     if (x->requires_gradient)
     {
-        error = view_slice_padding_arguments(x->buffer->view, arguments, length, &padding_arguments);
+        error = view_slice_padding_arguments(&x->buffer->view, arguments, length, &padding_arguments);
         if (error)
         {
             error = ERROR(ERROR_PADDING, string_create("failed to acquire padding arguments."), error);
@@ -2214,7 +2525,7 @@ static nw_error_t *padding_operation_backward(tensor_t *x, int64_t *arguments, i
 
     if (x->requires_gradient)
     {
-        error = view_padding_slice_arguments(x->buffer->view, arguments, length, &slice_arguments);
+        error = view_padding_slice_arguments(&x->buffer->view, arguments, length, &slice_arguments);
         if (error)
         {
             error = ERROR(ERROR_SLICE, string_create("failed to acquire slice arguments."), error);
@@ -2269,7 +2580,6 @@ static nw_error_t *image_to_column_operation_backward(tensor_t *x, int64_t *argu
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
     CHECK_NULL_ARGUMENT(arguments, "arguments");
     if (length != 7)
@@ -2328,7 +2638,6 @@ static nw_error_t *column_to_image_operation_backward(tensor_t *x, int64_t *argu
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
     CHECK_NULL_ARGUMENT(arguments, "arguments");
     if (length != 7)
@@ -2366,6 +2675,225 @@ cleanup:
     return error;
 }
 
+static nw_error_t *softmax_operation_forward(tensor_t *x, int64_t *arguments, int64_t length, tensor_t *result, bool_t logarithm)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(arguments, "arguments");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    nw_error_t *error = NULL;
+
+    error = buffer_structure((logarithm) ? LOGSOFTMAX_OPERATION : SOFTMAX_OPERATION, x->buffer, arguments, length, &result->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_SOFTMAX, string_create("failed to apply softmax."), error);
+    }
+
+    return error;
+}
+
+static nw_error_t *softmax_operation_backward(tensor_t *x, int64_t *arguments, int64_t length, tensor_t *result, tensor_t *gradient, bool_t logarithm)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(arguments, "arguments");
+    CHECK_NULL_ARGUMENT(result, "result");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+    if (length != 1)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("invalid number of arguments."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *x_gradient_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+
+    if (x->requires_gradient)
+    {
+        // Only the saved output is needed, the gradient is computed row by row in a single kernel.
+        error = buffer_softmax_backward((logarithm) ? LOGSOFTMAX_OPERATION : SOFTMAX_OPERATION, result->buffer, gradient->buffer, arguments[0], &x_gradient_buffer);
+        if (error)
+        {
+            error = ERROR(ERROR_SOFTMAX, string_create("failed to compute softmax gradient."), error);
+            goto cleanup;
+        }
+
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(x, x_gradient);
+        if (error)
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    tensor_destroy(x_gradient);
+
+    return error;
+}
+
+static nw_error_t *pooling_operation_forward(structure_operation_t *structure_operation, tensor_t *result)
+{
+    CHECK_NULL_ARGUMENT(structure_operation, "structure_operation");
+    CHECK_NULL_ARGUMENT(structure_operation->x, "structure_operation->x");
+    CHECK_NULL_ARGUMENT(structure_operation->arguments, "structure_operation->arguments");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    if (structure_operation->length != 3)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("pooling expects a kernel size, stride and padding."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    tensor_t *x = structure_operation->x;
+    int64_t *arguments = structure_operation->arguments;
+
+    // Argmax indices are only kept when the backward pass will scatter through them.
+    free(structure_operation->indices);
+    structure_operation->indices = NULL;
+
+    error = buffer_pooling_2d(structure_operation->operation_type, x->buffer, arguments[0], arguments[1], arguments[2], &result->buffer,
+                              (x->requires_gradient && !no_gradient) ? &structure_operation->indices : NULL);
+    if (error)
+    {
+        return ERROR(ERROR_POOLING, string_create("failed to pool tensor."), error);
+    }
+
+    return error;
+}
+
+static nw_error_t *pooling_operation_backward(structure_operation_t *structure_operation, tensor_t *gradient)
+{
+    CHECK_NULL_ARGUMENT(structure_operation, "structure_operation");
+    CHECK_NULL_ARGUMENT(structure_operation->x, "structure_operation->x");
+    CHECK_NULL_ARGUMENT(structure_operation->arguments, "structure_operation->arguments");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    if (structure_operation->length != 3)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("pooling expects a kernel size, stride and padding."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    tensor_t *x = structure_operation->x;
+    int64_t *arguments = structure_operation->arguments;
+    buffer_t *x_gradient_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+
+    if (x->requires_gradient)
+    {
+        error = buffer_pooling_2d_backward(structure_operation->operation_type, x->buffer, gradient->buffer, arguments[0], arguments[1], arguments[2],
+                                           structure_operation->indices, &x_gradient_buffer);
+        if (error)
+        {
+            error = ERROR(ERROR_POOLING, string_create("failed to compute pooling gradient."), error);
+            goto cleanup;
+        }
+
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(x, x_gradient);
+        if (error)
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    tensor_destroy(x_gradient);
+
+    return error;
+}
+
+static nw_error_t *dropout_operation_forward(tensor_t *x, int64_t *arguments, int64_t length, tensor_t *result)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(arguments, "arguments");
+    CHECK_NULL_ARGUMENT(result, "result");
+
+    if (length != 3)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("dropout expects a seed, offset and threshold."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+
+    error = buffer_dropout(x->buffer, (uint64_t) arguments[0], (uint64_t) arguments[1], (uint32_t) arguments[2], &result->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_DROPOUT, string_create("failed to apply dropout."), error);
+    }
+
+    return error;
+}
+
+static nw_error_t *dropout_operation_backward(tensor_t *x, int64_t *arguments, int64_t length, tensor_t *gradient)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(arguments, "arguments");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    if (length != 3)
+    {
+        return ERROR(ERROR_ARGUMENTS, string_create("dropout expects a seed, offset and threshold."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    buffer_t *x_gradient_buffer = NULL;
+    tensor_t *x_gradient = NULL;
+
+    if (x->requires_gradient)
+    {
+        // Regenerate the forward mask from the same counters rather than storing it.
+        error = buffer_dropout(gradient->buffer, (uint64_t) arguments[0], (uint64_t) arguments[1], (uint32_t) arguments[2], &x_gradient_buffer);
+        if (error)
+        {
+            error = ERROR(ERROR_DROPOUT, string_create("failed to compute dropout gradient."), error);
+            goto cleanup;
+        }
+
+        error = tensor_create(&x_gradient, x_gradient_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+            goto cleanup;
+        }
+        x_gradient_buffer = NULL;
+
+        error = tensor_accumulate_gradient(x, x_gradient);
+        if (error)
+        {
+            error = ERROR(ERROR_ADDITION, string_create("failed to accumulate gradient."), error);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+
+    buffer_destroy(x_gradient_buffer);
+    tensor_destroy(x_gradient);
+
+    return error;
+}
+
 /**
  * @brief Apply structure operation forward.
  * @param structure_operation Structure operation to execute.
@@ -2403,6 +2931,18 @@ static nw_error_t *structure_operation_forward(structure_operation_t *structure_
     case COLUMN_TO_IMAGE_OPERATION:
         error = column_to_image_operation_forward(structure_operation->x, structure_operation->arguments, structure_operation->length, result);
         break;
+    case SOFTMAX_OPERATION:
+    case LOGSOFTMAX_OPERATION:
+        error = softmax_operation_forward(structure_operation->x, structure_operation->arguments, structure_operation->length, result,
+                                          structure_operation->operation_type == LOGSOFTMAX_OPERATION);
+        break;
+    case MAX_POOL_2D_OPERATION:
+    case AVERAGE_POOL_2D_OPERATION:
+        error = pooling_operation_forward(structure_operation, result);
+        break;
+    case DROPOUT_OPERATION:
+        error = dropout_operation_forward(structure_operation->x, structure_operation->arguments, structure_operation->length, result);
+        break;
     default:
         error = ERROR(ERROR_OPERATION_TYPE, string_create("unknown operation type %d.", (int) structure_operation->operation_type), NULL);
         break;
@@ -2421,6 +2961,7 @@ static nw_error_t *structure_operation_forward(structure_operation_t *structure_
 /**
  * @brief Apply structure operation backward.
  * @param structure_operation Structure operation being differeniated.
+ * @param result Output of the structure operation.
  * @param gradient Incoming gradient of the result of the structure operation.
  * @return Error if `structure_operation` or `gradient` is NULL.
  *         Error if the gradient of the structure operation with respect to the operand failed to compute.
@@ -2428,7 +2969,7 @@ static nw_error_t *structure_operation_forward(structure_operation_t *structure_
  *         NULL if `structure_operation` successfully executed.
  *         NULL if the gradient of the structure operation with respect to the operand was successfully computed.
  */
-static nw_error_t *structure_operation_backward(structure_operation_t *structure_operation, tensor_t *gradient)
+static nw_error_t *structure_operation_backward(structure_operation_t *structure_operation, tensor_t *result, tensor_t *gradient)
 {
     CHECK_NULL_ARGUMENT(structure_operation, "structure_operation");
     CHECK_NULL_ARGUMENT(gradient, "gradient");
@@ -2458,6 +2999,18 @@ static nw_error_t *structure_operation_backward(structure_operation_t *structure
     case COLUMN_TO_IMAGE_OPERATION:
         error = column_to_image_operation_backward(structure_operation->x, structure_operation->arguments, structure_operation->length, gradient);
         break;
+    case SOFTMAX_OPERATION:
+    case LOGSOFTMAX_OPERATION:
+        error = softmax_operation_backward(structure_operation->x, structure_operation->arguments, structure_operation->length, result, gradient,
+                                           structure_operation->operation_type == LOGSOFTMAX_OPERATION);
+        break;
+    case MAX_POOL_2D_OPERATION:
+    case AVERAGE_POOL_2D_OPERATION:
+        error = pooling_operation_backward(structure_operation, gradient);
+        break;
+    case DROPOUT_OPERATION:
+        error = dropout_operation_backward(structure_operation->x, structure_operation->arguments, structure_operation->length, gradient);
+        break;
     default:
         error = ERROR(ERROR_OPERATION_TYPE, string_create("unknown operation type %d.", (int) structure_operation->operation_type), NULL);
         break;
@@ -2605,6 +3158,12 @@ static nw_error_t *creation_operation_forward(creation_operation_t *creation_ope
 
     nw_error_t *error = NULL;
 
+    // Persistent tensors outlive the training step, keep them out of the step arena.
+    if (creation_operation->persist)
+    {
+        runtime_arena_suspend(true);
+    }
+
     switch (creation_operation->operation_type)
     {
     case EMPTY_OPERATION:
@@ -2636,6 +3195,11 @@ static nw_error_t *creation_operation_forward(creation_operation_t *creation_ope
         break;
     }
 
+    if (creation_operation->persist)
+    {
+        runtime_arena_suspend(false);
+    }
+
     if (error)
     {
         return ERROR(ERROR_FORWARD, string_create("failed to execute creation operation forward pass."), error);
@@ -2656,7 +3220,7 @@ static void unary_operation_destroy(unary_operation_t *unary_operation)
 {
     if (unary_operation)
     {
-        free(unary_operation);
+        slab_free(unary_operation, sizeof(unary_operation_t));
     }
 }
 
@@ -2674,7 +3238,7 @@ static nw_error_t *unary_operation_create(unary_operation_t **unary_operation, u
     CHECK_NULL_ARGUMENT(unary_operation, "unary_operation");
     CHECK_NULL_ARGUMENT(x, "x");
 
-    *unary_operation = (unary_operation_t *) malloc(sizeof(unary_operation_t));
+    *unary_operation = (unary_operation_t *) slab_malloc(sizeof(unary_operation_t));
     if (!*unary_operation)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(unary_operation_t)), NULL);
@@ -2690,17 +3254,27 @@ static void binary_operation_destroy(binary_operation_t *binary_operation)
 {
     if (binary_operation)
     {
-        free(binary_operation);
+        slab_free(binary_operation->arguments, binary_operation->length * sizeof(int64_t));
+        slab_free(binary_operation, sizeof(binary_operation_t));
     }
 }
 
-static nw_error_t *binary_operation_create(binary_operation_t **binary_operation, binary_operation_type_t binary_operation_type, const tensor_t *x, const tensor_t *y)
+static nw_error_t *binary_operation_create(binary_operation_t **binary_operation, binary_operation_type_t binary_operation_type, const tensor_t *x, const tensor_t *y,
+                                           const int64_t *arguments, int64_t length)
 {
     CHECK_NULL_ARGUMENT(binary_operation, "binary_operation");
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(y, "y");
 
-    *binary_operation = (binary_operation_t *) malloc(sizeof(binary_operation_t));
+    if (length && !arguments)
+    {
+        return ERROR(ERROR_NULL, string_create("received null argument for arguments."), NULL);
+    }
+
+    nw_error_t *error = NULL;
+    size_t size = length * sizeof(int64_t);
+
+    *binary_operation = (binary_operation_t *) slab_malloc(sizeof(binary_operation_t));
     if (!*binary_operation)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(binary_operation_t)), NULL);
@@ -2709,15 +3283,34 @@ static nw_error_t *binary_operation_create(binary_operation_t **binary_operation
     (*binary_operation)->operation_type = binary_operation_type;
     (*binary_operation)->x = (tensor_t *) x; 
     (*binary_operation)->y = (tensor_t *) y;
+    (*binary_operation)->arguments = NULL;
+    (*binary_operation)->length = length;
 
-    return NULL;
+    if (length)
+    {
+        (*binary_operation)->arguments = (int64_t *) slab_malloc(size);
+        if (!(*binary_operation)->arguments)
+        {
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
+            goto cleanup;
+        }
+        memcpy((*binary_operation)->arguments, arguments, size);
+    }
+
+    return error;
+
+cleanup:
+
+    binary_operation_destroy(*binary_operation);
+
+    return error;
 }
 
 static void ternary_operation_destroy(ternary_operation_t *ternary_operation)
 {
     if (ternary_operation)
     {
-        free(ternary_operation);
+        slab_free(ternary_operation, sizeof(ternary_operation_t));
     }
 }
 
@@ -2728,7 +3321,7 @@ static nw_error_t *ternary_operation_create(ternary_operation_t **ternary_operat
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(y, "y");
 
-    *ternary_operation = (ternary_operation_t *) malloc(sizeof(ternary_operation_t));
+    *ternary_operation = (ternary_operation_t *) slab_malloc(sizeof(ternary_operation_t));
     if (!*ternary_operation)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(ternary_operation_t)), NULL);
@@ -2746,8 +3339,8 @@ static void reduction_operation_destroy(reduction_operation_t *reduction_operati
 {
     if (reduction_operation)
     {
-        free(reduction_operation->axis);
-        free(reduction_operation);
+        slab_free(reduction_operation->axis, reduction_operation->length * sizeof(int64_t));
+        slab_free(reduction_operation, sizeof(reduction_operation_t));
     }
 }
 
@@ -2765,14 +3358,14 @@ static nw_error_t *reduction_operation_create(reduction_operation_t **reduction_
     nw_error_t *error = NULL;
     size_t size = length * sizeof(int64_t);
 
-    *reduction_operation = (reduction_operation_t *) malloc(sizeof(reduction_operation_t));
+    *reduction_operation = (reduction_operation_t *) slab_malloc(sizeof(reduction_operation_t));
     if (!*reduction_operation)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(reduction_operation_t)), NULL);
         goto cleanup;
     }
 
-    (*reduction_operation)->axis = (int64_t *) malloc(size);
+    (*reduction_operation)->axis = (int64_t *) slab_malloc(size);
     if (!(*reduction_operation)->axis)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate size %zu bytes.", size), NULL);
@@ -2798,8 +3391,9 @@ static void structure_operation_destroy(structure_operation_t *structure_operati
 {
     if (structure_operation)
     {
-        free(structure_operation->arguments);
-        free(structure_operation);
+        slab_free(structure_operation->arguments, structure_operation->length * sizeof(int64_t));
+        free(structure_operation->indices);
+        slab_free(structure_operation, sizeof(structure_operation_t));
     }
 }
 
@@ -2816,14 +3410,15 @@ static nw_error_t *structure_operation_create(structure_operation_t **structure_
     nw_error_t *error = NULL;
     size_t size = length * sizeof(int64_t);
 
-    *structure_operation = (structure_operation_t *) malloc(sizeof(structure_operation_t));
+    *structure_operation = (structure_operation_t *) slab_malloc(sizeof(structure_operation_t));
     if (!*structure_operation)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(structure_operation_t)), NULL);
         goto cleanup;
     }
 
-    (*structure_operation)->arguments = (int64_t *) malloc(size);
+    (*structure_operation)->indices = NULL;
+    (*structure_operation)->arguments = (int64_t *) slab_malloc(size);
     if (!(*structure_operation)->arguments)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
@@ -2856,8 +3451,8 @@ static void creation_operation_destroy(creation_operation_t *creation_operation)
             }
         }
         free(creation_operation->arguments);
-        free(creation_operation->shape);
-        free(creation_operation);
+        slab_free(creation_operation->shape, creation_operation->rank * sizeof(int64_t));
+        slab_free(creation_operation, sizeof(creation_operation_t));
     }
 }
 
@@ -2875,7 +3470,7 @@ static nw_error_t *creation_operation_create(creation_operation_t **creation_ope
     nw_error_t *error = NULL;
     size_t size;
 
-    *creation_operation = (creation_operation_t *) malloc(sizeof(creation_operation_t));
+    *creation_operation = (creation_operation_t *) slab_malloc(sizeof(creation_operation_t));
     if (!*creation_operation)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(creation_operation_t)), NULL);
@@ -2895,7 +3490,7 @@ static nw_error_t *creation_operation_create(creation_operation_t **creation_ope
 
     // Shape
     size = rank * sizeof(int64_t);
-    (*creation_operation)->shape = (int64_t *) malloc(size);
+    (*creation_operation)->shape = (int64_t *) slab_malloc(size);
     if (!(*creation_operation)->shape)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
@@ -2918,7 +3513,7 @@ static nw_error_t *creation_operation_create(creation_operation_t **creation_ope
     }
 
     (*creation_operation)->length = length;
-    size = datatype_size(datatype);
+    size = datatype_size(datatype_compute(datatype));
     for (int64_t i = 0; i < length; ++i)
     {
         (*creation_operation)->arguments[i] = (void *) malloc(size);
@@ -2927,7 +3522,7 @@ static nw_error_t *creation_operation_create(creation_operation_t **creation_ope
             error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
             goto cleanup;
         }
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) (*creation_operation)->arguments[i] = *(float32_t *) arguments[i];
@@ -2986,7 +3581,7 @@ static void operation_destroy(operation_t *operation, operation_type_t operation
                 break;
             }
         }
-        free(operation);
+        slab_free(operation, sizeof(operation_t));
     }
 }
 
@@ -3007,7 +3602,7 @@ static nw_error_t *operation_create(operation_t **operation, operation_type_t op
 
     nw_error_t *error = NULL;
 
-    *operation = (operation_t *) malloc(sizeof(operation_t));
+    *operation = (operation_t *) slab_malloc(sizeof(operation_t));
     if (!*operation)
     {
         error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(operation_t)), NULL);
@@ -3049,7 +3644,48 @@ cleanup:
 }
 
 /**
- * @brief The function constructor.
+ * @brief Collect the tensor operands of an operation.
+ * @param operands Set to the operands in the order they are stored in the operation.
+ * @return The number of operands.
+ */
+static int64_t operation_operands(const operation_t *operation, operation_type_t operation_type, tensor_t *operands[MAX_OPERANDS])
+{
+    switch (operation_type)
+    {
+    case UNARY_OPERATION:
+        operands[0] = operation->unary_operation->x;
+        return 1;
+    case BINARY_OPERATION:
+        operands[0] = operation->binary_operation->x;
+        operands[1] = operation->binary_operation->y;
+        return 2;
+    case TERNARY_OPERATION:
+        operands[0] = operation->ternary_operation->w;
+        operands[1] = operation->ternary_operation->x;
+        operands[2] = operation->ternary_operation->y;
+        return 3;
+    case REDUCTION_OPERATION:
+        operands[0] = operation->reduction_operation->x;
+        return 1;
+    case STRUCTURE_OPERATION:
+        operands[0] = operation->structure_operation->x;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief The version of the storage of an operand, see `tensor_inplace_check`.
+ */
+static uint64_t operand_version(const tensor_t *operand)
+{
+    return (operand && operand->buffer && operand->buffer->storage) ? operand->buffer->storage->version : 0;
+}
+
+/**
+ * @brief The function constructor. The versions of the operands are saved so that the backward pass
+ *        can tell if one of them was modified in place since.
  * @param function The address of the pointer to the function being instantiated.
  * @param operation The operation the function applies.
  * @param operation_type The type of operation the function applies. 
@@ -3062,7 +3698,7 @@ nw_error_t *function_create(function_t **function, operation_t *operation, opera
     CHECK_NULL_ARGUMENT(function, "function");
     CHECK_NULL_ARGUMENT(operation, "operation");
 
-    *function = (function_t *) malloc(sizeof(function_t));
+    *function = (function_t *) slab_malloc(sizeof(function_t));
     if (!*function)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(function_t)), NULL);
@@ -3070,6 +3706,13 @@ nw_error_t *function_create(function_t **function, operation_t *operation, opera
 
     (*function)->operation = operation;
     (*function)->operation_type = operation_type;
+
+    tensor_t *operands[MAX_OPERANDS];
+    int64_t length = operation_operands(operation, operation_type, operands);
+    for (int64_t i = 0; i < length; ++i)
+    {
+        (*function)->versions[i] = operand_version(operands[i]);
+    }
     
     return NULL;
 }
@@ -3087,7 +3730,7 @@ void function_destroy(function_t *function, bool_t destroy_operation)
         {
             operation_destroy(function->operation, function->operation_type, true);
         }
-        free(function);
+        slab_free(function, sizeof(function_t));
     }
 }
 
@@ -3173,7 +3816,7 @@ static nw_error_t *operation_backward(operation_t *operation, operation_type_t o
         error = reduction_operation_backward(operation->reduction_operation, result, gradient);
         break;
     case STRUCTURE_OPERATION:
-        error = structure_operation_backward(operation->structure_operation, gradient);
+        error = structure_operation_backward(operation->structure_operation, result, gradient);
         break;
     case CREATION_OPERATION:
         break;
@@ -3228,6 +3871,7 @@ static nw_error_t *function_forward(function_t *function, tensor_t *result)
  * @param function The function being differentiated.
  * @param gradient The incoming gradient with respect to the result of the function.
  * @return Error if `function` or `gradient` is NULL.
+ *         Error if an operand was modified in place after the function was applied.
  *         Error if the gradients with respect to the operands failed to compute.
  *         NULL, if the gradients with respect to the operands were successfully computed.
  */
@@ -3238,6 +3882,17 @@ static nw_error_t *function_backward(function_t *function, tensor_t *result, ten
     CHECK_NULL_ARGUMENT(result, "result");
 
     nw_error_t *error = NULL;
+    tensor_t *operands[MAX_OPERANDS];
+    int64_t length = operation_operands(function->operation, function->operation_type, operands);
+
+    for (int64_t i = 0; i < length; ++i)
+    {
+        if (operand_version(operands[i]) != function->versions[i])
+        {
+            return ERROR(ERROR_REQUIRES_GRADIENT, string_create("tensor %lu was modified in place after it was used by tensor %lu.", 
+                         operands[i]->id, result->id), NULL);
+        }
+    }
 
     error = operation_backward(function->operation, function->operation_type, result, gradient);
     if (error)
@@ -3392,12 +4047,14 @@ cleanup:
  * @param binary_operation_type The type of binary operation being applied.
  * @param x The first operand of the binary function.
  * @param y The second operand of the binary function.
+ * @param arguments Integer parameters of the binary function, NULL when `length` is 0.
+ * @param length Number of elements in `arguments`.
  * @param result The output tensor of the binary function.
  * @return Error if `x`, `y`, or `result` is NULL.
  *         Error if binary function failed to execute.
  *         NULL if binary function executed successfully.
  */
-nw_error_t *apply_operation_binary(binary_operation_type_t binary_operation_type, const tensor_t *x, const tensor_t *y, tensor_t **result)
+nw_error_t *apply_operation_binary(binary_operation_type_t binary_operation_type, const tensor_t *x, const tensor_t *y, const int64_t *arguments, int64_t length, tensor_t **result)
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(y, "y");
@@ -3412,6 +4069,11 @@ nw_error_t *apply_operation_binary(binary_operation_type_t binary_operation_type
     {
         error = tensor_broadcast_matrix_multiplication(x, y, &x_broadcasted, &y_broadcasted);
     }
+    else if (binary_operation_type == CONVOLUTION_2D_OPERATION || binary_operation_type == EMBEDDING_OPERATION)
+    {
+        x_broadcasted = (tensor_t *) x;
+        y_broadcasted = (tensor_t *) y;
+    }
     else
     {
         error = tensor_broadcast(x, y, &x_broadcasted, &y_broadcasted);
@@ -3423,7 +4085,7 @@ nw_error_t *apply_operation_binary(binary_operation_type_t binary_operation_type
         goto cleanup;
     } 
 
-    error = binary_operation_create(&binary_operation, binary_operation_type, x_broadcasted, y_broadcasted);
+    error = binary_operation_create(&binary_operation, binary_operation_type, x_broadcasted, y_broadcasted, arguments, length);
     if (error)
     {
         error = ERROR(ERROR_CREATE, string_create("failed to create binary operation."), error);
@@ -3606,16 +4268,15 @@ nw_error_t *apply_operation_reduction(reduction_operation_type_t reduction_opera
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(result, "result");
 
     nw_error_t *error = NULL;
     reduction_operation_t *reduction_operation = NULL;
-    int64_t reduce_length = length ? length : x->buffer->view->rank;
+    int64_t reduce_length = length ? length : x->buffer->view.rank;
     int64_t reduce_axis[reduce_length];
-    view_t *reduced_view = NULL;
+    view_t reduced_view;
 
-    if (x->buffer->view->rank < reduce_length)
+    if (x->buffer->view.rank < reduce_length)
     {
         error = ERROR(ERROR_RANK, string_create("reduce axis length greater than rank of tensor."), NULL);
         goto cleanup;
@@ -3623,19 +4284,19 @@ nw_error_t *apply_operation_reduction(reduction_operation_type_t reduction_opera
 
     for (int64_t i = 0; i < reduce_length; ++i)
     {
-        reduce_axis[i] = (!axis || !length) ? i : dimension_to_index(axis[i], x->buffer->view->rank);
+        reduce_axis[i] = (!axis || !length) ? i : dimension_to_index(axis[i], x->buffer->view.rank);
     }
 
     CHECK_UNIQUE(reduce_axis, reduce_length, "reduce_axis");
 
-    error = view_reduce(x->buffer->view, &reduced_view, reduce_axis, reduce_length, keep_dimension);
+    error = view_reduce(&x->buffer->view, &reduced_view, reduce_axis, reduce_length, keep_dimension);
     if (error)
     {
         error = ERROR(ERROR_REDUCTION, string_create("failed to reduce tensor."), error);
         goto cleanup;
     }
 
-    if (view_shapes_equal(reduced_view, x->buffer->view))
+    if (view_shapes_equal(&reduced_view, &x->buffer->view))
     {
         *result = (tensor_t *) x;
     }
@@ -3656,14 +4317,11 @@ nw_error_t *apply_operation_reduction(reduction_operation_type_t reduction_opera
         }
     }
 
-    view_destroy(reduced_view);
-
     return error;
 
 cleanup:
 
     reduction_operation_destroy(reduction_operation);
-    view_destroy(reduced_view);
 
     return error;
 }
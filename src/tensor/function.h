@@ -23,6 +23,8 @@ typedef struct binary_operation_t
 {
     tensor_t *x;
     tensor_t *y;
+    int64_t *arguments;
+    int64_t length;
     binary_operation_type_t operation_type;
 } binary_operation_t;
 
@@ -48,6 +50,7 @@ typedef struct structure_operation_t
     tensor_t *x;
     int64_t *arguments;
     int64_t length;
+    int32_t *indices;
     structure_operation_type_t operation_type;
 } structure_operation_t;
 
@@ -75,17 +78,21 @@ typedef union operation_t
     creation_operation_t *creation_operation;
 } operation_t;
 
+// Most tensor operands of an operation, the ternary operations take three.
+#define MAX_OPERANDS 3
+
 typedef struct function_t
 {
     operation_type_t operation_type;
     operation_t *operation;
+    uint64_t versions[MAX_OPERANDS];
 } function_t;
 
 nw_error_t *function_create(function_t **function, operation_t *operation, operation_type_t operation_type);
 void function_destroy(function_t *function, bool_t destroy_operation);
 
 nw_error_t *apply_operation_unary(unary_operation_type_t unary_operation_type, const tensor_t *x, tensor_t **result);
-nw_error_t *apply_operation_binary(binary_operation_type_t binary_operation_type, const tensor_t *x, const tensor_t *y, tensor_t **result);
+nw_error_t *apply_operation_binary(binary_operation_type_t binary_operation_type, const tensor_t *x, const tensor_t *y, const int64_t *arguments, int64_t length, tensor_t **result);
 nw_error_t *apply_operation_ternary(ternary_operation_type_t ternary_operation_type, const tensor_t *w, const tensor_t *x, const tensor_t *y, tensor_t **result);
 nw_error_t *apply_operation_reduction(reduction_operation_type_t reduction_operation_type, const tensor_t *x, const int64_t *axis, int64_t length, bool_t keep_dimension, tensor_t **result);
 nw_error_t *apply_operation_structure(structure_operation_type_t structure_operation_type, const tensor_t *x, const int64_t *arguments, int64_t length, tensor_t **result);
@@ -55,6 +55,10 @@ string_t unary_operation_type_string(unary_operation_type_t unary_operation_type
         return "RECTIFIED_LINEAR_OPERATION";
     case SIGMOID_OPERATION:
         return "SIGMOID_OPERATION";
+    case TANH_OPERATION:
+        return "TANH_OPERATION";
+    case GELU_OPERATION:
+        return "GELU_OPERATION";
     case AS_OPERATION:
         return "AS_OPERATION";
     default:
@@ -82,6 +86,10 @@ string_t binary_operation_type_string(binary_operation_type_t binary_operation_t
         return "COMPARE_EQUAL_OPERATION";
     case COMPARE_GREATER_OPERATION:
         return "COMPARE_GREATER_OPERATION";
+    case CONVOLUTION_2D_OPERATION:
+        return "CONVOLUTION_2D_OPERATION";
+    case EMBEDDING_OPERATION:
+        return "EMBEDDING_OPERATION";
     default:
         return "OPERATION";
     }
@@ -129,6 +137,16 @@ string_t structure_operation_type_string(structure_operation_type_t structure_op
         return "IMAGE_TO_COLUMN_OPERATION";
     case COLUMN_TO_IMAGE_OPERATION:
         return "COLUMN_TO_IMAGE_OPERATION";
+    case SOFTMAX_OPERATION:
+        return "SOFTMAX_OPERATION";
+    case LOGSOFTMAX_OPERATION:
+        return "LOGSOFTMAX_OPERATION";
+    case MAX_POOL_2D_OPERATION:
+        return "MAX_POOL_2D_OPERATION";
+    case AVERAGE_POOL_2D_OPERATION:
+        return "AVERAGE_POOL_2D_OPERATION";
+    case DROPOUT_OPERATION:
+        return "DROPOUT_OPERATION";
     default:
         return "OPERATION";
     }
@@ -26,6 +26,8 @@ typedef enum unary_operation_type_t
     RECTIFIED_LINEAR_OPERATION,
     SIGMOID_OPERATION,
     AS_OPERATION,
+    TANH_OPERATION,
+    GELU_OPERATION,
 } unary_operation_type_t;
 
 typedef enum binary_operation_type_t
@@ -38,6 +40,8 @@ typedef enum binary_operation_type_t
     MATRIX_MULTIPLICATION_OPERATION,
     COMPARE_EQUAL_OPERATION,
     COMPARE_GREATER_OPERATION,
+    CONVOLUTION_2D_OPERATION,
+    EMBEDDING_OPERATION,
 } binary_operation_type_t;
 
 typedef enum ternary_operation_type_t
@@ -60,6 +64,11 @@ typedef enum structure_operation_type_t
     PADDING_OPERATION,
     IMAGE_TO_COLUMN_OPERATION,
     COLUMN_TO_IMAGE_OPERATION,
+    SOFTMAX_OPERATION,
+    LOGSOFTMAX_OPERATION,
+    MAX_POOL_2D_OPERATION,
+    AVERAGE_POOL_2D_OPERATION,
+    DROPOUT_OPERATION,
 } structure_operation_type_t;
 
 typedef enum creation_operation_type_t
@@ -5,7 +5,6 @@
 
 #include <tensor.h>
 #include <stack.h>
-#include <map.h>
 #include <function.h>
 #include <buffer.h>
 #include <view.h>
@@ -14,6 +13,7 @@
 #include <math.h>
 #include <random.h>
 #include <id_pool.h>
+#include <slab.h>
 
 bool_t no_gradient = false;
 static id_pool_t *id_pool = NULL;
@@ -47,7 +47,7 @@ nw_error_t *tensor_create(tensor_t **tensor, buffer_t *buffer, function_t *conte
         }
     }
 
-    *tensor = (tensor_t *) malloc(sizeof(tensor_t));
+    *tensor = (tensor_t *) slab_malloc(sizeof(tensor_t));
     if (!*tensor)
     {
         return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(tensor_t)), NULL);
@@ -62,13 +62,14 @@ nw_error_t *tensor_create(tensor_t **tensor, buffer_t *buffer, function_t *conte
         nw_error_t *error = id_pool_get(id_pool, &(*tensor)->id);
         if (error)
         {
-            free(*tensor);
+            slab_free(*tensor, sizeof(tensor_t));
             return ERROR(ERROR_GET, string_create("failed to get id."), error);
         }
     }
     (*tensor)->buffer = buffer;
     (*tensor)->context = context;
     (*tensor)->gradient = gradient;
+    (*tensor)->gradient_rows = NULL;
     (*tensor)->requires_gradient = requires_gradient;
     (*tensor)->persist = persist;
 
@@ -88,18 +89,23 @@ void tensor_destroy(tensor_t *tensor)
         PRINTLN_DEBUG_LOCATION("input");
         PRINTLN_DEBUG_TENSOR("tensor", tensor);
         PRINT_DEBUG_NEWLINE;
-        id_pool_put(id_pool, tensor->id);
+        uint64_t tensor_id = tensor->id;
+
+        buffer_destroy(tensor->buffer);
+        tensor_destroy(tensor->gradient);
+        tensor_destroy(tensor->gradient_rows);
+        function_destroy(tensor->context, true);
+        slab_free(tensor, sizeof(tensor_t));
+
+        // Once every tensor is gone the id space starts over and the object pools are handed back to the system.
+        id_pool_put(id_pool, tensor_id);
         if (id_pool->size == id)
         {
             id_pool_destroy(id_pool);
             id = 0;
             id_pool = NULL;
+            slab_trim();
         }
-
-        buffer_destroy(tensor->buffer);
-        tensor_destroy(tensor->gradient);
-        function_destroy(tensor->context, true);
-        free(tensor);
     }
 }
 
@@ -268,43 +274,41 @@ nw_error_t *tensor_concatenation(const tensor_t *x, const tensor_t *y, tensor_t
     CHECK_NULL_ARGUMENT(y, "y");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
     CHECK_NULL_ARGUMENT(y->buffer, "y->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
-    CHECK_NULL_ARGUMENT(y->buffer->view, "y->buffer->view");
     CHECK_NULL_ARGUMENT(z, "z");
 
-    if (x->buffer->view->rank != y->buffer->view->rank)
+    if (x->buffer->view.rank != y->buffer->view.rank)
     {
         return ERROR(ERROR_RANK, string_create("tensors not the same rank."), NULL);
     }
 
-    axis = dimension_to_index(axis, x->buffer->view->rank);
+    axis = dimension_to_index(axis, x->buffer->view.rank);
 
-    for (int64_t i = 0; i < x->buffer->view->rank; ++i)
+    for (int64_t i = 0; i < x->buffer->view.rank; ++i)
     {
-        if (i != axis && x->buffer->view->shape[i] != y->buffer->view->shape[i])
+        if (i != axis && x->buffer->view.shape[i] != y->buffer->view.shape[i])
         {
             return ERROR(ERROR_SHAPE, string_create("tensors do not have same shape along non-axis dimensions."), NULL);
         }
     }
 
-    if (axis < 0 || axis >= x->buffer->view->rank)
+    if (axis < 0 || axis >= x->buffer->view.rank)
     {
         return ERROR(ERROR_AXIS, string_create("axis is out of range of tensor."), NULL);
     }
 
-    int64_t length = 2 * x->buffer->view->rank;
+    int64_t length = 2 * x->buffer->view.rank;
     int64_t x_arguments[length];
     int64_t y_arguments[length];
     tensor_t *x_padded = NULL;
     tensor_t *y_padded = NULL;
     nw_error_t *error = NULL;
 
-    for (int64_t i = 0; i < x->buffer->view->rank; ++i)
+    for (int64_t i = 0; i < x->buffer->view.rank; ++i)
     {
         x_arguments[2 * i] = 0;
         if (i == axis)
         {
-            x_arguments[2 * i + 1] = y->buffer->view->shape[i];
+            x_arguments[2 * i + 1] = y->buffer->view.shape[i];
         }
         else
         {
@@ -312,12 +316,12 @@ nw_error_t *tensor_concatenation(const tensor_t *x, const tensor_t *y, tensor_t
         }
     }
 
-    for (int64_t i = 0; i < y->buffer->view->rank; ++i)
+    for (int64_t i = 0; i < y->buffer->view.rank; ++i)
     {
         y_arguments[2 * i + 1] = 0;
         if (i == axis)
         {
-            y_arguments[2 * i] = x->buffer->view->shape[i];
+            y_arguments[2 * i] = x->buffer->view.shape[i];
         }
         else
         {
@@ -368,8 +372,6 @@ nw_error_t *tensor_broadcast(const tensor_t *x_original, const tensor_t *y_origi
     CHECK_NULL_ARGUMENT(y_original, "y_original");
     CHECK_NULL_ARGUMENT(x_original->buffer, "x_original->buffer");
     CHECK_NULL_ARGUMENT(y_original->buffer, "y_original->buffer");
-    CHECK_NULL_ARGUMENT(x_original->buffer->view, "x_original->buffer->view");
-    CHECK_NULL_ARGUMENT(y_original->buffer->view, "y_original->buffer->view");
     CHECK_NULL_ARGUMENT(x_broadcasted, "x_broadcasted");
     CHECK_NULL_ARGUMENT(y_broadcasted, "y_broadcasted");
 
@@ -377,7 +379,7 @@ nw_error_t *tensor_broadcast(const tensor_t *x_original, const tensor_t *y_origi
     int64_t *broadcasted_shape = NULL;
     int64_t broadcasted_rank;
 
-    error = view_broadcast(x_original->buffer->view, y_original->buffer->view, &broadcasted_shape, &broadcasted_rank);
+    error = view_broadcast(&x_original->buffer->view, &y_original->buffer->view, &broadcasted_shape, &broadcasted_rank);
     if (error)
     {
         error = ERROR(ERROR_BROADCAST, string_create("failed to broadcast tensor shapes."), error);
@@ -426,8 +428,6 @@ nw_error_t *tensor_broadcast_matrix_multiplication(const tensor_t *x_original,
     CHECK_NULL_ARGUMENT(y_original, "y_original");
     CHECK_NULL_ARGUMENT(x_original->buffer, "x_original->buffer");
     CHECK_NULL_ARGUMENT(y_original->buffer, "y_original->buffer");
-    CHECK_NULL_ARGUMENT(x_original->buffer->view, "x_original->buffer->view");
-    CHECK_NULL_ARGUMENT(y_original->buffer->view, "y_original->buffer->view");
     CHECK_NULL_ARGUMENT(x_broadcasted, "x_broadcasted");
     CHECK_NULL_ARGUMENT(y_broadcasted, "y_broadcasted");
 
@@ -436,7 +436,7 @@ nw_error_t *tensor_broadcast_matrix_multiplication(const tensor_t *x_original,
     int64_t *x_broadcasted_shape = NULL;
     int64_t *y_broadcasted_shape = NULL;
 
-    error = view_broadcast_matrix_multiplication(x_original->buffer->view, y_original->buffer->view, 
+    error = view_broadcast_matrix_multiplication(&x_original->buffer->view, &y_original->buffer->view, 
                                                  &x_broadcasted_shape, &y_broadcasted_shape, &broadcasted_rank);
     if (error)
     {
@@ -508,64 +508,11 @@ nw_error_t *tensor_tanh(const tensor_t *x, tensor_t **y)
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    tensor_t *const_tensor_1 = NULL;
-    tensor_t *const_tensor_2 = NULL;
-    tensor_t *double_x = NULL;
-    tensor_t *sigmoid_2x = NULL;
-    tensor_t *double_sigmoid = NULL;
-    datatype_t datatype = x->buffer->storage->datatype;
-    runtime_t runtime = x->buffer->storage->runtime;
-
-    switch(datatype)
-    {
-    case FLOAT32:
-        float32_t scalar_1_32 = (float32_t) 1;
-        float32_t scalar_2_32 = (float32_t) 2;
-        error = tensor_constant(&scalar_1_32, datatype, runtime, false, false, &const_tensor_1);
-        error = tensor_constant(&scalar_2_32, datatype, runtime, false, false, &const_tensor_2);
-        break;
-    case FLOAT64:
-        float64_t scalar_1_64 = (float64_t) 1;
-        float64_t scalar_2_64 = (float64_t) 2;
-        error = tensor_constant(&scalar_1_64, datatype, runtime, false, false, &const_tensor_1);
-        error = tensor_constant(&scalar_2_64, datatype, runtime, false, false, &const_tensor_2);
-        break;
-    default:
-        error = ERROR(ERROR_DATATYPE, string_create("unknown datatype %d.", (int)datatype), NULL);
-        break;
-    }
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_multiplication(const_tensor_2, x, &double_x);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_sigmoid(double_x, &sigmoid_2x);
-    if (error)
-    {
-        error = ERROR(ERROR_SIGMOID, string_create("failed to perform sigmoid operation."), error);
-        goto cleanup;
-    }
-
-    error = tensor_multiplication(const_tensor_2, sigmoid_2x, &double_sigmoid);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
 
-    error = tensor_subtraction(double_sigmoid, const_tensor_1, y);
+    error = apply_operation_unary(TANH_OPERATION, x, y);
     if (error)
     {
-        error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_FORWARD, string_create("failed to apply tanh to tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
@@ -573,23 +520,6 @@ nw_error_t *tensor_tanh(const tensor_t *x, tensor_t **y)
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-    if (!tensor_shapes_equal(const_tensor_1, x))
-    {
-        tensor_destroy(const_tensor_1);
-    }
-
-    if (!tensor_shapes_equal(const_tensor_2, x))
-    {
-        tensor_destroy(const_tensor_2);
-    }
-
-    if (!x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(double_x);
-        tensor_destroy(sigmoid_2x);
-        tensor_destroy(double_sigmoid);
-    }
     return error;
 }
 
@@ -662,173 +592,11 @@ nw_error_t *tensor_gelu(const tensor_t *x, tensor_t **y)
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    tensor_t *constant_05 = NULL;
-    tensor_t *constant_1 = NULL;
-    tensor_t *constant_3 = NULL;
-    tensor_t *constant_079 = NULL;
-    tensor_t *constant_0044 = NULL;
-    tensor_t *x_cubed = NULL;
-    tensor_t *x_cubed_0044 = NULL;
-    tensor_t *x_plus_x_cubed_0044 = NULL;
-    tensor_t *x_079 = NULL;
-    tensor_t *tanh_input = NULL;
-    tensor_t *tanh_output = NULL;
-    tensor_t *one_plus_tanh = NULL;
-    tensor_t *x_05 = NULL;
-    void *scalar_05 = NULL;
-    void *scalar_3 = NULL;
-    void *scalar_1 = NULL;
-    void *scalar_079 = NULL;
-    void *scalar_0044 = NULL;
-    datatype_t datatype = x->buffer->storage->datatype;
-    runtime_t runtime = x->buffer->storage->runtime;
-    size_t size = datatype_size(datatype);
-
-    scalar_05 = malloc(size);
-    if (!scalar_05)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    scalar_3 = malloc(size);
-    if (!scalar_3)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    scalar_1 = malloc(size);
-    if (!scalar_1)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    scalar_079 = malloc(size);
-    if (!scalar_079)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    scalar_0044 = malloc(size);
-    if (!scalar_0044)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    switch(datatype)
-    {
-    case FLOAT32:
-        *(float32_t *) scalar_05 = (float32_t) 0.5;
-        *(float32_t *) scalar_3 = (float32_t) 3;
-        *(float32_t *) scalar_1 = (float32_t) 1;
-        *(float32_t *) scalar_079 = (float32_t) sqrtf(2.0 / M_PI);
-        *(float32_t *) scalar_0044 = (float32_t) 0.044715;
-        break;
-    case FLOAT64:
-        *(float64_t *) scalar_05 = (float64_t) 0.5;
-        *(float64_t *) scalar_3 = (float64_t) 3;
-        *(float64_t *) scalar_1 = (float64_t) 1;
-        *(float64_t *) scalar_079 = (float64_t) sqrt(2.0 / M_PI);
-        *(float64_t *) scalar_0044 = (float64_t) 0.044715;
-        break;
-    default:
-        error = ERROR(ERROR_DATATYPE, string_create("unknown datatype %d.", (int)datatype), NULL);
-        break;
-    }
-
-    error = tensor_constant(scalar_05, datatype, runtime, false, false, &constant_05);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_constant(scalar_3, datatype, runtime, false, false, &constant_3);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_constant(scalar_1, datatype, runtime, false, false, &constant_1);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-    
-    error = tensor_constant(scalar_079, datatype, runtime, false, false, &constant_079);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_constant(scalar_0044, datatype, runtime, false, false, &constant_0044);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_power(x, constant_3, &x_cubed);
-    if (error)
-    {
-        error = ERROR(ERROR_POWER, string_create("failed to perform power operation."), error);
-        goto cleanup;
-    }
-
-    error = tensor_multiplication(constant_0044, x_cubed, &x_cubed_0044);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_addition(x, x_cubed_0044, &x_plus_x_cubed_0044);
-    if (error)
-    {
-        error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_multiplication(constant_079, x_plus_x_cubed_0044, &tanh_input);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_tanh(tanh_input, &tanh_output);
-    if (error)
-    {
-        error = ERROR(ERROR_TANH, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_addition(constant_1, tanh_output, &one_plus_tanh);
-    if (error)
-    {
-        error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_multiplication(constant_05, x, &x_05);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
 
-    error = tensor_multiplication(x_05, one_plus_tanh, y);
+    error = apply_operation_unary(GELU_OPERATION, x, y);
     if (error)
     {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_FORWARD, string_create("failed to apply gelu to tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
@@ -836,51 +604,6 @@ nw_error_t *tensor_gelu(const tensor_t *x, tensor_t **y)
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    free(scalar_05);
-    free(scalar_3);
-    free(scalar_1);
-    free(scalar_079);
-    free(scalar_0044);
-
-    if (!tensor_shapes_equal(constant_05, x) || !x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(constant_05);
-    }
-
-    if (!tensor_shapes_equal(constant_3, x) || !x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(constant_3);
-    }
-
-    if (!tensor_shapes_equal(constant_1, x) || !x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(constant_1);
-    }
-
-    if (!tensor_shapes_equal(constant_079, x) || !x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(constant_079);
-    }
-
-    if (!tensor_shapes_equal(constant_0044, x) || !x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(constant_0044);
-    }
-
-    if (!x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(x_cubed);
-        tensor_destroy(x_cubed_0044);
-        tensor_destroy(x_plus_x_cubed_0044);
-        tensor_destroy(x_079);
-        tensor_destroy(tanh_input);
-        tensor_destroy(tanh_output);
-        tensor_destroy(one_plus_tanh);
-        tensor_destroy(x_05);
-    }
-
     return error;
 }
 
@@ -893,13 +616,12 @@ nw_error_t *tensor_expand(const tensor_t *x, const int64_t *shape, int64_t lengt
 
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(y, "y");
     CHECK_NULL_ARGUMENT(shape, "shape");
 
     nw_error_t *error = NULL;
 
-    if (view_has_shape(x->buffer->view, shape, length))
+    if (view_has_shape(&x->buffer->view, shape, length))
     {
         *y = (tensor_t *) x;
     }
@@ -934,7 +656,7 @@ nw_error_t *tensor_addition(const tensor_t *x, const tensor_t *y, tensor_t **z)
 
     nw_error_t *error = NULL;
 
-    error = apply_operation_binary(ADDITION_OPERATION, x, y, z);
+    error = apply_operation_binary(ADDITION_OPERATION, x, y, NULL, 0, z);
     if (error)
     {
         return ERROR(ERROR_FORWARD, string_create("failed to add tensors."), error);
@@ -993,7 +715,7 @@ nw_error_t *tensor_subtraction(const tensor_t *x, const tensor_t *y, tensor_t **
 
     nw_error_t *error = NULL;
 
-    error = apply_operation_binary(SUBTRACTION_OPERATION, x, y, z);
+    error = apply_operation_binary(SUBTRACTION_OPERATION, x, y, NULL, 0, z);
     if (error)
     {
         return ERROR(ERROR_FORWARD, string_create("failed to subtract tensors."), error);
@@ -1021,7 +743,7 @@ nw_error_t *tensor_division(const tensor_t *x, const tensor_t *y, tensor_t **z)
 
     nw_error_t *error = NULL;
 
-    error = apply_operation_binary(DIVISION_OPERATION, x, y, z);
+    error = apply_operation_binary(DIVISION_OPERATION, x, y, NULL, 0, z);
     if (error)
     {
         return ERROR(ERROR_FORWARD, string_create("failed to divide tensors."), error);
@@ -1049,7 +771,7 @@ nw_error_t *tensor_multiplication(const tensor_t *x, const tensor_t *y, tensor_t
 
     nw_error_t *error = NULL;
 
-    error = apply_operation_binary(MULTIPLICATION_OPERATION, x, y, z);
+    error = apply_operation_binary(MULTIPLICATION_OPERATION, x, y, NULL, 0, z);
     if (error)
     {
         return ERROR(ERROR_FORWARD, string_create("failed to multiply tensors."), error);
@@ -1064,120 +786,192 @@ nw_error_t *tensor_multiplication(const tensor_t *x, const tensor_t *y, tensor_t
     return NULL;
 }
 
-nw_error_t *tensor_compare_equal(const tensor_t *x, const tensor_t *y, tensor_t **z)
+/**
+ * @brief Check that `x` can be overwritten with the result of an in place operation with `y`.
+ *        In place operations are not recorded, so they are rejected while gradients are tracked for
+ *        either operand, and on tensors produced by an operation that is still part of the graph.
+ *        Leaves only hold their creation function and may be modified. Every write bumps the version of
+ *        the storage of `x`, functions that used it before then fail in the backward pass.
+ * @return Error if `x` or `y` is NULL or `x` is still needed by autograd.
+ *         NULL if `x` may be overwritten.
+ */
+static nw_error_t *tensor_inplace_check(const tensor_t *x, const tensor_t *y)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
+    CHECK_NULL_ARGUMENT(y->buffer, "y->buffer");
+
+    if (x->context && x->context->operation_type != CREATION_OPERATION)
+    {
+        return ERROR(ERROR_REQUIRES_GRADIENT, string_create("tensor %lu is part of a graph and cannot be modified in place.", x->id), NULL);
+    }
+
+    if (!no_gradient && (x->requires_gradient || y->requires_gradient))
+    {
+        return ERROR(ERROR_REQUIRES_GRADIENT, string_create("in place operations on tensors requiring gradients must run without gradient tracking."), NULL);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add `y` into `x` in place, `y` is broadcast to the shape of `x`.
+ *        No function is recorded, so neither operand may be needed by autograd.
+ */
+nw_error_t *tensor_addition_inplace(tensor_t *x, const tensor_t *y)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
     PRINT_DEBUG_NEWLINE;
 
-    CHECK_NULL_ARGUMENT(x, "x");
-    CHECK_NULL_ARGUMENT(y, "y");
-    CHECK_NULL_ARGUMENT(z, "z");
-
     nw_error_t *error = NULL;
-    with_no_gradient(true);
 
-    error = apply_operation_binary(COMPARE_EQUAL_OPERATION, x, y, z);
+    error = tensor_inplace_check(x, y);
     if (error)
     {
-        return ERROR(ERROR_FORWARD, string_create("failed to compare equal tensors."), error);
+        return ERROR(ERROR_REQUIRES_GRADIENT, string_create("unable to modify tensor in place."), error);
     }
 
-    with_no_gradient(false);
+    error = buffer_binary_inplace(ADDITION_OPERATION, x->buffer, y->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_ADDITION, string_create("failed to add tensors in place."), error);
+    }
+    ++x->buffer->storage->version;
 
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
-    PRINTLN_DEBUG_TENSOR("z", *z);
     PRINT_DEBUG_NEWLINE;
 
-    return NULL;
+    return error;
 }
 
-nw_error_t *tensor_compare_greater(const tensor_t *x, const tensor_t *y, tensor_t **z)
+/**
+ * @brief Subtract `y` from `x` in place, `y` is broadcast to the shape of `x`.
+ *        No function is recorded, so neither operand may be needed by autograd.
+ */
+nw_error_t *tensor_subtraction_inplace(tensor_t *x, const tensor_t *y)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
     PRINT_DEBUG_NEWLINE;
 
-    CHECK_NULL_ARGUMENT(x, "x");
-    CHECK_NULL_ARGUMENT(y, "y");
-    CHECK_NULL_ARGUMENT(z, "z");
-
     nw_error_t *error = NULL;
-    with_no_gradient(true);
 
-    error = apply_operation_binary(COMPARE_GREATER_OPERATION, x, y, z);
+    error = tensor_inplace_check(x, y);
     if (error)
     {
-        return ERROR(ERROR_FORWARD, string_create("failed to compare greater tensors."), error);
+        return ERROR(ERROR_REQUIRES_GRADIENT, string_create("unable to modify tensor in place."), error);
     }
 
-    with_no_gradient(false);
+    error = buffer_binary_inplace(SUBTRACTION_OPERATION, x->buffer, y->buffer);
+    if (error)
+    {
+        return ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors in place."), error);
+    }
+    ++x->buffer->storage->version;
 
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
-    PRINTLN_DEBUG_TENSOR("z", *z);
     PRINT_DEBUG_NEWLINE;
 
-    return NULL;
+    return error;
 }
 
-nw_error_t *tensor_max(const tensor_t *x, const tensor_t *y, tensor_t **z)
+/**
+ * @brief Multiply `x` by `y` in place, `y` is broadcast to the shape of `x`.
+ *        No function is recorded, so neither operand may be needed by autograd.
+ */
+nw_error_t *tensor_multiplication_inplace(tensor_t *x, const tensor_t *y)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
     PRINT_DEBUG_NEWLINE;
 
-    CHECK_NULL_ARGUMENT(x, "x");
-    CHECK_NULL_ARGUMENT(y, "y");
-    CHECK_NULL_ARGUMENT(z, "z");
-
     nw_error_t *error = NULL;
-    tensor_t *compare_x_y = NULL;
-    tensor_t *compare_y_x = NULL;
-    tensor_t *x_max = NULL;
-    tensor_t *y_max = NULL;
 
-    with_no_gradient(true);
-    
-    error = tensor_compare_greater(x, y, &compare_x_y);
+    error = tensor_inplace_check(x, y);
     if (error)
     {
-        error = ERROR(ERROR_FORWARD, string_create("failed to compare greater tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_REQUIRES_GRADIENT, string_create("unable to modify tensor in place."), error);
     }
 
-    error = tensor_compare_greater(y, x, &compare_y_x);
+    error = buffer_binary_inplace(MULTIPLICATION_OPERATION, x->buffer, y->buffer);
     if (error)
     {
-        error = ERROR(ERROR_FORWARD, string_create("failed to compare greater tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors in place."), error);
     }
+    ++x->buffer->storage->version;
 
-    error = tensor_multiplication(x, compare_x_y, &x_max);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
+/**
+ * @brief Accumulate `alpha * y` into `x` in place (axpy), `y` is broadcast to the shape of `x`.
+ *        No function is recorded, so neither operand may be needed by autograd.
+ * @param alpha Scalar in the compute datatype of `x`, float32 for reduced precision tensors.
+ */
+nw_error_t *tensor_scaled_add_inplace(tensor_t *x, const tensor_t *y, void *alpha)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(alpha, "alpha");
+
+    nw_error_t *error = NULL;
+
+    error = tensor_inplace_check(x, y);
+    if (error)
+    {
+        return ERROR(ERROR_REQUIRES_GRADIENT, string_create("unable to modify tensor in place."), error);
     }
 
-    error = tensor_multiplication(y, compare_y_x, &y_max);
+    error = buffer_scaled_addition(x->buffer, y->buffer, alpha);
     if (error)
     {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_ADDITION, string_create("failed to accumulate scaled tensor in place."), error);
     }
+    ++x->buffer->storage->version;
 
-    error = tensor_addition(x_max, y_max, z);
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
+nw_error_t *tensor_compare_equal(const tensor_t *x, const tensor_t *y, tensor_t **z)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(z, "z");
+
+    nw_error_t *error = NULL;
+    with_no_gradient(true);
+
+    error = apply_operation_binary(COMPARE_EQUAL_OPERATION, x, y, NULL, 0, z);
     if (error)
     {
-        error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_FORWARD, string_create("failed to compare equal tensors."), error);
     }
 
     with_no_gradient(false);
@@ -1188,17 +982,10 @@ nw_error_t *tensor_max(const tensor_t *x, const tensor_t *y, tensor_t **z)
     PRINTLN_DEBUG_TENSOR("z", *z);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    tensor_destroy(compare_x_y);
-    tensor_destroy(compare_y_x);
-    tensor_destroy(x_max);
-    tensor_destroy(y_max);
-
-    return error;
+    return NULL;
 }
 
-nw_error_t *tensor_power(const tensor_t *x, const tensor_t *y, tensor_t **z)
+nw_error_t *tensor_compare_greater(const tensor_t *x, const tensor_t *y, tensor_t **z)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
@@ -1207,25 +994,29 @@ nw_error_t *tensor_power(const tensor_t *x, const tensor_t *y, tensor_t **z)
 
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(z, "z");
 
     nw_error_t *error = NULL;
+    with_no_gradient(true);
 
-    error = apply_operation_binary(POWER_OPERATION, x, y, z);
+    error = apply_operation_binary(COMPARE_GREATER_OPERATION, x, y, NULL, 0, z);
     if (error)
     {
-        return ERROR(ERROR_FORWARD, string_create("failed to power tensors."), error);
+        return ERROR(ERROR_FORWARD, string_create("failed to compare greater tensors."), error);
     }
 
+    with_no_gradient(false);
+
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
     PRINTLN_DEBUG_TENSOR("z", *z);
     PRINT_DEBUG_NEWLINE;
 
-    return error;
+    return NULL;
 }
 
-nw_error_t *tensor_matrix_multiplication(const tensor_t *x, const tensor_t *y, tensor_t **z)
+nw_error_t *tensor_max(const tensor_t *x, const tensor_t *y, tensor_t **z)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
@@ -1237,30 +1028,50 @@ nw_error_t *tensor_matrix_multiplication(const tensor_t *x, const tensor_t *y, t
     CHECK_NULL_ARGUMENT(z, "z");
 
     nw_error_t *error = NULL;
-    tensor_t *x_contiguous = NULL;
-    tensor_t *y_contiguous = NULL;
+    tensor_t *compare_x_y = NULL;
+    tensor_t *compare_y_x = NULL;
+    tensor_t *x_max = NULL;
+    tensor_t *y_max = NULL;
 
-    error = tensor_contiguous(x, &x_contiguous);
+    with_no_gradient(true);
+    
+    error = tensor_compare_greater(x, y, &compare_x_y);
+    if (error)
+    {
+        error = ERROR(ERROR_FORWARD, string_create("failed to compare greater tensors."), error);
+        goto cleanup;
+    }
+
+    error = tensor_compare_greater(y, x, &compare_y_x);
     if (error)
     {
-        error = ERROR(ERROR_CONTIGUOUS, string_create("failed make tensor contiguous."), error);
+        error = ERROR(ERROR_FORWARD, string_create("failed to compare greater tensors."), error);
+        goto cleanup;
+    }
+
+    error = tensor_multiplication(x, compare_x_y, &x_max);
+    if (error)
+    {
+        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
         goto cleanup;
     }
 
-    error = tensor_contiguous(y, &y_contiguous);
+    error = tensor_multiplication(y, compare_y_x, &y_max);
     if (error)
     {
-        error = ERROR(ERROR_CONTIGUOUS, string_create("failed make tensor contiguous."), error);
+        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
         goto cleanup;
     }
 
-    error = apply_operation_binary(MATRIX_MULTIPLICATION_OPERATION, x_contiguous, y_contiguous, z);
+    error = tensor_addition(x_max, y_max, z);
     if (error)
     {
-        error = ERROR(ERROR_FORWARD, string_create("failed to matrix multiply tensors."), error);
+        error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
         goto cleanup;
     }
 
+    with_no_gradient(false);
+
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", y);
@@ -1269,16 +1080,66 @@ nw_error_t *tensor_matrix_multiplication(const tensor_t *x, const tensor_t *y, t
 
 cleanup:
 
-    if (x != x_contiguous && (!(x->requires_gradient) || no_gradient))
+    tensor_destroy(compare_x_y);
+    tensor_destroy(compare_y_x);
+    tensor_destroy(x_max);
+    tensor_destroy(y_max);
+
+    return error;
+}
+
+nw_error_t *tensor_power(const tensor_t *x, const tensor_t *y, tensor_t **z)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+
+    nw_error_t *error = NULL;
+
+    error = apply_operation_binary(POWER_OPERATION, x, y, NULL, 0, z);
+    if (error)
     {
-        tensor_destroy(x_contiguous);
+        return ERROR(ERROR_FORWARD, string_create("failed to power tensors."), error);
     }
 
-    if (y != y_contiguous && (!(y->requires_gradient) || no_gradient))
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINTLN_DEBUG_TENSOR("z", *z);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
+nw_error_t *tensor_matrix_multiplication(const tensor_t *x, const tensor_t *y, tensor_t **z)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+    CHECK_NULL_ARGUMENT(z, "z");
+
+    nw_error_t *error = NULL;
+
+    error = apply_operation_binary(MATRIX_MULTIPLICATION_OPERATION, x, y, NULL, 0, z);
+    if (error)
     {
-        tensor_destroy(y_contiguous);
+        return ERROR(ERROR_FORWARD, string_create("failed to matrix multiply tensors."), error);
     }
 
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("y", y);
+    PRINTLN_DEBUG_TENSOR("z", *z);
+    PRINT_DEBUG_NEWLINE;
+
     return error;
 }
 
@@ -1319,7 +1180,6 @@ nw_error_t *tensor_maximum(const tensor_t *x, tensor_t **y, const int64_t *axis,
 
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
@@ -1486,6 +1346,84 @@ cleanup:
     return error;
 }
 
+/**
+ * @brief Inference only linear layer on int8 weights from `buffer_quantize`.
+ *        The result is a leaf that does not require a gradient.
+ */
+nw_error_t *tensor_quantized_linear(const tensor_t *x, const quantization_t *quantization, const tensor_t *bias, tensor_t **y)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("bias", bias);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(quantization, "quantization");
+    CHECK_NULL_ARGUMENT(y, "y");
+
+    nw_error_t *error = NULL;
+    buffer_t *buffer = NULL;
+
+    error = buffer_quantized_linear(x->buffer, quantization, (bias) ? bias->buffer : NULL, &buffer);
+    if (error)
+    {
+        return ERROR(ERROR_QUANTIZATION, string_create("failed to apply quantized linear layer."), error);
+    }
+
+    error = tensor_create(y, buffer, NULL, NULL, false, false);
+    if (error)
+    {
+        buffer_destroy(buffer);
+        return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+    }
+
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("y", *y);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
+/**
+ * @brief Inference only 2D convolution on an int8 kernel from `buffer_quantize`.
+ *        The result is a leaf that does not require a gradient.
+ */
+nw_error_t *tensor_quantized_convolution_2d(const tensor_t *x, const quantization_t *quantization, const tensor_t *bias, tensor_t **y,
+                                            int64_t kernel_size, int64_t stride, int64_t padding)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("bias", bias);
+    PRINTLN_DEBUG_INT64_ARRAY("arguments", ((int64_t[]){kernel_size, stride, padding}), 3);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(quantization, "quantization");
+    CHECK_NULL_ARGUMENT(y, "y");
+
+    nw_error_t *error = NULL;
+    buffer_t *buffer = NULL;
+
+    error = buffer_quantized_convolution_2d(x->buffer, quantization, (bias) ? bias->buffer : NULL, kernel_size, stride, padding, &buffer);
+    if (error)
+    {
+        return ERROR(ERROR_QUANTIZATION, string_create("failed to apply quantized convolution."), error);
+    }
+
+    error = tensor_create(y, buffer, NULL, NULL, false, false);
+    if (error)
+    {
+        buffer_destroy(buffer);
+        return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+    }
+
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("y", *y);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
 nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *weights, const tensor_t *bias, tensor_t *running_mean, 
                                           tensor_t *running_variance, tensor_t **y, bool_t inference, void *momentum, void *epsilon)
 {
@@ -1499,12 +1437,11 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
 
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
     CHECK_NULL_ARGUMENT(y, "y");
     CHECK_NULL_ARGUMENT(epsilon, "epsilon");
 
-    if (x->buffer->view->rank != 4)
+    if (x->buffer->view.rank != 4)
     {
         return ERROR(ERROR_RANK, string_create("batch normalization 2d expects a rank 4 tensor."), NULL);
     }
@@ -1514,17 +1451,12 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
     tensor_t *variance = NULL;
     tensor_t *mean_reshaped = NULL;
     tensor_t *variance_reshaped = NULL;
-    tensor_t *running_mean_l = NULL;
-    tensor_t *running_mean_r = NULL;
-    tensor_t *running_variance_l = NULL;
-    tensor_t *running_variance_r = NULL;
     tensor_t *variance_perturbed = NULL;
     tensor_t *epsilon_constant = NULL;
     void *momentum_complement = NULL;
     void *value = NULL;
     tensor_t *unbiased_variance = NULL;
     tensor_t *value_constant = NULL;
-    tensor_t *momentum_constant = NULL;
     tensor_t *momentum_complement_constant = NULL;
     tensor_t *denominator = NULL;
     tensor_t *numerator = NULL;
@@ -1532,7 +1464,7 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
     tensor_t *scaled_standard_normal_x = NULL;
     tensor_t *reshaped_weights = NULL;
     tensor_t *reshaped_bias = NULL;
-    int64_t number_of_features = x->buffer->view->shape[1];
+    int64_t number_of_features = x->buffer->view.shape[1];
     datatype_t datatype = x->buffer->storage->datatype;
     runtime_t runtime = x->buffer->storage->runtime;
     int64_t n;
@@ -1551,14 +1483,14 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
 
     if (momentum && !inference)
     {
-        momentum_complement = (void *) malloc(datatype_size(datatype));
+        momentum_complement = (void *) malloc(datatype_size(datatype_compute(datatype)));
         if (!momentum_complement)
         {
-            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", datatype_size(datatype)), NULL);
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", datatype_size(datatype_compute(datatype))), NULL);
             goto cleanup;
         }
 
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) momentum_complement = (float32_t) 1.0 - *(float32_t *) momentum;
@@ -1571,13 +1503,6 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
             goto cleanup;
         }
 
-        error = tensor_constant(momentum, datatype, runtime, false, false, &momentum_constant);
-        if (error)
-        {
-            error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-            goto cleanup;
-        }
-        
         error = tensor_constant(momentum_complement, datatype, runtime, false, false, &momentum_complement_constant);
         if (error)
         {
@@ -1702,21 +1627,14 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
 
     if (running_mean && !inference)
     {
-        error = tensor_multiplication(momentum_complement_constant, running_mean, &running_mean_l);
-        if (error)
-        {
-            error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-            goto cleanup;
-        }
-
-        error = tensor_multiplication(momentum_constant, mean, &running_mean_r);
+        error = tensor_multiplication_inplace(running_mean, momentum_complement_constant);
         if (error)
         {
             error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
             goto cleanup;
         }
 
-        error = tensor_addition(running_mean_l, running_mean_r, &running_mean);
+        error = tensor_scaled_add_inplace(running_mean, mean, momentum);
         if (error)
         {
             error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
@@ -1733,14 +1651,14 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
             goto cleanup;
         }
 
-        value = (void *) malloc(datatype_size(datatype));
+        value = (void *) malloc(datatype_size(datatype_compute(datatype)));
         if (!value)
         {
-            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", datatype_size(datatype)), NULL);
+            error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", datatype_size(datatype_compute(datatype))), NULL);
             goto cleanup;
         }
         
-        switch (datatype)
+        switch (datatype_compute(datatype))
         {
         case FLOAT32:
             *(float32_t *) value = (float32_t) n / (float32_t) (n - number_of_features);
@@ -1760,7 +1678,7 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
             goto cleanup;
         }
 
-        error = tensor_multiplication(momentum_complement_constant, running_variance, &running_variance_l);
+        error = tensor_multiplication_inplace(running_variance, momentum_complement_constant);
         if (error)
         {
             error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
@@ -1774,14 +1692,7 @@ nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *wei
             goto cleanup;
         }
 
-        error = tensor_multiplication(momentum_constant, unbiased_variance, &running_variance_r);
-        if (error)
-        {
-            error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-            goto cleanup;
-        }
-
-        error = tensor_addition(running_variance_l, running_variance_r, &running_variance);
+        error = tensor_scaled_add_inplace(running_variance, unbiased_variance, momentum);
         if (error)
         {
             error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
@@ -1862,12 +1773,7 @@ cleanup:
     free(momentum_complement);
     tensor_destroy(unbiased_variance);
     tensor_destroy(value_constant);
-    tensor_destroy(momentum_constant);
     tensor_destroy(momentum_complement_constant);
-    tensor_destroy(running_mean_l);
-    tensor_destroy(running_mean_r);
-    tensor_destroy(running_variance_l);
-    tensor_destroy(running_variance_r);
     tensor_destroy(epsilon_constant);
 
     return error;
@@ -2040,66 +1946,34 @@ nw_error_t *tensor_convolution_2d(const tensor_t *w, const tensor_t *x, const te
     PRINT_DEBUG_NEWLINE;
 
     nw_error_t *error = NULL;
-    tensor_t *w_toeplitz = NULL;
-    tensor_t *x_reshape = NULL;
     tensor_t *y_reshape = NULL;
     tensor_t *v = NULL;
-    tensor_t *u = NULL;
-    int64_t batch_size = w->buffer->view->shape[0];
-    int64_t in_channels = w->buffer->view->shape[1];
-    int64_t height = w->buffer->view->shape[2];
-    int64_t width = w->buffer->view->shape[3];
-    int64_t out_channels = x->buffer->view->shape[0];
-    int64_t kernel_size = x->buffer->view->shape[2];
-
-    error = tensor_image_to_column(w, &w_toeplitz, kernel_size, stride, padding, in_channels, height, width, 0);
-    if (error)
-    {
-        error = ERROR(ERROR_IMAGE_TO_COLUMN, string_create("failed to convert image to column."), error);
-        goto cleanup;
-    }
-   
-    error = tensor_reshape(x, &x_reshape, (int64_t[]){out_channels, in_channels * kernel_size * kernel_size}, (int64_t) 2);
-    if (error)
-    {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
-    }
+    int64_t out_channels = x->buffer->view.shape[0];
 
-    error = tensor_matrix_multiplication(x_reshape, w_toeplitz, &v);
+    // The runtime picks between image to column with GEMM, direct and Winograd convolution from the shapes.
+    error = apply_operation_binary(CONVOLUTION_2D_OPERATION, w, x, (int64_t[]){stride, padding}, 2, (y) ? &v : z);
     if (error)
     {
-        error = ERROR(ERROR_MATRIX_MULTIPLICATION, string_create("failed to matrix multiply tensors."), error);
+        error = ERROR(ERROR_CONVOLUTION, string_create("failed to convolve tensors."), error);
         goto cleanup;
     }
 
     if (y)
     {
-        error = tensor_reshape(y, &y_reshape, (int64_t[]){out_channels, 1}, 2);
+        error = tensor_reshape(y, &y_reshape, (int64_t[]){1, out_channels, 1, 1}, 4);
         if (error)
         {
             error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
             goto cleanup;
         }
 
-        error = tensor_addition(v, y_reshape, &u);
+        error = tensor_addition(v, y_reshape, z);
         if (error)
         {
             error = ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
             goto cleanup;
         }
     }
-    else
-    {
-        u = v;
-    }
-
-    error = tensor_reshape(u, z, (int64_t[]){batch_size, out_channels, (height + 2 * padding - kernel_size) / stride + 1, (width + 2 * padding - kernel_size) / stride + 1}, 4);
-    if (error)
-    {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
-    }
 
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("w", w);
@@ -2110,30 +1984,15 @@ nw_error_t *tensor_convolution_2d(const tensor_t *w, const tensor_t *x, const te
     PRINT_DEBUG_NEWLINE;
 
 cleanup:
+
     if (y)
     {
-        if ((!v->requires_gradient && !y->requires_gradient) || no_gradient)
+        if ((!w->requires_gradient && !x->requires_gradient && !y->requires_gradient) || no_gradient)
         {
             if (y != y_reshape)
             {
                 tensor_destroy(y_reshape);
             }
-            if (*z != u)
-            {
-                tensor_destroy(u);
-            }
-        }
-    }
-
-    if ((!x->requires_gradient && !w->requires_gradient) || no_gradient)
-    {
-        tensor_destroy(w_toeplitz);
-        if (x != x_reshape)
-        {
-            tensor_destroy(x_reshape);
-        }
-        if (v != *z)
-        {
             tensor_destroy(v);
         }
     }
@@ -2152,40 +2011,11 @@ nw_error_t *tensor_max_pool_2d(const tensor_t *x, tensor_t **y, int64_t kernel_s
     PRINT_DEBUG_NEWLINE;
 
     nw_error_t *error = NULL;
-    tensor_t *x_toeplitz = NULL;
-    tensor_t *x_reshape = NULL;
-    tensor_t *u = NULL;
-    int64_t batch_size = x->buffer->view->shape[0];
-    int64_t channels = x->buffer->view->shape[1];
-    int64_t height = x->buffer->view->shape[2];
-    int64_t width = x->buffer->view->shape[3];
-    
-    error = tensor_reshape(x, &x_reshape, (int64_t[]){batch_size * channels, 1, height, width}, 4);
-    if (error)
-    {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_image_to_column(x_reshape, &x_toeplitz, kernel_size, stride, padding, 1, height, width, INT64_MIN);
-    if (error)
-    {
-        error = ERROR(ERROR_IMAGE_TO_COLUMN, string_create("failed to convert image to column."), error);
-        goto cleanup;
-    }
 
-    error = tensor_maximum(x_toeplitz, &u, (int64_t[]){-2}, 1, true);
+    error = apply_operation_structure(MAX_POOL_2D_OPERATION, x, (int64_t[]){kernel_size, stride, padding}, 3, y);
     if (error)
     {
-        error = ERROR(ERROR_MAXIMUM, string_create("failed to find maximum tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_reshape(u, y, (int64_t[]){batch_size, channels, (height + 2 * padding - kernel_size) / stride + 1, (width + 2 * padding - kernel_size) / stride + 1}, 4);
-    if (error)
-    {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
+        return ERROR(ERROR_POOLING, string_create("failed to max pool tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
@@ -2193,26 +2023,6 @@ nw_error_t *tensor_max_pool_2d(const tensor_t *x, tensor_t **y, int64_t kernel_s
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    if ((!x->requires_gradient) || no_gradient)
-    {
-        if (u != x_toeplitz)
-        {
-            tensor_destroy(x_toeplitz);
-        }
-
-        if (x != x_reshape)
-        {
-            tensor_destroy(x_reshape);
-        }
-
-        if (*y != u)
-        {
-            tensor_destroy(u);
-        }
-    }
-
     return error;
 }
 
@@ -2227,40 +2037,11 @@ nw_error_t *tensor_average_pool_2d(const tensor_t *x, tensor_t **y, int64_t kern
     PRINT_DEBUG_NEWLINE;
 
     nw_error_t *error = NULL;
-    tensor_t *x_toeplitz = NULL;
-    tensor_t *x_reshape = NULL;
-    tensor_t *u = NULL;
-    int64_t batch_size = x->buffer->view->shape[0];
-    int64_t channels = x->buffer->view->shape[1];
-    int64_t height = x->buffer->view->shape[2];
-    int64_t width = x->buffer->view->shape[3];
-    
-    error = tensor_reshape(x, &x_reshape, (int64_t[]){batch_size * channels, 1, height, width}, 4);
-    if (error)
-    {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_image_to_column(x_reshape, &x_toeplitz, kernel_size, stride, padding, 1, height, width, 0);
-    if (error)
-    {
-        error = ERROR(ERROR_IMAGE_TO_COLUMN, string_create("failed to convert image to column."), error);
-        goto cleanup;
-    }
-
-    error = tensor_mean(x_toeplitz, &u, (int64_t[]){-2}, 1, true);
-    if (error)
-    {
-        error = ERROR(ERROR_MAXIMUM, string_create("failed to find maximum tensor."), error);
-        goto cleanup;
-    }
 
-    error = tensor_reshape(u, y, (int64_t[]){batch_size, channels, (height + 2 * padding - kernel_size) / stride + 1, (width + 2 * padding - kernel_size) / stride + 1}, 4);
+    error = apply_operation_structure(AVERAGE_POOL_2D_OPERATION, x, (int64_t[]){kernel_size, stride, padding}, 3, y);
     if (error)
     {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
+        return ERROR(ERROR_POOLING, string_create("failed to average pool tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
@@ -2268,28 +2049,9 @@ nw_error_t *tensor_average_pool_2d(const tensor_t *x, tensor_t **y, int64_t kern
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    if ((!x->requires_gradient) || no_gradient)
-    {
-        if (u != x_toeplitz)
-        {
-            tensor_destroy(x_toeplitz);
-        }
-
-        if (x != x_reshape)
-        {
-            tensor_destroy(x_reshape);
-        }
-
-        if (*y != u)
-        {
-            tensor_destroy(u);
-        }
-    }
-
     return error;
 }
+
 nw_error_t *tensor_convolution_transpose_2d(const tensor_t *w, const tensor_t *x, const tensor_t *y, tensor_t **z, int64_t stride, int64_t padding)
 {
     CHECK_NULL_ARGUMENT(w, "w");
@@ -2310,12 +2072,12 @@ nw_error_t *tensor_convolution_transpose_2d(const tensor_t *w, const tensor_t *x
     tensor_t *y_reshape = NULL;
     tensor_t *v = NULL;
     tensor_t *u = NULL;
-    int64_t batch_size = w->buffer->view->shape[0];
-    int64_t in_height = w->buffer->view->shape[2];
-    int64_t in_width = w->buffer->view->shape[3];
-    int64_t in_channels = x->buffer->view->shape[0];
-    int64_t out_channels = x->buffer->view->shape[1];
-    int64_t kernel_size = x->buffer->view->shape[2];
+    int64_t batch_size = w->buffer->view.shape[0];
+    int64_t in_height = w->buffer->view.shape[2];
+    int64_t in_width = w->buffer->view.shape[3];
+    int64_t in_channels = x->buffer->view.shape[0];
+    int64_t out_channels = x->buffer->view.shape[1];
+    int64_t kernel_size = x->buffer->view.shape[2];
     int64_t out_height = (in_height - 1) * stride - 2 * padding + (kernel_size - 1) + 1;
     int64_t out_width = (in_width - 1) * stride - 2 * padding + (kernel_size - 1) + 1;
 
@@ -2427,10 +2189,9 @@ nw_error_t *tensor_item(const tensor_t *x, void *value)
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
     CHECK_NULL_ARGUMENT(x->buffer->storage->data, "x->buffer->storage->data");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(value, "value");
 
-    if (x->buffer->view->rank)
+    if (x->buffer->view.rank)
     {
         return ERROR(ERROR_RANK, string_create("tensor must be rank zero."), NULL);
     }
@@ -2445,6 +2206,18 @@ nw_error_t *tensor_item(const tensor_t *x, void *value)
     case FLOAT64:
         *(float64_t *) value = *(float64_t *) x->buffer->storage->data;
         break;
+    case BFLOAT16:
+        *(float32_t *) value = bfloat16_to_float32(*(bfloat16_t *) x->buffer->storage->data);
+        break;
+    case FLOAT16:
+        *(float32_t *) value = float16_to_float32(*(float16_t *) x->buffer->storage->data);
+        break;
+    case INT32:
+        *(float64_t *) value = (float64_t) *(int32_t *) x->buffer->storage->data;
+        break;
+    case INT64:
+        *(float64_t *) value = (float64_t) *(int64_t *) x->buffer->storage->data;
+        break;
     default:
         return ERROR(ERROR_DATATYPE, string_create("unknown datatype %d.", (int) x->buffer->storage->datatype), NULL);
     }
@@ -2463,12 +2236,10 @@ nw_error_t *tensor_argument_maximum(const tensor_t *x, tensor_t **y, int64_t axi
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
-    CHECK_NULL_ARGUMENT(x->buffer->view->shape, "x->buffer->view->shape");
     CHECK_NULL_ARGUMENT(y, "y");
     nw_error_t *error = NULL;
-    int64_t *shape = x->buffer->view->shape;
-    int64_t rank = x->buffer->view->rank;
+    int64_t *shape = x->buffer->view.shape;
+    int64_t rank = x->buffer->view.rank;
     axis = dimension_to_index(axis, rank);
 
     if ((!rank && axis) || (rank && axis >= rank))
@@ -2476,6 +2247,27 @@ nw_error_t *tensor_argument_maximum(const tensor_t *x, tensor_t **y, int64_t axi
         return ERROR(ERROR_AXIS, string_create("axis out of range of tensor."), NULL);
     }
 
+    // Integer tensors are searched natively, the float path below would compare float64 copies of them.
+    if (datatype_is_integer(x->buffer->storage->datatype))
+    {
+        buffer_t *buffer = NULL;
+
+        error = buffer_argument_maximum(x->buffer, axis, &buffer, keep_dimension);
+        if (error)
+        {
+            return ERROR(ERROR_MAXIMUM, string_create("failed to get argument maximum of buffer."), error);
+        }
+
+        error = tensor_create(y, buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            buffer_destroy(buffer);
+            return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+        }
+
+        return error;
+    }
+
     with_no_gradient(true);
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
@@ -2484,7 +2276,7 @@ nw_error_t *tensor_argument_maximum(const tensor_t *x, tensor_t **y, int64_t axi
     int64_t new_shape[new_rank];
     int64_t *reduce_axis = (rank) ? ((int64_t[]) {axis}) : ((int64_t[]){});
     int64_t reduce_rank = (rank) ? 1 : 0;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     void *value = NULL;
     void *start = NULL;
     void *stop = NULL;
@@ -2496,6 +2288,7 @@ nw_error_t *tensor_argument_maximum(const tensor_t *x, tensor_t **y, int64_t axi
     tensor_t *x_m = NULL;
     tensor_t *x_n = NULL;
     tensor_t *x_o = NULL;
+    tensor_t *x_p = NULL;
 
     value = (void *) malloc(size);
     if (!value)
@@ -2525,7 +2318,7 @@ nw_error_t *tensor_argument_maximum(const tensor_t *x, tensor_t **y, int64_t axi
         goto cleanup;
     }
     
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) value = (float32_t) dimension;
@@ -2602,13 +2395,21 @@ nw_error_t *tensor_argument_maximum(const tensor_t *x, tensor_t **y, int64_t axi
         goto cleanup;
     }
     
-    error = tensor_subtraction(x_o, x_n, y);
+    error = tensor_subtraction(x_o, x_n, &x_p);
     if (error)
     {
         error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
         goto cleanup;
     }
 
+    // Indices are returned as int64 regardless of the datatype of x.
+    error = tensor_cast(x_p, INT64, y);
+    if (error)
+    {
+        error = ERROR(ERROR_DATATYPE, string_create("failed to cast tensor."), error);
+        goto cleanup;
+    }
+
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("y", *y);
@@ -2637,6 +2438,7 @@ cleanup:
     }
     tensor_destroy(x_n);
     tensor_destroy(x_o);
+    tensor_destroy(x_p);
 
     return error;
 }
@@ -2649,7 +2451,7 @@ nw_error_t *tensor_number_of_elements(const tensor_t *x, int64_t *n)
 
     nw_error_t *error = NULL;
 
-    error = view_logical_size(x->buffer->view, n);
+    error = view_logical_size(&x->buffer->view, n);
     if (error)
     {
         return ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
@@ -2664,6 +2466,14 @@ nw_error_t *tensor_constant(void *constant, datatype_t datatype, runtime_t runti
     CHECK_NULL_ARGUMENT(x, "x");
 
     nw_error_t *error = NULL;
+    int64_t converted;
+
+    // Constants are given in the compute datatype and rounded to reduced precision or integer storage.
+    if (datatype_compute(datatype) != datatype)
+    {
+        runtime_convert(datatype_compute(datatype), constant, datatype, &converted, 1);
+        constant = &converted;
+    }
 
     error = tensor_from_data(x, constant, runtime, datatype, 0, (int64_t[]){}, true, requires_gradient, persist);
     if (error)
@@ -2693,7 +2503,7 @@ nw_error_t *tensor_mean(const tensor_t *x, tensor_t **y, const int64_t *axis, in
     tensor_t *x_j = NULL;
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
 
     value = (void *) malloc(size);
     if (!value)
@@ -2725,7 +2535,7 @@ nw_error_t *tensor_mean(const tensor_t *x, tensor_t **y, const int64_t *axis, in
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) value = (float32_t) n_i / (float32_t) n;
@@ -2794,18 +2604,18 @@ nw_error_t *tensor_variance(const tensor_t *x, tensor_t **y, const int64_t *axis
     tensor_t *x_m = NULL;
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     int64_t n, n_i;
-    view_t *view = NULL;
+    view_t view;
 
-    error = view_reduce(x->buffer->view, &view, axis, length, keep_dimension);
+    error = view_reduce(&x->buffer->view, &view, axis, length, keep_dimension);
     if (error)
     {
         error = ERROR(ERROR_REDUCTION, string_create("failed to reduce tensor."), error);
         goto cleanup;
     }
 
-    error = view_logical_size(view, &n_i);
+    error = view_logical_size(&view, &n_i);
     if (error)
     {
         error = ERROR(ERROR_N, string_create("failed to get number of elements of tensor."), error);
@@ -2860,7 +2670,7 @@ nw_error_t *tensor_variance(const tensor_t *x, tensor_t **y, const int64_t *axis
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) value = (float32_t) n / (float32_t) n_i;
@@ -2903,7 +2713,6 @@ nw_error_t *tensor_variance(const tensor_t *x, tensor_t **y, const int64_t *axis
 cleanup:
 
     free(value);
-    view_destroy(view);
     if (!x->requires_gradient || no_gradient)
     {
         if (x_i != x)
@@ -3014,74 +2823,6 @@ cleanup:
     return error;
 }
 
-static nw_error_t *softmax(const tensor_t *x, tensor_t **y_max, tensor_t **y_num, tensor_t **y_den, int64_t axis)
-{
-    PRINTLN_DEBUG_LOCATION("input");
-    PRINTLN_DEBUG_TENSOR("x", x);
-    PRINTF_DEBUG("axis %ld\n", axis);
-    PRINT_DEBUG_NEWLINE;
-
-    CHECK_NULL_ARGUMENT(x, "x");
-    CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
-    CHECK_NULL_ARGUMENT(y_max, "y_max");
-    CHECK_NULL_ARGUMENT(y_num, "y_num");
-    CHECK_NULL_ARGUMENT(y_den, "y_den");
-
-    nw_error_t *error = NULL;
-    tensor_t *x_i = NULL;
-    int64_t rank = x->buffer->view->rank;
-    int64_t *reduce_axis = (rank) ? ((int64_t[]) {axis}) : ((int64_t[]){});
-    int64_t reduce_rank = (rank) ? 1 : 0;
-
-    error = tensor_maximum(x, &x_i, reduce_axis, reduce_rank, true);
-    if (error)
-    {
-        error = ERROR(ERROR_MAXIMUM, string_create("failed to get maximum of tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_subtraction(x, x_i, y_max);
-    if (error)
-    {
-        error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
-        goto cleanup;
-    }
-
-    error = tensor_exponential(*y_max, y_num);
-    if (error)
-    {
-        error = ERROR(ERROR_EXPONENTIAL, string_create("failed to exponentiate tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_summation(*y_num, y_den, reduce_axis, reduce_rank, true);
-    if (error)
-    {
-        error = ERROR(ERROR_SUMMATION, string_create("failed to sum tensor."), error);
-        goto cleanup;
-    }
-
-    PRINTLN_DEBUG_LOCATION("output");
-    PRINTLN_DEBUG_TENSOR("x", x);
-    PRINTLN_DEBUG_TENSOR("y_max", *y_max);
-    PRINTLN_DEBUG_TENSOR("y_num", *y_num);
-    PRINTLN_DEBUG_TENSOR("y_den", *y_den);
-    PRINT_DEBUG_NEWLINE;
-
-cleanup:
-
-    if (!x->requires_gradient || no_gradient)
-    {
-        if (x != x_i)
-        {
-            tensor_destroy(x_i);
-        }
-    }
-
-    return error;
-}
-
 nw_error_t *tensor_softmax(const tensor_t *x, tensor_t **y, int64_t axis)
 {
     PRINTLN_DEBUG_LOCATION("input");
@@ -3090,25 +2831,17 @@ nw_error_t *tensor_softmax(const tensor_t *x, tensor_t **y, int64_t axis)
     PRINT_DEBUG_NEWLINE;
 
     CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    tensor_t *x_i = NULL;
-    tensor_t *x_j = NULL;
-    tensor_t *x_k = NULL;
-
-    error = softmax(x, &x_i, &x_j, &x_k, axis);
-    if (error)
-    {
-        error = ERROR(ERROR_SOFTMAX, string_create("failed to softmax tensor."), error);
-        goto cleanup;
-    }
+    int64_t rank = x->buffer->view.rank;
+    int64_t arguments[] = {(rank) ? dimension_to_index(axis, rank) : 0};
 
-    error = tensor_division(x_j, x_k, y);
+    error = apply_operation_structure(SOFTMAX_OPERATION, x, arguments, 1, y);
     if (error)
     {
-        error = ERROR(ERROR_DIVISION, string_create("failed to divide tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_SOFTMAX, string_create("failed to softmax tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
@@ -3116,18 +2849,6 @@ nw_error_t *tensor_softmax(const tensor_t *x, tensor_t **y, int64_t axis)
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    if (!x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(x_i);
-        if (x_j != x_k)
-        {
-            tensor_destroy(x_j);
-        }
-        tensor_destroy(x_k);
-    }
-
     return error;
 }
 
@@ -3139,33 +2860,17 @@ nw_error_t *tensor_logsoftmax(const tensor_t *x, tensor_t **y, int64_t axis)
     PRINT_DEBUG_NEWLINE;
 
     CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    tensor_t *x_i = NULL;
-    tensor_t *x_j = NULL;
-    tensor_t *x_k = NULL;
-    tensor_t *x_l = NULL;
+    int64_t rank = x->buffer->view.rank;
+    int64_t arguments[] = {(rank) ? dimension_to_index(axis, rank) : 0};
 
-    error = softmax(x, &x_i, &x_j, &x_k, axis);
+    error = apply_operation_structure(LOGSOFTMAX_OPERATION, x, arguments, 1, y);
     if (error)
     {
-        error = ERROR(ERROR_SOFTMAX, string_create("failed to softmax tensor."), error);
-        goto cleanup;
-    }
-    
-    error = tensor_logarithm(x_k, &x_l);
-    if (error)
-    {
-        error = ERROR(ERROR_LOGARITHM, string_create("failed to log tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_subtraction(x_i, x_l, y);
-    if (error)
-    {
-        error = ERROR(ERROR_SUBTRACTION, string_create("failed to subtract tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_SOFTMAX, string_create("failed to log softmax tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
@@ -3173,16 +2878,6 @@ nw_error_t *tensor_logsoftmax(const tensor_t *x, tensor_t **y, int64_t axis)
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    if (!x->requires_gradient || no_gradient)
-    {
-        tensor_destroy(x_i);
-        tensor_destroy(x_j);
-        tensor_destroy(x_k);
-        tensor_destroy(x_l);
-    }
-
     return error;
 }
 
@@ -3194,7 +2889,7 @@ nw_error_t *tensor_is_contiguous(const tensor_t *x, bool_t *is_contiguous)
 
     nw_error_t *error = NULL;
 
-    error = view_is_contiguous(x->buffer->view, is_contiguous);
+    error = view_is_contiguous(&x->buffer->view, is_contiguous);
     if (error)
     {
         return ERROR(ERROR_CONTIGUOUS, string_create("failed to determin if view is contiguous."), error);
@@ -3238,7 +2933,7 @@ nw_error_t *tensor_reshape(const tensor_t *x, tensor_t **y, const int64_t *shape
         }
     }
 
-    if (view_has_shape(x->buffer->view, actual_shape, length))
+    if (view_has_shape(&x->buffer->view, actual_shape, length))
     {
         *y = (tensor_t *) x;
     }
@@ -3357,8 +3052,8 @@ nw_error_t *tensor_padding(const tensor_t *x, tensor_t **y, int64_t *arguments,
 
 bool_t tensor_shapes_equal(const tensor_t *x, const tensor_t *y)
 {
-    return x && y && x->buffer && y->buffer && x->buffer->view && y->buffer->view &&
-           view_shapes_equal(x->buffer->view, y->buffer->view);
+    return x && y && x->buffer && y->buffer &&
+           view_shapes_equal(&x->buffer->view, &y->buffer->view);
 }
 
 nw_error_t *tensor_transpose(const tensor_t *x, tensor_t **y, int64_t axis1, int64_t axis2)
@@ -3370,12 +3065,11 @@ nw_error_t *tensor_transpose(const tensor_t *x, tensor_t **y, int64_t axis1, int
 
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
 
-    int64_t rank = x->buffer->view->rank;
+    int64_t rank = x->buffer->view.rank;
     int64_t index1 = dimension_to_index(axis1, rank);
     int64_t index2 = dimension_to_index(axis2, rank);
     int64_t axis[rank];
@@ -3654,7 +3348,7 @@ nw_error_t *tensor_lower_triangular(const tensor_t *x, tensor_t **y)
     void *start = NULL, *stop = NULL, *step = NULL;
     runtime_t runtime = x->buffer->storage->runtime;
     datatype_t datatype = x->buffer->storage->datatype;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     tensor_t *x_i = NULL;
     tensor_t *x_j = NULL;
     tensor_t *x_k = NULL;
@@ -3662,8 +3356,8 @@ nw_error_t *tensor_lower_triangular(const tensor_t *x, tensor_t **y)
     tensor_t *x_m = NULL;
     tensor_t *x_n = NULL;
     tensor_t *x_o = NULL;
-    int64_t r = x->buffer->view->shape[x->buffer->view->rank - 2];
-    int64_t c = x->buffer->view->shape[x->buffer->view->rank - 1];
+    int64_t r = x->buffer->view.shape[x->buffer->view.rank - 2];
+    int64_t c = x->buffer->view.shape[x->buffer->view.rank - 1];
 
     start = (void *) malloc(size);
     if (!start)
@@ -3686,7 +3380,7 @@ nw_error_t *tensor_lower_triangular(const tensor_t *x, tensor_t **y)
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) start = (float32_t) 0.0;
@@ -3710,7 +3404,7 @@ nw_error_t *tensor_lower_triangular(const tensor_t *x, tensor_t **y)
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) start = (float32_t) -1.0;
@@ -3920,10 +3614,10 @@ nw_error_t *tensor_causal_multihead_self_attention(tensor_t *x, const tensor_t *
     tensor_t *attention_transpose = NULL;
     tensor_t *attention_reshaped = NULL;
     tensor_t *output_projection = NULL;
-    int64_t rank = x->buffer->view->rank;
-    int64_t batch_size = x->buffer->view->shape[0];
-    int64_t sequence_length = x->buffer->view->shape[1];
-    int64_t embedding_size = x->buffer->view->shape[2];
+    int64_t rank = x->buffer->view.rank;
+    int64_t batch_size = x->buffer->view.shape[0];
+    int64_t sequence_length = x->buffer->view.shape[1];
+    int64_t embedding_size = x->buffer->view.shape[2];
     int64_t head_size = embedding_size / number_of_heads;
 
     error = tensor_linear(x, input_weights, input_bias, &input_projection);
@@ -4100,9 +3794,9 @@ nw_error_t *tensor_scaled_dot_product_attention(const tensor_t *query, const ten
     tensor_t *attention_m = NULL;
     datatype_t datatype = query->buffer->storage->datatype;
     runtime_t runtime = query->buffer->storage->runtime;
-    int64_t d_k = key->buffer->view->shape[key->buffer->view->rank - 1];
-    int64_t T = query->buffer->view->shape[query->buffer->view->rank - 2];
-    size_t size = datatype_size(datatype);
+    int64_t d_k = key->buffer->view.shape[key->buffer->view.rank - 1];
+    int64_t T = query->buffer->view.shape[query->buffer->view.rank - 2];
+    size_t size = datatype_size(datatype_compute(datatype));
 
     scale = (void *) malloc(size);
     if (!scale)
@@ -4118,7 +3812,7 @@ nw_error_t *tensor_scaled_dot_product_attention(const tensor_t *query, const ten
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) scale = (float32_t) 1.0 / sqrtf((float32_t) d_k);
@@ -4293,7 +3987,7 @@ cleanup:
     return error;
 }
 
-nw_error_t *tensor_embedding(const tensor_t *x, const tensor_t *weights, const tensor_t *vocabulary_counter, tensor_t **z)
+nw_error_t *tensor_embedding(const tensor_t *x, const tensor_t *weights, const tensor_t *vocabulary_counter, bool_t sparse, tensor_t **z)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
@@ -4306,68 +4000,30 @@ nw_error_t *tensor_embedding(const tensor_t *x, const tensor_t *weights, const t
     CHECK_NULL_ARGUMENT(vocabulary_counter, "vocabulary_counter");
     CHECK_NULL_ARGUMENT(z, "z");
 
-    if (x->buffer->view->rank != 2 || weights->buffer->view->rank != 2 || vocabulary_counter->buffer->view->rank != 1)
+    if (x->buffer->view.rank != 2 || weights->buffer->view.rank != 2 || vocabulary_counter->buffer->view.rank != 1)
     {
         return ERROR(ERROR_RANK, string_create("rank conflict."), NULL);
     }
 
-    nw_error_t *error = NULL;
-    tensor_t *vocabulary_counter_reshaped = NULL;
-    tensor_t *x_reshaped = NULL;
-    tensor_t *one_hot = NULL;
-    int64_t batch_size = x->buffer->view->shape[0];
-    int64_t block_size = x->buffer->view->shape[1];
-    int64_t vocabulary_size = vocabulary_counter->buffer->view->shape[0];
-
-    error = tensor_reshape(vocabulary_counter, &vocabulary_counter_reshaped, (int64_t[]){1, 1, vocabulary_size}, 3);
-    if (error)
-    {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_reshape(x, &x_reshaped, (int64_t[]){batch_size, block_size, 1}, 3);
-    if (error)
+    if (vocabulary_counter->buffer->view.shape[0] != weights->buffer->view.shape[0])
     {
-        error = ERROR(ERROR_RESHAPE, string_create("failed to reshape tensor."), error);
-        goto cleanup;
+        return ERROR(ERROR_SHAPE, string_create("vocabulary size conflict."), NULL);
     }
 
-    error = tensor_compare_equal(x_reshaped, vocabulary_counter_reshaped, &one_hot);
-    if (error)
-    {
-        error = ERROR(ERROR_COMPARE_EQUAL, string_create("failed to compare equal tensors."), error);
-        goto cleanup;
-    }
+    nw_error_t *error = NULL;
 
-    error = tensor_matrix_multiplication(one_hot, weights, z);
+    // Rows of the weights are gathered by index, the cost does not depend on the vocabulary size.
+    // With `sparse` the weights receive a gradient holding only the gathered rows.
+    error = apply_operation_binary(EMBEDDING_OPERATION, weights, x, (int64_t[]){(int64_t) sparse}, 1, z);
     if (error)
     {
-        error = ERROR(ERROR_MATRIX_MULTIPLICATION, string_create("failed to matrix multiply tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_EMBEDDING, string_create("failed to embed tensor."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("z", *z);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
-
-    if (vocabulary_counter != vocabulary_counter_reshaped)
-    {
-        tensor_destroy(vocabulary_counter_reshaped);
-    }
-
-    if ((!x->requires_gradient || no_gradient) && x != x_reshaped)
-    {
-        tensor_destroy(x_reshaped);
-    }
-
-    if (!weights->requires_gradient || no_gradient)
-    {
-        tensor_destroy(one_hot);
-    }
-
     return error;
 }
 
@@ -4381,17 +4037,9 @@ nw_error_t *tensor_dropout(const tensor_t *x, tensor_t **y, void *probability, b
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    tensor_t *probability_constant = NULL;
-    tensor_t *scale = NULL;
-    tensor_t *mask = NULL;
-    tensor_t *rand_tensor = NULL;
-    tensor_t *x_i = NULL;
-    void *min = NULL;
-    void *max = NULL;
-    void *scalar = NULL;
     datatype_t datatype = x->buffer->storage->datatype;
-    runtime_t runtime = x->buffer->storage->runtime;
-    size_t size = datatype_size(datatype);
+    float64_t p;
+    int64_t n;
 
     if (inference || !probability || is_zero(probability, datatype))
     {
@@ -4399,210 +4047,208 @@ nw_error_t *tensor_dropout(const tensor_t *x, tensor_t **y, void *probability, b
         return error;
     }
 
-    min = (void *) malloc(size);
-    if (!min) 
+    switch (datatype_compute(datatype))
     {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
+    case FLOAT32:
+        p = (float64_t) *(float32_t *) probability;
+        break;
+    case FLOAT64:
+        p = *(float64_t *) probability;
+        break;
+    default:
+        return ERROR(ERROR_DATATYPE, string_create("unknown datatype."), NULL);
     }
 
-    max = (void *) malloc(size);
-    if (!max) 
+    if (p < 0.0 || p >= 1.0)
     {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    scalar = (void *) malloc(size);
-    if (!scalar) 
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    switch (datatype)
-    {
-    case FLOAT32:
-        *(float32_t *) min = (float32_t) 0.0;
-        *(float32_t *) max = (float32_t) 1.0;
-        *(float32_t *) scalar = (float32_t) 1.0 / ((float32_t) 1.0 - *(float32_t *) probability);
-        break;
-    case FLOAT64:
-        *(float64_t *) min = (float64_t) 0.0;
-        *(float64_t *) max = (float64_t) 1.0;
-        *(float64_t *) scalar = (float64_t) 1.0 / ((float64_t) 1.0 - *(float64_t *) probability);
-        break;
-    default:
-        error = ERROR(ERROR_DATATYPE, string_create("unknown datatype."), NULL);
-        goto cleanup;
-    }
-
-    error = tensor_constant(probability, datatype, runtime, false, false, &probability_constant);
-    if (error)
-    {
-        return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+        return ERROR(ERROR_DROPOUT, string_create("dropout probability must be in [0, 1), got %lf.", p), NULL);
     }
 
-    error = tensor_constant(scalar, datatype, runtime, false, false, &scale);
+    error = view_logical_size(&x->buffer->view, &n);
     if (error)
     {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_create_uniform(&rand_tensor, x->buffer->view->shape, x->buffer->view->rank, runtime, datatype, false, false, min, max);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
-        goto cleanup;
-    }
-
-    error = tensor_compare_greater(rand_tensor, probability_constant, &mask);
-    if (error)
-    {
-        error = ERROR(ERROR_COMPARE_GREATER, string_create("failed to compare greater tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_N, string_create("failed to get logical size of view."), error);
     }
 
-    error = tensor_multiplication(x, mask, &x_i);
-    if (error)
-    {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
-    }
+    // An element is dropped when its 32-bit Philox word is below p * 2^32. The counters are
+    // reserved here so that the mask can be regenerated in the backward pass.
+    int64_t arguments[] = {
+        (int64_t) get_seed(),
+        (int64_t) random_reserve((uint64_t) (n + 3) / 4),
+        (int64_t) fmin(round(p * 0x1p32), (float64_t) UINT32_MAX),
+    };
 
-    error = tensor_multiplication(x_i, scale, y);
+    error = apply_operation_structure(DROPOUT_OPERATION, x, arguments, 3, y);
     if (error)
     {
-        error = ERROR(ERROR_MULTIPLICATION, string_create("failed to multiply tensors."), error);
-        goto cleanup;
+        return ERROR(ERROR_DROPOUT, string_create("failed to apply dropout."), error);
     }
 
     PRINTLN_DEBUG_LOCATION("output");
     PRINTLN_DEBUG_TENSOR("y", *y);
     PRINT_DEBUG_NEWLINE;
 
-cleanup:
+    return error;
+}
 
-    free(scalar);
-    free(min);
-    free(max);
-    
-    tensor_destroy(probability_constant);
-    tensor_destroy(rand_tensor);
-    tensor_destroy(scale);
+/**
+ * @brief Get the operands of the operation that produced `tensor`, leaves have none.
+ * @param[out] operands At least two entries, the first `length` are set.
+ * @param[out] length Number of operands.
+ */
+static nw_error_t *tensor_operands(const tensor_t *tensor, tensor_t **operands, int64_t *length)
+{
+    *length = 0;
 
-    if (!x->requires_gradient || no_gradient)
+    if (!tensor->context)
     {
-        tensor_destroy(mask);
-        tensor_destroy(x_i);
+        return NULL;
     }
 
-    return error;
+    operation_t *operation = tensor->context->operation;
+    operation_type_t operation_type = tensor->context->operation_type;
+
+    switch (operation_type)
+    {
+    case UNARY_OPERATION:
+        if (!operation->unary_operation)
+        {
+            return ERROR(ERROR_NULL, string_create("operation is null."), NULL);
+        }
+        operands[(*length)++] = operation->unary_operation->x;
+        break;
+    case BINARY_OPERATION:
+        if (!operation->binary_operation)
+        {
+            return ERROR(ERROR_NULL, string_create("operation is null."), NULL);
+        }
+        operands[(*length)++] = operation->binary_operation->x;
+        operands[(*length)++] = operation->binary_operation->y;
+        break;
+    case REDUCTION_OPERATION:
+        if (!operation->reduction_operation)
+        {
+            return ERROR(ERROR_NULL, string_create("operation is null."), NULL);
+        }
+        operands[(*length)++] = operation->reduction_operation->x;
+        break;
+    case STRUCTURE_OPERATION:
+        if (!operation->structure_operation)
+        {
+            return ERROR(ERROR_NULL, string_create("operation is null."), NULL);
+        }
+        operands[(*length)++] = operation->structure_operation->x;
+        break;
+    case CREATION_OPERATION:
+        // Leaf node
+        break;
+    default:
+        return ERROR(ERROR_OPERATION_TYPE, string_create("unknown operation type %d.", (int) operation_type), NULL);
+    }
+
+    return NULL;
 }
 
-static nw_error_t *topological_sort(tensor_t *tensor, map_t *visited, stack_t *tensors)
+typedef struct topological_frame_t
+{
+    tensor_t *tensor;
+    int64_t operand;
+} topological_frame_t;
+
+/**
+ * @brief Push the graph ending in `tensor` onto `tensors` in post order, so popping yields a topological order.
+ *        The depth first search keeps its path in an explicit frame array rather than on the call stack,
+ *        and marks visited tensors in a bitset indexed by id, ids are dense since they are recycled.
+ */
+static nw_error_t *topological_sort(tensor_t *tensor, stack_t *tensors)
 {
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("tensor", tensor);
     PRINT_DEBUG_NEWLINE;
 
     CHECK_NULL_ARGUMENT(tensor, "tensor");
-    CHECK_NULL_ARGUMENT(visited, "visited");
     CHECK_NULL_ARGUMENT(tensors, "tensors");
 
     nw_error_t *error = NULL;
-    string_t id = string_create("%lu", tensor->id);
-    function_t *context = tensor->context;
+    size_t words = (size_t) (id / 64 + 1);
+    uint64_t *visited = NULL;
+    topological_frame_t *frames = NULL;
+    int64_t capacity = 64;
+    int64_t depth = 0;
 
-    if (map_contains(visited, id))
+    visited = (uint64_t *) calloc(words, sizeof(uint64_t));
+    if (!visited)
     {
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", words * sizeof(uint64_t)), NULL);
         goto cleanup;
     }
 
-    if (context)
+    frames = (topological_frame_t *) malloc(capacity * sizeof(topological_frame_t));
+    if (!frames)
     {
-        operation_t *operation = tensor->context->operation;
-        operation_type_t operation_type = tensor->context->operation_type;
-        
-        switch (operation_type)
+        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", capacity * sizeof(topological_frame_t)), NULL);
+        goto cleanup;
+    }
+
+    visited[tensor->id / 64] |= (uint64_t) 1 << (tensor->id % 64);
+    frames[depth++] = (topological_frame_t) {tensor, 0};
+
+    while (depth > 0)
+    {
+        topological_frame_t *frame = &frames[depth - 1];
+        tensor_t *operands[2];
+        int64_t length;
+
+        error = tensor_operands(frame->tensor, operands, &length);
+        if (error)
         {
-        case UNARY_OPERATION:
-            if (operation->unary_operation)
-            {
-                error = topological_sort(operation->unary_operation->x, visited, tensors);
-            }
-            else
-            {
-                error = ERROR(ERROR_NULL, string_create("operation is null."), NULL);
-            }
-            break;
-        case BINARY_OPERATION:
-            if (operation->binary_operation)
-            {
-                error = topological_sort(operation->binary_operation->x, visited, tensors);
-                if (!error)
-                {
-                    error = topological_sort(operation->binary_operation->y, visited, tensors);
-                }
-            }
-            else
-            {
-                error = ERROR(ERROR_NULL, string_create("operation is null."), NULL);
-            }
-            break;
-        case REDUCTION_OPERATION:
-            if (operation->reduction_operation)
-            {
-                error = topological_sort(operation->reduction_operation->x, visited, tensors);
-            }
-            else
-            {
-                error = ERROR(ERROR_NULL, string_create("operation is null."), NULL);
-            }
-            break;
-        case STRUCTURE_OPERATION:
-            if (operation->structure_operation)
-            {
-                error = topological_sort(operation->structure_operation->x, visited, tensors);
-            }
-            else
+            error = ERROR(ERROR_SORT, string_create("failed to topologically sort computational graph."), error);
+            goto cleanup;
+        }
+
+        if (frame->operand == length)
+        {
+            error = stack_push(tensors, frame->tensor);
+            if (error)
             {
-                error = ERROR(ERROR_NULL, string_create("operation is null."), NULL);
+                error = ERROR(ERROR_PUSH, string_create("failed to push tensor to stack."), error);
+                goto cleanup;
             }
-            break;
-        case CREATION_OPERATION:
-            // Leaf node
-            break;
-        default:
-            error = ERROR(ERROR_OPERATION_TYPE, string_create("unknown operation type %d.", (int) operation_type), NULL);
-            break;
+            --depth;
+            continue;
         }
 
-        if (error)
+        tensor_t *operand = operands[frame->operand++];
+        if (!operand)
         {
-            error = ERROR(ERROR_SORT, string_create("failed to topologically sort computational graph."), error);
+            error = ERROR(ERROR_NULL, string_create("received null operand."), NULL);
             goto cleanup;
         }
-    }
 
-    error = stack_push(tensors, tensor);
-    if (error)
-    {
-        error = ERROR(ERROR_PUSH, string_create("failed to push tensor to stack."), error);
-        goto cleanup;
-    }
+        if (visited[operand->id / 64] & ((uint64_t) 1 << (operand->id % 64)))
+        {
+            continue;
+        }
+        visited[operand->id / 64] |= (uint64_t) 1 << (operand->id % 64);
 
-    error = map_set(visited, id, NULL);
-    if (error)
-    {
-        error = ERROR(ERROR_SET, string_create("failed set tensor in map."), error);
-        goto cleanup;
+        if (depth == capacity)
+        {
+            topological_frame_t *resized = (topological_frame_t *) realloc(frames, 2 * capacity * sizeof(topological_frame_t));
+            if (!resized)
+            {
+                error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", 2 * capacity * sizeof(topological_frame_t)), NULL);
+                goto cleanup;
+            }
+            frames = resized;
+            capacity *= 2;
+        }
+        frames[depth++] = (topological_frame_t) {operand, 0};
     }
 
 cleanup:
 
-    string_destroy(id);
+    free(visited);
+    free(frames);
 
     return error;
 }
@@ -4623,7 +4269,7 @@ nw_error_t *tensor_arange(tensor_t **x, void *start, void *stop, void *step, run
     const void *arguments[] = {start, stop, step};
     int64_t length = 3;
     
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *shape = (int64_t) ((*(float32_t *) stop - *(float32_t *) start) / *(float32_t *) step);
@@ -4651,13 +4297,12 @@ nw_error_t *tensor_zeroes_like(const tensor_t *x, tensor_t **y, bool_t requires_
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    int64_t *shape = x->buffer->view->shape;
-    int64_t rank = x->buffer->view->rank;
+    int64_t *shape = x->buffer->view.shape;
+    int64_t rank = x->buffer->view.rank;
     datatype_t datatype = x->buffer->storage->datatype;
     runtime_t runtime = x->buffer->storage->runtime;
 
@@ -4674,13 +4319,12 @@ nw_error_t *tensor_ones_like(const tensor_t *x, tensor_t **y, bool_t requires_gr
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    int64_t *shape = x->buffer->view->shape;
-    int64_t rank = x->buffer->view->rank;
+    int64_t *shape = x->buffer->view.shape;
+    int64_t rank = x->buffer->view.rank;
     datatype_t datatype = x->buffer->storage->datatype;
     runtime_t runtime = x->buffer->storage->runtime;
 
@@ -4826,43 +4470,18 @@ cleanup:
 
 static nw_error_t *compute_fan(const int64_t *shape, int64_t rank, int64_t *fan, bool_t mode)
 {
-    if (!mode)
+    if (rank == 2)
     {
-        if (rank == 2)
-        {
-            *fan = shape[0];
-        }
-        else if (rank == 4)
-        {
-            *fan = shape[1] * shape[2] * shape[3];
-        }
-        else if (rank == 5)
-        {
-            *fan = shape[1] * shape[2] * shape[3] * shape[3];
-        }
-        else
-        {
-            return ERROR(ERROR_RANK, string_create("unable to compute fan_in for tensor."), NULL);
-        }
+        *fan = (mode) ? shape[1] : shape[0];
+    }
+    else if (rank > 2)
+    {
+        // Convolution weights are (out_channels, in_channels, *kernel), the fan scales with the receptive field.
+        *fan = array_product(&shape[2], rank - 2) * ((mode) ? shape[0] : shape[1]);
     }
     else
     {
-        if (rank == 2)
-        {
-            *fan = shape[1];
-        }
-        else if (rank == 4)
-        {
-            *fan = shape[0] * shape[2] * shape[3];
-        }
-        else if (rank == 5)
-        {
-            *fan = shape[0] * shape[2] * shape[3] * shape[3];
-        }
-        else
-        {
-            return ERROR(ERROR_RANK, string_create("unable to compute fan_out for tensor."), NULL);
-        }
+        return ERROR(ERROR_RANK, string_create("unable to compute %s for tensor.", (mode) ? "fan_out" : "fan_in"), NULL);
     }
 
     return NULL;
@@ -4878,7 +4497,7 @@ nw_error_t *tensor_create_kaiming_uniform(tensor_t **x, const int64_t *shape, in
     nw_error_t *error = NULL;
     void *lower_bound = NULL;
     void *upper_bound = NULL;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     int64_t fan = 0;
 
     error = compute_fan(shape, rank, &fan, mode);
@@ -4902,7 +4521,7 @@ nw_error_t *tensor_create_kaiming_uniform(tensor_t **x, const int64_t *shape, in
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) upper_bound = *(float32_t *) gain * sqrtf(3.0 / (float32_t) fan);
@@ -4942,7 +4561,7 @@ nw_error_t *tensor_create_kaiming_normal(tensor_t **x, const int64_t *shape, int
     nw_error_t *error = NULL;
     void *mean = NULL;
     void *standard_deviation = NULL;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     int64_t fan = 0;
 
     error = compute_fan(shape, rank, &fan, mode);
@@ -4966,7 +4585,7 @@ nw_error_t *tensor_create_kaiming_normal(tensor_t **x, const int64_t *shape, int
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) standard_deviation = *(float32_t *) gain / sqrtf((float32_t) fan);
@@ -5006,7 +4625,7 @@ nw_error_t *tensor_create_glorot_uniform(tensor_t **x, const int64_t *shape, int
     nw_error_t *error = NULL;
     void *lower_bound = NULL;
     void *upper_bound = NULL;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     int64_t fan_in = 0, fan_out = 0;
 
     error = compute_fan(shape, rank, &fan_in, false);
@@ -5037,7 +4656,7 @@ nw_error_t *tensor_create_glorot_uniform(tensor_t **x, const int64_t *shape, int
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) upper_bound = *(float32_t *) gain * sqrtf(6.0 / ((float32_t) fan_in + (float32_t) fan_out));
@@ -5077,7 +4696,7 @@ nw_error_t *tensor_create_glorot_normal(tensor_t **x, const int64_t *shape, int6
     nw_error_t *error = NULL;
     void *mean = NULL;
     void *standard_deviation = NULL;
-    size_t size = datatype_size(datatype);
+    size_t size = datatype_size(datatype_compute(datatype));
     int64_t fan_in = 0, fan_out = 0;
 
     error = compute_fan(shape, rank, &fan_in, false);
@@ -5108,7 +4727,7 @@ nw_error_t *tensor_create_glorot_normal(tensor_t **x, const int64_t *shape, int6
         goto cleanup;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         *(float32_t *) standard_deviation = *(float32_t *) gain * sqrtf(2.0 / ((float32_t) fan_in + (float32_t) fan_out));
@@ -5149,13 +4768,12 @@ nw_error_t *tensor_empty_like(const tensor_t *x, tensor_t **y, bool_t requires_g
 
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
     CHECK_NULL_ARGUMENT(x->buffer->storage, "x->buffer->storage");
     CHECK_NULL_ARGUMENT(y, "y");
 
     nw_error_t *error = NULL;
-    int64_t *shape = x->buffer->view->shape;
-    int64_t rank = x->buffer->view->rank;
+    int64_t *shape = x->buffer->view.shape;
+    int64_t rank = x->buffer->view.rank;
     datatype_t datatype = x->buffer->storage->datatype;
     runtime_t runtime = x->buffer->storage->runtime;
 
@@ -5206,8 +4824,6 @@ nw_error_t *tensor_backward(tensor_t *x, tensor_t *gradient)
 {
     CHECK_NULL_ARGUMENT(x, "x");
     CHECK_NULL_ARGUMENT(x->buffer, "x->buffer");
-    CHECK_NULL_ARGUMENT(x->buffer->view, "x->buffer->view");
-
     PRINTLN_DEBUG_LOCATION("input");
     PRINTLN_DEBUG_TENSOR("x", x);
     PRINTLN_DEBUG_TENSOR("x->gradient", x->gradient);
@@ -5217,12 +4833,11 @@ nw_error_t *tensor_backward(tensor_t *x, tensor_t *gradient)
     with_no_gradient(true);
     nw_error_t *error = NULL;
     stack_t *tensors = NULL;
-    map_t *visited = NULL;
     tensor_t *y = NULL;
 
     if (!gradient)
     {
-        if (x->buffer->view->rank)
+        if (x->buffer->view.rank)
         {
             return ERROR(ERROR_RANK, string_create("gradient only implicitly created for scalars"), NULL);
         }
@@ -5241,14 +4856,7 @@ nw_error_t *tensor_backward(tensor_t *x, tensor_t *gradient)
         goto cleanup;
     }
 
-    error = map_create(&visited);
-    if (error)
-    {
-        error = ERROR(ERROR_CREATE, string_create("failed to create map."), error);
-        goto cleanup;
-    }
-
-    error = topological_sort(x, visited, tensors);
+    error = topological_sort(x, tensors);
     if (error)
     {
         error = ERROR(ERROR_SORT, string_create("failed to topologically sort tensors."), error);
@@ -5283,7 +4891,6 @@ nw_error_t *tensor_backward(tensor_t *x, tensor_t *gradient)
 
 cleanup:
 
-    map_destroy(visited);
     stack_destroy(tensors);
     with_no_gradient(false);
     
@@ -5317,6 +4924,68 @@ nw_error_t *tensor_as_tensor(const tensor_t *x, tensor_t **y)
     return error;
 }
 
+/**
+ * @brief Copy a tensor into a new contiguous tensor of another datatype. 
+ *        Casts are not differentiable, the result is a leaf that does not require a gradient.
+ */
+nw_error_t *tensor_cast(const tensor_t *x, datatype_t datatype, tensor_t **y)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTF_DEBUG("datatype %s\n", datatype_string(datatype));
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(y, "y");
+
+    nw_error_t *error = NULL;
+    buffer_t *buffer = NULL;
+
+    error = buffer_cast(x->buffer, datatype, &buffer);
+    if (error)
+    {
+        return ERROR(ERROR_DATATYPE, string_create("failed to cast tensor to %s.", datatype_string(datatype)), error);
+    }
+
+    error = tensor_create(y, buffer, NULL, NULL, false, false);
+    if (error)
+    {
+        buffer_destroy(buffer);
+        return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+    }
+
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("y", *y);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
+/**
+ * @brief Whether the dense gradient of `x` can be written in place: it is not tracked by autograd
+ *        and is the only view of contiguous storage, so no other tensor observes the write.
+ *        Backward runs without gradient tracking, so gradients it produces are never tracked.
+ */
+static bool_t tensor_gradient_owned(const tensor_t *x)
+{
+    nw_error_t *error = NULL;
+    bool_t is_contiguous = false;
+
+    if (!x->gradient || x->gradient_rows || (!no_gradient && x->gradient->requires_gradient) || x->gradient->buffer->storage->reference_count != 1)
+    {
+        return false;
+    }
+
+    error = view_is_contiguous(&x->gradient->buffer->view, &is_contiguous);
+    if (error)
+    {
+        error_destroy(error);
+        return false;
+    }
+
+    return is_contiguous;
+}
+
 nw_error_t *tensor_accumulate_gradient(tensor_t *x, tensor_t *gradient)
 {
     PRINTLN_DEBUG_LOCATION("input");
@@ -5329,6 +4998,22 @@ nw_error_t *tensor_accumulate_gradient(tensor_t *x, tensor_t *gradient)
 
     nw_error_t *error = NULL;
 
+    error = tensor_dense_gradient(x);
+    if (error)
+    {
+        return ERROR(ERROR_CREATE, string_create("failed to create dense gradient."), error);
+    }
+
+    // Persistent tensors keep one gradient buffer across steps, every contribution is accumulated into it.
+    if (!x->gradient && x->persist)
+    {
+        error = tensor_zeroes_like(x, &x->gradient, false, true);
+        if (error)
+        {
+            return ERROR(ERROR_CREATE, string_create("failed create tensor."), error);
+        }
+    }
+
     if (!x->gradient)
     {
         error = tensor_as_tensor(gradient, &(x->gradient));
@@ -5337,6 +5022,14 @@ nw_error_t *tensor_accumulate_gradient(tensor_t *x, tensor_t *gradient)
             return ERROR(ERROR_CREATE, string_create("failed create tensor."), error);
         }
     }
+    else if ((no_gradient || !gradient->requires_gradient) && tensor_gradient_owned(x))
+    {
+        error = tensor_addition_inplace(x->gradient, gradient);
+        if (error)
+        {
+            return ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
+        }
+    }
     else
     {
         tensor_t *updated_gradient = NULL;
@@ -5358,3 +5051,180 @@ nw_error_t *tensor_accumulate_gradient(tensor_t *x, tensor_t *gradient)
     return error;
 }
 
+/**
+ * @brief Accumulate a gradient that only covers some rows of `x`.
+ *        While every contribution is row sparse the gradient of `x` is kept as its sorted distinct rows in `x->gradient_rows`
+ *        and one row of values per entry in `x->gradient`. A dense contribution turns it into a dense gradient.
+ * @param x Rank 2 tensor receiving the gradient.
+ * @param rows Sorted distinct int64 rows of the contribution.
+ * @param gradient Values of the contribution, one row per entry of `rows`.
+ */
+nw_error_t *tensor_accumulate_sparse_gradient(tensor_t *x, tensor_t *rows, tensor_t *gradient)
+{
+    PRINTLN_DEBUG_LOCATION("input");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("rows", rows);
+    PRINTLN_DEBUG_TENSOR("gradient", gradient);
+    PRINT_DEBUG_NEWLINE;
+
+    CHECK_NULL_ARGUMENT(x, "x");
+    CHECK_NULL_ARGUMENT(rows, "rows");
+    CHECK_NULL_ARGUMENT(gradient, "gradient");
+
+    nw_error_t *error = NULL;
+    buffer_t *rows_buffer = NULL;
+    buffer_t *buffer = NULL;
+    tensor_t *updated_rows = NULL;
+    tensor_t *updated_gradient = NULL;
+    tensor_t *dense_gradient = NULL;
+
+    if (!x->gradient)
+    {
+        error = tensor_as_tensor(gradient, &x->gradient);
+        if (!error)
+        {
+            error = tensor_as_tensor(rows, &x->gradient_rows);
+        }
+        if (error)
+        {
+            tensor_destroy(x->gradient);
+            x->gradient = NULL;
+            return ERROR(ERROR_CREATE, string_create("failed create tensor."), error);
+        }
+    }
+    else if (x->gradient_rows)
+    {
+        error = buffer_sparse_accumulate(x->gradient_rows->buffer, x->gradient->buffer, rows->buffer, gradient->buffer, &rows_buffer, &buffer);
+        if (error)
+        {
+            return ERROR(ERROR_ADDITION, string_create("failed to add sparse gradients."), error);
+        }
+
+        error = tensor_create(&updated_rows, rows_buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            buffer_destroy(rows_buffer);
+            buffer_destroy(buffer);
+            return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+        }
+
+        error = tensor_create(&updated_gradient, buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            tensor_destroy(updated_rows);
+            buffer_destroy(buffer);
+            return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+        }
+
+        tensor_destroy(x->gradient);
+        tensor_destroy(x->gradient_rows);
+        x->gradient = updated_gradient;
+        x->gradient_rows = updated_rows;
+    }
+    else
+    {
+        error = buffer_sparse_to_dense(rows->buffer, gradient->buffer, x->gradient->buffer->view.shape[0], &buffer);
+        if (error)
+        {
+            return ERROR(ERROR_CREATE, string_create("failed to create dense gradient."), error);
+        }
+
+        error = tensor_create(&dense_gradient, buffer, NULL, NULL, false, false);
+        if (error)
+        {
+            buffer_destroy(buffer);
+            return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+        }
+
+        error = tensor_addition(x->gradient, dense_gradient, &updated_gradient);
+        tensor_destroy(dense_gradient);
+        if (error)
+        {
+            return ERROR(ERROR_ADDITION, string_create("failed to add tensors."), error);
+        }
+        tensor_destroy(x->gradient);
+        x->gradient = updated_gradient;
+    }
+
+    PRINTLN_DEBUG_LOCATION("output");
+    PRINTLN_DEBUG_TENSOR("x", x);
+    PRINTLN_DEBUG_TENSOR("x->gradient", x->gradient);
+    PRINT_DEBUG_NEWLINE;
+
+    return error;
+}
+
+/**
+ * @brief Replace a row sparse gradient of `x` by the equivalent dense gradient, does nothing if it is already dense.
+ */
+nw_error_t *tensor_dense_gradient(tensor_t *x)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+
+    nw_error_t *error = NULL;
+    buffer_t *buffer = NULL;
+    tensor_t *gradient = NULL;
+
+    if (!x->gradient || !x->gradient_rows)
+    {
+        return error;
+    }
+
+    error = buffer_sparse_to_dense(x->gradient_rows->buffer, x->gradient->buffer, x->buffer->view.shape[0], &buffer);
+    if (error)
+    {
+        return ERROR(ERROR_CREATE, string_create("failed to create dense gradient."), error);
+    }
+
+    error = tensor_create(&gradient, buffer, NULL, NULL, false, false);
+    if (error)
+    {
+        buffer_destroy(buffer);
+        return ERROR(ERROR_CREATE, string_create("failed to create tensor."), error);
+    }
+
+    tensor_destroy(x->gradient);
+    tensor_destroy(x->gradient_rows);
+    x->gradient = gradient;
+    x->gradient_rows = NULL;
+
+    return error;
+}
+
+/**
+ * @brief Reset the gradient of `x` before the next backward pass.
+ *        A dense gradient owned by `x` is kept and cleared with memset, so the next backward accumulates into it
+ *        without allocating. Row sparse and shared gradients are released.
+ * @param set_to_none Release the gradient even if it could be kept.
+ */
+nw_error_t *tensor_zero_gradient(tensor_t *x, bool_t set_to_none)
+{
+    CHECK_NULL_ARGUMENT(x, "x");
+
+    nw_error_t *error = NULL;
+
+    if (!set_to_none && tensor_gradient_owned(x))
+    {
+        error = buffer_persist(x->gradient->buffer);
+        if (error)
+        {
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to move gradient out of the arena."), error);
+        }
+
+        error = buffer_zero(x->gradient->buffer);
+        if (error)
+        {
+            return ERROR(ERROR_ZERO_GRADIENT, string_create("failed to zero gradient."), error);
+        }
+
+        return error;
+    }
+
+    tensor_destroy(x->gradient);
+    tensor_destroy(x->gradient_rows);
+    x->gradient = NULL;
+    x->gradient_rows = NULL;
+
+    return error;
+}
+
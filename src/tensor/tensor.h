@@ -12,6 +12,7 @@
 // Forward declarations
 typedef struct function_t function_t;
 typedef struct buffer_t buffer_t;
+typedef struct quantization_t quantization_t;
 typedef enum runtime_t runtime_t;
 
 // Data Structure
@@ -21,6 +22,7 @@ typedef struct tensor_t
     buffer_t *buffer;
     function_t *context;
     struct tensor_t *gradient;
+    struct tensor_t *gradient_rows;
     bool_t requires_gradient;
     bool_t persist;
 } tensor_t;
@@ -80,10 +82,19 @@ nw_error_t *tensor_compare_greater(const tensor_t *x, const tensor_t *y, tensor_
 nw_error_t *tensor_max(const tensor_t *x, const tensor_t *y, tensor_t **z);
 nw_error_t *tensor_concatenation(const tensor_t *x, const tensor_t *y, tensor_t **z, int64_t axis);
 
+// In Place Operations
+nw_error_t *tensor_addition_inplace(tensor_t *x, const tensor_t *y);
+nw_error_t *tensor_subtraction_inplace(tensor_t *x, const tensor_t *y);
+nw_error_t *tensor_multiplication_inplace(tensor_t *x, const tensor_t *y);
+nw_error_t *tensor_scaled_add_inplace(tensor_t *x, const tensor_t *y, void *alpha);
+
 // Ternary Operations
 nw_error_t *tensor_convolution_2d(const tensor_t *w, const tensor_t *x, const tensor_t *y, tensor_t **z, int64_t stride, int64_t padding);
 nw_error_t *tensor_convolution_transpose_2d(const tensor_t *w, const tensor_t *x, const tensor_t *y, tensor_t **z, int64_t stride, int64_t padding);
 nw_error_t *tensor_linear(const tensor_t *w, const tensor_t *x, const tensor_t *y, tensor_t **z);
+nw_error_t *tensor_quantized_linear(const tensor_t *x, const quantization_t *quantization, const tensor_t *bias, tensor_t **y);
+nw_error_t *tensor_quantized_convolution_2d(const tensor_t *x, const quantization_t *quantization, const tensor_t *bias, tensor_t **y,
+                                            int64_t kernel_size, int64_t stride, int64_t padding);
 nw_error_t *tensor_batch_normalization_2d(const tensor_t *x, const tensor_t *weights, const tensor_t *bias, tensor_t *running_mean, 
                                           tensor_t *running_variance, tensor_t **y, bool_t inference, void *momentum, void *epsilon);
 nw_error_t *tensor_layer_normalization(const tensor_t *x, const tensor_t *weights, const tensor_t *bias, tensor_t **y, int64_t *normalized_shape, int64_t length, void *epsilon);
@@ -91,7 +102,7 @@ nw_error_t *tensor_causal_multihead_self_attention(tensor_t *x, const tensor_t *
                                                    int64_t number_of_heads, void *dropout_probability, bool_t inference, tensor_t **y);
 nw_error_t *tensor_scaled_dot_product_attention(const tensor_t *query, const tensor_t *key, const tensor_t *value, tensor_t **y, void *dropout_probability, bool_t inference);
 nw_error_t *tensor_where(const tensor_t *w, const tensor_t *x, const tensor_t *y, tensor_t **z);
-nw_error_t *tensor_embedding(const tensor_t *x, const tensor_t *weights, const tensor_t *vocabulary_counter, tensor_t **z);
+nw_error_t *tensor_embedding(const tensor_t *x, const tensor_t *weights, const tensor_t *vocabulary_counter, bool_t sparse, tensor_t **z);
 
 // Reduction Operations
 nw_error_t *tensor_summation(const tensor_t *x, tensor_t **y, const int64_t *axis, int64_t length, bool_t keep_dimension);
@@ -123,10 +134,14 @@ nw_error_t *tensor_tanh(const tensor_t *x, tensor_t **y);
 nw_error_t *tensor_gelu(const tensor_t *x, tensor_t **y);
 nw_error_t *tensor_absolute(const tensor_t *x, tensor_t **y);
 nw_error_t *tensor_as_tensor(const tensor_t *x, tensor_t **y);
+nw_error_t *tensor_cast(const tensor_t *x, datatype_t datatype, tensor_t **y);
 nw_error_t *tensor_lower_triangular(const tensor_t *x, tensor_t **y);
 
 // Back Propogation
 nw_error_t *tensor_backward(tensor_t *x, tensor_t *gradient);
 nw_error_t *tensor_accumulate_gradient(tensor_t *x, tensor_t *gradient);
+nw_error_t *tensor_accumulate_sparse_gradient(tensor_t *x, tensor_t *rows, tensor_t *gradient);
+nw_error_t *tensor_dense_gradient(tensor_t *x);
+nw_error_t *tensor_zero_gradient(tensor_t *x, bool_t set_to_none);
 void with_no_gradient(bool_t flag);
 #endif
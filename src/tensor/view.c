@@ -189,9 +189,9 @@ static bool_t is_expandable(const int64_t *original_shape, int64_t original_rank
 #pragma endregion VIEW_HELPERS
 
 /**
- * @brief Dynamically memory allocate and initialize a view. 
+ * @brief Initialize a view. The shape and strides are stored inline in the view so no memory is allocated.
  *        Reference: https://pytorch.org/docs/stable/generated/torch.Tensor.view.html       
- * @param[out] view Pointer to allocated view memory. 
+ * @param[out] view The view to initialize. 
  * @param[in] offset The offset in the underlying storage in terms of number of 
  *                   storage elements (not bytes).
  *                   Reference: https://pytorch.org/docs/stable/generated/torch.Tensor.storage_offset.html
@@ -199,30 +199,28 @@ static bool_t is_expandable(const int64_t *original_shape, int64_t original_rank
  *                 in the closed interval `[0, MAX_RANK]`.
  *                 Reference: https://pytorch.org/docs/stable/generated/torch.Tensor.ndimension.html
  * @param[in] shape The dimensions of the tensor. Must not be NULL. 
- *                  Contents is copied to dynamically memory allocated 
- *                  shape member in view.
+ *                  Contents is copied to the shape member of the view.
  *                  Reference: https://pytorch.org/docs/stable/generated/torch.Tensor.size.html
  * @param[in] strides The strides are the jumps necessary to go from one element 
  *                    to the next one in storage along each dimension (not bytes).
- *                    Contents is copied to dynamically memory allocated strides 
- *                    member in view if not NULL otherwise the allocated strides will be 
- *                    initialized under the assumption that the tensor is contiguous 
- *                    and in row major format.
+ *                    Contents is copied to the strides member of the view if not NULL 
+ *                    otherwise the strides will be initialized under the assumption 
+ *                    that the tensor is contiguous and in row major format.
  *                    Reference: https://pytorch.org/docs/stable/generated/torch.Tensor.stride.html
- * @return Error if failed to dynamically allocate memory for view or any of its members.
+ * @return Error if `view` or `shape` is NULL.
  *         Error if `rank` does not satisfy `0 <= rank <= MAX_RANK`.
  *         Error of the contiguous tensor strides failed to be computed.
  *         Error if a dimension in shape is less than or equal to 0.
- *         NULL if view was successfully dynamically memory allocated and initialized.
+ *         NULL if view was successfully initialized.
  */
-nw_error_t *view_create(view_t **view, int64_t offset, int64_t rank, const int64_t *shape, const int64_t *strides)
+nw_error_t *view_create(view_t *view, int64_t offset, int64_t rank, const int64_t *shape, const int64_t *strides)
 {
     CHECK_NULL_ARGUMENT(view, "view");
     CHECK_NULL_ARGUMENT(shape, "shape");
 
     if (rank < 0 || rank > MAX_RANK)
     {
-        return ERROR(ERROR_RANK, string_create("rank must be in the interval [0, %d].", rank, (int) MAX_RANK), NULL);
+        return ERROR(ERROR_RANK, string_create("rank %ld must be in the interval [0, %d].", rank, (int) MAX_RANK), NULL);
     }
 
     for (int64_t i = 0; i < rank; ++i)
@@ -236,80 +234,31 @@ nw_error_t *view_create(view_t **view, int64_t offset, int64_t rank, const int64
     nw_error_t *error = NULL;
     size_t size = rank * sizeof(int64_t);
 
-    // View
-    *view = (view_t *) malloc(sizeof(view_t));
-    if (!*view)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate view of size %zu.", sizeof(view_t)), NULL);
-        goto cleanup;
-    } 
-
-    // Initialize
-    (*view)->offset = offset;
-    (*view)->rank = rank;
-    (*view)->shape = NULL;
-    (*view)->strides = NULL;
-
-    // Dynamically allocate memory for shape, strides.
-    // If rank is 0, this should return a reference to a block of memory of size 0.
-
-    (*view)->shape = (int64_t *) malloc(size);
-    if (!(*view)->shape)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
-
-    (*view)->strides = (int64_t *) malloc(size);
-    if (!(*view)->strides)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
-    }
+    view->offset = offset;
+    view->rank = rank;
 
-    // Copy
     // Don't need to copy for scalar tensors.
     if (rank)
     {
-        memcpy((*view)->shape, shape, size);
+        // The shape and strides may be read from the view being written.
+        memmove(view->shape, shape, size);
         if (strides)
         {
-            memcpy((*view)->strides, strides, size);
+            memmove(view->strides, strides, size);
         }
         else
         {
-            error = strides_from_shape((*view)->strides, shape, rank);
+            error = strides_from_shape(view->strides, view->shape, rank);
             if (error)
             {
-                error = ERROR(ERROR_INITIALIZATION, string_create("failed to initialize strides."), error);
-                goto cleanup;
+                return ERROR(ERROR_INITIALIZATION, string_create("failed to initialize strides."), error);
             }
         }
     }
 
-    return error;
-
-cleanup:
-
-    view_destroy(*view);
-
     return error;
 }
 
-/**
- * @brief Free memory dynamically allocated for view and its members.
- * @param[in] view The view instance to be freed.
- */
-void view_destroy(view_t *view)
-{
-    if (view)
-    {
-        free(view->shape);
-        free(view->strides);
-        free(view);
-    }
-}
-
 nw_error_t *view_save(view_t *view, FILE *file)
 {
     CHECK_NULL_ARGUMENT(view, "view");
@@ -338,75 +287,40 @@ nw_error_t *view_save(view_t *view, FILE *file)
     return NULL;
 }
 
-nw_error_t *view_load(view_t **view, FILE *file)
+nw_error_t *view_load(view_t *view, FILE *file)
 {
     CHECK_NULL_ARGUMENT(view, "view");
     CHECK_NULL_ARGUMENT(file, "file");
 
-    nw_error_t *error = NULL;
-
-    // View
-    *view = (view_t *) malloc(sizeof(view_t));
-    if (!*view)
+    if (!fread(&view->rank, sizeof(int64_t), 1, file))
     {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate view of size %zu.", sizeof(view_t)), NULL);
-        goto cleanup;
-    } 
-
-    // Initialize
-    (*view)->shape = NULL;
-    (*view)->strides = NULL;
-
-    if (!fread(&(*view)->rank, sizeof(int64_t), 1, file))
-    {
-        error = ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
-        goto cleanup;
+        return ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
     }
 
-    if (!fread(&(*view)->offset, sizeof(int64_t), 1, file))
+    if (view->rank < 0 || view->rank > MAX_RANK)
     {
-        error = ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
-        goto cleanup;
-    }
-
-    size_t size = (*view)->rank * sizeof(int64_t);
-
-    (*view)->shape = (int64_t *) malloc(size);
-    if (!(*view)->shape)
-    {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
+        return ERROR(ERROR_RANK, string_create("rank %ld must be in the interval [0, %d].", view->rank, (int) MAX_RANK), NULL);
     }
 
-    (*view)->strides = (int64_t *) malloc(size);
-    if (!(*view)->strides)
+    if (!fread(&view->offset, sizeof(int64_t), 1, file))
     {
-        error = ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
-        goto cleanup;
+        return ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
     }
 
-    if (!fread((*view)->shape, sizeof(int64_t), (*view)->rank, file))
+    if (!fread(view->shape, sizeof(int64_t), view->rank, file))
     {
-        error = ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
-        goto cleanup;
+        return ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
     }
 
-    if (!fread((*view)->strides, sizeof(int64_t), (*view)->rank, file))
+    if (!fread(view->strides, sizeof(int64_t), view->rank, file))
     {
-        error = ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
-        goto cleanup;
+        return ERROR(ERROR_READ, string_create("failed to read from file."), NULL);
     }
 
-    return error;
-
-cleanup:
-
-    view_destroy(*view);
-    
-    return error;
+    return NULL;
 }
 
-nw_error_t *view_create_contiguous(view_t **view, const int64_t *shape, int64_t rank)
+static nw_error_t *view_create_contiguous(view_t *view, const int64_t *shape, int64_t rank)
 {
     CHECK_NULL_ARGUMENT(view, "view");
     CHECK_NULL_ARGUMENT(shape, "shape");
@@ -427,24 +341,16 @@ nw_error_t *view_create_contiguous(view_t **view, const int64_t *shape, int64_t
  * @param[in] source_view The view whose contents is being copied. Must not be NULL.
  * @param[out] destination_view The view to write the copied contents to. Must not be NULL.
  * return Error if `source_view` or `destination_view` is NULL.
- *        Error if destination view could not be allocated and initialized.
  *        NULL if copy was successful.
  */
-nw_error_t *view_copy(const view_t *source_view, view_t **destination_view)
+nw_error_t *view_copy(const view_t *source_view, view_t *destination_view)
 {
     CHECK_NULL_ARGUMENT(source_view, "source_view");
     CHECK_NULL_ARGUMENT(destination_view, "destination_view");
 
-    nw_error_t *error = NULL;
-
-    error = view_create(destination_view, source_view->offset, source_view->rank, 
-                        source_view->shape, source_view->strides);
-    if (error)
-    {
-        return ERROR(ERROR_CREATE, string_create("failed to create view."), error);
-    }        
+    *destination_view = *source_view;
 
-    return error;
+    return NULL;
 }
 
 /**
@@ -491,7 +397,59 @@ nw_error_t *view_is_contiguous(const view_t *view, bool_t *is_contiguous)
     return error;
 }
 
-nw_error_t *view_permute(const view_t *original_view, view_t **permuted_view, const int64_t *axis, int64_t length)
+/**
+ * @brief Given the view of a matrix operand determine whether its trailing two dimensions can be handed
+ *        to a BLAS GEMM as is, either row major or as the transpose of a row major matrix, and with
+ *        which leading dimension.
+ * @param[in] view The view of the matrix operand. Must be atleast rank 2.
+ * @param[out] is_compatible True if the matrix can be read in place, False if it must be made contiguous first.
+ * @param[out] transpose True if the matrix is stored column major and must be passed with the transpose flag.
+ * @param[out] leading_dimension The stride between consecutive rows (or columns if `transpose`) of the matrix.
+ * @return Error if `view`, `is_compatible`, `transpose` or `leading_dimension` is NULL.
+ *         Error if `view` has rank less than 2.
+ *         NULL if the layout was determined successfully.
+ */
+nw_error_t *view_matrix_layout(const view_t *view, bool_t *is_compatible, bool_t *transpose, int64_t *leading_dimension)
+{
+    CHECK_NULL_ARGUMENT(view, "view");
+    CHECK_NULL_ARGUMENT(is_compatible, "is_compatible");
+    CHECK_NULL_ARGUMENT(transpose, "transpose");
+    CHECK_NULL_ARGUMENT(leading_dimension, "leading_dimension");
+
+    if (view->rank < 2)
+    {
+        return ERROR(ERROR_RANK, string_create("matrix operand must be atleast rank 2."), NULL);
+    }
+
+    int64_t rows = view->shape[view->rank - 2];
+    int64_t columns = view->shape[view->rank - 1];
+    int64_t row_stride = view->strides[view->rank - 2];
+    int64_t column_stride = view->strides[view->rank - 1];
+
+    // Strides of dimensions of size one are never followed so they do not constrain the layout.
+    if ((columns == 1 || column_stride == 1) && (rows == 1 || row_stride >= columns))
+    {
+        *is_compatible = true;
+        *transpose = false;
+        *leading_dimension = (rows == 1) ? columns : row_stride;
+    }
+    else if ((rows == 1 || row_stride == 1) && (columns == 1 || column_stride >= rows))
+    {
+        *is_compatible = true;
+        *transpose = true;
+        *leading_dimension = (columns == 1) ? rows : column_stride;
+    }
+    else
+    {
+        *is_compatible = false;
+        *transpose = false;
+        *leading_dimension = 0;
+    }
+
+    return NULL;
+}
+
+nw_error_t *view_permute(const view_t *original_view, view_t *permuted_view, const int64_t *axis, int64_t length)
 {
     CHECK_NULL_ARGUMENT(original_view, "original_view");
     CHECK_NULL_ARGUMENT(permuted_view, "permuted_view");
@@ -520,8 +478,8 @@ nw_error_t *view_permute(const view_t *original_view, view_t **permuted_view, co
     for (int64_t i = 0; i < length; ++i)
     {
         int64_t j = dimension_to_index(axis[i], original_view->rank);
-        (*permuted_view)->shape[i] = original_view->shape[j];
-        (*permuted_view)->strides[i] = original_view->strides[j];
+        permuted_view->shape[i] = original_view->shape[j];
+        permuted_view->strides[i] = original_view->strides[j];
     }
     
     return error;
@@ -541,7 +499,7 @@ nw_error_t *view_permute(const view_t *original_view, view_t **permuted_view, co
  *         Error if negative argument received for `length`.
  *         NULL if the view was recovered successfully.
  */
-nw_error_t *view_recover_dimensions(const view_t *reduced_view, view_t **recovered_view, const int64_t *axis, int64_t length)
+nw_error_t *view_recover_dimensions(const view_t *reduced_view, view_t *recovered_view, const int64_t *axis, int64_t length)
 {
     CHECK_NULL_ARGUMENT(reduced_view, "reduced_view");
     CHECK_NULL_ARGUMENT(recovered_view, "recovered_view");
@@ -605,7 +563,7 @@ nw_error_t *view_recover_dimensions(const view_t *reduced_view, view_t **recover
  *         Error if view failed to be allocated and initialized.
  *         NULL if reduced view was successfully determined.
  */
-nw_error_t *view_reduce(const view_t *original_view, view_t **reduced_view, const int64_t *axis, int64_t length, bool_t keep_dimensions)
+nw_error_t *view_reduce(const view_t *original_view, view_t *reduced_view, const int64_t *axis, int64_t length, bool_t keep_dimensions)
 {
     CHECK_NEGATIVE_ARGUMENT(length, "length");
     CHECK_NULL_ARGUMENT(original_view, "original_view");
@@ -692,7 +650,6 @@ nw_error_t *view_reduce(const view_t *original_view, view_t **reduced_view, cons
 nw_error_t *view_physical_size(const view_t *view, int64_t *size)
 {
     CHECK_NULL_ARGUMENT(view, "view");
-    CHECK_NULL_ARGUMENT(view->strides, "view->strides");
     CHECK_NULL_ARGUMENT(size, "size");
 
     *size = array_product(view->shape, view->rank);
@@ -758,7 +715,7 @@ bool_t view_has_shape(const view_t *view, const int64_t *shape, int64_t rank)
  *         Error if `original_view`, `expanded_view`, or `shape` are NULL.
  *         Error if tensor cannot be expanded to target shape.
  */
-nw_error_t *view_expand(const view_t *original_view, view_t **expanded_view, const int64_t *shape, int64_t rank)
+nw_error_t *view_expand(const view_t *original_view, view_t *expanded_view, const int64_t *shape, int64_t rank)
 {
     CHECK_NULL_ARGUMENT(original_view, "original_view");
     CHECK_NULL_ARGUMENT(expanded_view, "expanded_view");
@@ -938,7 +895,7 @@ cleanup:
     return error;
 }
 
-nw_error_t *view_matrix_multiplication(const view_t *view_a, const view_t *view_b, view_t **view_c)
+nw_error_t *view_matrix_multiplication(const view_t *view_a, const view_t *view_b, view_t *view_c)
 {
     CHECK_NULL_ARGUMENT(view_a, "view_a");
     CHECK_NULL_ARGUMENT(view_b, "view_b");
@@ -1071,7 +1028,7 @@ nw_error_t *view_reduce_axis(const view_t *original_view,
     return NULL;
 }
 
-nw_error_t *view_slice(const view_t *original_view, view_t **sliced_view, const int64_t *arguments, int64_t length)
+nw_error_t *view_slice(const view_t *original_view, view_t *sliced_view, const int64_t *arguments, int64_t length)
 {
     CHECK_NULL_ARGUMENT(original_view, "original_view");
     CHECK_NULL_ARGUMENT(sliced_view, "sliced_view");
@@ -1085,7 +1042,7 @@ nw_error_t *view_slice(const view_t *original_view, view_t **sliced_view, const
     int64_t sliced_rank = original_view->rank;
     int64_t sliced_shape[sliced_rank];
     int64_t sliced_offset = 0;
-    int64_t *sliced_strides = original_view->strides;
+    const int64_t *sliced_strides = original_view->strides;
 
     for (int64_t i = 0; i < original_view->rank; ++i)
     {
@@ -1136,7 +1093,7 @@ nw_error_t *view_slice_padding_arguments(const view_t *original_view, const int6
     return NULL;
 }
 
-nw_error_t *view_padding(const view_t *original_view, view_t **padding_view, const int64_t *arguments, int64_t length)
+nw_error_t *view_padding(const view_t *original_view, view_t *padding_view, const int64_t *arguments, int64_t length)
 {
     CHECK_NULL_ARGUMENT(original_view, "original_view");
     CHECK_NULL_ARGUMENT(padding_view, "padding_view");
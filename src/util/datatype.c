@@ -14,6 +14,14 @@ string_t datatype_string(datatype_t datatype)
         return "FLOAT32";
     case FLOAT64:
         return "FLOAT64";
+    case BFLOAT16:
+        return "BFLOAT16";
+    case FLOAT16:
+        return "FLOAT16";
+    case INT32:
+        return "INT32";
+    case INT64:
+        return "INT64";
     default:
         return "UNKNOWN";
     }
@@ -27,11 +35,44 @@ size_t datatype_size(datatype_t datatype)
         return sizeof(float32_t);
     case FLOAT64:
         return sizeof(float64_t);
+    case BFLOAT16:
+        return sizeof(bfloat16_t);
+    case FLOAT16:
+        return sizeof(float16_t);
+    case INT32:
+        return sizeof(int32_t);
+    case INT64:
+        return sizeof(int64_t);
     default:
         return 0;
     }
 }
 
+/**
+ * @brief The datatype kernels run and accumulate in for a storage datatype.
+ *        Scalars that parameterize operations on reduced precision or integer tensors are passed in this datatype.
+ *        Integers compute in float64, which represents every int32 and every int64 index below 2^53 exactly.
+ */
+datatype_t datatype_compute(datatype_t datatype)
+{
+    switch (datatype)
+    {
+    case BFLOAT16:
+    case FLOAT16:
+        return FLOAT32;
+    case INT32:
+    case INT64:
+        return FLOAT64;
+    default:
+        return datatype;
+    }
+}
+
+bool_t datatype_is_integer(datatype_t datatype)
+{
+    return datatype == INT32 || datatype == INT64;
+}
+
 string_t string_create(string_t format, ...)
 {
     if (!format)
@@ -66,7 +107,7 @@ bool_t is_zero(void *value, datatype_t datatype)
         return true;
     }
 
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         return fabsf(*(float32_t *) value) < FLT_EPSILON;
@@ -74,6 +115,8 @@ bool_t is_zero(void *value, datatype_t datatype)
     case FLOAT64:
         return fabs(*(float64_t *) value) < DBL_EPSILON;
         break;
+    default:
+        break;
     }
 
     return false;
@@ -81,12 +124,14 @@ bool_t is_zero(void *value, datatype_t datatype)
 
 bool_t compare_greater_than_equal(void *lvalue, void *rvalue, datatype_t datatype)
 {
-    switch (datatype)
+    switch (datatype_compute(datatype))
     {
     case FLOAT32:
         return *(float32_t *) lvalue >= *(float32_t *) rvalue;
     case FLOAT64:
         return *(float64_t *) lvalue >= *(float64_t *) rvalue;
+    default:
+        break;
     }
 
     return false;
@@ -8,9 +8,12 @@
 #include <stdio.h>
 #include <limits.h>
 #include <float.h>
+#include <string.h>
 
 typedef float float32_t;
 typedef double float64_t;
+typedef uint16_t bfloat16_t;
+typedef uint16_t float16_t;
 typedef bool bool_t;
 typedef const char * string_t;
 typedef char char_t;
@@ -23,7 +26,11 @@ typedef enum datatype_t
 #endif
 {
     FLOAT32,
-    FLOAT64
+    FLOAT64,
+    BFLOAT16,
+    FLOAT16,
+    INT32,
+    INT64
 } datatype_t;
 
 #ifndef M_PI
@@ -41,10 +48,96 @@ typedef enum datatype_t
 #define AS_MEMBER_LAMBDA(func) [&](auto obj, auto&&... args) -> decltype(obj.func(std::forward<decltype(args)>(args)...)) { return obj.func(std::forward<decltype(args)>(args)...); }
 #endif
 
+// BFLOAT16 and FLOAT16 are storage only datatypes that compute in float32 and the INT32 and INT64 index
+// datatypes compute in float64, they are not counted here.
 #define DATATYPES 2
 
+static inline float32_t bfloat16_to_float32(bfloat16_t x)
+{
+    uint32_t bits = (uint32_t) x << 16;
+    float32_t y;
+    memcpy(&y, &bits, sizeof(y));
+    return y;
+}
+
+static inline bfloat16_t float32_to_bfloat16(float32_t x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    if ((bits & 0x7FFFFFFFU) > 0x7F800000U)
+    {
+        return (bfloat16_t) ((bits >> 16) | 0x0040U);
+    }
+    // Round to nearest even.
+    bits += 0x7FFFU + ((bits >> 16) & 1U);
+    return (bfloat16_t) (bits >> 16);
+}
+
+static inline float32_t float16_to_float32(float16_t x)
+{
+    uint32_t sign = (uint32_t) (x & 0x8000U) << 16;
+    uint32_t exponent = (x >> 10) & 0x1FU;
+    uint32_t mantissa = x & 0x3FFU;
+    uint32_t bits;
+    float32_t y;
+
+    if (exponent == 0x1FU)
+    {
+        bits = sign | 0x7F800000U | (mantissa << 13);
+    }
+    else if (exponent)
+    {
+        bits = sign | ((exponent + 112U) << 23) | (mantissa << 13);
+    }
+    else
+    {
+        // Zero or subnormal, exactly representable as a float32.
+        y = (float32_t) mantissa * 0x1p-24f;
+        memcpy(&bits, &y, sizeof(bits));
+        bits |= sign;
+    }
+
+    memcpy(&y, &bits, sizeof(y));
+    return y;
+}
+
+static inline float16_t float32_to_float16(float32_t x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000U);
+    bits &= 0x7FFFFFFFU;
+
+    if (bits >= 0x7F800000U)
+    {
+        return sign | 0x7C00U | ((bits > 0x7F800000U) ? 0x0200U : 0U);
+    }
+
+    if (bits >= 0x477FF000U)
+    {
+        return sign | 0x7C00U;
+    }
+
+    if (bits < 0x38800000U)
+    {
+        // Adding 0.5 aligns the float32 unit in the last place with the float16 subnormal spacing of 2^-24.
+        float32_t y;
+        memcpy(&y, &bits, sizeof(y));
+        y += 0.5f;
+        memcpy(&bits, &y, sizeof(bits));
+        return sign | (uint16_t) (bits - 0x3F000000U);
+    }
+
+    // Rebias the exponent from 127 to 15 and round to nearest even.
+    bits += 0xC8000FFFU + ((bits >> 13) & 1U);
+    return sign | (uint16_t) (bits >> 13);
+}
+
+
 string_t datatype_string(datatype_t datatype);
 size_t datatype_size(datatype_t datatype);
+datatype_t datatype_compute(datatype_t datatype);
+bool_t datatype_is_integer(datatype_t datatype);
 string_t string_create(string_t format, ...);
 void string_destroy(string_t string);
 bool_t is_zero(void *value, datatype_t datatype);
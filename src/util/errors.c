@@ -235,6 +235,8 @@ string_t error_type_string(nw_error_type_t error_type)
         return "ERROR_SAVE";
     case ERROR_READ: 
         return "ERROR_READ";
+    case ERROR_QUANTIZATION:
+        return "ERROR_QUANTIZATION";
     default:
         return "ERROR";
     }
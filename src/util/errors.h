@@ -147,6 +147,12 @@
                         fprintf(stderr, ", %lf", ((double *) (storage)->data)[_j]);\
                     }\
                     break;\
+                case INT32:\
+                    fprintf(stderr, (!_j) ? "%d" : ", %d", ((int32_t *) (storage)->data)[_j]);\
+                    break;\
+                case INT64:\
+                    fprintf(stderr, (!_j) ? "%ld" : ", %ld", ((int64_t *) (storage)->data)[_j]);\
+                    break;\
                 default:\
                     break;\
                 }\
@@ -175,7 +181,7 @@
     else\
     {\
         fprintf(stderr, "(view: ");\
-        PRINT_DEBUG_VIEW((buffer)->view);\
+        PRINT_DEBUG_VIEW(&(buffer)->view);\
         fprintf(stderr, ", storage: ");\
         PRINT_DEBUG_STORAGE((buffer)->storage);\
         fprintf(stderr, ")");\
@@ -692,6 +698,7 @@ typedef enum nw_error_type_t
     ERROR_SAVE,
     ERROR_WRITE,
     ERROR_READ,
+    ERROR_QUANTIZATION,
 } nw_error_type_t;
 
 typedef struct nw_error_t
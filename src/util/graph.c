@@ -82,36 +82,31 @@ static string_t int64_array_to_string(const int64_t *array, int64_t length)
         return NULL;
     }
 
-    switch(length)
+    // Each entry takes at most 20 digits, a sign and a separator.
+    char buffer[2 + MAX_RANK * 24];
+    int64_t position = 0;
+
+    buffer[position++] = '(';
+    for (int64_t i = 0; i < length; ++i)
     {
-    case 0:
-        return string_create("()");
-    case 1:
-        return string_create("(%ld)", array[0]);
-    case 2:
-        return string_create("(%ld, %ld)", array[0], array[1]);
-    case 3:
-        return string_create("(%ld, %ld, %ld)", array[0], array[1], array[2]);
-    case 4:
-        return string_create("(%ld, %ld, %ld, %ld)", array[0], array[1], array[2], array[3]);
-    case 5:
-        return string_create("(%ld, %ld, %ld, %ld, %ld)", array[0], array[1], array[2], array[3], array[4]);
+        position += snprintf(&buffer[position], sizeof(buffer) - position, (i) ? ", %ld" : "%ld", array[i]);
     }
+    snprintf(&buffer[position], sizeof(buffer) - position, ")");
 
-    return NULL;
+    return string_create("%s", buffer);
 }
 
 nw_error_t *graph_tensor_node(tensor_t *tensor, Agnode_t **node)
 {
     nw_error_t *error = NULL;
     uint64_t tensor_id = tensor->id;
-    int64_t rank = tensor->buffer->view->rank;
+    int64_t rank = tensor->buffer->view.rank;
     int64_t n = tensor->buffer->storage->n;
-    int64_t offset = tensor->buffer->view->offset;
+    int64_t offset = tensor->buffer->view.offset;
     string_t tensor_id_string = string_create("%lu", tensor->id);
     string_t node_id_string = string_create("%lu", global_node_id);
-    string_t shape_string = int64_array_to_string(tensor->buffer->view->shape, rank);
-    string_t stride_string = int64_array_to_string(tensor->buffer->view->strides, rank);
+    string_t shape_string = int64_array_to_string(tensor->buffer->view.shape, rank);
+    string_t stride_string = int64_array_to_string(tensor->buffer->view.strides, rank);
     string_t node_label = string_create("<F0> Tensor_ID: %lu|Shape: %s|Size: %ld|Stride: %s|Offset: %ld|Requires Gradient: %s", 
                                         tensor_id, shape_string, n, stride_string, offset, (tensor->requires_gradient) ? "true" : "false");
 
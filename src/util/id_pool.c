@@ -1,25 +1,7 @@
 #include <id_pool.h>
 
-static nw_error_t *id_node_create(id_node_t **id_node, uint64_t id, id_node_t *next)
-{
-    CHECK_NULL_ARGUMENT(id_node, "id_node");
-
-    *id_node = (id_node_t *) malloc(sizeof(id_node_t));
-    if (!*id_node)
-    {
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(id_node_t)), NULL);
-    }
-
-    (*id_node)->id = id;
-    (*id_node)->next = next;
-
-    return NULL;
-}
-
-static void id_node_destroy(id_node_t *id_node)
-{
-    free(id_node);
-}
+// Released ids are kept in a growable array used as a stack, so putting and getting an id is a store and an index update.
+#define ID_POOL_INITIAL_CAPACITY 64
 
 nw_error_t *id_pool_create(id_pool_t **id_pool)
 {
@@ -28,11 +10,12 @@ nw_error_t *id_pool_create(id_pool_t **id_pool)
     *id_pool = (id_pool_t *) malloc(sizeof(id_pool_t));
     if (!*id_pool)
     {
-        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(id_node_t)), NULL);
+        return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", sizeof(id_pool_t)), NULL);
     }
 
-    (*id_pool)->head = NULL;
+    (*id_pool)->ids = NULL;
     (*id_pool)->size = 0;
+    (*id_pool)->capacity = 0;
 
     return NULL;
 }
@@ -41,30 +24,29 @@ void id_pool_destroy(id_pool_t *id_pool)
 {
     if (id_pool)
     {
-        id_node_t *id_node = id_pool->head;
-        while (id_node)
-        {
-            id_node_t *temp = id_node;
-            id_node = id_node->next;
-            id_node_destroy(temp);
-        }
+        free(id_pool->ids);
         free(id_pool);
     }
 }
 
 nw_error_t *id_pool_put(id_pool_t *id_pool, uint64_t id)
 {
-    nw_error_t *error = NULL;
-    id_node_t *id_node = NULL;
+    CHECK_NULL_ARGUMENT(id_pool, "id_pool");
 
-    error = id_node_create(&id_node, id, id_pool->head);
-    if (error)
+    if (id_pool->size == id_pool->capacity)
     {
-        return ERROR(ERROR_CREATE, string_create("failed to create id node."), error);
+        uint64_t capacity = (id_pool->capacity) ? 2 * id_pool->capacity : ID_POOL_INITIAL_CAPACITY;
+        size_t size = capacity * sizeof(uint64_t);
+        uint64_t *ids = (uint64_t *) realloc(id_pool->ids, size);
+        if (!ids)
+        {
+            return ERROR(ERROR_MEMORY_ALLOCATION, string_create("failed to allocate %zu bytes.", size), NULL);
+        }
+        id_pool->ids = ids;
+        id_pool->capacity = capacity;
     }
-    
-    id_pool->head = id_node;
-    id_pool->size++;
+
+    id_pool->ids[id_pool->size++] = id;
 
     return NULL;
 }
@@ -74,22 +56,17 @@ nw_error_t *id_pool_get(id_pool_t *id_pool, uint64_t *id)
     CHECK_NULL_ARGUMENT(id_pool, "id_pool");
     CHECK_NULL_ARGUMENT(id, "id");
 
-    if (!id_pool->head)
+    if (!id_pool->size)
     {
         return ERROR(ERROR_NULL, string_create("id pool is empty."), NULL);
     }
 
-    *id = id_pool->head->id;
-    id_node_t *id_node = id_pool->head;
-    id_pool->head = id_pool->head->next;
-    id_node_destroy(id_node);
-    id_pool->size--;
+    *id = id_pool->ids[--id_pool->size];
 
     return NULL;
 }
 
 bool_t id_pool_is_empty(id_pool_t *id_pool)
 {
-    return !id_pool || !id_pool->head;
+    return !id_pool || !id_pool->size;
 }
-
@@ -4,16 +4,11 @@
 #include <datatype.h>
 #include <errors.h>
 
-typedef struct id_node_t
-{
-    uint64_t id;
-    struct id_node_t *next;
-} id_node_t;
-
 typedef struct id_pool_t
 {
     uint64_t size;
-    id_node_t *head;    
+    uint64_t capacity;
+    uint64_t *ids;
 } id_pool_t;
 
 nw_error_t *id_pool_create(id_pool_t **id_pool);
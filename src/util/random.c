@@ -4,10 +4,48 @@
  */
 
 #include <random.h>
+#include <stdatomic.h>
 
+static uint64_t random_seed = 0;
+static _Atomic uint64_t random_offset = 0;
+
+/**
+ * @brief Set the generator key and restart its counter.
+ * @param seed The new key.
+ */
 void set_seed(uint64_t seed)
 {
-    srand(seed);
+    random_seed = seed;
+    atomic_store(&random_offset, 0);
+}
+
+uint64_t get_seed(void)
+{
+    return random_seed;
+}
+
+/**
+ * @brief Move the generator to an arbitrary counter, e.g. to replay a stream.
+ * @param offset The next counter to be handed out.
+ */
+void set_offset(uint64_t offset)
+{
+    atomic_store(&random_offset, offset);
+}
+
+uint64_t get_offset(void)
+{
+    return atomic_load(&random_offset);
+}
+
+/**
+ * @brief Reserve a contiguous block of counters from the global generator.
+ * @param counters Number of Philox blocks (four 32-bit words each) to reserve.
+ * @return The first reserved counter.
+ */
+uint64_t random_reserve(uint64_t counters)
+{
+    return atomic_fetch_add(&random_offset, counters);
 }
 
 float32_t multinomialf(float32_t *probabilities, int64_t length)
@@ -64,54 +102,41 @@ float64_t multinomial(float64_t *probabilities, int64_t length)
     return (float64_t) (length - 1);
 }
 
-inline float32_t uniformf(float32_t lower_bound, float32_t upper_bound)
+float32_t uniformf(float32_t lower_bound, float32_t upper_bound)
 {
-    return (float32_t) uniform((float64_t) lower_bound, (float64_t) upper_bound);
+    uint32_t bits[4];
+    philox(random_seed, random_reserve(1), bits);
+    return philox_uniformf(bits[0]) * (upper_bound - lower_bound) + lower_bound;
 }
 
-inline float64_t uniform(float64_t lower_bound, float64_t upper_bound)
+float64_t uniform(float64_t lower_bound, float64_t upper_bound)
 {
-    return (float64_t) rand() / (float64_t) RAND_MAX * (upper_bound - lower_bound) + lower_bound;
+    uint32_t bits[4];
+    philox(random_seed, random_reserve(1), bits);
+    return philox_uniform(bits[0], bits[1]) * (upper_bound - lower_bound) + lower_bound;
 }
 
-
 float32_t normalf(float32_t mean, float32_t standard_deviation)
 {
-    return (float32_t) normal((float64_t) mean, (float64_t) standard_deviation);
+    uint32_t bits[4];
+    philox(random_seed, random_reserve(1), bits);
+    float32_t radius = sqrtf(-2.0f * logf(philox_uniformf(bits[0])));
+    return mean + standard_deviation * radius * cosf((float32_t) RANDOM_TWO_PI * philox_uniformf(bits[1]));
 }
 
 float64_t normal(float64_t mean, float64_t standard_deviation)
 {
-    float64_t u, v, r2, f;
-    static float64_t sample;
-    static bool_t sample_available = false;
-
-    if (sample_available)
-    {
-        sample_available = false;
-        return mean + standard_deviation * sample;
-    }
-
-    do
-    {
-        u = 2.0 * uniform(0.0, 1.0) - 1.0;
-        v = 2.0 * uniform(0.0, 1.0) - 1.0;
-        r2 = u * u + v * v;
-    }
-    while (r2 >= 1.0 || r2 == 0.0);
-
-    f = sqrt(-2.0 * log(r2) / r2);
-    sample = u * f;
-    sample_available = true;
-
-    return mean + standard_deviation * v * f;
+    uint32_t bits[4];
+    philox(random_seed, random_reserve(1), bits);
+    float64_t radius = sqrt(-2.0 * log(philox_uniform(bits[0], bits[1])));
+    return mean + standard_deviation * radius * cos(RANDOM_TWO_PI * philox_uniform(bits[2], bits[3]));
 }
 
 void shuffle_array(int64_t *array, int64_t length)
 {   
     for (int64_t i = 0; i < length - 1; i++)
     {
-        size_t j = i + rand() / (RAND_MAX / (length - i) + 1);
+        int64_t j = i + (int64_t) (uniform(0.0, 1.0) * (float64_t) (length - i));
         int64_t temp = array[j];
         array[j] = array[i];
         array[i] = temp;
@@ -1,6 +1,11 @@
 /**@file random.h
  * @brief Provides probability distribution utilities.
  *
+ * Random numbers are drawn from a Philox4x32-10 counter-based generator.
+ * The generator state is a 64-bit seed (the key) and a 64-bit offset (the next
+ * unused counter). Every counter yields four independent 32-bit words, so a
+ * block of counters can be reserved up front with `random_reserve` and then
+ * expanded in any order, on any number of threads, with identical results.
  */
 
 #ifndef RANDOM_H
@@ -9,7 +14,72 @@
 #include <datatype.h>
 #include <math.h>
 
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+#define RANDOM_TWO_PI 6.28318530717958647692
+
+/**
+ * @brief Compute the Philox4x32-10 block for a given key and counter.
+ *        Defined inline so that fill loops in the runtime can be vectorized.
+ * @param seed The generator key.
+ * @param counter The 64-bit block counter.
+ * @param output The four 32-bit random words of the block.
+ */
+static inline void philox(uint64_t seed, uint64_t counter, uint32_t output[4])
+{
+    uint32_t key_0 = (uint32_t) seed;
+    uint32_t key_1 = (uint32_t) (seed >> 32);
+    uint32_t x_0 = (uint32_t) counter;
+    uint32_t x_1 = (uint32_t) (counter >> 32);
+    uint32_t x_2 = 0;
+    uint32_t x_3 = 0;
+
+    for (int i = 0; i < PHILOX_ROUNDS; ++i)
+    {
+        uint64_t product_0 = (uint64_t) PHILOX_M0 * (uint64_t) x_0;
+        uint64_t product_1 = (uint64_t) PHILOX_M1 * (uint64_t) x_2;
+        uint32_t y_0 = (uint32_t) (product_1 >> 32) ^ x_1 ^ key_0;
+        uint32_t y_1 = (uint32_t) product_1;
+        uint32_t y_2 = (uint32_t) (product_0 >> 32) ^ x_3 ^ key_1;
+        uint32_t y_3 = (uint32_t) product_0;
+        x_0 = y_0;
+        x_1 = y_1;
+        x_2 = y_2;
+        x_3 = y_3;
+        key_0 += PHILOX_W0;
+        key_1 += PHILOX_W1;
+    }
+
+    output[0] = x_0;
+    output[1] = x_1;
+    output[2] = x_2;
+    output[3] = x_3;
+}
+
+/**
+ * @brief Map 32 random bits to a float in (0, 1).
+ */
+static inline float32_t philox_uniformf(uint32_t x)
+{
+    return ((float32_t) (x >> 8) + 0.5f) * 0x1p-24f;
+}
+
+/**
+ * @brief Map 64 random bits to a double in (0, 1).
+ */
+static inline float64_t philox_uniform(uint32_t x, uint32_t y)
+{
+    return ((float64_t) ((((uint64_t) x << 32) | (uint64_t) y) >> 11) + 0.5) * 0x1p-53;
+}
+
 void set_seed(uint64_t seed);
+uint64_t get_seed(void);
+void set_offset(uint64_t offset);
+uint64_t get_offset(void);
+uint64_t random_reserve(uint64_t counters);
 float32_t uniformf(float32_t lower_bound, float32_t upper_bound);
 float64_t uniform(float64_t lower_bound, float64_t upper_bound);
 float32_t normalf(float32_t mean, float32_t standard_deviation);
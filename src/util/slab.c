@@ -0,0 +1,218 @@
+/**@file slab.c
+ * @brief Implements slab pools for small framework objects.
+ *
+ * Tensors, buffers, storages, functions and operations are created and destroyed for every operation.
+ * Requests up to NW_SLAB_MAXIMUM_SIZE bytes are rounded up to a multiple of NW_SLAB_GRANULARITY and served from a
+ * free list of that size class, or carved out of the newest NW_SLAB_SIZE byte slab of the class with a pointer bump.
+ * Pools are thread local, so an object must be released on the thread that allocated it. Debug builds reject a block
+ * that does not belong to a slab of the calling thread instead of adding it to the wrong pool. When a thread exits
+ * the slabs of its size classes without live objects are returned to the system, the slabs of classes that still
+ * have live objects are left to them.
+ */
+
+#include <slab.h>
+#include <pthread.h>
+#ifdef DEBUG
+#include <errors.h>
+#endif
+
+// Largest request served from a pool, larger ones go to malloc. Zero disables pooling.
+#ifndef NW_SLAB_MAXIMUM_SIZE
+#define NW_SLAB_MAXIMUM_SIZE 256
+#endif
+
+// Bytes requested from malloc whenever a size class runs out of blocks.
+#ifndef NW_SLAB_SIZE
+#define NW_SLAB_SIZE ((size_t) 1 << 16)
+#endif
+
+// Block sizes are multiples of the granularity, which also keeps every block aligned like malloc.
+#define NW_SLAB_GRANULARITY 16
+#define NW_SLAB_CLASSES ((NW_SLAB_MAXIMUM_SIZE + NW_SLAB_GRANULARITY - 1) / NW_SLAB_GRANULARITY + 1)
+
+typedef struct slab_block_t
+{
+    struct slab_block_t *next;
+} slab_block_t;
+
+typedef struct slab_t
+{
+    struct slab_t *next;
+} slab_t;
+
+typedef struct slab_class_t
+{
+    slab_block_t *blocks;
+    slab_t *slabs;
+    char *cursor;
+    char *end;
+    int64_t live;
+} slab_class_t;
+
+static _Thread_local slab_class_t slab_classes[NW_SLAB_CLASSES];
+static _Thread_local bool_t slab_registered;
+static pthread_key_t slab_key;
+static pthread_once_t slab_key_once = PTHREAD_ONCE_INIT;
+
+static inline size_t slab_class_index(size_t size)
+{
+    return (size + NW_SLAB_GRANULARITY - 1) / NW_SLAB_GRANULARITY;
+}
+
+static void slab_release(slab_class_t *classes)
+{
+    for (size_t i = 0; i < NW_SLAB_CLASSES; ++i)
+    {
+        slab_class_t *pool = &classes[i];
+
+        if (pool->live)
+        {
+            continue;
+        }
+
+        while (pool->slabs)
+        {
+            slab_t *slab = pool->slabs;
+            pool->slabs = slab->next;
+            free(slab);
+        }
+
+        pool->blocks = NULL;
+        pool->cursor = NULL;
+        pool->end = NULL;
+    }
+}
+
+static void slab_thread_exit(void *classes)
+{
+    slab_release((slab_class_t *) classes);
+}
+
+static void slab_key_create(void)
+{
+    pthread_key_create(&slab_key, slab_thread_exit);
+}
+
+// The pools of a thread are registered with its first slab so they are released when the thread exits.
+static void slab_register(void)
+{
+    pthread_once(&slab_key_once, slab_key_create);
+    if (!pthread_setspecific(slab_key, (void *) slab_classes))
+    {
+        slab_registered = true;
+    }
+}
+
+#ifdef DEBUG
+static bool_t slab_owned(const slab_class_t *pool, const void *pointer, size_t block_size)
+{
+    for (const slab_t *slab = pool->slabs; slab; slab = slab->next)
+    {
+        const char *begin = (const char *) slab + NW_SLAB_GRANULARITY;
+        size_t capacity = ((NW_SLAB_SIZE - NW_SLAB_GRANULARITY) / block_size) * block_size;
+
+        if ((const char *) pointer >= begin && (const char *) pointer < begin + capacity)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+/**
+ * @brief Allocate memory for a small object.
+ * @param size Number of bytes requested.
+ * @return Pointer to at least `size` bytes or NULL if no memory could be allocated.
+ */
+void *slab_malloc(size_t size)
+{
+    // Empty requests keep the semantics of malloc(0).
+    if (!size || size > NW_SLAB_MAXIMUM_SIZE)
+    {
+        return malloc(size);
+    }
+
+    slab_class_t *pool = &slab_classes[slab_class_index(size)];
+    size_t block_size = slab_class_index(size) * NW_SLAB_GRANULARITY;
+    void *pointer = NULL;
+
+    if (pool->blocks)
+    {
+        pointer = (void *) pool->blocks;
+        pool->blocks = pool->blocks->next;
+    }
+    else
+    {
+        if (pool->cursor == pool->end)
+        {
+            if (!slab_registered)
+            {
+                slab_register();
+            }
+
+            slab_t *slab = (slab_t *) malloc(NW_SLAB_SIZE);
+            if (!slab)
+            {
+                return NULL;
+            }
+
+            // The header is padded to the granularity so blocks keep their alignment.
+            slab->next = pool->slabs;
+            pool->slabs = slab;
+            pool->cursor = (char *) slab + NW_SLAB_GRANULARITY;
+            pool->end = pool->cursor + ((NW_SLAB_SIZE - NW_SLAB_GRANULARITY) / block_size) * block_size;
+        }
+
+        pointer = (void *) pool->cursor;
+        pool->cursor += block_size;
+    }
+
+    ++pool->live;
+
+    return pointer;
+}
+
+/**
+ * @brief Release memory allocated with `slab_malloc`.
+ * @param pointer Memory to release. Argument can be NULL.
+ * @param size The size `pointer` was allocated with.
+ */
+void slab_free(void *pointer, size_t size)
+{
+    if (!pointer)
+    {
+        return;
+    }
+
+    if (!size || size > NW_SLAB_MAXIMUM_SIZE)
+    {
+        free(pointer);
+        return;
+    }
+
+    slab_class_t *pool = &slab_classes[slab_class_index(size)];
+    slab_block_t *block = (slab_block_t *) pointer;
+
+#ifdef DEBUG
+    // A block of another thread or size class would corrupt the free list and live count of this pool.
+    if (!slab_owned(pool, pointer, slab_class_index(size) * NW_SLAB_GRANULARITY))
+    {
+        PRINTLN_DEBUG_LOCATION("slab_free: block was not allocated by this thread with this size, ignoring it");
+        return;
+    }
+#endif
+
+    block->next = pool->blocks;
+    pool->blocks = block;
+    --pool->live;
+}
+
+/**
+ * @brief Return the slabs of every size class of the calling thread without live objects to the system.
+ */
+void slab_trim(void)
+{
+    slab_release(slab_classes);
+}
@@ -0,0 +1,15 @@
+/**@file slab.h
+ * @brief Provides size classed slab pools for small framework objects.
+ *
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <datatype.h>
+
+void *slab_malloc(size_t size);
+void slab_free(void *pointer, size_t size);
+void slab_trim(void);
+
+#endif
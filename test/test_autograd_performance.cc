@@ -0,0 +1,334 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <mgl2/base_cf.h>
+#include <mgl2/canvas_cf.h>
+#include <mgl2/mgl_cf.h>
+extern "C"
+{
+#include <buffer.h>
+#include <tensor.h>
+#include <view.h>
+#include <errors.h>
+#include <datatype.h>
+#include <measure.h>
+
+#include <check.h>
+// TODO: Make this portable to windows
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <test_helper.h>
+}
+#include <test_helper_torch.h>
+
+// Take average over UT_MEASUREMENT_ITERS iterations.
+#ifndef UT_MEASUREMENT_ITERS
+#define UT_MEASUREMENT_ITERS 10
+#endif
+
+#define SAVE_DIR "img/autograd"
+
+nw_error_t *error;
+
+static void mkdir_recurse(string_t s)
+{
+    char temp[PATH_MAX];
+    char *c;
+
+    snprintf(temp, sizeof(temp), "%s", s);
+
+    c = temp;
+    while (*c != '\0')
+    {
+        if (*c == '/')
+        {
+            *c = '\0';
+            mkdir(temp, S_IRWXU);
+            *c = '/';
+        }
+        ++c;
+    }
+    mkdir(temp, S_IRWXU);
+}
+
+void setup(void)
+{
+    struct stat st_result = {0};
+    if (stat(SAVE_DIR, &st_result) == -1)
+    {
+        mkdir_recurse(SAVE_DIR);
+    }
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+}
+
+void plot_heuristics(std::string t, std::string save_path,
+        std::string x_str, float64_t* x, int x_n,
+        std::string y_str, float64_t* y1, int y1_n, std::string plt1,
+        float64_t* y2, int y2_n, std::string plt2,
+        float64_t y_min, float64_t y_max)
+{
+    HMGL graph = mgl_create_graph(800,400);
+
+    HMDT x_mgl = mgl_create_data();
+    HMDT y1_mgl = mgl_create_data();
+    HMDT y2_mgl = mgl_create_data();
+
+    mgl_data_set_double(x_mgl, x, x_n, 1, 1);
+    mgl_data_set_double(y1_mgl, y1, y1_n, 1, 1);
+    mgl_data_set_double(y2_mgl, y2, y2_n, 1, 1);
+
+    // L    dark green blue
+    // P    dark purple
+    // #.   circle-dot marker
+    mgl_add_legend(graph, plt1.c_str(), "2L#.");
+    mgl_add_legend(graph, plt2.c_str(), "2P#.");
+
+    // Colour values range from 0 to 1
+    mgl_fill_background(graph, 1, 1, 1, 1);
+
+    mgl_inplot(graph, 0, 1, 0, 1);
+    mgl_title(graph, t.c_str(), "", 5);
+    mgl_set_range_dat(graph, 'x', x_mgl, 0);
+    mgl_set_range_val(graph, 'y', y_min, y_max);
+    mgl_axis(graph, "xy", "", "");
+    // |    long dashed line
+    // h    grey
+    mgl_axis_grid(graph, "xy", "|h", "");
+    mgl_label(graph, 'x', x_str.c_str(), 0, "");
+    mgl_label(graph, 'y', y_str.c_str(), 0, "");
+    mgl_box(graph);
+    mgl_plot_xy(graph, x_mgl, y1_mgl, "2L#.", "");
+    mgl_plot_xy(graph, x_mgl, y2_mgl, "2P#.", "");
+
+    // 0    absolute position of legend
+    // NULL font style
+    // #    draw box around legend
+    mgl_legend(graph, 1, NULL, "#");
+
+    mgl_write_png(graph, save_path.c_str(), "w");
+
+    mgl_delete_graph(graph);
+}
+
+/*
+ * Times tensor_backward on a chain of `depth` diamonds `c = -c + c` over a scalar leaf.
+ * Every intermediate is reachable along two paths, so the traversal has to consult its visited set
+ * for every node, and the graph has 2 * depth + 1 nodes. The deepest graphs would overflow the call stack
+ * of a recursive traversal.
+ */
+void performance_test(std::string graph_name, datatype_t datatype, int max_depth_exp8)
+{
+    // 8^6 diamonds already builds a graph of half a million nodes.
+    ck_assert(0 < max_depth_exp8 && max_depth_exp8 < 7);
+
+    int num_cases = (7 * max_depth_exp8) + 1;
+
+    float64_t torch_time_arr[num_cases];
+    float64_t torch_time_min = DBL_MAX;
+    float64_t torch_time_max = DBL_MIN;
+
+    float64_t nw_time_arr[RUNTIMES][num_cases];
+    float64_t nw_time_min[RUNTIMES];
+    float64_t nw_time_max[RUNTIMES];
+
+    float64_t nodes[num_cases];
+
+    std::string graph_name_dir = graph_name;
+    std::string graph_save_dir;
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        nw_time_min[i] = DBL_MAX;
+        nw_time_max[i] = DBL_MIN;
+    }
+
+    for (int x = 0; x <= max_depth_exp8; ++x)
+    {
+        int y = 0;
+        do
+        {
+            int64_t depth = (y + 1) * pow(8, x);
+            float64_t torch_time = 0;
+
+            for (int i = 0; i < RUNTIMES; ++i)
+            {
+                float64_t nw_time = 0;
+
+                for (int j = 0; j < UT_MEASUREMENT_ITERS; ++j)
+                {
+                    int64_t torch_start, torch_end;
+                    int64_t nw_start, nw_end;
+
+                    torch::Tensor torch_leaf;
+                    torch::Tensor torch_tensor;
+
+                    tensor_t *leaf;
+                    tensor_t *tensor;
+
+                    switch (datatype)
+                    {
+                    case FLOAT32:
+                        torch_leaf = torch::randn({}, torch::TensorOptions().dtype(torch::kFloat32).requires_grad(true));
+                        break;
+                    case FLOAT64:
+                        torch_leaf = torch::randn({}, torch::TensorOptions().dtype(torch::kFloat64).requires_grad(true));
+                        break;
+                    default:
+                        ck_abort_msg("unknown datatype.");
+                    }
+
+                    leaf = torch_to_tensor(torch_leaf, (runtime_t) i, datatype);
+                    tensor = leaf;
+                    torch_tensor = torch_leaf;
+
+                    for (int64_t k = 0; k < depth; ++k)
+                    {
+                        tensor_t *negated = NULL;
+                        tensor_t *summed = NULL;
+
+                        error = tensor_negation(tensor, &negated);
+                        ck_assert_ptr_null(error);
+                        error = tensor_addition(negated, tensor, &summed);
+                        ck_assert_ptr_null(error);
+                        tensor = summed;
+
+                        torch_tensor = -torch_tensor + torch_tensor;
+                    }
+
+                    // The backward pass releases every intermediate tensor, only the leaf remains.
+                    nw_start = get_time_nanoseconds();
+                    error = tensor_backward(tensor, NULL);
+                    runtime_synchronize((runtime_t) i);
+                    nw_end = get_time_nanoseconds();
+                    ck_assert_ptr_null(error);
+
+                    tensor_destroy(leaf);
+
+                    nw_time += (float64_t) (nw_end - nw_start) / UT_MEASUREMENT_ITERS;
+
+                    if ((runtime_t) i == OPENBLAS_RUNTIME)
+                    {
+                        torch_start = get_time_nanoseconds();
+                        torch_tensor.backward();
+                        torch_end = get_time_nanoseconds();
+
+                        torch_time += (float64_t) (torch_end - torch_start) / UT_MEASUREMENT_ITERS;
+                    }
+                }
+
+                nw_time_arr[i][(x * 7) + y] = nw_time;
+                nw_time_min[i] = std::min(nw_time_min[i], nw_time);
+                nw_time_max[i] = std::max(nw_time_max[i], nw_time);
+            }
+
+            torch_time_arr[(x * 7) + y] = torch_time;
+            torch_time_min = std::min(torch_time_min, torch_time);
+            torch_time_max = std::max(torch_time_max, torch_time);
+
+            nodes[(x * 7) + y] = (float64_t) (2 * depth + 1);
+
+            ++y;
+        } while ((y < 7) && (x != max_depth_exp8));
+    }
+
+    std::for_each(graph_name_dir.begin(), graph_name_dir.end(), [] (char &c) {
+            if (isupper(c))
+            {
+                c = tolower(c);
+            }
+            else if (isspace(c))
+            {
+                c = '_';
+            }});
+
+    graph_save_dir = std::string(SAVE_DIR) + "/" + graph_name_dir;
+    struct stat st_result = {0};
+    if (stat(graph_save_dir.c_str(), &st_result) == -1)
+    {
+        mkdir(graph_save_dir.c_str(), S_IRWXU);
+    }
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        std::string runtime_str;
+
+        switch ((runtime_t) i)
+        {
+        case OPENBLAS_RUNTIME:
+            runtime_str = "openblas";
+            break;
+        case MKL_RUNTIME:
+            runtime_str = "mkl";
+            break;
+        case CU_RUNTIME:
+            runtime_str = "cuda";
+            break;
+        default:
+            ck_abort_msg("unknown runtime.");
+        }
+
+        plot_heuristics("Backward Completion Time - " + graph_name,
+                graph_save_dir + "/" + runtime_str + "_backward_time.png",
+                "Graph Nodes", nodes, num_cases,
+                "Time (nsec)", nw_time_arr[i], num_cases, "NeuralWindow",
+                torch_time_arr, num_cases, "PyTorch",
+                std::min(nw_time_min[i], torch_time_min), std::max(nw_time_max[i], torch_time_max));
+    }
+}
+
+START_TEST(test_backward_traversal_performance)
+{
+    performance_test("Diamond Chain FLOAT32", FLOAT32, 5);
+    performance_test("Diamond Chain FLOAT64", FLOAT64, 5);
+}
+END_TEST
+
+Suite *make_autograd_perf_suite(void)
+{
+    Suite *s;
+    TCase *tc_autograd;
+
+    s = suite_create("Test Autograd Performance Suite");
+
+    tc_autograd = tcase_create("Autograd Case");
+    tcase_add_checked_fixture(tc_autograd, setup, teardown);
+    tcase_add_test(tc_autograd, test_backward_traversal_performance);
+
+    suite_add_tcase(s, tc_autograd);
+
+    return s;
+}
+
+int main(void)
+{
+    // Set seed
+    torch::manual_seed(SEED);
+
+    int number_failed;
+    SRunner *sr;
+
+    sr = srunner_create(make_autograd_perf_suite());
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_VERBOSE);
+
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
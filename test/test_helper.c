@@ -270,6 +270,12 @@ void ck_assert_element_eq(const void *returned_data, int64_t returned_index,
                                                                     ((float64_t *) expected_data)[expected_index], *(float64_t *) epsilon));
         }
         break;
+    case INT32:
+        ck_assert_int_eq(((int32_t *) returned_data)[returned_index], ((int32_t *) expected_data)[expected_index]);
+        break;
+    case INT64:
+        ck_assert_int_eq(((int64_t *) returned_data)[returned_index], ((int64_t *) expected_data)[expected_index]);
+        break;
     default:
         ck_abort_msg("unknown datatype.");
     }
@@ -294,7 +300,7 @@ void ck_assert_buffer_eq(const buffer_t *returned_buffer, const buffer_t *expect
     ck_assert_ptr_nonnull(returned_buffer);
     ck_assert_ptr_nonnull(expected_buffer);
 
-    ck_assert_view_eq(returned_buffer->view, expected_buffer->view);
+    ck_assert_view_eq(&returned_buffer->view, &expected_buffer->view);
     ck_assert_storage_eq(returned_buffer->storage, expected_buffer->storage, epsilon);
 }
 
@@ -484,23 +490,21 @@ static void _ck_assert_tensor_equiv(const tensor_t *returned_tensor, const tenso
     }
 
     ck_assert_ptr_nonnull(expected_tensor->buffer);
-    ck_assert_ptr_nonnull(expected_tensor->buffer->view);
     ck_assert_ptr_nonnull(expected_tensor->buffer->storage);
     ck_assert_ptr_nonnull(returned_tensor->buffer);
-    ck_assert_ptr_nonnull(returned_tensor->buffer->view);
     ck_assert_ptr_nonnull(returned_tensor->buffer->storage);
 
-    ck_assert_int_eq(returned_tensor->buffer->view->rank, expected_tensor->buffer->view->rank);
-    for (int64_t i = 0; i < expected_tensor->buffer->view->rank; ++i)
+    ck_assert_int_eq(returned_tensor->buffer->view.rank, expected_tensor->buffer->view.rank);
+    for (int64_t i = 0; i < expected_tensor->buffer->view.rank; ++i)
     {
-        ck_assert_int_eq(returned_tensor->buffer->view->shape[i], 
-                          expected_tensor->buffer->view->shape[i]);
+        ck_assert_int_eq(returned_tensor->buffer->view.shape[i], 
+                          expected_tensor->buffer->view.shape[i]);
     }
     ck_assert_int_eq(returned_tensor->buffer->storage->datatype, expected_tensor->buffer->storage->datatype);
 
-    ck_assert_data_equiv(returned_tensor->buffer->storage->data, returned_tensor->buffer->view->strides, returned_tensor->buffer->view->offset,
-                         expected_tensor->buffer->storage->data, expected_tensor->buffer->view->strides, expected_tensor->buffer->view->offset,
-                         expected_tensor->buffer->view->shape, expected_tensor->buffer->view->rank, expected_tensor->buffer->storage->datatype, epsilon);
+    ck_assert_data_equiv(returned_tensor->buffer->storage->data, returned_tensor->buffer->view.strides, returned_tensor->buffer->view.offset,
+                         expected_tensor->buffer->storage->data, expected_tensor->buffer->view.strides, expected_tensor->buffer->view.offset,
+                         expected_tensor->buffer->view.shape, expected_tensor->buffer->view.rank, expected_tensor->buffer->storage->datatype, epsilon);
 
 }
 
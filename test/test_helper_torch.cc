@@ -17,7 +17,7 @@ tensor_t *torch_to_tensor(torch::Tensor torch_tensor, runtime_t runtime, datatyp
     nw_error_t *error = NULL;
     buffer_t *buffer = NULL;
     storage_t *storage = NULL;
-    view_t *view = NULL;
+    view_t view;
     tensor_t *tensor = NULL;
 
     switch (datatype)
@@ -28,6 +28,12 @@ tensor_t *torch_to_tensor(torch::Tensor torch_tensor, runtime_t runtime, datatyp
     case FLOAT64:
         torch_tensor = torch_tensor.to(torch::kFloat64);
         break;
+    case INT32:
+        torch_tensor = torch_tensor.to(torch::kInt32);
+        break;
+    case INT64:
+        torch_tensor = torch_tensor.to(torch::kInt64);
+        break;
     default:
         ck_abort_msg("invalid datatype.");
     }
@@ -46,7 +52,7 @@ tensor_t *torch_to_tensor(torch::Tensor torch_tensor, runtime_t runtime, datatyp
     }
     ck_assert_ptr_null(error);
 
-    error = buffer_create(&buffer, view, storage, false);
+    error = buffer_create(&buffer, &view, storage, false);
     if (error)
     {
         error_print(error);
@@ -433,6 +433,125 @@ START_TEST(test_model_exporter)
 }
 END_TEST
 
+// Largest deviation of the quantized model relative to the largest output of the float model.
+#define QUANTIZE_TOLERANCE 5e-2
+
+static tensor_t *quantize_input(runtime_t runtime, datatype_t datatype, int case_index)
+{
+    tensor_t *x = NULL;
+    int64_t feed_forward_shape[] = {4, 10};
+    int64_t convolutional_shape[] = {3, 5, 1, 1};
+    int64_t transformer_shape[] = {2, 3};
+    float32_t tokens_f[] = {0.0, 4.0, 2.0, 1.0, 3.0, 1.0};
+    float64_t tokens[] = {0.0, 4.0, 2.0, 1.0, 3.0, 1.0};
+    float32_t mean_f = 0.0, standard_deviation_f = 1.0;
+    float64_t mean = 0.0, standard_deviation = 1.0;
+    void *a = (datatype == FLOAT32) ? (void *) &mean_f : (void *) &mean;
+    void *b = (datatype == FLOAT32) ? (void *) &standard_deviation_f : (void *) &standard_deviation;
+
+    switch (case_index)
+    {
+    case 0:
+        error = tensor_create_normal(&x, feed_forward_shape, 2, runtime, datatype, false, true, a, b);
+        break;
+    case 1:
+        error = tensor_create_normal(&x, convolutional_shape, 4, runtime, datatype, false, true, a, b);
+        break;
+    case 2:
+        error = tensor_from_data(&x, (datatype == FLOAT32) ? (void *) tokens_f : (void *) tokens, runtime, datatype, 2, transformer_shape, true, false, true);
+        break;
+    default:
+        ck_abort_msg("unsupported case.");
+    }
+    ck_assert_ptr_null(error);
+
+    return x;
+}
+
+static float64_t quantize_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == FLOAT32)
+    {
+        return (float64_t) ((float32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((float64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+START_TEST(test_model_quantize)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int k = 0; k < CASES; ++k)
+            {
+                runtime_t runtime = (runtime_t) i;
+                datatype_t datatype = (datatype_t) j;
+                model_t *expected_model = NULL;
+                tensor_t *x = quantize_input(runtime, datatype, k);
+                tensor_t *returned = NULL, *expected = NULL;
+                float64_t maximum = 0.0, worst = 0.0;
+                int64_t n;
+
+                // The float model is kept as a saved copy, quantization is not persisted.
+                error = model_save(models[i][j][k], "test.bin");
+                ck_assert_ptr_null(error);
+                error = model_load(&expected_model, "test.bin");
+                ck_assert_ptr_null(error);
+                error = model_quantize(models[i][j][k]);
+                if (datatype != FLOAT32)
+                {
+                    // Only float32 compute datatypes are quantized.
+                    ck_assert_ptr_nonnull(error);
+                    ck_assert_int_eq(error->error_type, ERROR_QUANTIZATION);
+                    error_destroy(error);
+                    error = NULL;
+                    tensor_destroy(x);
+                    model_destroy(expected_model);
+                    continue;
+                }
+                ck_assert_ptr_null(error);
+                ck_assert_model_eq(models[i][j][k], expected_model);
+
+                with_no_gradient(true);
+                error = model_inference(models[i][j][k], true);
+                ck_assert_ptr_null(error);
+                error = model_inference(expected_model, true);
+                ck_assert_ptr_null(error);
+                error = model_forward(models[i][j][k], x, &returned);
+                ck_assert_ptr_null(error);
+                error = model_forward(expected_model, x, &expected);
+                ck_assert_ptr_null(error);
+                with_no_gradient(false);
+                runtime_synchronize(runtime);
+
+                ck_assert_int_eq(returned->buffer->view.rank, expected->buffer->view.rank);
+                for (int64_t l = 0; l < expected->buffer->view.rank; ++l)
+                {
+                    ck_assert_int_eq(returned->buffer->view.shape[l], expected->buffer->view.shape[l]);
+                }
+                error = view_logical_size(&expected->buffer->view, &n);
+                ck_assert_ptr_null(error);
+                for (int64_t l = 0; l < n; ++l)
+                {
+                    maximum = fmax(maximum, fabs(quantize_element(expected, l)));
+                    worst = fmax(worst, fabs(quantize_element(returned, l) - quantize_element(expected, l)));
+                }
+                // The integer path is taken and stays close to the float model.
+                ck_assert_double_gt(worst, 0.0);
+                ck_assert_double_le(worst, QUANTIZE_TOLERANCE * maximum);
+
+                tensor_destroy(x);
+                tensor_destroy(returned);
+                tensor_destroy(expected);
+                model_destroy(expected_model);
+            }
+        }
+    }
+}
+END_TEST
+
 Suite *make_model_exporter_suite(void)
 {
     Suite *s;
@@ -443,6 +562,7 @@ Suite *make_model_exporter_suite(void)
     tc = tcase_create("Test Model Exporter Case");
     tcase_add_checked_fixture(tc, setup, teardown);
     tcase_add_test(tc, test_model_exporter);
+    tcase_add_test(tc, test_model_quantize);
 
     suite_add_tcase(s, tc);
 
@@ -1260,7 +1260,7 @@ void test_optimizer(algorithm_type_t algorithm_type)
                         tensor_t *output = NULL;
                         tensor_t *cost = NULL;
 
-                        error = zero_gradient_model(models[i][j][k][l]);
+                        error = zero_gradient_model(models[i][j][k][l], false);
                         ck_assert_ptr_null(error);
                         error = model_forward(models[i][j][k][l], inputs[i][j][k][l], &output);
                         ck_assert_ptr_null(error);
@@ -1371,12 +1371,408 @@ START_TEST(test_adam)
 }
 END_TEST
 
+#define SPARSE_OPTIMIZER_CASES 5
+#define SPARSE_OPTIMIZER_STEPS 3
+#define SPARSE_OPTIMIZER_LOOKUPS 6
+#define SPARSE_VOCABULARY 8
+#define SPARSE_EMBEDDING_SIZE 4
+// Row looked up on every step but the second one.
+#define SPARSE_SKIPPED_ROW 4
+
+typedef struct sparse_optimizer_case_t
+{
+    algorithm_type_t algorithm_type;
+    float64_t learning_rate;
+    float64_t momentum;
+    float64_t dampening;
+    float64_t weight_decay;
+    bool_t nesterov;
+    // Whether a dense update of a row without a gradient leaves the optimizer state as the lazy update would.
+    bool_t replay;
+} sparse_optimizer_case_t;
+
+sparse_optimizer_case_t sparse_optimizer_cases[SPARSE_OPTIMIZER_CASES] = {
+    {STOCASTIC_GRADIENT_DESCENT, 1e-1, 0.0, 0.0, 0.0, false, true},
+    {STOCASTIC_GRADIENT_DESCENT, 1e-1, 0.9, 0.0, 0.0, false, false},
+    {STOCASTIC_GRADIENT_DESCENT, 1e-1, 0.9, 0.1, 1e-2, true, false},
+    {ADAM, 1e-2, 0.0, 0.0, 0.0, false, true},
+    {ADAM, 1e-2, 0.0, 0.0, 1e-1, false, false},
+};
+
+int64_t sparse_optimizer_indices[SPARSE_OPTIMIZER_STEPS][SPARSE_OPTIMIZER_LOOKUPS] = {
+    {0, 2, 2, 5, 3, 4},
+    {5, 0, 3, 3, 2, 0},
+    {4, 2, 0, 5, 3, 4},
+};
+
+// Rows 0, 2, 3 and 5 are looked up on every step, rows 1, 6 and 7 never are.
+bool_t sparse_optimizer_always[SPARSE_VOCABULARY] = {true, false, true, true, false, true, false, false};
+
+void setup_sparse_optimizer(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_sparse_optimizer(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static float64_t sparse_optimizer_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == FLOAT32)
+    {
+        return (float64_t) ((float32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((float64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+static optimizer_t *sparse_optimizer_create(const sparse_optimizer_case_t *optimizer_case, datatype_t datatype)
+{
+    optimizer_t *optimizer = NULL;
+    float32_t learning_rate_f = (float32_t) optimizer_case->learning_rate, momentum_f = (float32_t) optimizer_case->momentum;
+    float32_t dampening_f = (float32_t) optimizer_case->dampening, weight_decay_f = (float32_t) optimizer_case->weight_decay;
+    float32_t beta_1_f = 0.9, beta_2_f = 0.999, epsilon_f = 1e-8;
+    float64_t learning_rate = optimizer_case->learning_rate, momentum = optimizer_case->momentum;
+    float64_t dampening = optimizer_case->dampening, weight_decay = optimizer_case->weight_decay;
+    float64_t beta_1 = 0.9, beta_2 = 0.999, epsilon = 1e-8;
+    bool_t single = datatype == FLOAT32;
+
+    switch (optimizer_case->algorithm_type)
+    {
+    case STOCASTIC_GRADIENT_DESCENT:
+        error = optimizer_stochastic_gradient_descent_create(&optimizer, datatype,
+                                                             (single) ? (void *) &learning_rate_f : (void *) &learning_rate,
+                                                             (single) ? (void *) &momentum_f : (void *) &momentum,
+                                                             (single) ? (void *) &dampening_f : (void *) &dampening,
+                                                             (single) ? (void *) &weight_decay_f : (void *) &weight_decay,
+                                                             optimizer_case->nesterov);
+        break;
+    case ADAM:
+        error = optimizer_adam_create(&optimizer, datatype,
+                                      (single) ? (void *) &learning_rate_f : (void *) &learning_rate,
+                                      (single) ? (void *) &beta_1_f : (void *) &beta_1,
+                                      (single) ? (void *) &beta_2_f : (void *) &beta_2,
+                                      (single) ? (void *) &weight_decay_f : (void *) &weight_decay,
+                                      (single) ? (void *) &epsilon_f : (void *) &epsilon);
+        break;
+    default:
+        ck_abort_msg("unsupported algorithm type.");
+    }
+    ck_assert_ptr_null(error);
+
+    return optimizer;
+}
+
+// Looks up one step of indices, weights the lookup by a fixed gradient and updates the weights.
+static void sparse_optimizer_step(optimizer_t *optimizer, tensor_t *weights, const tensor_t *vocabulary_counter,
+                                  const tensor_t *gradient, const int64_t *indices, bool_t sparse)
+{
+    int64_t shape[] = {2, SPARSE_OPTIMIZER_LOOKUPS / 2};
+    tensor_t *x = NULL, *z = NULL, *product = NULL, *cost = NULL;
+    runtime_t runtime = weights->buffer->storage->runtime;
+
+    error = zero_gradient_parameters(weights, true);
+    ck_assert_ptr_null(error);
+    error = tensor_from_data(&x, (void *) indices, runtime, INT64, 2, shape, true, false, true);
+    ck_assert_ptr_null(error);
+    error = tensor_embedding(x, weights, vocabulary_counter, sparse, &z);
+    ck_assert_ptr_null(error);
+    error = tensor_multiplication(z, gradient, &product);
+    ck_assert_ptr_null(error);
+    error = tensor_summation(product, &cost, NULL, 0, false);
+    ck_assert_ptr_null(error);
+    error = tensor_backward(cost, NULL);
+    ck_assert_ptr_null(error);
+    ck_assert((weights->gradient_rows != NULL) == sparse);
+    error = update_parameters(optimizer, weights);
+    ck_assert_ptr_null(error);
+    runtime_synchronize(runtime);
+
+    tensor_destroy(x);
+}
+
+START_TEST(test_sparse_optimizer)
+{
+    int64_t vocabulary[SPARSE_VOCABULARY] = {0, 1, 2, 3, 4, 5, 6, 7};
+    int64_t vocabulary_shape[] = {SPARSE_VOCABULARY};
+    int64_t weights_shape[] = {SPARSE_VOCABULARY, SPARSE_EMBEDDING_SIZE};
+    int64_t gradient_shape[] = {2, SPARSE_OPTIMIZER_LOOKUPS / 2, SPARSE_EMBEDDING_SIZE};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int k = 0; k < SPARSE_OPTIMIZER_CASES; ++k)
+            {
+                runtime_t runtime = (runtime_t) i;
+                datatype_t datatype = (datatype_t) j;
+                sparse_optimizer_case_t *optimizer_case = &sparse_optimizer_cases[k];
+                float64_t tolerance = (datatype == FLOAT32) ? 1e-5 : 1e-12;
+                float32_t lower_bound_f = -1.0, upper_bound_f = 1.0;
+                float64_t lower_bound = -1.0, upper_bound = 1.0;
+                void *a = (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound;
+                void *b = (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound;
+                optimizer_t *optimizer = sparse_optimizer_create(optimizer_case, datatype);
+                optimizer_t *optimizer_expected = sparse_optimizer_create(optimizer_case, datatype);
+                tensor_t *weights = NULL, *weights_expected = NULL, *vocabulary_counter = NULL;
+                tensor_t *gradients[SPARSE_OPTIMIZER_STEPS] = {NULL};
+                float64_t initial[SPARSE_VOCABULARY * SPARSE_EMBEDDING_SIZE];
+                // Dense update of the skipped row on the step it was skipped.
+                float64_t skipped_update[SPARSE_EMBEDDING_SIZE];
+
+                error = tensor_create_uniform(&weights, weights_shape, 2, runtime, datatype, true, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_from_data(&weights_expected, weights->buffer->storage->data, runtime, datatype, 2, weights_shape, true, true, true);
+                ck_assert_ptr_null(error);
+                error = tensor_from_data(&vocabulary_counter, vocabulary, runtime, INT64, 1, vocabulary_shape, true, false, true);
+                ck_assert_ptr_null(error);
+                for (int64_t l = 0; l < SPARSE_OPTIMIZER_STEPS; ++l)
+                {
+                    error = tensor_create_uniform(&gradients[l], gradient_shape, 3, runtime, datatype, false, true, a, b);
+                    ck_assert_ptr_null(error);
+                }
+                runtime_synchronize(runtime);
+                for (int64_t l = 0; l < SPARSE_VOCABULARY * SPARSE_EMBEDDING_SIZE; ++l)
+                {
+                    initial[l] = sparse_optimizer_element(weights, l);
+                }
+
+                for (int64_t l = 0; l < SPARSE_OPTIMIZER_STEPS; ++l)
+                {
+                    sparse_optimizer_step(optimizer, weights, vocabulary_counter, gradients[l], sparse_optimizer_indices[l], true);
+                    if (l == 1)
+                    {
+                        for (int64_t m = 0; m < SPARSE_EMBEDDING_SIZE; ++m)
+                        {
+                            skipped_update[m] = sparse_optimizer_element(weights_expected, SPARSE_SKIPPED_ROW * SPARSE_EMBEDDING_SIZE + m);
+                        }
+                    }
+                    sparse_optimizer_step(optimizer_expected, weights_expected, vocabulary_counter, gradients[l], sparse_optimizer_indices[l], false);
+                    if (l == 1)
+                    {
+                        for (int64_t m = 0; m < SPARSE_EMBEDDING_SIZE; ++m)
+                        {
+                            skipped_update[m] -= sparse_optimizer_element(weights_expected, SPARSE_SKIPPED_ROW * SPARSE_EMBEDDING_SIZE + m);
+                        }
+                    }
+                }
+
+                for (int64_t l = 0; l < SPARSE_VOCABULARY; ++l)
+                {
+                    for (int64_t m = 0; m < SPARSE_EMBEDDING_SIZE; ++m)
+                    {
+                        int64_t n = l * SPARSE_EMBEDDING_SIZE + m;
+                        float64_t returned = sparse_optimizer_element(weights, n);
+                        float64_t expected = sparse_optimizer_element(weights_expected, n);
+
+                        if (sparse_optimizer_always[l])
+                        {
+                            // Rows with a gradient on every step follow the dense update.
+                            ck_assert_double_eq_tol(returned, expected, tolerance);
+                        }
+                        else if (l == SPARSE_SKIPPED_ROW)
+                        {
+                            ck_assert_double_ne(returned, initial[n]);
+                            // Without weight decay or momentum the lazy update only misses the dense update of the skipped step.
+                            if (optimizer_case->replay)
+                            {
+                                ck_assert_double_eq_tol(returned, expected + skipped_update[m], tolerance);
+                            }
+                        }
+                        else
+                        {
+                            // Rows never looked up receive neither weight decay nor momentum.
+                            ck_assert_double_eq(returned, initial[n]);
+                        }
+                    }
+                }
+
+                optimizer_destroy(optimizer);
+                optimizer_destroy(optimizer_expected);
+                tensor_destroy(weights);
+                tensor_destroy(weights_expected);
+                tensor_destroy(vocabulary_counter);
+                for (int64_t l = 0; l < SPARSE_OPTIMIZER_STEPS; ++l)
+                {
+                    tensor_destroy(gradients[l]);
+                }
+            }
+        }
+    }
+}
+END_TEST
+
+#define ZERO_GRADIENT_BATCH 4
+#define ZERO_GRADIENT_INPUT 5
+#define ZERO_GRADIENT_OUTPUT 3
+
+void setup_zero_gradient(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_zero_gradient(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static float64_t zero_gradient_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == FLOAT32)
+    {
+        return (float64_t) ((float32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((float64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+// Runs the model on `x` and back propagates the sum of the output weighted by `r`.
+static void zero_gradient_backward(model_t *model, tensor_t *x, const tensor_t *r)
+{
+    tensor_t *y = NULL, *product = NULL, *cost = NULL;
+
+    error = model_forward(model, x, &y);
+    ck_assert_ptr_null(error);
+    error = tensor_multiplication(y, r, &product);
+    ck_assert_ptr_null(error);
+    error = tensor_summation(product, &cost, NULL, 0, false);
+    ck_assert_ptr_null(error);
+    error = tensor_backward(cost, NULL);
+    ck_assert_ptr_null(error);
+    runtime_synchronize(x->buffer->storage->runtime);
+}
+
+START_TEST(test_zero_gradient)
+{
+    int64_t x_shape[] = {ZERO_GRADIENT_BATCH, ZERO_GRADIENT_INPUT};
+    int64_t weights_shape[] = {ZERO_GRADIENT_INPUT, ZERO_GRADIENT_OUTPUT};
+    int64_t bias_shape[] = {ZERO_GRADIENT_OUTPUT};
+    int64_t r_shape[] = {ZERO_GRADIENT_BATCH, ZERO_GRADIENT_OUTPUT};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int set_to_none = 0; set_to_none < 2; ++set_to_none)
+            {
+                runtime_t runtime = (runtime_t) i;
+                datatype_t datatype = (datatype_t) j;
+                float64_t tolerance = (datatype == FLOAT32) ? 1e-5 : 1e-12;
+                float32_t lower_bound_f = -1.0, upper_bound_f = 1.0;
+                float64_t lower_bound = -1.0, upper_bound = 1.0;
+                void *a = (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound;
+                void *b = (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound;
+                tensor_t *x = NULL, *r = NULL, *weights = NULL, *bias = NULL;
+                tensor_t *parameters[2];
+                int64_t sizes[2] = {ZERO_GRADIENT_INPUT * ZERO_GRADIENT_OUTPUT, ZERO_GRADIENT_OUTPUT};
+                float64_t expected[2][ZERO_GRADIENT_INPUT * ZERO_GRADIENT_OUTPUT];
+                tensor_t *gradients[2];
+                void *data[2];
+                layer_t *layer = NULL;
+                block_t *block = NULL;
+                model_t *model = NULL;
+
+                error = tensor_create_uniform(&x, x_shape, 2, runtime, datatype, false, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&r, r_shape, 2, runtime, datatype, false, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&weights, weights_shape, 2, runtime, datatype, true, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&bias, bias_shape, 1, runtime, datatype, true, true, a, b);
+                ck_assert_ptr_null(error);
+                error = linear_layer_create_from_parameters(&layer, weights, bias);
+                ck_assert_ptr_null(error);
+                error = block_create(&block, 1, layer);
+                ck_assert_ptr_null(error);
+                error = model_create(&model, block);
+                ck_assert_ptr_null(error);
+                parameters[0] = weights;
+                parameters[1] = bias;
+
+                zero_gradient_backward(model, x, r);
+                for (int k = 0; k < 2; ++k)
+                {
+                    ck_assert_ptr_nonnull(parameters[k]->gradient);
+                    gradients[k] = parameters[k]->gradient;
+                    data[k] = parameters[k]->gradient->buffer->storage->data;
+                    for (int64_t l = 0; l < sizes[k]; ++l)
+                    {
+                        expected[k][l] = zero_gradient_element(parameters[k]->gradient, l);
+                    }
+                }
+
+                error = zero_gradient_model(model, (bool_t) set_to_none);
+                ck_assert_ptr_null(error);
+                for (int k = 0; k < 2; ++k)
+                {
+                    if (set_to_none)
+                    {
+                        ck_assert_ptr_null(parameters[k]->gradient);
+                        continue;
+                    }
+
+                    // The gradient buffer is kept and cleared in place.
+                    ck_assert_ptr_eq(parameters[k]->gradient, gradients[k]);
+                    ck_assert_ptr_eq(parameters[k]->gradient->buffer->storage->data, data[k]);
+                    for (int64_t l = 0; l < sizes[k]; ++l)
+                    {
+                        ck_assert_double_eq(zero_gradient_element(parameters[k]->gradient, l), 0.0);
+                    }
+                }
+
+                // Two passes on the same batch accumulate twice the gradient of one, starting from nothing left over.
+                zero_gradient_backward(model, x, r);
+                zero_gradient_backward(model, x, r);
+                for (int k = 0; k < 2; ++k)
+                {
+                    ck_assert_ptr_nonnull(parameters[k]->gradient);
+                    if (!set_to_none)
+                    {
+                        ck_assert_ptr_eq(parameters[k]->gradient->buffer->storage->data, data[k]);
+                    }
+                    for (int64_t l = 0; l < sizes[k]; ++l)
+                    {
+                        ck_assert_double_eq_tol(zero_gradient_element(parameters[k]->gradient, l), 2.0 * expected[k][l], tolerance);
+                    }
+                }
+
+                model_destroy(model);
+                tensor_destroy(x);
+                tensor_destroy(r);
+            }
+        }
+    }
+}
+END_TEST
+
 Suite *make_optimizer_suite(void)
 {
     Suite *s;
     TCase *tc_sgd;
     TCase *tc_rms_prop;
     TCase *tc_adam;
+    TCase *tc_sparse_optimizer;
+    TCase *tc_zero_gradient;
 
     s = suite_create("Test Optimizer Suite");
 
@@ -1392,9 +1788,19 @@ Suite *make_optimizer_suite(void)
     tcase_add_checked_fixture(tc_adam, setup_adam, teardown_adam);
     tcase_add_test(tc_adam, test_adam);
 
+    tc_sparse_optimizer = tcase_create("Test Sparse Optimizer Case");
+    tcase_add_checked_fixture(tc_sparse_optimizer, setup_sparse_optimizer, teardown_sparse_optimizer);
+    tcase_add_test(tc_sparse_optimizer, test_sparse_optimizer);
+
+    tc_zero_gradient = tcase_create("Test Zero Gradient Case");
+    tcase_add_checked_fixture(tc_zero_gradient, setup_zero_gradient, teardown_zero_gradient);
+    tcase_add_test(tc_zero_gradient, test_zero_gradient);
+
     suite_add_tcase(s, tc_sgd);
     suite_add_tcase(s, tc_adam);
     suite_add_tcase(s, tc_rms_prop);
+    suite_add_tcase(s, tc_sparse_optimizer);
+    suite_add_tcase(s, tc_zero_gradient);
 
     return s;
 }
@@ -0,0 +1,672 @@
+#include <check.h>
+#include <omp.h>
+#include <pthread.h>
+#include <string.h>
+#include <runtime.h>
+#include <buffer.h>
+#include <tensor.h>
+#include <random.h>
+#include <errors.h>
+#include <datatype.h>
+#include <slab.h>
+#include <test_helper.h>
+
+// Above the parallel threshold of the generators and not a multiple of a Philox block.
+#define RANDOM_ELEMENTS 65537
+#define RANDOM_SEED 1234
+
+// Four thousand bytes of float32, rounded up to a 4096 byte size class.
+#define ALLOCATOR_ELEMENTS 1000
+#define ALLOCATOR_LARGE_ELEMENTS 100000
+
+// More blocks than fit in one slab of their size class.
+#define SLAB_BLOCKS 5000
+#define TENSOR_IDS 100
+
+nw_error_t *error;
+
+void setup(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static tensor_t *random_tensor(runtime_t runtime, datatype_t datatype, bool_t normal)
+{
+    tensor_t *x = NULL;
+    float32_t lower_bound_f = -2.0, upper_bound_f = 3.0;
+    float64_t lower_bound = -2.0, upper_bound = 3.0;
+    void *a = (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound;
+    void *b = (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound;
+
+    if (normal)
+    {
+        error = tensor_create_normal(&x, (int64_t[]){RANDOM_ELEMENTS}, 1, runtime, datatype, false, true, a, b);
+    }
+    else
+    {
+        error = tensor_create_uniform(&x, (int64_t[]){RANDOM_ELEMENTS}, 1, runtime, datatype, false, true, a, b);
+    }
+    ck_assert_ptr_null(error);
+    runtime_synchronize(runtime);
+
+    return x;
+}
+
+static void ck_assert_random_eq(const tensor_t *x, const tensor_t *y)
+{
+    ck_assert_int_eq(x->buffer->storage->datatype, y->buffer->storage->datatype);
+    ck_assert_int_eq(x->buffer->storage->n, y->buffer->storage->n);
+    ck_assert_mem_eq(x->buffer->storage->data, y->buffer->storage->data, x->buffer->storage->n * datatype_size(x->buffer->storage->datatype));
+}
+
+START_TEST(test_random_thread_count)
+{
+    int threads = omp_get_max_threads();
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int k = 0; k < 2; ++k)
+            {
+                omp_set_num_threads(1);
+                set_seed(RANDOM_SEED);
+                tensor_t *serial = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+
+                omp_set_num_threads(4);
+                set_seed(RANDOM_SEED);
+                tensor_t *parallel = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+
+                ck_assert_random_eq(serial, parallel);
+
+                tensor_destroy(serial);
+                tensor_destroy(parallel);
+            }
+        }
+    }
+
+    omp_set_num_threads(threads);
+}
+END_TEST
+
+START_TEST(test_random_replay)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int k = 0; k < 2; ++k)
+            {
+                set_seed(RANDOM_SEED);
+                ck_assert_uint_eq(get_offset(), 0);
+                tensor_t *first = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+                uint64_t offset = get_offset();
+                tensor_t *second = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+                ck_assert_uint_gt(get_offset(), offset);
+                ck_assert_mem_ne(first->buffer->storage->data, second->buffer->storage->data,
+                                 first->buffer->storage->n * datatype_size(first->buffer->storage->datatype));
+
+                // Reseeding restarts the stream.
+                set_seed(RANDOM_SEED);
+                tensor_t *reseeded = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+                ck_assert_random_eq(first, reseeded);
+
+                // Rewinding the offset replays a later draw.
+                set_offset(offset);
+                tensor_t *replayed = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+                ck_assert_random_eq(second, replayed);
+
+                // Another seed gives another stream.
+                set_seed(RANDOM_SEED + 1);
+                tensor_t *other = random_tensor((runtime_t) i, (datatype_t) j, (bool_t) k);
+                ck_assert_mem_ne(first->buffer->storage->data, other->buffer->storage->data,
+                                 first->buffer->storage->n * datatype_size(first->buffer->storage->datatype));
+
+                tensor_destroy(first);
+                tensor_destroy(second);
+                tensor_destroy(reseeded);
+                tensor_destroy(replayed);
+                tensor_destroy(other);
+            }
+        }
+    }
+}
+END_TEST
+
+static allocator_statistics_t allocator_statistics(runtime_t runtime)
+{
+    allocator_statistics_t statistics;
+
+    runtime_allocator_statistics(runtime, &statistics);
+
+    return statistics;
+}
+
+START_TEST(test_allocator_reuse)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_t runtime = (runtime_t) i;
+        void *data = NULL, *reused = NULL, *other = NULL;
+
+        runtime_allocator_trim(runtime, 0);
+        allocator_statistics_t initial = allocator_statistics(runtime);
+        ck_assert_uint_eq(initial.bytes_cached, 0);
+
+        error = runtime_malloc(&data, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_ptr_nonnull(data);
+        ck_assert_uint_eq((uintptr_t) data % 64, 0);
+        allocator_statistics_t allocated = allocator_statistics(runtime);
+        size_t size = allocated.bytes_in_use - initial.bytes_in_use;
+        ck_assert_uint_ge(size, ALLOCATOR_ELEMENTS * sizeof(float32_t));
+        ck_assert_uint_le(size, ALLOCATOR_ELEMENTS * sizeof(float32_t) * 5 / 4);
+        ck_assert_uint_eq(allocated.misses, initial.misses + 1);
+        ck_assert_uint_eq(allocated.hits, initial.hits);
+
+        // A freed block is cached instead of returned to the system.
+        runtime_free(data, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        allocator_statistics_t freed = allocator_statistics(runtime);
+        ck_assert_uint_eq(freed.bytes_in_use, initial.bytes_in_use);
+        ck_assert_uint_eq(freed.bytes_cached, size);
+
+        // Requests of the same size class get the cached block back whatever their datatype.
+        error = runtime_malloc(&reused, ALLOCATOR_ELEMENTS / 2, FLOAT64, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_ptr_eq(reused, data);
+        allocator_statistics_t hit = allocator_statistics(runtime);
+        ck_assert_uint_eq(hit.hits, initial.hits + 1);
+        ck_assert_uint_eq(hit.misses, initial.misses + 1);
+        ck_assert_uint_eq(hit.bytes_cached, 0);
+        ck_assert_uint_eq(hit.bytes_in_use, allocated.bytes_in_use);
+        ck_assert_double_eq_tol(hit.hit_rate, (float64_t) hit.hits / (float64_t) (hit.hits + hit.misses), 1e-12);
+
+        // Another size class misses the cache.
+        error = runtime_malloc(&other, ALLOCATOR_LARGE_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_ptr_ne(other, reused);
+        ck_assert_uint_eq(allocator_statistics(runtime).misses, initial.misses + 2);
+
+        runtime_free(reused, ALLOCATOR_ELEMENTS / 2, FLOAT64, runtime);
+        runtime_free(other, ALLOCATOR_LARGE_ELEMENTS, FLOAT32, runtime);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_in_use, initial.bytes_in_use);
+
+        error = runtime_malloc(&data, 0, FLOAT32, runtime);
+        ck_assert_ptr_nonnull(error);
+        ck_assert_int_eq(error->error_type, ERROR_MEMORY_ALLOCATION);
+        error_destroy(error);
+        error = NULL;
+    }
+}
+END_TEST
+
+START_TEST(test_allocator_trim)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_t runtime = (runtime_t) i;
+        void *small = NULL, *large = NULL, *data = NULL;
+
+        runtime_allocator_trim(runtime, 0);
+        allocator_statistics_t initial = allocator_statistics(runtime);
+
+        error = runtime_malloc(&small, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        size_t small_size = allocator_statistics(runtime).bytes_in_use - initial.bytes_in_use;
+        error = runtime_malloc(&large, ALLOCATOR_LARGE_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        runtime_free(small, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_free(large, ALLOCATOR_LARGE_ELEMENTS, FLOAT32, runtime);
+        ck_assert_uint_gt(allocator_statistics(runtime).bytes_cached, small_size);
+
+        // Trimming releases the largest size classes first.
+        runtime_allocator_trim(runtime, small_size);
+        allocator_statistics_t trimmed = allocator_statistics(runtime);
+        ck_assert_uint_eq(trimmed.bytes_cached, small_size);
+        ck_assert_uint_eq(trimmed.bytes_in_use, initial.bytes_in_use);
+
+        error = runtime_malloc(&data, ALLOCATOR_LARGE_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_uint_eq(allocator_statistics(runtime).misses, trimmed.misses + 1);
+        runtime_free(data, ALLOCATOR_LARGE_ELEMENTS, FLOAT32, runtime);
+
+        error = runtime_malloc(&data, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_ptr_eq(data, small);
+        ck_assert_uint_eq(allocator_statistics(runtime).hits, trimmed.hits + 1);
+        runtime_free(data, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+
+        runtime_allocator_trim(runtime, 0);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_cached, 0);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_in_use, initial.bytes_in_use);
+    }
+}
+END_TEST
+
+START_TEST(test_arena_rewind)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_t runtime = (runtime_t) i;
+        // Arena blocks are rounded up to the allocator alignment.
+        size_t size = (ALLOCATOR_ELEMENTS * sizeof(float32_t) + 63) / 64 * 64;
+        void *first = NULL, *second = NULL, *rewound = NULL, *outside = NULL;
+
+        runtime_allocator_trim(runtime, 0);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena, 0);
+        uint64_t survivors = allocator_statistics(runtime).arena_survivors;
+
+        // The arena is sized by the demand of the first step, what does not fit comes from the cache.
+        runtime_arena_begin();
+        error = runtime_malloc(&first, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        error = runtime_malloc(&second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(runtime_arena_contains(first, runtime));
+        ck_assert(!runtime_arena_contains(second, runtime));
+        runtime_free(first, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_free(second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_arena_end();
+
+        // Once the step is over the arena grows to the peak demand and later steps bump allocate from it.
+        runtime_arena_begin();
+        error = runtime_malloc(&first, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        error = runtime_malloc(&second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena, 2 * size);
+        ck_assert(runtime_arena_contains(first, runtime));
+        ck_assert(runtime_arena_contains(second, runtime));
+        ck_assert_ptr_eq(second, (char *) first + size);
+
+        // Freeing everything allocated from the arena rewinds it.
+        runtime_free(second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_free(first, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        error = runtime_malloc(&rewound, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert_ptr_eq(rewound, first);
+
+        // Suspended and nested scopes.
+        runtime_arena_suspend(true);
+        error = runtime_malloc(&outside, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(!runtime_arena_contains(outside, runtime));
+        runtime_free(outside, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_arena_suspend(false);
+
+        runtime_arena_begin();
+        runtime_arena_end();
+        error = runtime_malloc(&second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(runtime_arena_contains(second, runtime));
+        runtime_arena_end();
+
+        // Memory that outlives its step stays valid in a retired arena and the next step starts on a fresh one.
+        allocator_statistics_t retired = allocator_statistics(runtime);
+        ck_assert_uint_eq(retired.arena_survivors, survivors + 1);
+        ck_assert_uint_eq(retired.bytes_arena, 0);
+        ck_assert_uint_eq(retired.bytes_arena_retired, 2 * size);
+        ck_assert(runtime_arena_contains(rewound, runtime));
+        runtime_arena_begin();
+        error = runtime_malloc(&outside, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(runtime_arena_contains(outside, runtime));
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena, 2 * size);
+        ck_assert((char *) outside < (char *) rewound || (char *) outside >= (char *) rewound + 2 * size);
+
+        // The retired arena is released along with the last of its blocks.
+        runtime_free(rewound, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena_retired, 2 * size);
+        runtime_free(second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena_retired, 0);
+
+        // A block that does not fit raises the demand, the emptied arena grows to hold it next time.
+        error = runtime_malloc(&first, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        error = runtime_malloc(&second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(!runtime_arena_contains(second, runtime));
+        runtime_free(first, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_free(outside, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        runtime_free(second, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        error = runtime_malloc(&rewound, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(runtime_arena_contains(rewound, runtime));
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena, 3 * size);
+        runtime_free(rewound, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+
+        // A step that frees all of its arena memory is not counted.
+        runtime_arena_end();
+        ck_assert_uint_eq(allocator_statistics(runtime).arena_survivors, survivors + 1);
+
+        // Outside of a scope memory comes from the cache.
+        error = runtime_malloc(&outside, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+        ck_assert_ptr_null(error);
+        ck_assert(!runtime_arena_contains(outside, runtime));
+        runtime_free(outside, ALLOCATOR_ELEMENTS, FLOAT32, runtime);
+
+        // Trimming the whole cache also releases the arena once nothing in it is alive.
+        runtime_allocator_trim(runtime, 0);
+        ck_assert_uint_eq(allocator_statistics(runtime).bytes_arena, 0);
+    }
+}
+END_TEST
+
+START_TEST(test_buffer_persist)
+{
+    int64_t shape[] = {ALLOCATOR_ELEMENTS};
+    int64_t reshaped[] = {ALLOCATOR_ELEMENTS / 8, 8};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = (datatype_t) j;
+            float32_t lower_bound_f = -1.0, upper_bound_f = 1.0;
+            float64_t lower_bound = -1.0, upper_bound = 1.0;
+            void *a = (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound;
+            void *b = (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound;
+            tensor_t *x = NULL, *y = NULL, *z = NULL, *view = NULL;
+            size_t size = ALLOCATOR_ELEMENTS * datatype_size(datatype);
+            void *expected = malloc(size);
+            void *data = NULL;
+
+            ck_assert_ptr_nonnull(expected);
+            runtime_allocator_trim(runtime, 0);
+            runtime_arena_begin();
+
+            // Persistent tensors are created outside the arena.
+            error = tensor_create_uniform(&x, shape, 1, runtime, datatype, false, true, a, b);
+            ck_assert_ptr_null(error);
+            ck_assert(!runtime_arena_contains(x->buffer->storage->data, runtime));
+
+            // A first step sizes the arena for the temporaries of the next one.
+            error = tensor_create_uniform(&y, shape, 1, runtime, datatype, false, false, a, b);
+            ck_assert_ptr_null(error);
+            error = tensor_addition(x, y, &z);
+            ck_assert_ptr_null(error);
+            tensor_destroy(y);
+            tensor_destroy(z);
+            y = NULL;
+            z = NULL;
+
+            error = tensor_create_uniform(&y, shape, 1, runtime, datatype, false, false, a, b);
+            ck_assert_ptr_null(error);
+            ck_assert(runtime_arena_contains(y->buffer->storage->data, runtime));
+            error = tensor_addition(x, y, &z);
+            ck_assert_ptr_null(error);
+            error = tensor_reshape(z, &view, reshaped, 2);
+            ck_assert_ptr_null(error);
+            runtime_synchronize(runtime);
+            ck_assert_ptr_eq(view->buffer->storage, z->buffer->storage);
+            ck_assert(runtime_arena_contains(z->buffer->storage->data, runtime));
+            memcpy(expected, z->buffer->storage->data, size);
+
+            // The storage moves out of the arena with its contents, every buffer sharing it follows.
+            error = buffer_persist(z->buffer);
+            ck_assert_ptr_null(error);
+            ck_assert(!runtime_arena_contains(z->buffer->storage->data, runtime));
+            ck_assert_ptr_eq(view->buffer->storage->data, z->buffer->storage->data);
+            ck_assert_mem_eq(z->buffer->storage->data, expected, size);
+
+            // Storage already outside the arena is left in place.
+            data = x->buffer->storage->data;
+            error = buffer_persist(x->buffer);
+            ck_assert_ptr_null(error);
+            ck_assert_ptr_eq(x->buffer->storage->data, data);
+
+            // With the arena released by everything but the persisted storage it rewinds under it.
+            data = y->buffer->storage->data;
+            tensor_destroy(y);
+            y = NULL;
+            error = tensor_create_uniform(&y, shape, 1, runtime, datatype, false, false, a, b);
+            ck_assert_ptr_null(error);
+            ck_assert_ptr_eq(y->buffer->storage->data, data);
+            runtime_synchronize(runtime);
+            ck_assert_mem_eq(z->buffer->storage->data, expected, size);
+
+            runtime_arena_end();
+
+            tensor_destroy(x);
+            tensor_destroy(y);
+            tensor_destroy(z);
+            tensor_destroy(view);
+            free(expected);
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_slab_reuse)
+{
+    void **blocks = (void **) malloc(SLAB_BLOCKS * sizeof(void *));
+    void **reused = (void **) malloc(SLAB_BLOCKS * sizeof(void *));
+    void *pointer = NULL, *other = NULL;
+
+    ck_assert_ptr_nonnull(blocks);
+    ck_assert_ptr_nonnull(reused);
+
+    // Blocks are aligned like malloc and do not overlap.
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        blocks[i] = slab_malloc(24);
+        ck_assert_ptr_nonnull(blocks[i]);
+        ck_assert_uint_eq((uintptr_t) blocks[i] % 16, 0);
+        memset(blocks[i], (int) (i % 251), 24);
+    }
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        for (int64_t j = 0; j < 24; ++j)
+        {
+            ck_assert_int_eq(((unsigned char *) blocks[i])[j], i % 251);
+        }
+    }
+
+    // Released blocks are handed out again, last released first, to any request of the same size class.
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        slab_free(blocks[i], 24);
+    }
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        reused[i] = slab_malloc(32);
+        ck_assert_ptr_eq(reused[i], blocks[SLAB_BLOCKS - 1 - i]);
+    }
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        slab_free(reused[i], 32);
+    }
+
+    // Trimming keeps the slabs of classes with live objects.
+    pointer = slab_malloc(64);
+    ck_assert_ptr_nonnull(pointer);
+    memset(pointer, 0x5a, 64);
+    slab_trim();
+    for (int64_t i = 0; i < 64; ++i)
+    {
+        ck_assert_int_eq(((unsigned char *) pointer)[i], 0x5a);
+    }
+    other = slab_malloc(64);
+    ck_assert_ptr_ne(other, pointer);
+    slab_free(other, 64);
+    slab_free(pointer, 64);
+
+    // Empty and large requests bypass the pools.
+    pointer = slab_malloc(0);
+    slab_free(pointer, 0);
+    pointer = slab_malloc(4096);
+    ck_assert_ptr_nonnull(pointer);
+    memset(pointer, 0, 4096);
+    slab_free(pointer, 4096);
+    slab_trim();
+
+    free(blocks);
+    free(reused);
+}
+END_TEST
+
+static void *slab_worker(void *argument)
+{
+    void **blocks = (void **) argument;
+
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        blocks[i] = slab_malloc(48);
+    }
+    for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+    {
+        slab_free(blocks[i], 48);
+    }
+
+    return NULL;
+}
+
+START_TEST(test_slab_thread)
+{
+    void **blocks = (void **) malloc(SLAB_BLOCKS * sizeof(void *));
+    void *pointer = NULL, *reused = NULL;
+    pthread_t thread;
+
+    ck_assert_ptr_nonnull(blocks);
+
+    // Pools of a thread are private to it and released when it exits.
+    pointer = slab_malloc(48);
+    ck_assert_ptr_nonnull(pointer);
+    slab_free(pointer, 48);
+    for (int64_t j = 0; j < 2; ++j)
+    {
+        ck_assert_int_eq(pthread_create(&thread, NULL, slab_worker, (void *) blocks), 0);
+        ck_assert_int_eq(pthread_join(thread, NULL), 0);
+        for (int64_t i = 0; i < SLAB_BLOCKS; ++i)
+        {
+            ck_assert_ptr_ne(blocks[i], pointer);
+        }
+    }
+    reused = slab_malloc(48);
+    ck_assert_ptr_eq(reused, pointer);
+    slab_free(reused, 48);
+    slab_trim();
+
+    free(blocks);
+}
+END_TEST
+
+START_TEST(test_tensor_id_reuse)
+{
+    tensor_t *tensors[TENSOR_IDS];
+    tensor_t *released = NULL;
+    uint64_t released_id, maximum_id = 0;
+
+    for (int64_t i = 0; i < TENSOR_IDS; ++i)
+    {
+        error = tensor_create(&tensors[i], NULL, NULL, NULL, false, false);
+        ck_assert_ptr_null(error);
+        maximum_id = (tensors[i]->id > maximum_id) ? tensors[i]->id : maximum_id;
+    }
+
+    // The id and memory of a destroyed tensor go to the next tensor created.
+    released = tensors[TENSOR_IDS / 2];
+    released_id = released->id;
+    tensor_destroy(released);
+    error = tensor_create(&tensors[TENSOR_IDS / 2], NULL, NULL, NULL, false, false);
+    ck_assert_ptr_null(error);
+    ck_assert_uint_eq(tensors[TENSOR_IDS / 2]->id, released_id);
+    ck_assert_ptr_eq(tensors[TENSOR_IDS / 2], released);
+
+    // Ids of live tensors stay distinct while released ids are reused.
+    for (int64_t i = 0; i < TENSOR_IDS; i += 2)
+    {
+        tensor_destroy(tensors[i]);
+    }
+    for (int64_t i = 0; i < TENSOR_IDS; i += 2)
+    {
+        error = tensor_create(&tensors[i], NULL, NULL, NULL, false, false);
+        ck_assert_ptr_null(error);
+    }
+    for (int64_t i = 0; i < TENSOR_IDS; ++i)
+    {
+        for (int64_t j = i + 1; j < TENSOR_IDS; ++j)
+        {
+            ck_assert_uint_ne(tensors[i]->id, tensors[j]->id);
+        }
+        ck_assert_uint_le(tensors[i]->id, maximum_id);
+    }
+
+    // Once every tensor is gone the id space starts over.
+    for (int64_t i = 0; i < TENSOR_IDS; ++i)
+    {
+        tensor_destroy(tensors[i]);
+    }
+    error = tensor_create(&tensors[0], NULL, NULL, NULL, false, false);
+    ck_assert_ptr_null(error);
+    ck_assert_uint_eq(tensors[0]->id, 0);
+    tensor_destroy(tensors[0]);
+}
+END_TEST
+
+Suite *make_runtime_suite(void)
+{
+    Suite *s;
+    TCase *tc_random;
+    TCase *tc_allocator;
+    TCase *tc_arena;
+    TCase *tc_slab;
+
+    s = suite_create("Test Runtime Suite");
+
+    tc_random = tcase_create("Test Random");
+    tcase_add_checked_fixture(tc_random, setup, teardown);
+    tcase_add_test(tc_random, test_random_thread_count);
+    tcase_add_test(tc_random, test_random_replay);
+    suite_add_tcase(s, tc_random);
+
+    tc_allocator = tcase_create("Test Allocator");
+    tcase_add_checked_fixture(tc_allocator, setup, teardown);
+    tcase_add_test(tc_allocator, test_allocator_reuse);
+    tcase_add_test(tc_allocator, test_allocator_trim);
+    suite_add_tcase(s, tc_allocator);
+
+    tc_arena = tcase_create("Test Arena");
+    tcase_add_checked_fixture(tc_arena, setup, teardown);
+    tcase_add_test(tc_arena, test_arena_rewind);
+    tcase_add_test(tc_arena, test_buffer_persist);
+    suite_add_tcase(s, tc_arena);
+
+    tc_slab = tcase_create("Test Slab");
+    tcase_add_checked_fixture(tc_slab, setup, teardown);
+    tcase_add_test(tc_slab, test_slab_reuse);
+    tcase_add_test(tc_slab, test_slab_thread);
+    tcase_add_test(tc_slab, test_tensor_id_reuse);
+    suite_add_tcase(s, tc_slab);
+
+    return s;
+}
+
+int main(void)
+{
+    int number_failed;
+    SRunner *sr;
+
+    sr = srunner_create(make_runtime_suite());
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_VERBOSE);
+
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
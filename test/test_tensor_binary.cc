@@ -17,11 +17,13 @@ extern "C"
 #define BINARY_ELEMENTWISE_CASES_2_0 25
 #define BINARY_ELEMENTWISE_CASES_3_0 61
 #define BINARY_ELEMENTWISE_CASES_4_0 125
+#define BINARY_ELEMENTWISE_CASES_5_0 4
 #define BINARY_ELEMENTWISE_CASES BINARY_ELEMENTWISE_CASES_0_0 + \
                                  BINARY_ELEMENTWISE_CASES_1_0 + \
                                  BINARY_ELEMENTWISE_CASES_2_0 + \
                                  BINARY_ELEMENTWISE_CASES_3_0 + \
-                                 BINARY_ELEMENTWISE_CASES_4_0
+                                 BINARY_ELEMENTWISE_CASES_4_0 + \
+                                 BINARY_ELEMENTWISE_CASES_5_0
 
 std::vector<int64_t> binary_elementwise_shapes_x[BINARY_ELEMENTWISE_CASES] = {
     // Cases 0.0
@@ -264,6 +266,11 @@ std::vector<int64_t> binary_elementwise_shapes_x[BINARY_ELEMENTWISE_CASES] = {
     {6, 5, 4, 3, 2},
     {6, 5, 4, 3, 2},
     {6, 5, 4, 3, 2},
+    // Cases 5.0
+    {2, 1, 3, 1, 2, 2},
+    {2, 3, 1, 2, 2, 1},
+    {2, 2, 1, 2, 1, 2, 1},
+    {1, 2, 1, 2, 1, 2, 1, 2},
 };
 
 std::vector<int64_t> binary_elementwise_shapes_y[BINARY_ELEMENTWISE_CASES] = {
@@ -507,16 +514,23 @@ std::vector<int64_t> binary_elementwise_shapes_y[BINARY_ELEMENTWISE_CASES] = {
     {6, 1, 4, 3, 2},
     {1, 5, 4, 3, 2},
     {6, 5, 4, 3, 2},
+    // Cases 5.0
+    {1, 2, 1, 3, 2, 1},
+    {2, 3, 1, 2, 2, 1},
+    {2, 1, 2},
+    {2, 1, 2, 1, 2, 1, 2, 1},
 };
 
 #define MATRIX_MULTIPLICATION_CASES_0_0 6
 #define MATRIX_MULTIPLICATION_CASES_1_0 14
 #define MATRIX_MULTIPLICATION_CASES_2_0 16
 #define MATRIX_MULTIPLICATION_CASES_3_0 34
+#define MATRIX_MULTIPLICATION_CASES_4_0 3
 #define MATRIX_MULTIPLICATION_CASES MATRIX_MULTIPLICATION_CASES_0_0 + \
                                     MATRIX_MULTIPLICATION_CASES_1_0 + \
                                     MATRIX_MULTIPLICATION_CASES_2_0 + \
-                                    MATRIX_MULTIPLICATION_CASES_3_0
+                                    MATRIX_MULTIPLICATION_CASES_3_0 + \
+                                    MATRIX_MULTIPLICATION_CASES_4_0
 
 
 std::vector<int64_t> matrix_multiplication_shapes_x[MATRIX_MULTIPLICATION_CASES] = {
@@ -594,6 +608,10 @@ std::vector<int64_t> matrix_multiplication_shapes_x[MATRIX_MULTIPLICATION_CASES]
     {2, 5, 3, 6, 4},
     {2, 5, 3, 6, 4},
     {2, 5, 3, 6, 4},
+    // Cases 4.0
+    {2, 1, 2, 1, 3, 4},
+    {2, 2, 1, 2, 1, 3, 4},
+    {1, 2, 1, 2, 1, 2, 3, 4},
 };
 
 std::vector<int64_t> matrix_multiplication_shapes_y[MATRIX_MULTIPLICATION_CASES] = {
@@ -671,6 +689,10 @@ std::vector<int64_t> matrix_multiplication_shapes_y[MATRIX_MULTIPLICATION_CASES]
     {3, 4, 7},
     {1, 4, 7},
     {4, 7},
+    // Cases 4.0
+    {1, 2, 1, 2, 4, 5},
+    {2, 1, 4, 5},
+    {2, 1, 2, 1, 2, 1, 4, 5},
 };
 
 #define CONCATENATION_CASES 5
@@ -1068,12 +1090,1046 @@ START_TEST(test_concatenation)
 }
 END_TEST
 
+#define EMBEDDING_VOCABULARY 8
+#define EMBEDDING_SIZE 5
+
+void setup_embedding(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_embedding(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static float64_t embedding_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == FLOAT32)
+    {
+        return (float64_t) ((float32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((float64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+// Looks up `indices` the way embeddings were computed before the gather kernel, as a one-hot matrix times the weights.
+static tensor_t *embedding_one_hot(const tensor_t *weights, const int64_t *indices, int64_t rows, int64_t columns)
+{
+    int64_t one_hot_shape[] = {rows * columns, EMBEDDING_VOCABULARY};
+    int64_t shape[] = {rows, columns, EMBEDDING_SIZE};
+    datatype_t datatype = weights->buffer->storage->datatype;
+    runtime_t runtime = weights->buffer->storage->runtime;
+    void *data = calloc(rows * columns * EMBEDDING_VOCABULARY, datatype_size(datatype));
+    tensor_t *one_hot = NULL, *product = NULL, *z = NULL;
+
+    ck_assert_ptr_nonnull(data);
+    for (int64_t i = 0; i < rows * columns; ++i)
+    {
+        if (datatype == FLOAT32)
+        {
+            ((float32_t *) data)[i * EMBEDDING_VOCABULARY + indices[i]] = 1.0;
+        }
+        else
+        {
+            ((float64_t *) data)[i * EMBEDDING_VOCABULARY + indices[i]] = 1.0;
+        }
+    }
+
+    error = tensor_from_data(&one_hot, data, runtime, datatype, 2, one_hot_shape, true, false, false);
+    ck_assert_ptr_null(error);
+    error = tensor_matrix_multiplication(one_hot, weights, &product);
+    ck_assert_ptr_null(error);
+    error = tensor_reshape(product, &z, shape, 3);
+    ck_assert_ptr_null(error);
+    free(data);
+
+    return z;
+}
+
+static tensor_t *embedding_indices(const int64_t *indices, int64_t rows, int64_t columns, runtime_t runtime, datatype_t datatype)
+{
+    int64_t shape[] = {rows, columns};
+    tensor_t *x_wide = NULL, *x = NULL;
+
+    error = tensor_from_data(&x_wide, (void *) indices, runtime, INT64, 2, shape, true, false, true);
+    ck_assert_ptr_null(error);
+    error = tensor_cast(x_wide, datatype, &x);
+    ck_assert_ptr_null(error);
+    x->persist = true;
+    tensor_destroy(x_wide);
+
+    return x;
+}
+
+START_TEST(test_embedding)
+{
+    // Repeated ids have to be summed into one gradient row, the last row is never looked up.
+    int64_t indices[] = {0, 6, 2, 2, 5, 0, 1, 6, 6, 3, 2, 0};
+    int64_t other_indices[] = {4, 6, 1};
+    int64_t touched_rows[] = {0, 1, 2, 3, 4, 5, 6};
+    int64_t vocabulary[EMBEDDING_VOCABULARY] = {0, 1, 2, 3, 4, 5, 6, 7};
+    int64_t weights_shape[] = {EMBEDDING_VOCABULARY, EMBEDDING_SIZE};
+    int64_t gradient_shape[] = {3, 4, EMBEDDING_SIZE};
+    int64_t vocabulary_shape[] = {EMBEDDING_VOCABULARY};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int sparse = 0; sparse < 2; ++sparse)
+            {
+                runtime_t runtime = (runtime_t) i;
+                datatype_t datatype = (datatype_t) j;
+                float32_t lower_bound_f = -1.0, upper_bound_f = 1.0;
+                float64_t lower_bound = -1.0, upper_bound = 1.0;
+                void *a = (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound;
+                void *b = (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound;
+                tensor_t *weights = NULL, *weights_expected = NULL, *vocabulary_counter = NULL, *gradient = NULL;
+                tensor_t *x = embedding_indices(indices, 3, 4, runtime, datatype);
+                tensor_t *x_other = embedding_indices(other_indices, 1, 3, runtime, INT64);
+                tensor_t *z = NULL, *z_other = NULL, *product = NULL, *cost = NULL, *cost_other = NULL, *total = NULL;
+                tensor_t *z_expected = NULL, *z_other_expected = NULL, *product_expected = NULL;
+                tensor_t *cost_expected = NULL, *cost_other_expected = NULL, *total_expected = NULL;
+
+                error = tensor_create_uniform(&weights, weights_shape, 2, runtime, datatype, true, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_from_data(&weights_expected, weights->buffer->storage->data, runtime, datatype, 2, weights_shape, true, true, true);
+                ck_assert_ptr_null(error);
+                error = tensor_from_data(&vocabulary_counter, vocabulary, runtime, INT64, 1, vocabulary_shape, true, false, true);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&gradient, gradient_shape, 3, runtime, datatype, false, true, a, b);
+                ck_assert_ptr_null(error);
+
+                error = tensor_embedding(x, weights, vocabulary_counter, (bool_t) sparse, &z);
+                ck_assert_ptr_null(error);
+                error = tensor_embedding(x_other, weights, vocabulary_counter, (bool_t) sparse, &z_other);
+                ck_assert_ptr_null(error);
+                z_expected = embedding_one_hot(weights_expected, indices, 3, 4);
+                z_other_expected = embedding_one_hot(weights_expected, other_indices, 1, 3);
+                runtime_synchronize(runtime);
+
+                // The gather copies rows, so it matches the one-hot product exactly.
+                ck_assert_tensor_equiv(z, z_expected);
+                ck_assert_tensor_equiv(z_other, z_other_expected);
+
+                // Two lookups of the same weights have their gradients merged by row.
+                error = tensor_multiplication(z, gradient, &product);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(product, &cost, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(z_other, &cost_other, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_addition(cost, cost_other, &total);
+                ck_assert_ptr_null(error);
+                error = tensor_backward(total, NULL);
+                ck_assert_ptr_null(error);
+
+                error = tensor_multiplication(z_expected, gradient, &product_expected);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(product_expected, &cost_expected, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(z_other_expected, &cost_other_expected, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_addition(cost_expected, cost_other_expected, &total_expected);
+                ck_assert_ptr_null(error);
+                error = tensor_backward(total_expected, NULL);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+
+                ck_assert_ptr_nonnull(weights->gradient);
+                if (sparse)
+                {
+                    // Only the looked up rows are kept, sorted and without repeats.
+                    ck_assert_ptr_nonnull(weights->gradient_rows);
+                    ck_assert_int_eq(weights->gradient_rows->buffer->storage->datatype, INT64);
+                    ck_assert_int_eq(weights->gradient_rows->buffer->view.shape[0], 7);
+                    ck_assert_int_eq(weights->gradient->buffer->view.shape[0], 7);
+                    ck_assert_int_eq(weights->gradient->buffer->view.shape[1], EMBEDDING_SIZE);
+                    for (int64_t k = 0; k < 7; ++k)
+                    {
+                        int64_t row = ((int64_t *) weights->gradient_rows->buffer->storage->data)[weights->gradient_rows->buffer->view.offset + k];
+                        ck_assert_int_eq(row, touched_rows[k]);
+                        for (int64_t l = 0; l < EMBEDDING_SIZE; ++l)
+                        {
+                            ck_assert_double_eq_tol(embedding_element(weights->gradient, k * EMBEDDING_SIZE + l),
+                                                    embedding_element(weights_expected->gradient, row * EMBEDDING_SIZE + l), 1e-5);
+                        }
+                    }
+
+                    error = tensor_dense_gradient(weights);
+                    ck_assert_ptr_null(error);
+                }
+
+                ck_assert_ptr_null(weights->gradient_rows);
+                ck_assert_tensor_equiv(weights->gradient, weights_expected->gradient);
+
+                tensor_destroy(weights);
+                tensor_destroy(weights_expected);
+                tensor_destroy(vocabulary_counter);
+                tensor_destroy(gradient);
+                tensor_destroy(x);
+                tensor_destroy(x_other);
+            }
+        }
+    }
+}
+END_TEST
+
+#define STORAGE_DATATYPES 2
+
+datatype_t storage_datatypes[STORAGE_DATATYPES] = {
+    BFLOAT16,
+    FLOAT16,
+};
+
+// Relative tolerances for the 8 and 11 significant bits kept by bfloat16 and float16.
+float32_t storage_epsilons[STORAGE_DATATYPES] = {
+    1.0 / 128.0,
+    1.0 / 1024.0,
+};
+
+void setup_storage_datatype(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_storage_datatype(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static tensor_t *storage_uniform(int64_t *shape, int64_t rank, runtime_t runtime)
+{
+    tensor_t *x = NULL;
+    float32_t lower_bound = -1.0, upper_bound = 1.0;
+
+    error = tensor_create_uniform(&x, shape, rank, runtime, FLOAT32, false, true, &lower_bound, &upper_bound);
+    ck_assert_ptr_null(error);
+
+    return x;
+}
+
+static tensor_t *storage_cast(const tensor_t *x, datatype_t datatype, bool_t requires_gradient)
+{
+    tensor_t *y = NULL;
+
+    error = tensor_cast(x, datatype, &y);
+    ck_assert_ptr_null(error);
+    ck_assert_int_eq(y->buffer->storage->datatype, datatype);
+    y->requires_gradient = requires_gradient;
+    y->persist = true;
+
+    return y;
+}
+
+// Compares a storage datatype tensor against its float32 reference relative to the magnitude of the reference.
+static void ck_assert_storage_close(const tensor_t *returned_tensor, const tensor_t *expected_tensor, float32_t epsilon)
+{
+    tensor_t *returned_float = NULL;
+    tensor_t *expected_float = NULL;
+    int64_t n;
+
+    error = tensor_cast(returned_tensor, FLOAT32, &returned_float);
+    ck_assert_ptr_null(error);
+    error = tensor_cast(expected_tensor, FLOAT32, &expected_float);
+    ck_assert_ptr_null(error);
+
+    ck_assert_int_eq(returned_float->buffer->view.rank, expected_float->buffer->view.rank);
+    for (int64_t i = 0; i < expected_float->buffer->view.rank; ++i)
+    {
+        ck_assert_int_eq(returned_float->buffer->view.shape[i], expected_float->buffer->view.shape[i]);
+    }
+
+    error = view_logical_size(&expected_float->buffer->view, &n);
+    ck_assert_ptr_null(error);
+    for (int64_t i = 0; i < n; ++i)
+    {
+        float32_t returned = ((float32_t *) returned_float->buffer->storage->data)[i];
+        float32_t expected = ((float32_t *) expected_float->buffer->storage->data)[i];
+        ck_assert_float_eq_tol(returned, expected, epsilon * (1.0 + fabs(expected)));
+    }
+
+    tensor_destroy(returned_float);
+    tensor_destroy(expected_float);
+}
+
+START_TEST(test_storage_datatype_round_trip)
+{
+    // Every value is exactly representable in both storage datatypes.
+    float32_t exact[] = {0.0, 1.0, -2.0, 0.5, -0.25, 3.0, 1024.0, -0.125};
+    int64_t exact_shape[] = {2, 4};
+    int64_t shape[] = {8, 16};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < STORAGE_DATATYPES; ++j)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = storage_datatypes[j];
+            tensor_t *x = NULL, *x_reduced = NULL, *x_float = NULL;
+            tensor_t *y = NULL, *y_reduced = NULL, *y_float = NULL, *y_twice = NULL;
+
+            error = tensor_from_data(&x, exact, runtime, FLOAT32, 2, exact_shape, true, false, true);
+            ck_assert_ptr_null(error);
+            x_reduced = storage_cast(x, datatype, false);
+            ck_assert_int_eq(x_reduced->buffer->storage->n, 8);
+            x_float = storage_cast(x_reduced, FLOAT32, false);
+            ck_assert_tensor_eq(x_float, x);
+
+            // Rounding to the storage datatype loses at most half a unit in the last place and is idempotent.
+            y = storage_uniform(shape, 2, runtime);
+            y_reduced = storage_cast(y, datatype, false);
+            y_float = storage_cast(y_reduced, FLOAT32, false);
+            ck_assert_storage_close(y_float, y, storage_epsilons[j] / 2.0);
+            y_twice = storage_cast(y_float, datatype, false);
+            ck_assert_mem_eq(y_twice->buffer->storage->data, y_reduced->buffer->storage->data,
+                             y_reduced->buffer->storage->n * datatype_size(datatype));
+
+            tensor_destroy(x);
+            tensor_destroy(x_reduced);
+            tensor_destroy(x_float);
+            tensor_destroy(y);
+            tensor_destroy(y_reduced);
+            tensor_destroy(y_float);
+            tensor_destroy(y_twice);
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_storage_datatype_arithmetic)
+{
+    int64_t shape_x[] = {4, 8, 16};
+    int64_t shape_w[] = {16, 12};
+    int64_t slice[] = {1, 3, 2, 6, 4, 16};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < STORAGE_DATATYPES; ++j)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = storage_datatypes[j];
+            float32_t epsilon = storage_epsilons[j];
+            tensor_t *x_source = storage_uniform(shape_x, 3, runtime);
+            tensor_t *y_source = storage_uniform(shape_x, 3, runtime);
+            tensor_t *w_source = storage_uniform(shape_w, 2, runtime);
+            // The float32 reference starts from the rounded values so only the arithmetic is compared.
+            tensor_t *x = storage_cast(x_source, datatype, true);
+            tensor_t *y = storage_cast(y_source, datatype, true);
+            tensor_t *w = storage_cast(w_source, datatype, true);
+            tensor_t *x_expected = storage_cast(x, FLOAT32, true);
+            tensor_t *y_expected = storage_cast(y, FLOAT32, true);
+            tensor_t *w_expected = storage_cast(w, FLOAT32, true);
+            tensor_t *sum = NULL, *product = NULL, *z = NULL, *cost = NULL;
+            tensor_t *sum_expected = NULL, *product_expected = NULL, *z_expected = NULL, *cost_expected = NULL;
+
+            error = tensor_addition(x, y, &sum);
+            ck_assert_ptr_null(error);
+            error = tensor_addition(x_expected, y_expected, &sum_expected);
+            ck_assert_ptr_null(error);
+            ck_assert_int_eq(sum->buffer->storage->datatype, datatype);
+            ck_assert_storage_close(sum, sum_expected, epsilon);
+
+            error = tensor_multiplication(sum, x, &product);
+            ck_assert_ptr_null(error);
+            error = tensor_multiplication(sum_expected, x_expected, &product_expected);
+            ck_assert_ptr_null(error);
+            ck_assert_storage_close(product, product_expected, 2 * epsilon);
+
+            error = tensor_matrix_multiplication(product, w, &z);
+            ck_assert_ptr_null(error);
+            error = tensor_matrix_multiplication(product_expected, w_expected, &z_expected);
+            ck_assert_ptr_null(error);
+            ck_assert_int_eq(z->buffer->storage->datatype, datatype);
+            ck_assert_storage_close(z, z_expected, 4 * epsilon);
+
+            error = tensor_summation(z, &cost, NULL, 0, false);
+            ck_assert_ptr_null(error);
+            error = tensor_summation(z_expected, &cost_expected, NULL, 0, false);
+            ck_assert_ptr_null(error);
+            error = tensor_backward(cost, NULL);
+            ck_assert_ptr_null(error);
+            error = tensor_backward(cost_expected, NULL);
+            ck_assert_ptr_null(error);
+
+            // Gradients are stored in the datatype of their tensor.
+            ck_assert_int_eq(x->gradient->buffer->storage->datatype, datatype);
+            ck_assert_int_eq(w->gradient->buffer->storage->datatype, datatype);
+            ck_assert_storage_close(x->gradient, x_expected->gradient, 4 * epsilon);
+            ck_assert_storage_close(y->gradient, y_expected->gradient, 4 * epsilon);
+            ck_assert_storage_close(w->gradient, w_expected->gradient, 4 * epsilon);
+
+            // Views into the middle of a storage only convert the span they cover.
+            tensor_t *x_slice = NULL, *y_slice = NULL, *slice_sum = NULL, *slice_exponential = NULL;
+            tensor_t *x_slice_expected = NULL, *y_slice_expected = NULL, *slice_sum_expected = NULL, *slice_exponential_expected = NULL;
+
+            with_no_gradient(true);
+            error = tensor_slice(x, &x_slice, slice, 6);
+            ck_assert_ptr_null(error);
+            error = tensor_slice(y, &y_slice, slice, 6);
+            ck_assert_ptr_null(error);
+            error = tensor_slice(x_expected, &x_slice_expected, slice, 6);
+            ck_assert_ptr_null(error);
+            error = tensor_slice(y_expected, &y_slice_expected, slice, 6);
+            ck_assert_ptr_null(error);
+            ck_assert_int_ne(x_slice->buffer->view.offset, 0);
+
+            error = tensor_addition(x_slice, y_slice, &slice_sum);
+            ck_assert_ptr_null(error);
+            error = tensor_addition(x_slice_expected, y_slice_expected, &slice_sum_expected);
+            ck_assert_ptr_null(error);
+            ck_assert_storage_close(slice_sum, slice_sum_expected, epsilon);
+
+            error = tensor_exponential(x_slice, &slice_exponential);
+            ck_assert_ptr_null(error);
+            error = tensor_exponential(x_slice_expected, &slice_exponential_expected);
+            ck_assert_ptr_null(error);
+            ck_assert_storage_close(slice_exponential, slice_exponential_expected, epsilon);
+            with_no_gradient(false);
+
+            tensor_destroy(slice_sum);
+            tensor_destroy(slice_sum_expected);
+            tensor_destroy(slice_exponential);
+            tensor_destroy(slice_exponential_expected);
+            tensor_destroy(x_slice);
+            tensor_destroy(y_slice);
+            tensor_destroy(x_slice_expected);
+            tensor_destroy(y_slice_expected);
+            tensor_destroy(x_source);
+            tensor_destroy(y_source);
+            tensor_destroy(w_source);
+            tensor_destroy(x);
+            tensor_destroy(y);
+            tensor_destroy(w);
+            tensor_destroy(x_expected);
+            tensor_destroy(y_expected);
+            tensor_destroy(w_expected);
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_storage_datatype_save_load)
+{
+    int64_t shape[] = {3, 5, 7};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < STORAGE_DATATYPES; ++j)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = storage_datatypes[j];
+            tensor_t *x_source = storage_uniform(shape, 3, runtime);
+            tensor_t *x = storage_cast(x_source, datatype, true);
+            tensor_t *loaded = NULL;
+            FILE *file = tmpfile();
+
+            ck_assert_ptr_nonnull(file);
+            error = tensor_save(x, file);
+            ck_assert_ptr_null(error);
+            rewind(file);
+            error = tensor_load(&loaded, file);
+            ck_assert_ptr_null(error);
+            fclose(file);
+
+            // The two byte encoding is written as is, so the load is bit exact.
+            ck_assert_int_eq(loaded->buffer->storage->datatype, datatype);
+            ck_assert_int_eq(loaded->buffer->storage->n, x->buffer->storage->n);
+            ck_assert_view_eq(&loaded->buffer->view, &x->buffer->view);
+            ck_assert_mem_eq(loaded->buffer->storage->data, x->buffer->storage->data,
+                             x->buffer->storage->n * datatype_size(datatype));
+            ck_assert(loaded->requires_gradient);
+
+            tensor_destroy(x_source);
+            tensor_destroy(x);
+            tensor_destroy(loaded);
+        }
+    }
+}
+END_TEST
+
+#define INTEGER_DATATYPES 2
+
+datatype_t integer_datatypes[INTEGER_DATATYPES] = {
+    INT32,
+    INT64,
+};
+
+void setup_integer_datatype(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_integer_datatype(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static int64_t integer_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == INT32)
+    {
+        return (int64_t) ((int32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((int64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+START_TEST(test_integer_datatype_creation)
+{
+    int64_t shape[] = {2, 3};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < INTEGER_DATATYPES; ++j)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = integer_datatypes[j];
+            tensor_t *zeroes = NULL, *ones = NULL, *range = NULL;
+            // Scalar arguments are given in the compute datatype.
+            float64_t start = -2.0, stop = 7.0, step = 3.0;
+
+            error = tensor_create_zeroes(&zeroes, shape, 2, runtime, datatype, false, true);
+            ck_assert_ptr_null(error);
+            error = tensor_create_ones(&ones, shape, 2, runtime, datatype, false, true);
+            ck_assert_ptr_null(error);
+            error = tensor_arange(&range, &start, &stop, &step, runtime, datatype, false, true);
+            ck_assert_ptr_null(error);
+
+            ck_assert_int_eq(zeroes->buffer->storage->datatype, datatype);
+            ck_assert_int_eq(ones->buffer->storage->datatype, datatype);
+            ck_assert_int_eq(range->buffer->storage->datatype, datatype);
+            for (int64_t k = 0; k < 6; ++k)
+            {
+                ck_assert_int_eq(integer_element(zeroes, k), 0);
+                ck_assert_int_eq(integer_element(ones, k), 1);
+            }
+            ck_assert_int_eq(range->buffer->view.shape[0], 3);
+            for (int64_t k = 0; k < 3; ++k)
+            {
+                ck_assert_int_eq(integer_element(range, k), -2 + 3 * k);
+            }
+
+            tensor_destroy(zeroes);
+            tensor_destroy(ones);
+            tensor_destroy(range);
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_integer_datatype_cast)
+{
+    int64_t values[] = {-3, 0, 7, 123456789, -2147483647 - 1, 2147483647};
+    // Casting from floating point rounds half to even.
+    float32_t rounded[] = {-2.5, -0.4, 0.5, 1.5, 2.4, 3.6};
+    int64_t expected_rounded[] = {-2, 0, 0, 2, 2, 4};
+    int64_t shape[] = {2, 3};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_t runtime = (runtime_t) i;
+        tensor_t *x = NULL, *x_narrow = NULL, *x_wide = NULL, *x_float = NULL, *x_back = NULL;
+        tensor_t *y = NULL, *y_integer = NULL;
+
+        error = tensor_from_data(&x, values, runtime, INT64, 2, shape, true, false, true);
+        ck_assert_ptr_null(error);
+        ck_assert_int_eq(x->buffer->storage->datatype, INT64);
+
+        error = tensor_cast(x, INT32, &x_narrow);
+        ck_assert_ptr_null(error);
+        ck_assert_int_eq(x_narrow->buffer->storage->datatype, INT32);
+        error = tensor_cast(x_narrow, INT64, &x_wide);
+        ck_assert_ptr_null(error);
+        error = tensor_cast(x_narrow, FLOAT64, &x_float);
+        ck_assert_ptr_null(error);
+        error = tensor_cast(x_float, INT32, &x_back);
+        ck_assert_ptr_null(error);
+        for (int64_t k = 0; k < 6; ++k)
+        {
+            ck_assert_int_eq(integer_element(x_narrow, k), values[k]);
+            ck_assert_int_eq(integer_element(x_wide, k), values[k]);
+            ck_assert_double_eq(((float64_t *) x_float->buffer->storage->data)[k], (float64_t) values[k]);
+            ck_assert_int_eq(integer_element(x_back, k), values[k]);
+        }
+
+        error = tensor_from_data(&y, rounded, runtime, FLOAT32, 2, shape, true, false, true);
+        ck_assert_ptr_null(error);
+        error = tensor_cast(y, INT32, &y_integer);
+        ck_assert_ptr_null(error);
+        for (int64_t k = 0; k < 6; ++k)
+        {
+            ck_assert_int_eq(integer_element(y_integer, k), expected_rounded[k]);
+        }
+
+        tensor_destroy(x);
+        tensor_destroy(x_narrow);
+        tensor_destroy(x_wide);
+        tensor_destroy(x_float);
+        tensor_destroy(x_back);
+        tensor_destroy(y);
+        tensor_destroy(y_integer);
+    }
+}
+END_TEST
+
+START_TEST(test_integer_datatype_argument_maximum)
+{
+    int64_t shape[] = {3, 4, 5};
+    int64_t large_shape[] = {4};
+    int64_t large[] = {(INT64_C(1) << 60) + 1, (INT64_C(1) << 60) + 3, (INT64_C(1) << 60) + 2, (INT64_C(1) << 60) + 3};
+    float32_t values_f[60];
+    int64_t values[60];
+
+    // Few distinct values, so every axis has ties and the first maximum has to be returned.
+    for (int64_t k = 0; k < 60; ++k)
+    {
+        values[k] = (k * 37) % 11 - 5;
+        values_f[k] = (float32_t) values[k];
+    }
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < INTEGER_DATATYPES; ++j)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = integer_datatypes[j];
+            tensor_t *x_float = NULL, *x_wide = NULL, *x = NULL;
+            tensor_t *x_float_transpose = NULL, *x_transpose = NULL;
+
+            error = tensor_from_data(&x_float, values_f, runtime, FLOAT32, 3, shape, true, false, true);
+            ck_assert_ptr_null(error);
+            error = tensor_from_data(&x_wide, values, runtime, INT64, 3, shape, true, false, true);
+            ck_assert_ptr_null(error);
+            error = tensor_cast(x_wide, datatype, &x);
+            ck_assert_ptr_null(error);
+            error = tensor_transpose(x_float, &x_float_transpose, 0, 2);
+            ck_assert_ptr_null(error);
+            error = tensor_transpose(x, &x_transpose, 0, 2);
+            ck_assert_ptr_null(error);
+
+            // The float path is checked against torch, integer inputs have to agree with it.
+            for (int transpose = 0; transpose < 2; ++transpose)
+            {
+                for (int64_t axis = 0; axis < 3; ++axis)
+                {
+                    for (int keep_dimension = 0; keep_dimension < 2; ++keep_dimension)
+                    {
+                        tensor_t *returned = NULL, *expected = NULL, *expected_contiguous = NULL;
+                        int64_t n;
+
+                        error = tensor_argument_maximum((transpose) ? x_transpose : x, &returned, axis, (bool_t) keep_dimension);
+                        ck_assert_ptr_null(error);
+                        error = tensor_argument_maximum((transpose) ? x_float_transpose : x_float, &expected, axis, (bool_t) keep_dimension);
+                        ck_assert_ptr_null(error);
+                        error = tensor_contiguous(expected, &expected_contiguous);
+                        ck_assert_ptr_null(error);
+                        runtime_synchronize(runtime);
+
+                        ck_assert_int_eq(returned->buffer->storage->datatype, INT64);
+                        ck_assert_int_eq(returned->buffer->view.rank, expected->buffer->view.rank);
+                        for (int64_t k = 0; k < expected->buffer->view.rank; ++k)
+                        {
+                            ck_assert_int_eq(returned->buffer->view.shape[k], expected->buffer->view.shape[k]);
+                        }
+                        error = tensor_number_of_elements(expected, &n);
+                        ck_assert_ptr_null(error);
+                        for (int64_t k = 0; k < n; ++k)
+                        {
+                            ck_assert_int_eq(integer_element(returned, k), integer_element(expected_contiguous, k));
+                        }
+
+                        if (expected_contiguous != expected)
+                        {
+                            tensor_destroy(expected_contiguous);
+                        }
+                        tensor_destroy(returned);
+                        tensor_destroy(expected);
+                    }
+                }
+            }
+
+            tensor_destroy(x_float);
+            tensor_destroy(x_wide);
+            tensor_destroy(x);
+            tensor_destroy(x_float_transpose);
+            tensor_destroy(x_transpose);
+        }
+
+        // Indices are compared natively, values that only differ beyond float64 precision are told apart.
+        tensor_t *x = NULL, *returned = NULL;
+
+        error = tensor_from_data(&x, large, (runtime_t) i, INT64, 1, large_shape, true, false, true);
+        ck_assert_ptr_null(error);
+        error = tensor_argument_maximum(x, &returned, 0, false);
+        ck_assert_ptr_null(error);
+        ck_assert_int_eq(returned->buffer->storage->datatype, INT64);
+        ck_assert_int_eq(returned->buffer->view.rank, 0);
+        ck_assert_int_eq(integer_element(returned, 0), 1);
+
+        tensor_destroy(x);
+        tensor_destroy(returned);
+    }
+}
+END_TEST
+
+START_TEST(test_integer_datatype_embedding)
+{
+    int64_t weights_shape[] = {4, 3};
+    int64_t indices_shape[] = {2, 3};
+    int64_t vocabulary_shape[] = {4};
+    int64_t indices[] = {0, 1, 2, 3, 1, 0};
+    float32_t indices_f[] = {0.0, 1.0, 2.0, 3.0, 1.0, 0.0};
+    int64_t vocabulary[] = {0, 1, 2, 3};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int k = 0; k < INTEGER_DATATYPES; ++k)
+            {
+                runtime_t runtime = (runtime_t) i;
+                datatype_t datatype = (datatype_t) j;
+                tensor_t *weights = NULL, *vocabulary_counter = NULL;
+                tensor_t *x_wide = NULL, *x = NULL, *x_transpose = NULL;
+                tensor_t *x_float = NULL, *x_float_transpose = NULL;
+                tensor_t *returned = NULL, *expected = NULL;
+                float32_t lower_bound_f = -1.0, upper_bound_f = 1.0;
+                float64_t lower_bound = -1.0, upper_bound = 1.0;
+
+                error = tensor_create_uniform(&weights, weights_shape, 2, runtime, datatype, false, true,
+                                              (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound,
+                                              (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound);
+                ck_assert_ptr_null(error);
+                error = tensor_from_data(&vocabulary_counter, vocabulary, runtime, INT64, 1, vocabulary_shape, true, false, true);
+                ck_assert_ptr_null(error);
+
+                // Strided integer indices are read in place.
+                error = tensor_from_data(&x_wide, indices, runtime, INT64, 2, indices_shape, true, false, true);
+                ck_assert_ptr_null(error);
+                error = tensor_cast(x_wide, integer_datatypes[k], &x);
+                ck_assert_ptr_null(error);
+                error = tensor_transpose(x, &x_transpose, 0, 1);
+                ck_assert_ptr_null(error);
+                error = tensor_from_data(&x_float, indices_f, runtime, FLOAT32, 2, indices_shape, true, false, true);
+                ck_assert_ptr_null(error);
+                error = tensor_transpose(x_float, &x_float_transpose, 0, 1);
+                ck_assert_ptr_null(error);
+
+                error = tensor_embedding(x_transpose, weights, vocabulary_counter, false, &returned);
+                ck_assert_ptr_null(error);
+                error = tensor_embedding(x_float_transpose, weights, vocabulary_counter, false, &expected);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+
+                ck_assert_int_eq(returned->buffer->storage->datatype, datatype);
+                ck_assert_tensor_equiv(returned, expected);
+                for (int64_t l = 0; l < 3; ++l)
+                {
+                    for (int64_t m = 0; m < 2; ++m)
+                    {
+                        for (int64_t o = 0; o < 3; ++o)
+                        {
+                            int64_t row = indices[m * 3 + l];
+                            if (datatype == FLOAT32)
+                            {
+                                ck_assert_float_eq(((float32_t *) returned->buffer->storage->data)[(l * 2 + m) * 3 + o],
+                                                   ((float32_t *) weights->buffer->storage->data)[row * 3 + o]);
+                            }
+                            else
+                            {
+                                ck_assert_double_eq(((float64_t *) returned->buffer->storage->data)[(l * 2 + m) * 3 + o],
+                                                    ((float64_t *) weights->buffer->storage->data)[row * 3 + o]);
+                            }
+                        }
+                    }
+                }
+
+                tensor_destroy(weights);
+                tensor_destroy(vocabulary_counter);
+                tensor_destroy(x_wide);
+                tensor_destroy(x);
+                tensor_destroy(x_transpose);
+                tensor_destroy(x_float);
+                tensor_destroy(x_float_transpose);
+                tensor_destroy(returned);
+                tensor_destroy(expected);
+            }
+        }
+    }
+}
+END_TEST
+
+#define INPLACE_CASES 4
+#define INPLACE_ROWS 6
+#define INPLACE_COLUMNS 5
+
+typedef enum inplace_operation_t
+{
+    INPLACE_ADDITION,
+    INPLACE_SUBTRACTION,
+    INPLACE_MULTIPLICATION,
+    INPLACE_SCALED_ADDITION
+} inplace_operation_t;
+
+void setup_inplace(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_inplace(void)
+{
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    with_no_gradient(false);
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static float64_t inplace_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == FLOAT32)
+    {
+        return (float64_t) ((float32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((float64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+static nw_error_t *inplace_apply(inplace_operation_t operation, tensor_t *x, const tensor_t *y)
+{
+    float32_t alpha_f = -0.5;
+    float64_t alpha = -0.5;
+
+    switch (operation)
+    {
+    case INPLACE_ADDITION:
+        return tensor_addition_inplace(x, y);
+    case INPLACE_SUBTRACTION:
+        return tensor_subtraction_inplace(x, y);
+    case INPLACE_MULTIPLICATION:
+        return tensor_multiplication_inplace(x, y);
+    case INPLACE_SCALED_ADDITION:
+        return tensor_scaled_add_inplace(x, y, (x->buffer->storage->datatype == FLOAT32) ? (void *) &alpha_f : (void *) &alpha);
+    default:
+        return NULL;
+    }
+}
+
+static float64_t inplace_expected(inplace_operation_t operation, float64_t x, float64_t y)
+{
+    switch (operation)
+    {
+    case INPLACE_ADDITION:
+        return x + y;
+    case INPLACE_SUBTRACTION:
+        return x - y;
+    case INPLACE_MULTIPLICATION:
+        return x * y;
+    case INPLACE_SCALED_ADDITION:
+        return x - 0.5 * y;
+    default:
+        return x;
+    }
+}
+
+// Expects an in place operation to be rejected without touching `x`.
+static void ck_assert_inplace_rejected(inplace_operation_t operation, tensor_t *x, const tensor_t *y)
+{
+    size_t size = x->buffer->storage->n * datatype_size(x->buffer->storage->datatype);
+    void *data = malloc(size);
+
+    ck_assert_ptr_nonnull(data);
+    memcpy(data, x->buffer->storage->data, size);
+    error = inplace_apply(operation, x, y);
+    ck_assert_ptr_nonnull(error);
+    ck_assert_int_eq(error->error_type, ERROR_REQUIRES_GRADIENT);
+    error_destroy(error);
+    error = NULL;
+    ck_assert_mem_eq(x->buffer->storage->data, data, size);
+    free(data);
+}
+
+START_TEST(test_inplace)
+{
+    int64_t shape[] = {INPLACE_ROWS, INPLACE_COLUMNS};
+    int64_t broadcast_shape[] = {INPLACE_COLUMNS};
+
+    for (int i = 0; i < RUNTIMES; ++i)
+    {
+        for (int j = 0; j < DATATYPES; ++j)
+        {
+            for (int k = 0; k < INPLACE_CASES; ++k)
+            {
+                runtime_t runtime = (runtime_t) i;
+                datatype_t datatype = (datatype_t) j;
+                inplace_operation_t operation = (inplace_operation_t) k;
+                float64_t tolerance = (datatype == FLOAT32) ? 1e-6 : 1e-12;
+                float32_t lower_bound_f = -1.0, upper_bound_f = 1.0;
+                float64_t lower_bound = -1.0, upper_bound = 1.0;
+                void *a = (datatype == FLOAT32) ? (void *) &lower_bound_f : (void *) &lower_bound;
+                void *b = (datatype == FLOAT32) ? (void *) &upper_bound_f : (void *) &upper_bound;
+                tensor_t *x = NULL, *x_gradient = NULL, *y = NULL, *y_gradient = NULL, *y_broadcast = NULL, *z = NULL;
+                tensor_t *product = NULL, *cost = NULL;
+                float64_t initial[INPLACE_ROWS * INPLACE_COLUMNS];
+
+                error = tensor_create_uniform(&x, shape, 2, runtime, datatype, false, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&x_gradient, shape, 2, runtime, datatype, true, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&y, shape, 2, runtime, datatype, false, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&y_gradient, shape, 2, runtime, datatype, true, true, a, b);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&y_broadcast, broadcast_shape, 1, runtime, datatype, false, true, a, b);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+
+                // In place updates are not recorded, so they are refused while either operand is tracked.
+                ck_assert_inplace_rejected(operation, x_gradient, y);
+                ck_assert_inplace_rejected(operation, x, y_gradient);
+
+                // A result still part of the graph is refused even without gradient tracking.
+                error = tensor_addition(x_gradient, y, &z);
+                ck_assert_ptr_null(error);
+                ck_assert_ptr_nonnull(z->context);
+                with_no_gradient(true);
+                ck_assert_inplace_rejected(operation, z, y);
+
+                // Without gradient tracking leaves are updated in place, with `y` broadcast to the shape of `x`.
+                for (int64_t l = 0; l < INPLACE_ROWS * INPLACE_COLUMNS; ++l)
+                {
+                    initial[l] = inplace_element(x_gradient, l);
+                }
+                error = inplace_apply(operation, x_gradient, y);
+                ck_assert_ptr_null(error);
+                error = inplace_apply(operation, x_gradient, y_broadcast);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+                with_no_gradient(false);
+                ck_assert(x_gradient->requires_gradient);
+                for (int64_t l = 0; l < INPLACE_ROWS * INPLACE_COLUMNS; ++l)
+                {
+                    float64_t expected = inplace_expected(operation, inplace_expected(operation, initial[l], inplace_element(y, l)),
+                                                          inplace_element(y_broadcast, l % INPLACE_COLUMNS));
+                    ck_assert_double_eq_tol(inplace_element(x_gradient, l), expected, tolerance);
+                }
+
+                // The graph of `z` saw `x_gradient` before the update and refuses to back propagate through it.
+                error = tensor_summation(z, &cost, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_backward(cost, NULL);
+                ck_assert_ptr_nonnull(error);
+                error_destroy(error);
+                error = NULL;
+                cost = NULL;
+                ck_assert_ptr_null(x_gradient->gradient);
+
+                // The gradient of a product is the other operand as it was when the product was taken.
+                error = tensor_multiplication(x, y_gradient, &product);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(product, &cost, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_backward(cost, NULL);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+                product = NULL;
+                cost = NULL;
+                ck_assert_ptr_nonnull(y_gradient->gradient);
+                for (int64_t l = 0; l < INPLACE_ROWS * INPLACE_COLUMNS; ++l)
+                {
+                    initial[l] = inplace_element(x, l);
+                    ck_assert_double_eq_tol(inplace_element(y_gradient->gradient, l), initial[l], tolerance);
+                }
+
+                // Updating `x` while another product still holds it would change that gradient, so back propagation fails.
+                error = tensor_multiplication(x, y_gradient, &product);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(product, &cost, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = inplace_apply(operation, x, y);
+                ck_assert_ptr_null(error);
+                error = tensor_backward(cost, NULL);
+                ck_assert_ptr_nonnull(error);
+                error_destroy(error);
+                error = NULL;
+                cost = NULL;
+                runtime_synchronize(runtime);
+                for (int64_t l = 0; l < INPLACE_ROWS * INPLACE_COLUMNS; ++l)
+                {
+                    ck_assert_double_eq_tol(inplace_element(y_gradient->gradient, l), initial[l], tolerance);
+                }
+
+                // Untracked operands need no guard.
+                for (int64_t l = 0; l < INPLACE_ROWS * INPLACE_COLUMNS; ++l)
+                {
+                    initial[l] = inplace_element(x, l);
+                }
+                error = inplace_apply(operation, x, y);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+                for (int64_t l = 0; l < INPLACE_ROWS * INPLACE_COLUMNS; ++l)
+                {
+                    ck_assert_double_eq_tol(inplace_element(x, l), inplace_expected(operation, initial[l], inplace_element(y, l)), tolerance);
+                }
+
+                tensor_destroy(x);
+                tensor_destroy(x_gradient);
+                tensor_destroy(y);
+                tensor_destroy(y_gradient);
+                tensor_destroy(y_broadcast);
+                tensor_destroy(z);
+                tensor_destroy(product);
+            }
+        }
+    }
+}
+END_TEST
+
 Suite *make_binary_suite(void)
 {
     Suite *s;
     TCase *tc_binary_elementwise;
     TCase *tc_matrix_multiplication;
     TCase *tc_concatenation;
+    TCase *tc_embedding;
+    TCase *tc_storage_datatype;
+    TCase *tc_integer_datatype;
+    TCase *tc_inplace;
 
     s = suite_create("Test Binary Tensor Suite");
 
@@ -1096,9 +2152,34 @@ Suite *make_binary_suite(void)
     tcase_add_checked_fixture(tc_concatenation, setup_concatenation, teardown_concatenation);
     tcase_add_test(tc_concatenation, test_concatenation);
 
+    tc_embedding = tcase_create("Test Embedding Case");
+    tcase_add_checked_fixture(tc_embedding, setup_embedding, teardown_embedding);
+    tcase_add_test(tc_embedding, test_embedding);
+
+    tc_storage_datatype = tcase_create("Test Storage Datatype Case");
+    tcase_add_checked_fixture(tc_storage_datatype, setup_storage_datatype, teardown_storage_datatype);
+    tcase_add_test(tc_storage_datatype, test_storage_datatype_round_trip);
+    tcase_add_test(tc_storage_datatype, test_storage_datatype_arithmetic);
+    tcase_add_test(tc_storage_datatype, test_storage_datatype_save_load);
+
+    tc_integer_datatype = tcase_create("Test Integer Datatype Case");
+    tcase_add_checked_fixture(tc_integer_datatype, setup_integer_datatype, teardown_integer_datatype);
+    tcase_add_test(tc_integer_datatype, test_integer_datatype_creation);
+    tcase_add_test(tc_integer_datatype, test_integer_datatype_cast);
+    tcase_add_test(tc_integer_datatype, test_integer_datatype_argument_maximum);
+    tcase_add_test(tc_integer_datatype, test_integer_datatype_embedding);
+
+    tc_inplace = tcase_create("Test Inplace Case");
+    tcase_add_checked_fixture(tc_inplace, setup_inplace, teardown_inplace);
+    tcase_add_test(tc_inplace, test_inplace);
+
     suite_add_tcase(s, tc_binary_elementwise);
     suite_add_tcase(s, tc_matrix_multiplication);
     suite_add_tcase(s, tc_concatenation);
+    suite_add_tcase(s, tc_embedding);
+    suite_add_tcase(s, tc_storage_datatype);
+    suite_add_tcase(s, tc_integer_datatype);
+    suite_add_tcase(s, tc_inplace);
 
     return s;
 }
@@ -33,8 +33,9 @@ typedef enum tensor_reduction_type_t
 #define CASES_5_1 8
 #define CASES_5_2 8
 #define CASES_5_3 8
+#define CASES_6_0 4
 
-#define CASES CASES_0_0 + CASES_1_0 + CASES_2_0 + CASES_3_0 + CASES_4_0 + CASES_5_0 + CASES_5_1 + CASES_5_2 + CASES_5_3
+#define CASES CASES_0_0 + CASES_1_0 + CASES_2_0 + CASES_3_0 + CASES_4_0 + CASES_5_0 + CASES_5_1 + CASES_5_2 + CASES_5_3 + CASES_6_0
 #define KEEP_DIMENSIONS 2
 
 nw_error_t *error;
@@ -140,6 +141,11 @@ std::vector<int64_t> axis[CASES] = {
     {1, 3},
     {0, 2, 4},
     {0, 1, 2, 3, 4},
+    // Cases 6.0
+    {0, 2, 5},
+    {-1, -3, -6},
+    {1, 3, 6},
+    {0, 4, 7},
 };
 
 std::vector<int64_t> shapes[CASES] = {
@@ -236,6 +242,11 @@ std::vector<int64_t> shapes[CASES] = {
     {4, 1, 1},
     {4, 1, 1},
     {4, 1, 1},
+    // Cases 6.0
+    {2, 3, 2, 1, 2, 3},
+    {3, 2, 2, 1, 2, 2},
+    {2, 2, 3, 2, 2, 1, 2},
+    {2, 1, 2, 1, 2, 2, 1, 3},
 };
 
 std::vector<int64_t> expanded_shapes[CASES] = {
@@ -332,6 +343,11 @@ std::vector<int64_t> expanded_shapes[CASES] = {
     {6, 5, 4, 3, 2},
     {6, 5, 4, 3, 2},
     {6, 5, 4, 3, 2},
+    // Cases 6.0
+    {2, 3, 2, 1, 2, 3},
+    {3, 2, 2, 1, 2, 2},
+    {2, 2, 3, 2, 2, 1, 2},
+    {2, 2, 2, 2, 2, 2, 2, 3},
 };
 
 void setup(void)
@@ -442,7 +458,8 @@ void test_reduction(tensor_reduction_type_t tensor_reduction_type, bool_t test_g
                         ck_abort_msg("unknown reduction type.");
                     }
 
-                    expected_tensors[i][j][k][l] = torch_to_tensor(expected_tensor, (runtime_t) i, (datatype_t) j);
+                    expected_tensors[i][j][k][l] = torch_to_tensor(expected_tensor, (runtime_t) i, 
+                                                                   (tensor_reduction_type == TENSOR_ARGUMENT_MAXIMUM) ? INT64 : (datatype_t) j);
 
                     switch (tensor_reduction_type)
                     {
@@ -11,41 +11,53 @@ extern "C"
 }
 #include <test_helper_torch.h>
 
-#define CONVOLUTION_2D_CASES 3
+#define CONVOLUTION_2D_CASES 5
 #define CONVOLUTION_TRANSPOSE_2D_CASES 3
 #define POOL_2D_CASES 3
 #define BATCH_NORMALIZATION_2D_CASES 3
 #define LAYER_NORMALIZATION_CASES 3
 #define CAUSAL_MULTIHEAD_SELF_ATTENTION_CASES 3
 
+// The first cases run the direct kernel, the last two force the winograd (3x3, stride 1, in * out channels >= 64)
+// and image to column (in channels * kernel area >= 64, out channels >= 16) algorithms.
 std::vector<int64_t> convolution_2d_shapes_x[CONVOLUTION_2D_CASES] = {
     {5, 3, 6, 7},
     {1, 1, 9, 7},
     {10, 9, 9, 11},
+    {2, 8, 7, 9},
+    {3, 4, 9, 8},
 };
 
 std::vector<int64_t> convolution_2d_shapes_weights[CONVOLUTION_2D_CASES] = {
     {5, 3, 3, 3},
     {10, 1, 4, 4},
     {11, 9, 1, 1},
+    {8, 8, 3, 3},
+    {16, 4, 4, 4},
 };
 
 std::vector<int64_t> convolution_2d_shapes_bias[CONVOLUTION_2D_CASES] = {
     {5},
     {10},
     {11},
+    {8},
+    {16},
 };
 
 int64_t convolution_2d_stride[CONVOLUTION_2D_CASES] = {
     2,
     1,
     3,
+    1,
+    2,
 };
 
 int64_t convolution_2d_padding[CONVOLUTION_2D_CASES] = {
     1,
     3,
     0,
+    1,
+    1,
 };
 
 std::vector<int64_t> convolution_transpose_2d_shapes_x[CONVOLUTION_TRANSPOSE_2D_CASES] = {
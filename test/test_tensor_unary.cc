@@ -640,10 +640,153 @@ START_TEST(test_gelu)
 }
 END_TEST
 
+#define DROPOUT_CASES 3
+
+float64_t dropout_probabilities[DROPOUT_CASES] = {
+    0.0,
+    0.5,
+    0.99,
+};
+
+void setup_dropout(void)
+{
+    for (int i = 0; i < RUNTIMES; i++)
+    {
+        runtime_create_context((runtime_t) i);
+    }
+}
+
+void teardown_dropout(void)
+{
+    for (int i = 0; i < RUNTIMES; i++)
+    {
+        runtime_destroy_context((runtime_t) i);
+    }
+    error_print(error);
+    error_destroy(error);
+    error = NULL;
+}
+
+static float64_t dropout_element(const tensor_t *x, int64_t i)
+{
+    if (x->buffer->storage->datatype == FLOAT32)
+    {
+        return (float64_t) ((float32_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+    }
+
+    return ((float64_t *) x->buffer->storage->data)[x->buffer->view.offset + i];
+}
+
+START_TEST(test_dropout)
+{
+    const int64_t n = 4096;
+    int64_t shape[] = {64, 64};
+    bool_t mask[n];
+
+    for (int i = 0; i < RUNTIMES; i++)
+    {
+        for (int j = 0; j < DATATYPES; j++)
+        {
+            runtime_t runtime = (runtime_t) i;
+            datatype_t datatype = (datatype_t) j;
+            float32_t bounds_f[] = {1.0, 2.0, -1.0, 1.0};
+            float64_t bounds[] = {1.0, 2.0, -1.0, 1.0};
+
+            for (int k = 0; k < DROPOUT_CASES; ++k)
+            {
+                float64_t p = dropout_probabilities[k];
+                float32_t p_f = (float32_t) p;
+                void *probability = (datatype == FLOAT32) ? (void *) &p_f : (void *) &p;
+                // The kernel scales by the rounded 32-bit threshold rather than p.
+                float64_t epsilon = (datatype == FLOAT32) ? 1e-5 : 1e-7;
+                tensor_t *x = NULL, *gradient = NULL, *y = NULL, *z = NULL, *cost = NULL;
+                int64_t kept = 0;
+
+                // Inputs are bounded away from zero so a zero output marks a dropped element.
+                error = tensor_create_uniform(&x, shape, 2, runtime, datatype, true, true,
+                                              (datatype == FLOAT32) ? (void *) &bounds_f[0] : (void *) &bounds[0],
+                                              (datatype == FLOAT32) ? (void *) &bounds_f[1] : (void *) &bounds[1]);
+                ck_assert_ptr_null(error);
+                error = tensor_create_uniform(&gradient, shape, 2, runtime, datatype, false, true,
+                                              (datatype == FLOAT32) ? (void *) &bounds_f[2] : (void *) &bounds[2],
+                                              (datatype == FLOAT32) ? (void *) &bounds_f[3] : (void *) &bounds[3]);
+                ck_assert_ptr_null(error);
+
+                error = tensor_dropout(x, &y, probability, false);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+
+                for (int64_t l = 0; l < n; ++l)
+                {
+                    mask[l] = dropout_element(y, l) != 0.0;
+                    if (mask[l])
+                    {
+                        ck_assert_double_eq_tol(dropout_element(y, l), dropout_element(x, l) / (1.0 - p), epsilon * dropout_element(y, l));
+                        ++kept;
+                    }
+                }
+
+                if (p == 0.0)
+                {
+                    ck_assert_int_eq(kept, n);
+                }
+                else
+                {
+                    ck_assert_int_gt(kept, 0);
+                    ck_assert_int_lt(kept, n);
+                    ck_assert_double_eq_tol((float64_t) kept / (float64_t) n, 1.0 - p, 0.05);
+                }
+
+                // The backward pass regenerates the mask, it has to drop exactly the elements the forward pass dropped.
+                error = tensor_multiplication(y, gradient, &z);
+                ck_assert_ptr_null(error);
+                error = tensor_summation(z, &cost, NULL, 0, false);
+                ck_assert_ptr_null(error);
+                error = tensor_backward(cost, NULL);
+                ck_assert_ptr_null(error);
+                runtime_synchronize(runtime);
+
+                ck_assert_ptr_nonnull(x->gradient);
+                for (int64_t l = 0; l < n; ++l)
+                {
+                    if (mask[l])
+                    {
+                        ck_assert_double_eq_tol(dropout_element(x->gradient, l), dropout_element(gradient, l) / (1.0 - p),
+                                                epsilon * fabs(dropout_element(gradient, l) / (1.0 - p)));
+                    }
+                    else
+                    {
+                        ck_assert_double_eq(dropout_element(x->gradient, l), 0.0);
+                    }
+                }
+
+                tensor_destroy(x);
+                tensor_destroy(gradient);
+            }
+
+            // Dropping every element is rejected.
+            float64_t p = 1.0;
+            float32_t p_f = 1.0;
+            tensor_t *x = NULL, *y = NULL;
+
+            error = tensor_create_ones(&x, shape, 1, runtime, datatype, true, true);
+            ck_assert_ptr_null(error);
+            error = tensor_dropout(x, &y, (datatype == FLOAT32) ? (void *) &p_f : (void *) &p, false);
+            ck_assert_ptr_nonnull(error);
+            error_destroy(error);
+            error = NULL;
+            ck_assert_ptr_null(y);
+            tensor_destroy(x);
+        }
+    }
+}
+END_TEST
+
 Suite *make_unary_suite(void)
 {
     Suite *s;
     TCase *tc_unary;
+    TCase *tc_dropout;
 
     s = suite_create("Test Unary Tensor Suite");
 
@@ -666,6 +809,11 @@ Suite *make_unary_suite(void)
 
     suite_add_tcase(s, tc_unary);
 
+    tc_dropout = tcase_create("Test Dropout Case");
+    tcase_add_checked_fixture(tc_dropout, setup_dropout, teardown_dropout);
+    tcase_add_test(tc_dropout, test_dropout);
+    suite_add_tcase(s, tc_dropout);
+
     return s;
 }
 
@@ -5,25 +5,19 @@
 #include <test_helper.h>
 
 nw_error_t *error;
-view_t *original_view;
-view_t *returned_view;
-view_t *expected_view;
+view_t original_view;
+view_t returned_view;
+view_t expected_view;
 
 void setup(void)
 {
     error = NULL;
-    original_view = NULL;
-    returned_view = NULL;
-    expected_view = NULL;
 }
 
 void teardown(void)
 {
     error_print(error);
     error_destroy(error);
-    view_destroy(original_view);
-    view_destroy(returned_view);
-    view_destroy(expected_view);
 }
 
 START_TEST(test_view_create_error)
@@ -80,8 +74,6 @@ START_TEST(test_view_create_error)
 
         error_destroy(error);
         error = NULL;
-        view_destroy(returned_view);
-        returned_view = NULL;
     }
 }
 END_TEST
@@ -127,27 +119,15 @@ START_TEST(test_view_create)
         ck_assert_ptr_null(error);
 
         // Ranks and offsets must be the same as arguments
-        ck_assert_int_eq(returned_view->offset, offsets[i]);
-        ck_assert_int_eq(returned_view->rank, ranks[i]);
-
-        // Ensure the shape and strides are not NULL.
-        ck_assert_ptr_nonnull(returned_view->shape);
-        ck_assert_ptr_nonnull(returned_view->strides);
-
-        // Shapes and strides need to be copied and not directly assigned
-        ck_assert_ptr_ne(returned_view->shape, shapes[i]);
-        ck_assert_ptr_ne(returned_view->strides, strides[i]);
+        ck_assert_int_eq(returned_view.offset, offsets[i]);
+        ck_assert_int_eq(returned_view.rank, ranks[i]);
 
         // Compare shape and strides with expected
         for (int64_t j = 0; j < ranks[i]; j++)
         {
-            ck_assert_int_eq(returned_view->shape[j], shapes[i][j]);
-            ck_assert_int_eq(returned_view->strides[j], expected_strides[i][j]);
+            ck_assert_int_eq(returned_view.shape[j], shapes[i][j]);
+            ck_assert_int_eq(returned_view.strides[j], expected_strides[i][j]);
         }
-
-        // Destroy view
-        view_destroy(returned_view);
-        returned_view = NULL;
     }
 }
 END_TEST
@@ -233,13 +213,10 @@ START_TEST(test_view_is_contiguous)
         error = view_create(&returned_view, offsets[i], ranks[i], shapes[i], strides[i]);
         ck_assert_ptr_null(error);
 
-        error = view_is_contiguous(returned_view, &returned_is_contiguous);
+        error = view_is_contiguous(&returned_view, &returned_is_contiguous);
         ck_assert_ptr_null(error);
 
         ck_assert(expected_is_contiguous[i] == returned_is_contiguous);
-
-        view_destroy(returned_view);
-        returned_view = NULL;
     }
 }
 END_TEST
@@ -426,21 +403,17 @@ START_TEST(test_view_permute)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;
-        view_t *expected_view = NULL;
-        view_t *returned_view = NULL;
+        view_t original_view;
+        view_t expected_view;
+        view_t returned_view;
 
         error = view_create(&original_view, offsets[i], ranks[i], original_shapes[i], original_strides[i]);
         ck_assert_ptr_null(error);
         error = view_create(&expected_view, offsets[i], ranks[i], expected_shapes[i], expected_strides[i]);
         ck_assert_ptr_null(error);
-        error = view_permute(original_view, &returned_view, axes[i], lengths[i]);
+        error = view_permute(&original_view, &returned_view, axes[i], lengths[i]);
         ck_assert_ptr_null(error);
-        ck_assert_view_eq(returned_view, expected_view);
-
-        view_destroy(original_view);
-        view_destroy(expected_view);
-        view_destroy(returned_view);
+        ck_assert_view_eq(&returned_view, &expected_view);
     }
 }
 END_TEST
@@ -541,21 +514,17 @@ START_TEST(test_view_recover_dimensions)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;
-        view_t *expected_view = NULL;
-        view_t *returned_view = NULL;
+        view_t original_view;
+        view_t expected_view;
+        view_t returned_view;
 
         error = view_create(&original_view, reduced_offsets[i], reduced_ranks[i], reduced_shapes[i], reduced_strides[i]);
         ck_assert_ptr_null(error);
         error = view_create(&expected_view, recovered_offsets[i], recovered_ranks[i], expected_recovered_shapes[i], expected_recovered_strides[i]);
         ck_assert_ptr_null(error);
-        error = view_recover_dimensions(original_view, &returned_view, axis[i], lengths[i]);
+        error = view_recover_dimensions(&original_view, &returned_view, axis[i], lengths[i]);
         ck_assert_ptr_null(error);
-        ck_assert_view_eq(returned_view, expected_view);
-
-        view_destroy(original_view);
-        view_destroy(expected_view);
-        view_destroy(returned_view);
+        ck_assert_view_eq(&returned_view, &expected_view);
     }
 }
 END_TEST
@@ -973,21 +942,17 @@ START_TEST(test_view_reduce)
     
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;
-        view_t *expected_view = NULL;
-        view_t *returned_view = NULL;
+        view_t original_view;
+        view_t expected_view;
+        view_t returned_view;
 
         error = view_create(&original_view, original_offsets[i], original_ranks[i], original_shapes[i], original_strides[i]);
         ck_assert_ptr_null(error);
         error = view_create(&expected_view, reduced_offsets[i], reduced_ranks[i], expected_reduced_shapes[i], expected_reduced_strides[i]);
         ck_assert_ptr_null(error);
-        error = view_reduce(original_view, &returned_view, axis[i], lengths[i], keep_dimensions[i]);
+        error = view_reduce(&original_view, &returned_view, axis[i], lengths[i], keep_dimensions[i]);
         ck_assert_ptr_null(error);
-        ck_assert_view_eq(returned_view, expected_view);
-
-        view_destroy(original_view);
-        view_destroy(expected_view);
-        view_destroy(returned_view);
+        ck_assert_view_eq(&returned_view, &expected_view);
     }
 }
 END_TEST
@@ -1043,19 +1008,16 @@ START_TEST(test_view_shapes_equal)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *x_view = NULL;
-        view_t *y_view = NULL;
+        view_t x_view;
+        view_t y_view;
 
         error = view_create(&x_view, 0, x_ranks[i], x_shapes[i], NULL);
         ck_assert_ptr_null(error);
         error = view_create(&y_view, 0, y_ranks[i], y_shapes[i], NULL);
         ck_assert_ptr_null(error);
-        ck_assert(expected[i] == view_shapes_equal(x_view, y_view));
-        ck_assert(expected[i] == view_has_shape(x_view, y_view->shape, y_view->rank));
-        ck_assert(expected[i] == view_has_shape(y_view, x_view->shape, x_view->rank));
-
-        view_destroy(x_view);
-        view_destroy(y_view);
+        ck_assert(expected[i] == view_shapes_equal(&x_view, &y_view));
+        ck_assert(expected[i] == view_has_shape(&x_view, y_view.shape, y_view.rank));
+        ck_assert(expected[i] == view_has_shape(&y_view, x_view.shape, x_view.rank));
     }
 }
 END_TEST
@@ -1117,16 +1079,14 @@ START_TEST(test_view_logical_size)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *view = NULL;
+        view_t view;
         int64_t returned_n;
 
         error = view_create(&view, offsets[i], ranks[i], shapes[i], strides[i]);
         ck_assert_ptr_null(error);
-        error = view_logical_size(view, &returned_n);
+        error = view_logical_size(&view, &returned_n);
         ck_assert_ptr_null(error);
         ck_assert_int_eq(returned_n, expected_n[i]);
-
-        view_destroy(view);
     }
 }
 END_TEST
@@ -1273,21 +1233,17 @@ START_TEST(test_view_expand)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;
-        view_t *expected_view = NULL;
-        view_t *returned_view = NULL;
+        view_t original_view;
+        view_t expected_view;
+        view_t returned_view;
 
         error = view_create(&original_view, original_offsets[i], original_ranks[i], original_shapes[i], original_strides[i]);
         ck_assert_ptr_null(error);
         error = view_create(&expected_view, expanded_offsets[i], expanded_ranks[i], expanded_shapes[i], expanded_strides[i]);
         ck_assert_ptr_null(error);
-        error = view_expand(original_view, &returned_view, expanded_shapes[i], expanded_ranks[i]);
+        error = view_expand(&original_view, &returned_view, expanded_shapes[i], expanded_ranks[i]);
         ck_assert_ptr_null(error);
-        ck_assert_view_eq(returned_view, expected_view);
-
-        view_destroy(original_view);
-        view_destroy(expected_view);
-        view_destroy(returned_view);
+        ck_assert_view_eq(&returned_view, &expected_view);
     }
 }
 END_TEST
@@ -1334,21 +1290,18 @@ START_TEST(test_view_expand_error)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;
-        view_t *returned_view = NULL;
+        view_t original_view;
+        view_t returned_view;
 
         error = view_create(&original_view, original_offsets[i], original_ranks[i], original_shapes[i], original_strides[i]);
         ck_assert_ptr_null(error);
         error = view_create(&expected_view, expanded_offsets[i], expanded_ranks[i], expanded_shapes[i], expanded_strides[i]);
         ck_assert_ptr_null(error);
-        error = view_expand(original_view, &returned_view, expanded_shapes[i], expanded_ranks[i]);
+        error = view_expand(&original_view, &returned_view, expanded_shapes[i], expanded_ranks[i]);
         ck_assert_ptr_nonnull(error);
         ck_assert_int_eq(error->error_type, error_types[i]);
         error_destroy(error);
         error = NULL;
-
-        view_destroy(original_view);
-        view_destroy(returned_view);
     }
 }
 END_TEST
@@ -1503,8 +1456,8 @@ START_TEST(test_view_broadcast)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *x_view = NULL;
-        view_t *y_view = NULL;
+        view_t x_view;
+        view_t y_view;
         int64_t *returned_broadcasted_shape = NULL;
         int64_t returned_broadcasted_rank;
 
@@ -1512,7 +1465,7 @@ START_TEST(test_view_broadcast)
         ck_assert_ptr_null(error);
         error = view_create(&y_view, 0, y_original_ranks[i], y_original_shapes[i], NULL);
         ck_assert_ptr_null(error);
-        error = view_broadcast(x_view, y_view, &returned_broadcasted_shape, &returned_broadcasted_rank);
+        error = view_broadcast(&x_view, &y_view, &returned_broadcasted_shape, &returned_broadcasted_rank);
         ck_assert_ptr_null(error);
         ck_assert_int_eq(broadcasted_ranks[i], returned_broadcasted_rank);
         for (int64_t j = 0; j < broadcasted_ranks[i]; j++)
@@ -1522,8 +1475,6 @@ START_TEST(test_view_broadcast)
         }
 
         free(returned_broadcasted_shape);
-        view_destroy(x_view);
-        view_destroy(y_view);
     }
 }
 END_TEST
@@ -1575,8 +1526,8 @@ START_TEST(test_view_broadcast_error)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *x_view = NULL;
-        view_t *y_view = NULL;
+        view_t x_view;
+        view_t y_view;
         int64_t *returned_broadcasted_shape = NULL;
         int64_t returned_broadcasted_rank;
 
@@ -1584,15 +1535,13 @@ START_TEST(test_view_broadcast_error)
         ck_assert_ptr_null(error);
         error = view_create(&y_view, 0, y_original_ranks[i], y_original_shapes[i], NULL);
         ck_assert_ptr_null(error);
-        error = view_broadcast(x_view, y_view, &returned_broadcasted_shape, &returned_broadcasted_rank);
+        error = view_broadcast(&x_view, &y_view, &returned_broadcasted_shape, &returned_broadcasted_rank);
         ck_assert_ptr_nonnull(error);
         ck_assert_int_eq(error->error_type, error_types[i]);
         error_destroy(error);
         error = NULL;
 
         free(returned_broadcasted_shape);
-        view_destroy(x_view);
-        view_destroy(y_view);
     }
 }
 END_TEST
@@ -1721,7 +1670,7 @@ START_TEST(test_view_reduce_axis)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;        
+        view_t original_view;
         int64_t *returned_axis_keep_dimensions = NULL;
         int64_t *returned_axis_remove_dimensions = NULL;
         int64_t returned_length_keep_dimensions;
@@ -1730,7 +1679,7 @@ START_TEST(test_view_reduce_axis)
         error = view_create(&original_view, 0, original_ranks[i], original_shapes[i], NULL);
         ck_assert_ptr_null(error);
 
-        error = view_reduce_axis(original_view, broadcasted_shapes[i], broadcasted_ranks[i],
+        error = view_reduce_axis(&original_view, broadcasted_shapes[i], broadcasted_ranks[i],
                                  &returned_axis_keep_dimensions, &returned_length_keep_dimensions,
                                  &returned_axis_remove_dimensions, &returned_length_remove_dimensions);
         ck_assert_ptr_null(error);
@@ -1755,7 +1704,6 @@ START_TEST(test_view_reduce_axis)
                               expected_axis_remove_dimensions[i][j]);
         }
 
-        view_destroy(original_view);
         free(returned_axis_keep_dimensions);
         free(returned_axis_remove_dimensions);
     }
@@ -1803,7 +1751,7 @@ START_TEST(test_view_reduce_axis_error)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *original_view = NULL;        
+        view_t original_view;
         int64_t *returned_axis_keep_dimensions = NULL;
         int64_t *returned_axis_remove_dimensions = NULL;
         int64_t returned_length_keep_dimensions;
@@ -1812,7 +1760,7 @@ START_TEST(test_view_reduce_axis_error)
         error = view_create(&original_view, 0, original_ranks[i], original_shapes[i], NULL);
         ck_assert_ptr_null(error);
 
-        error = view_reduce_axis(original_view, broadcasted_shapes[i], broadcasted_ranks[i],
+        error = view_reduce_axis(&original_view, broadcasted_shapes[i], broadcasted_ranks[i],
                                  &returned_axis_keep_dimensions, &returned_length_keep_dimensions,
                                  &returned_axis_remove_dimensions, &returned_length_remove_dimensions);
         ck_assert_ptr_nonnull(error);
@@ -1820,7 +1768,6 @@ START_TEST(test_view_reduce_axis_error)
         error_destroy(error);
         error = NULL;
 
-        view_destroy(original_view);
         free(returned_axis_keep_dimensions);
         free(returned_axis_remove_dimensions);
     }
@@ -1925,15 +1872,13 @@ START_TEST(test_view_physical_size)
 
     for (int64_t i = 0; i < number_of_cases; i++)
     {
-        view_t *view = NULL;
+        view_t view;
 
         error = view_create(&view, offsets[i], ranks[i], shapes[i], strides[i]);
         ck_assert_ptr_null(error);
-        error = view_physical_size(view, &returned_n[i]);
+        error = view_physical_size(&view, &returned_n[i]);
         ck_assert_ptr_null(error);
         ck_assert_int_eq(returned_n[i], expected_n[i]);
-
-        view_destroy(view);
     }
 }
 END_TEST